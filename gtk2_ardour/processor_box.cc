@@ -561,6 +561,11 @@ ProcessorEntry::setup_tooltip ()
 			}
 			return;
 		}
+		if (std::dynamic_pointer_cast<DeferredProcessor> (_processor)) {
+			ARDOUR_UI::instance()->set_tip (_button,
+					string_compose (_("<b>%1</b>\nThe Plugin will be loaded when the track/bus is activated."), name (Wide)));
+			return;
+		}
 		if(std::dynamic_pointer_cast<UnknownProcessor> (_processor)) {
 			ARDOUR_UI::instance()->set_tip (_button,
 					string_compose (_("<b>%1</b>\nThe Plugin is not available on this system\nand has been replaced by a stub."), name (Wide)));
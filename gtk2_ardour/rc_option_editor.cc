@@ -2398,6 +2398,17 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("General"), new UndoOptions (_rc_config));
 
+	SpinOption<uint32_t>* spill = new SpinOption<uint32_t> (
+		"history-spill-depth",
+		_("Move undo history to disk after (commands, 0: never)"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_history_spill_depth),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_history_spill_depth),
+		0, 4096, 1, 16
+		);
+	Gtkmm2ext::UI::instance()->set_tip (spill->tip_widget(),
+	                                    _("Only keep the most recent undo commands in memory. Older commands are written to a file in the session folder, and read back when they are undone."));
+	add_option (_("General"), spill);
+
 	add_option (_("General"),
 	     new BoolOption (
 		     "verify-remove-last-capture",
@@ -2469,6 +2480,38 @@ RCOptionEditor::RCOptionEditor ()
 		     sigc::mem_fun (UIConfiguration::instance(), &UIConfiguration::set_save_export_mixer_screenshot)
 		     ));
 
+	bo = new BoolOption (
+		     "offline-export-render",
+		     _("Render export without using the audio engine's freewheel mode"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_offline_export_render),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_offline_export_render)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, non-realtime export is processed as fast as possible in a thread of its own, independent of the audio backend. The audio device keeps running, but session outputs are silent during export."));
+	add_option (_("General"), bo);
+
+	SpinOption<uint32_t>* cts = new SpinOption<uint32_t> (
+		"export-concurrent-timespans",
+		_("Maximum number of ranges to export concurrently"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_export_concurrent_timespans),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_export_concurrent_timespans),
+		1, 64, 1, 4
+		);
+	Gtkmm2ext::UI::instance()->set_tip (cts->tip_widget(),
+	                                    _("Overlapping or adjacent ranges (e.g. consecutive range markers) are exported in a single pass over the timeline, instead of one after another. This does not apply to realtime export."));
+	add_option (_("General"), cts);
+
+	SpinOption<uint32_t>* nmem = new SpinOption<uint32_t> (
+		"export-normalize-memory",
+		_("Memory to use for normalized export (MiB)"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_export_normalize_memory),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_export_normalize_memory),
+		0, 65536, 64, 1024
+		);
+	Gtkmm2ext::UI::instance()->set_tip (nmem->tip_widget(),
+	                                    _("Normalized export keeps the analyzed audio in memory up to this limit, and uses a temporary file only beyond it. This does not apply to realtime export."));
+	add_option (_("General"), nmem);
+
 #if defined PHONE_HOME && !defined MIXBUS
 	add_option (_("General"), new OptionEditorHeading (_("New Version Check")));
 	bo = new BoolOption (
@@ -4020,6 +4063,16 @@ These settings will only take effect after %1 is restarted.\n\
 	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
 					    _("<b>When enabled</b> the Plugin Manager is display at session load if the session contains any plugins that are missing, or plugins have been updated and require a rescan."));
 
+	bo = new BoolOption (
+		"defer-plugin-instantiation",
+			_("Load plugins of inactive tracks/busses when they are activated"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_defer_plugin_instantiation),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_defer_plugin_instantiation)
+			);
+	add_option (_("Plugins"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> plugins of tracks/busses that are inactive when a session is loaded are not instantiated until the track/bus is activated. This speeds up loading sessions and templates with many inactive tracks.\nThe setting only takes effect when loading a session."));
+
 	bo = new BoolOption (
 		"new-plugins-active",
 			_("Make new plugins active"),
@@ -107,12 +107,18 @@ Amp::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sampl
 		const gain_t a = 156.825f / (gain_t)_session.nominal_sample_rate(); // 25 Hz LPF; see Amp::apply_gain for details
 		gain_t lpf = _current_gain;
 
-		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			Sample* const sp = i->data();
-			lpf = _current_gain;
+		if (bufs.count().n_audio() > 0) {
+			/* low-pass filter the automation curve once, in place (the buffer is
+			 * only valid for this cycle), and apply it to all channels.
+			 */
 			for (pframes_t nx = 0; nx < nframes; ++nx) {
-				sp[nx] *= lpf;
-				lpf += a * (gab[nx] - lpf);
+				const gain_t g = gab[nx];
+				gab[nx] = lpf;
+				lpf += a * (g - lpf);
+			}
+
+			for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
+				apply_gain_vector_to_buffer (i->data(), gab, nframes);
 			}
 		}
 
@@ -180,13 +186,7 @@ Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes,
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		const gain_t lpf = apply_gain_ramp_to_buffer (i->data(), nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -262,11 +262,7 @@ Amp::apply_gain (AudioBuffer& buf, samplecnt_t sample_rate, samplecnt_t nframes,
 	Sample* const buffer = buf.data (offset);
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	gain_t lpf = initial;
-	for (pframes_t nx = 0; nx < nframes; ++nx) {
-		buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
-	}
+	const gain_t lpf = apply_gain_ramp_to_buffer (buffer, nframes, initial, target, a);
 
 	if (fabsf (lpf - target) < GAIN_COEFF_DELTA) return target;
 	return lpf;
@@ -42,6 +42,11 @@ public:
 	void cycle_end (pframes_t);
 	void cycle_split ();
 
+	/* cycle_start/end of several ports at once, their resamplers
+	 * share the filter computation when they are in sync */
+	static void cycle_start_batch (AudioPort* const*, uint32_t, pframes_t);
+	static void cycle_end_batch (AudioPort* const*, uint32_t, pframes_t);
+
 	void flush_buffers (pframes_t nframes);
 
 	/* reset SRC, clear out any state */
@@ -54,6 +54,7 @@ namespace ARDOUR {
 
 class InternalPort;
 class MidiPort;
+class OfflinePortEngine;
 class MIDIDM;
 class Port;
 class Session;
@@ -131,9 +132,22 @@ class LIBARDOUR_API AudioEngine : public PortManager, public SessionHandlePtr
 
 	/* END BACKEND PROXY API */
 
-	bool freewheeling() const { return _freewheeling; }
+	bool freewheeling() const { return _freewheeling.load (); }
 	bool running() const { return _running; }
 
+	/** Process the session in a thread of our own, as fast as possible,
+	 * using private port buffers (see OfflinePortEngine) instead of the
+	 * backend's. This is an alternative to freewheel (true), which does
+	 * not depend on backend support and leaves the backend running
+	 * (with silent outputs) while rendering. Processing uses the
+	 * backend's period size.
+	 *
+	 * freewheel (false) stops rendering asynchronously, freewheeling()
+	 * is true until the render thread has finished.
+	 */
+	int  start_offline_render ();
+	bool offline_rendering () const { return _offline_rendering.load (); }
+
 	std::string backend_id (bool for_input);
 
 	Glib::Threads::Mutex& process_lock() { return _process_lock; }
@@ -276,7 +290,7 @@ class LIBARDOUR_API AudioEngine : public PortManager, public SessionHandlePtr
 	gain_t                     session_removal_gain;
 	gain_t                     session_removal_gain_step;
 	bool                      _running;
-	bool                      _freewheeling;
+	std::atomic<bool>         _freewheeling; // set by the backend, or the offline render thread
 	/// number of samples between each check for changes in monitor input
 	samplecnt_t                monitor_check_interval;
 	/// time of the last monitor check in samples
@@ -314,6 +328,14 @@ class LIBARDOUR_API AudioEngine : public PortManager, public SessionHandlePtr
 	std::atomic<int>         _pending_playback_latency_callback;
 	std::atomic<int>         _pending_capture_latency_callback;
 
+	std::atomic<bool>         _offline_rendering;
+	std::atomic<bool>         _stop_offline_render;
+	PBD::Thread*              _offline_render_thread;
+	OfflinePortEngine*        _offline_engine;
+
+	void offline_render_thread ();
+	void stop_offline_render ();
+
 	void start_hw_event_processing();
 	void stop_hw_event_processing();
 	void do_reset_backend();
@@ -44,6 +44,7 @@
 namespace ARDOUR {
 
 class AutomationList;
+class AutomationPrerender;
 class BeatsSamplesConverter;
 
 /** A SharedStatefulProperty for AutomationLists */
@@ -103,7 +104,7 @@ public:
 
 	static PBD::Signal1<void,AutomationList*> AutomationListCreated;
 
-	void start_write_pass (timepos_t const & when);
+	void start_write_pass (timepos_t const & when, double thinning_factor = 0.0);
 	void write_pass_finished (timepos_t const & when, double thinning_factor=0.0);
 
 	void start_touch (timepos_t const & when);
@@ -126,8 +127,15 @@ public:
 
 	ControlList::InterpolationStyle default_interpolation () const;
 
+	/** Realtime safe evaluation of the curve for [start, end), using
+	 * values pre-rendered by the butler if available, see
+	 * AutomationPrerender. May fail if the list is locked.
+	 */
+	bool rt_safe_get_vector (samplepos_t start, samplepos_t end, float* vec, samplecnt_t veclen) const;
+
 private:
 	void create_curve_if_necessary ();
+	void maybe_create_prerender ();
 	int deserialize_events (const XMLNode&);
 
 	XMLNode& state (bool save_auto_state, bool need_lock) const;
@@ -143,6 +151,8 @@ private:
 	bool operator== (const AutomationList&) const { /* not called */ abort(); return false; }
 	XMLNode* _before; //used for undo of touch start/stop pairs.
 
+	std::atomic<AutomationPrerender*> _prerender;
+
 };
 
 } // namespace
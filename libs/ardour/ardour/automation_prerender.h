@@ -0,0 +1,106 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_automation_prerender_h__
+#define __ardour_automation_prerender_h__
+
+#include <atomic>
+#include <set>
+
+#include <glibmm/threads.h>
+
+#include "pbd/ringbuffer.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class AutomationList;
+
+/** Read-ahead of sample-rate automation values for one AutomationList.
+ *
+ * The butler renders the curve of the list ahead of the playhead into a
+ * lock-free ring buffer, so the process thread can copy values rather
+ * than interpolating under the list's lock (which fails, and skips
+ * automation, whenever an edit holds the lock).
+ *
+ * A list may be read by several process threads concurrently (e.g. a VCA
+ * master by all routes that it controls), at slightly different positions.
+ * Readers therefore never modify the ring: they only report the position
+ * they need next. The butler discards values that no reader needed during
+ * the last two refills, and starts over at the earliest reported position
+ * when the data in the ring is stale (after a locate, an edit or an
+ * underrun). Until then callers fall back to evaluating the curve.
+ */
+class LIBARDOUR_API AutomationPrerender
+{
+public:
+	AutomationPrerender (AutomationList&, samplecnt_t bufsize);
+	~AutomationPrerender ();
+
+	/** Process thread: copy the values for [start, start + nframes) to @p vec.
+	 * Realtime safe, and safe to call from several threads at once.
+	 * @return false if they have not been rendered (yet).
+	 */
+	bool read (samplepos_t start, float* vec, samplecnt_t nframes);
+
+	/** Any thread: the list was modified, rendered data is stale */
+	void invalidate () { _generation.fetch_add (1); }
+
+	/** Butler: render as much as fits into the ring */
+	void refill ();
+
+	/** Butler: refill all instances whose list is currently playing back */
+	static void refill_all ();
+
+	/** @return true if some instance wants the butler to run */
+	static bool refill_wanted () { return _refill_wanted.load () != 0; }
+
+private:
+	AutomationList&        _list;
+	PBD::RingBuffer<float> _buf;
+
+	/** timeline position of the first value in the ring (butler only) */
+	std::atomic<samplepos_t> _read_pos;
+	/** timeline position of the next value to be rendered (butler only) */
+	samplepos_t              _write_pos;
+
+	/** odd while the butler discards values or resets the ring, and
+	 * incremented for every such change; readers that see it change
+	 * while copying retry later (seqlock)
+	 */
+	std::atomic<unsigned int> _seq;
+
+	std::atomic<int>          _generation;
+	std::atomic<int>          _rendered_generation;
+	std::atomic<int>          _reset_pending;
+
+	/** earliest position a reader needs next, since the last refill */
+	std::atomic<samplepos_t>  _next_pos;
+	samplepos_t               _prev_next_pos;
+
+	void note_position (samplepos_t);
+	void request_reset ();
+
+	static Glib::Threads::Mutex            _instance_lock;
+	static std::set<AutomationPrerender*>  _instances;
+	static std::atomic<int>                _refill_wanted;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_automation_prerender_h__ */
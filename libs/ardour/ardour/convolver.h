@@ -33,6 +33,12 @@ namespace ARDOUR { namespace DSP {
 class LIBARDOUR_API Convolution : public SessionHandleRef
 {
 public:
+	enum ThreadPolicy {
+		Realtime, ///< one thread per partition size (default)
+		Parallel, ///< each partition size is shared by several threads
+		Export    ///< Realtime, but Parallel while the engine is freewheeling
+	};
+
 	Convolution (Session&, uint32_t n_in, uint32_t n_out);
 	virtual ~Convolution () {}
 
@@ -53,12 +59,43 @@ public:
 
 	void clear_impdata ();
 	void restart ();
+
+	/** Set how partitions of the IR are processed by background threads.
+	 * All threads run at realtime priority, below the engine's.
+	 * Takes effect on the next restart ().
+	 *
+	 * This only applies to threaded convolution. Without background
+	 * threads, the IR is processed by the caller of run () in a single
+	 * partition size, which is never shared.
+	 *
+	 * The smallest partition size, if it equals the latency, is also
+	 * processed by the caller of run (), and not shared. Helper threads
+	 * of all instances are limited to one less than the number of CPU
+	 * cores in total, the first levels that are started get them.
+	 *
+	 * @param n_threads number of threads per partition size, used by
+	 * Parallel and Export policies. 0: one per CPU core
+	 */
+	void set_thread_policy (ThreadPolicy, uint32_t n_threads = 0);
+
+	/** Set the smallest and largest partition size, takes effect on the
+	 * next restart (). Sizes are rounded up to a power of two, 0 uses
+	 * the default.
+	 *
+	 * The smallest partition defines the latency of threaded convolution,
+	 * otherwise the session's block size is used. Large partitions
+	 * reduce the CPU load of long IRs. Without background threads the
+	 * largest partition is the block size, since larger ones need them.
+	 */
+	void set_partition_size (uint32_t min_part, uint32_t max_part);
 	void run (BufferSet&, ChanMapping const&, ChanMapping const&, pframes_t, samplecnt_t);
 
 	void run_mono_buffered (float*, uint32_t);
 	void run_mono_no_latency (float*, uint32_t);
 
 protected:
+	void process ();
+
 	ArdourZita::Convproc _convproc;
 
 	uint32_t _n_samples;
@@ -117,6 +154,12 @@ private:
 	std::vector<ImpData> _impdata;
 	uint32_t             _n_inputs;
 	uint32_t             _n_outputs;
+
+	ThreadPolicy _thread_policy;
+	uint32_t     _n_threads;
+	uint32_t     _min_part;
+	uint32_t     _max_part;
+	bool         _parallel;
 };
 
 class LIBARDOUR_API Convolver : public Convolution
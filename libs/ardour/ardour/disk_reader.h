@@ -175,7 +175,6 @@ protected:
 
 	private:
 		float _a;
-		float _l;
 		float _g;
 	};
 
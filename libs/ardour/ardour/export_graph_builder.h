@@ -28,8 +28,10 @@
 
 #include "audiographer/utils/identity_vertex.h"
 
+#include <atomic>
+
 #include <boost/ptr_container/ptr_list.hpp>
-#include <glibmm/threadpool.h>
+#include <glibmm/threads.h>
 
 namespace AudioGrapher {
 	class SampleRateConverter;
@@ -45,18 +47,37 @@ namespace AudioGrapher {
 	template <typename T> class SndfileWriter;
 	template <typename T> class CmdPipeWriter;
 	template <typename T> class SilenceTrimmer;
+	template <typename T> class AsyncWriter;
 	template <typename T> class TmpFile;
+	template <typename T> class TmpBuffer;
 	template <typename T> class Threader;
+	class WorkerPool;
 	template <typename T> class AllocatingProcessContext;
 }
 
 namespace ARDOUR
 {
 
+class Buffer;
 class ExportTimespan;
 class MidiBuffer;
 class Session;
 
+/** Channel data of one process cycle, shared by the graph builders of
+ * timespans that are exported concurrently. Reading an export channel
+ * advances its delay-lines, so every channel must only be read once.
+ */
+class LIBARDOUR_API ExportChannelReads
+{
+  public:
+	void reserve (size_t n) { _reads.reserve (n); }
+	void clear () { _reads.clear (); }
+	Buffer const* read (ExportChannelPtr const&, samplecnt_t samples);
+
+  private:
+	std::vector<std::pair<ExportChannel const*, Buffer const*> > _reads;
+};
+
 class LIBARDOUR_API ExportGraphBuilder
 {
   private:
@@ -91,6 +112,14 @@ class LIBARDOUR_API ExportGraphBuilder
 	~ExportGraphBuilder ();
 
 	samplecnt_t process (samplecnt_t samples, bool last_cycle);
+
+	/** Process the part of a cycle that falls into the current timespan.
+	 * @param position timeline position of the first sample after latency pre-roll
+	 * @return number of samples of the cycle after latency pre-roll
+	 */
+	samplecnt_t process (samplecnt_t samples, samplepos_t position, ExportChannelReads& reads);
+	size_t n_channels () const { return channels.size (); }
+
 	bool post_process (); // returns true when finished
 	bool need_postprocessing () const { return !intermediates.empty(); }
 	bool realtime() const { return _realtime; }
@@ -99,6 +128,18 @@ class LIBARDOUR_API ExportGraphBuilder
 	void reset ();
 	void cleanup (bool remove_out_files = false);
 	void set_current_timespan (std::shared_ptr<ExportTimespan> span);
+
+	/** Set the threads that process the outputs of Intermediates in
+	 * parallel. The pool is shared with all other builders of the same
+	 * export, and must be set before adding configurations.
+	 */
+	void set_worker_pool (std::shared_ptr<AudioGrapher::WorkerPool> pool) { _worker_pool = pool; }
+
+	/** Set the memory (in samples) that non-realtime Intermediates may use
+	 * instead of a temporary file. The budget is shared with all other
+	 * builders of the same export, 0 writes everything to files.
+	 */
+	void set_tmp_buffer_budget (std::shared_ptr<std::atomic<samplecnt_t> > budget) { _tmp_buffer_budget = budget; }
 	void add_config (FileSpec const & config, bool rt);
 	void get_analysis_results (AnalysisResults& results);
 
@@ -137,6 +178,11 @@ class LIBARDOUR_API ExportGraphBuilder
 
 		typedef std::shared_ptr<AudioGrapher::CmdPipeWriter<Sample> > FloatPipePtr;
 
+		typedef std::shared_ptr<AudioGrapher::AsyncWriter<Sample> > FloatQueuePtr;
+		typedef std::shared_ptr<AudioGrapher::AsyncWriter<int> >    IntQueuePtr;
+		typedef std::shared_ptr<AudioGrapher::AsyncWriter<short> >  ShortQueuePtr;
+
+		template<typename T> std::shared_ptr<AudioGrapher::Sink<T> > init_queue (std::shared_ptr<AudioGrapher::AsyncWriter<T> > & queue, std::shared_ptr<AudioGrapher::Sink<T> > writer);
 		template<typename T> void init_writer (std::shared_ptr<AudioGrapher::SndfileWriter<T> > & writer);
 		template<typename T> void init_writer (std::shared_ptr<AudioGrapher::CmdPipeWriter<T> > & writer);
 
@@ -153,6 +199,11 @@ class LIBARDOUR_API ExportGraphBuilder
 		IntWriterPtr   int_writer;
 		ShortWriterPtr short_writer;
 		FloatPipePtr   pipe_writer;
+
+		// Encoder threads, feeding the writer
+		FloatQueuePtr  float_queue;
+		IntQueuePtr    int_queue;
+		ShortQueuePtr  short_queue;
 	};
 
 	// sample format converter
@@ -211,9 +262,11 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef std::shared_ptr<AudioGrapher::PeakReader> PeakReaderPtr;
 		typedef std::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef std::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
+		typedef std::shared_ptr<AudioGrapher::TmpBuffer<Sample> > TmpBufferPtr;
 		typedef std::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef std::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
+		TmpFilePtr create_tmp_file ();
 		void prepare_post_processing ();
 		void start_post_processing ();
 
@@ -225,7 +278,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		bool            use_peak;
 		BufferPtr       buffer;
 		PeakReaderPtr   peak_reader;
-		TmpFilePtr      tmp_file;
+		TmpBufferPtr    tmp_buffer;
 		ThreaderPtr     threader;
 
 		LoudnessReaderPtr    loudness_reader;
@@ -316,7 +369,13 @@ class LIBARDOUR_API ExportGraphBuilder
 	bool        _realtime;
 	samplecnt_t _master_align;
 
-	Glib::ThreadPool     thread_pool;
+	/* shared by all Threaders, see set_worker_pool() */
+	std::shared_ptr<AudioGrapher::WorkerPool> _worker_pool;
+
+	/* memory (in samples) that Intermediates may use instead of a TmpFile,
+	 * see set_tmp_buffer_budget() */
+	std::shared_ptr<std::atomic<samplecnt_t> > _tmp_buffer_budget;
+
 	Glib::Threads::Mutex engine_request_lock;
 };
 
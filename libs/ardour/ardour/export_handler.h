@@ -24,8 +24,10 @@
 #ifndef __ardour_export_handler_h__
 #define __ardour_export_handler_h__
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <boost/operators.hpp>
 
@@ -37,6 +39,10 @@
 #include "ardour/types.h"
 #include "pbd/signals.h"
 
+namespace AudioGrapher {
+	class WorkerPool;
+}
+
 namespace AudioGrapher {
 	class BroadcastInfo;
 }
@@ -46,6 +52,7 @@ namespace ARDOUR
 
 class ExportTimespan;
 class ExportChannelConfiguration;
+class ExportChannelReads;
 class ExportFormatSpecification;
 class ExportFilename;
 class ExportGraphBuilder;
@@ -157,6 +164,44 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	ExportTimespanPtr     current_timespan;
 	TimespanBounds        timespan_bounds;
 
+	/* Overlapping or adjacent timespans can be exported concurrently, in a
+	 * single pass over the timeline, each with its own graph builder.
+	 * (see RCConfiguration::get_export_concurrent_timespans)
+	 */
+	struct ConcurrentTimespan {
+		ConcurrentTimespan (ExportTimespanPtr ts, std::shared_ptr<ExportGraphBuilder> gb)
+			: timespan (ts)
+			, graph_builder (gb)
+			, position (0)
+			, done (false)
+		{}
+
+		ExportTimespanPtr                   timespan;
+		std::shared_ptr<ExportGraphBuilder> graph_builder;
+		samplepos_t                         position;
+		bool                                done;
+	};
+
+	typedef std::vector<ConcurrentTimespan> ConcurrentTimespans;
+	ConcurrentTimespans   concurrent_timespans;
+
+	/* additional graph builders, graph_builder is used for the first timespan */
+	std::vector<std::shared_ptr<ExportGraphBuilder> > concurrent_graph_builders;
+	std::shared_ptr<ExportChannelReads>               channel_reads;
+
+	/* threads shared by all graph builders, created on demand */
+	std::shared_ptr<AudioGrapher::WorkerPool>         worker_pool;
+
+	/* memory (in samples) that all graph builders together may use
+	 * instead of temporary files, see RCConfiguration::get_export_normalize_memory */
+	std::shared_ptr<std::atomic<samplecnt_t> >        tmp_buffer_budget;
+
+	bool can_export_concurrently (ExportTimespanPtr) const;
+	void collect_concurrent_timespans (std::vector<ExportTimespanPtr>&) const;
+	int  start_concurrent_timespans (std::vector<ExportTimespanPtr> const&);
+	int  process_concurrent_timespans (samplecnt_t samples);
+	void finish_files (ExportGraphBuilder&);
+
 	PBD::ScopedConnection process_connection;
 	samplepos_t           process_position;
 
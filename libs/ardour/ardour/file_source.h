@@ -88,6 +88,11 @@ public:
 
 	static PBD::Signal2<int,std::string,std::vector<std::string> > AmbiguousFileName;
 
+	/** Whether find() may emit AmbiguousFileName in the calling thread.
+	 * When disabled, an ambiguous name is treated like a missing file.
+	 */
+	static void set_ask_about_ambiguous_files (bool);
+
 	void existence_check ();
 	virtual void prevent_deletion ();
 
@@ -115,6 +120,9 @@ public:
 	bool        _within_session;
 	std::string _origin;
 	float       _gain;
+
+  private:
+	static thread_local bool _ask_about_ambiguous_files;
 };
 
 } // namespace ARDOUR
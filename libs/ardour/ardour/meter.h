@@ -28,14 +28,10 @@
 #include "pbd/fastlog.h"
 
 #include "ardour/libardour_visibility.h"
+#include "ardour/meter_bank.h"
 #include "ardour/processor.h"
 #include "ardour/types.h"
 
-#include "ardour/iec1ppmdsp.h"
-#include "ardour/iec2ppmdsp.h"
-#include "ardour/kmeterdsp.h"
-#include "ardour/vumeterdsp.h"
-
 namespace ARDOUR {
 
 class BufferSet;
@@ -109,10 +105,8 @@ private:
 	std::vector<float> _peak_power;      // includes accurate falloff, hence dB
 	std::vector<float> _max_peak_signal; // dB calculation is done on demand
 
-	std::vector<Kmeterdsp*>  _kmeter;
-	std::vector<Iec1ppmdsp*> _iec1meter;
-	std::vector<Iec2ppmdsp*> _iec2meter;
-	std::vector<Vumeterdsp*> _vumeter;
+	MeterBank                  _meter_bank; // K, IEC1, IEC2, VU
+	std::vector<Sample const*> _audio_data; // internal, channel pointers for _meter_bank
 
 	MeterType _meter_type;
 };
@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_meter_bank_h__
+#define __ardour_meter_bank_h__
+
+#include <stdint.h>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** Ballistic meters (K-meter, IEC1 and IEC2 PPM, VU) of many channels.
+ *
+ * This runs the same filters as Kmeterdsp, Iec1ppmdsp, Iec2ppmdsp and
+ * Vumeterdsp, but the state of all channels is kept in contiguous arrays,
+ * and 4 channels are processed at once by the optimized kmeter_bank (),
+ * iecppm_bank () and vumeter_bank () routines.
+ *
+ * process () is called from the realtime thread, read () from the GUI.
+ */
+class LIBARDOUR_API MeterBank
+{
+public:
+	MeterBank ();
+
+	static void init (float fsamp);
+
+	/** Allocate state for @a n channels (not realtime safe), and reset it */
+	void     set_channels (uint32_t n);
+	uint32_t n_channels () const { return _n_channels; }
+
+	void reset ();
+	void reset (MeterType types);
+
+	/** Run the meters given by @a types.
+	 * @param bufs @a n_bufs channels of data, channels beyond n_channels () are ignored,
+	 * and channels beyond @a n_bufs keep their state
+	 */
+	void process (MeterType types, Sample const* const* bufs, uint32_t n_bufs, pframes_t nframes);
+
+	/** Highest level of channel @a chn since the last call (gain coefficient) */
+	float read (MeterType type, uint32_t chn);
+
+private:
+	static const uint32_t lanes = 4;
+
+	struct State {
+		void resize (uint32_t n);
+		void reset (bool res);
+
+		std::vector<float>   z1;  // filter state
+		std::vector<float>   z2;  // filter state
+		std::vector<float>   m;   // max value since last read (rms for K-meter)
+		std::vector<uint8_t> res; // set by read (), resets m
+	};
+
+	class Group;
+
+	void kmeter (uint32_t c, uint32_t nc, Sample const* const* bufs, pframes_t nframes);
+	void iecppm (State&, float w1, float w2, float w3, uint32_t c, uint32_t nc, Sample const* const* bufs, pframes_t nframes);
+	void vumeter (uint32_t c, uint32_t nc, Sample const* const* bufs, pframes_t nframes);
+
+	uint32_t _n_channels;
+
+	State _kmeter;
+	State _iec1;
+	State _iec2;
+	State _vu;
+
+	static float _k_omega;
+	static float _iec1_w1, _iec1_w2, _iec1_w3, _iec1_g;
+	static float _iec2_w1, _iec2_w2, _iec2_w3, _iec2_g;
+	static float _vu_w, _vu_g;
+};
+
+} // namespace ARDOUR
+
+#endif // __ardour_meter_bank_h__
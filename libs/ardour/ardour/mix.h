@@ -34,6 +34,22 @@ extern "C" {
 }
 
 LIBARDOUR_API void x86_sse_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API void x86_sse_clip_floats             (float* buf, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API float x86_sse_apply_gain_ramp_to_buffer    (float* buf, uint32_t nframes, float gain, float target, float coeff);
+LIBARDOUR_API void  x86_sse_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_vmr_interpolate              (float* c, float const* cq1, float const* cq2, float aa, float bb, uint32_t hl);
+LIBARDOUR_API float x86_sse_vmr_dot_product              (float const* c, float const* p, uint32_t n);
+LIBARDOUR_API void  x86_sse_conv_mac                     (float* d, float const* a, float const* b, uint32_t n);
+LIBARDOUR_API void  x86_sse_kmeter_bank                  (float* z1, float* z2, float const* const* bufs, uint32_t n_chan, uint32_t nframes, float omega);
+LIBARDOUR_API void  x86_sse_iecppm_bank                  (float* z1, float* z2, float* m, float const* const* bufs, uint32_t n_chan, uint32_t nframes, float w1, float w2, float w3);
+LIBARDOUR_API void  x86_sse_vumeter_bank                 (float* z1, float* z2, float* m, float const* const* bufs, uint32_t n_chan, uint32_t nframes, float w);
+
+#ifdef __SSE2__
+/* SSE2 functions */
+LIBARDOUR_API void x86_sse2_float_to_int16         (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void x86_sse2_float_to_int32         (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+#endif
 
 extern "C" {
 /* AVX functions */
@@ -48,6 +64,16 @@ extern "C" {
 }
 #ifdef PLATFORM_WINDOWS
 LIBARDOUR_API void x86_sse_avx_find_peaks               (float const* buf, uint32_t nsamples, float* min, float* max);
+#else
+LIBARDOUR_API void x86_sse_avx_float_to_int16           (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void x86_sse_avx_float_to_int32           (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void x86_sse_avx_clip_floats              (float* buf, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API float x86_sse_avx_apply_gain_ramp_to_buffer    (float* buf, uint32_t nframes, float gain, float target, float coeff);
+LIBARDOUR_API void  x86_sse_avx_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_vmr_interpolate              (float* c, float const* cq1, float const* cq2, float aa, float bb, uint32_t hl);
+LIBARDOUR_API float x86_sse_avx_vmr_dot_product              (float const* c, float const* p, uint32_t n);
+LIBARDOUR_API void  x86_sse_avx_conv_mac                     (float* d, float const* a, float const* b, uint32_t n);
 #endif
 
 /* FMA functions */
@@ -63,6 +89,13 @@ LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain   (float* dst, float const
 LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain     (float* dst, float const* src, uint32_t nframes);
 LIBARDOUR_API void  x86_avx512f_copy_vector             (float* dst, float const* src, uint32_t nframes);
 LIBARDOUR_API void  x86_avx512f_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API void  x86_avx512f_float_to_int16          (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void  x86_avx512f_float_to_int32          (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void  x86_avx512f_clip_floats             (float* buf, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API float x86_avx512f_apply_gain_ramp_to_buffer    (float* buf, uint32_t nframes, float gain, float target, float coeff);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_conv_mac                     (float* d, float const* a, float const* b, uint32_t n);
 #endif
 
 /* debug wrappers for SSE functions */
@@ -82,6 +115,8 @@ LIBARDOUR_API void  veclib_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDOU
 LIBARDOUR_API void  veclib_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  veclib_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  veclib_find_peaks                (ARDOUR::Sample const* buf, ARDOUR::pframes_t nsamples, float* min, float* max);
+LIBARDOUR_API void  veclib_apply_gain_vector_to_buffer  (ARDOUR::Sample* buf, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  veclib_mix_buffers_with_gain_vector (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
 
 #endif
 
@@ -95,6 +130,20 @@ extern "C" {
 	LIBARDOUR_API void  arm_neon_mix_buffers_no_gain   (float* dst, float const* src, uint32_t nframes);
 	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain (float* dst, float const* src, uint32_t nframes, float gain);
 }
+LIBARDOUR_API void arm_neon_clip_floats                (float* buf, uint32_t nframes);
+LIBARDOUR_API void  arm_neon_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API float arm_neon_apply_gain_ramp_to_buffer    (float* buf, uint32_t nframes, float gain, float target, float coeff);
+LIBARDOUR_API void  arm_neon_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  arm_neon_vmr_interpolate              (float* c, float const* cq1, float const* cq2, float aa, float bb, uint32_t hl);
+LIBARDOUR_API float arm_neon_vmr_dot_product              (float const* c, float const* p, uint32_t n);
+LIBARDOUR_API void  arm_neon_conv_mac                     (float* d, float const* a, float const* b, uint32_t n);
+LIBARDOUR_API void  arm_neon_kmeter_bank                  (float* z1, float* z2, float const* const* bufs, uint32_t n_chan, uint32_t nframes, float omega);
+LIBARDOUR_API void  arm_neon_iecppm_bank                  (float* z1, float* z2, float* m, float const* const* bufs, uint32_t n_chan, uint32_t nframes, float w1, float w2, float w3);
+LIBARDOUR_API void  arm_neon_vumeter_bank                 (float* z1, float* z2, float* m, float const* const* bufs, uint32_t n_chan, uint32_t nframes, float w);
+#ifdef __aarch64__
+LIBARDOUR_API void arm_neon_float_to_int16             (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void arm_neon_float_to_int32             (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+#endif
 #endif
 
 /* non-optimized functions */
@@ -105,5 +154,17 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDO
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_apply_gain_vector_to_buffer  (ARDOUR::Sample* buf, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float default_apply_gain_ramp_to_buffer    (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float gain, float target, float coeff);
+LIBARDOUR_API void  default_mix_buffers_with_gain_vector (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_kmeter_bank                  (float* z1, float* z2, ARDOUR::Sample const* const* bufs, uint32_t n_chan, ARDOUR::pframes_t nframes, float omega);
+LIBARDOUR_API void  default_iecppm_bank                  (float* z1, float* z2, float* m, ARDOUR::Sample const* const* bufs, uint32_t n_chan, ARDOUR::pframes_t nframes, float w1, float w2, float w3);
+LIBARDOUR_API void  default_vumeter_bank                 (float* z1, float* z2, float* m, ARDOUR::Sample const* const* bufs, uint32_t n_chan, ARDOUR::pframes_t nframes, float w);
+
+/* sample format conversion for AudioGrapher::Routines, bit-identical to gdither */
+
+LIBARDOUR_API void  default_float_to_int16            (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void  default_float_to_int32            (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift);
+LIBARDOUR_API void  default_clip_floats               (float* buf, uint32_t nframes);
 
 #endif /* __ardour_mix_h__ */
@@ -0,0 +1,152 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _libardour_offline_port_engine_h_
+#define _libardour_offline_port_engine_h_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/port_engine.h"
+#include "ardour/port_manager.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** A PortEngine that forwards everything to the backend's port engine, except
+ * for port buffers.
+ *
+ * It is used to render a session faster than realtime, in a thread other
+ * than the backend's process thread (see AudioEngine::start_offline_render).
+ * Every port owned by %Ardour gets a private buffer, and input ports
+ * receive the data of the %Ardour-owned output ports that they are connected
+ * to, the way a backend mixes connected ports. Data from ports of other
+ * clients and hardware ports is silent, the backend's buffers are not used.
+ *
+ * The set of ports and their connections is taken when rendering starts.
+ * Ports that are added later are silent.
+ */
+class LIBARDOUR_API OfflinePortEngine : public PortEngine
+{
+public:
+	OfflinePortEngine (PortManager&, PortEngine&);
+	~OfflinePortEngine ();
+
+	/** Allocate buffers for the given ports, and look up their connections.
+	 * Must be called with the process lock held.
+	 */
+	void start (PortManager::Ports const&, pframes_t nframes);
+	void stop ();
+
+	/* forwarded to the backend */
+
+	void* private_handle () const { return _backend.private_handle (); }
+	const std::string& my_name () const { return _backend.my_name (); }
+	uint32_t port_name_size () const { return _backend.port_name_size (); }
+
+	int         set_port_name (PortHandle p, const std::string& n) { return _backend.set_port_name (p, n); }
+	std::string get_port_name (PortHandle p) const { return _backend.get_port_name (p); }
+	PortFlags   get_port_flags (PortHandle p) const { return _backend.get_port_flags (p); }
+	int         get_port_property (PortHandle p, const std::string& k, std::string& v, std::string& t) const { return _backend.get_port_property (p, k, v, t); }
+	int         set_port_property (PortHandle p, const std::string& k, const std::string& v, const std::string& t) { return _backend.set_port_property (p, k, v, t); }
+	PortPtr     get_port_by_name (const std::string& n) const { return _backend.get_port_by_name (n); }
+	int         get_ports (const std::string& pattern, DataType t, PortFlags f, std::vector<std::string>& p) const { return _backend.get_ports (pattern, t, f, p); }
+	DataType    port_data_type (PortHandle p) const { return _backend.port_data_type (p); }
+
+	PortPtr register_port (const std::string& n, DataType t, PortFlags f) { return _backend.register_port (n, t, f); }
+	void    unregister_port (PortHandle p) { _backend.unregister_port (p); }
+
+	int  connect (const std::string& src, const std::string& dst) { return _backend.connect (src, dst); }
+	int  disconnect (const std::string& src, const std::string& dst) { return _backend.disconnect (src, dst); }
+	int  connect (PortHandle src, const std::string& dst) { return _backend.connect (src, dst); }
+	int  disconnect (PortHandle src, const std::string& dst) { return _backend.disconnect (src, dst); }
+	int  disconnect_all (PortHandle p) { return _backend.disconnect_all (p); }
+	bool connected (PortHandle p, bool s = true) { return _backend.connected (p, s); }
+	bool connected_to (PortHandle p, const std::string& n, bool s = true) { return _backend.connected_to (p, n, s); }
+	bool physically_connected (PortHandle p, bool s = true) { return _backend.physically_connected (p, s); }
+	bool externally_connected (PortHandle p, bool s = true) { return _backend.externally_connected (p, s); }
+	int  get_connections (PortHandle p, std::vector<std::string>& n, bool s = true) { return _backend.get_connections (p, n, s); }
+
+	bool can_monitor_input () const { return _backend.can_monitor_input (); }
+	int  request_input_monitoring (PortHandle p, bool yn) { return _backend.request_input_monitoring (p, yn); }
+	int  ensure_input_monitoring (PortHandle p, bool yn) { return _backend.ensure_input_monitoring (p, yn); }
+	bool monitoring_input (PortHandle p) { return _backend.monitoring_input (p); }
+
+	void         set_latency_range (PortHandle p, bool for_playback, LatencyRange r) { _backend.set_latency_range (p, for_playback, r); }
+	LatencyRange get_latency_range (PortHandle p, bool for_playback) { return _backend.get_latency_range (p, for_playback); }
+
+	bool      port_is_physical (PortHandle p) const { return _backend.port_is_physical (p); }
+	void      get_physical_outputs (DataType t, std::vector<std::string>& n) { _backend.get_physical_outputs (t, n); }
+	void      get_physical_inputs (DataType t, std::vector<std::string>& n) { _backend.get_physical_inputs (t, n); }
+	ChanCount n_physical_outputs () const { return _backend.n_physical_outputs (); }
+	ChanCount n_physical_inputs () const { return _backend.n_physical_inputs (); }
+
+	samplepos_t sample_time_at_cycle_start () { return _backend.sample_time_at_cycle_start (); }
+
+	/* private buffers */
+
+	void* get_buffer (PortHandle, pframes_t);
+
+	int      midi_event_get (pframes_t& timestamp, size_t& size, uint8_t const** buf, void* port_buffer, uint32_t event_index);
+	int      midi_event_put (void* port_buffer, pframes_t timestamp, const uint8_t* buffer, size_t size);
+	uint32_t get_midi_event_count (void* port_buffer);
+	void     midi_clear (void* port_buffer);
+
+private:
+	struct MidiData {
+		struct Event {
+			Event (pframes_t t, size_t o, size_t s) : time (t), offset (o), size (s) {}
+			pframes_t time;
+			size_t    offset;
+			size_t    size;
+		};
+		std::vector<Event>   events;
+		std::vector<uint8_t> data;
+
+		void clear () {
+			events.clear ();
+			data.clear ();
+		}
+	};
+
+	struct Buffer {
+		Buffer () : type (DataType::NIL), input (false) {}
+
+		DataType             type;
+		bool                 input;
+		std::vector<Sample>  audio;
+		MidiData             midi;
+		std::vector<Buffer*> sources;
+	};
+
+	typedef std::map<ProtoPort const*, Buffer*> Buffers;
+
+	PortEngine&         _backend;
+	Buffers             _buffers;
+	pframes_t           _nframes;
+	std::vector<Sample> _silence;
+
+	void* mix_audio (Buffer&);
+	void* mix_midi (Buffer&);
+	void  drop_buffers ();
+};
+
+} // namespace ARDOUR
+
+#endif /* _libardour_offline_port_engine_h_ */
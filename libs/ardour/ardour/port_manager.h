@@ -278,6 +278,11 @@ public:
 protected:
 	std::shared_ptr<AudioBackend> _backend;
 
+	/** If set, used by port_engine() instead of the backend,
+	 * see AudioEngine::start_offline_render()
+	 */
+	std::atomic<PortEngine*> _offline_port_engine;
+
 	SerializedRCUManager<Ports> _ports;
 
 	bool                   _port_remove_in_progress;
@@ -291,6 +296,7 @@ protected:
 
 	void silence (pframes_t nframes, Session* s = 0);
 	void silence_outputs (pframes_t nframes);
+	void silence_backend_outputs (pframes_t nframes);
 	void check_monitoring ();
 	/** Signal the start of an audio cycle.
 	 * This MUST be called before any reading/writing for this cycle.
@@ -316,6 +322,9 @@ protected:
 
 private:
 	void run_input_meters (pframes_t, samplecnt_t);
+	Ports::const_iterator next_batch (Ports::const_iterator) const;
+	void cycle_start_ports (Ports::const_iterator, Ports::const_iterator, pframes_t);
+	void cycle_end_ports (Ports::const_iterator, Ports::const_iterator, pframes_t);
 	void set_pretty_names (std::vector<std::string> const&, DataType, bool);
 	void fill_midi_port_info_locked ();
 	void load_port_info ();
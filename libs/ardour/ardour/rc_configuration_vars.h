@@ -205,6 +205,9 @@ CONFIG_VARIABLE (bool, verify_remove_last_capture, "verify-remove-last-capture",
 CONFIG_VARIABLE (bool, save_history, "save-history", true)
 CONFIG_VARIABLE (int32_t, saved_history_depth, "save-history-depth", 20)
 CONFIG_VARIABLE (int32_t, history_depth, "history-depth", 20)
+CONFIG_VARIABLE (uint32_t, history_spill_depth, "history-spill-depth", 0) /* keep only this many undo transactions in memory, move older ones to disk (0: all in memory) */
+CONFIG_VARIABLE (bool, save_state_cache, "save-state-cache", true) /* also write a binary copy of the session file, which loads faster */
+CONFIG_VARIABLE (bool, save_pending_state_async, "save-pending-state-async", true) /* write periodic (pending) saves in a background thread */
 CONFIG_VARIABLE (RegionEquivalence, region_equivalence, "region-equivalency", LayerTime)
 CONFIG_VARIABLE (bool, periodic_safety_backups, "periodic-safety-backups", true)
 CONFIG_VARIABLE (uint32_t, periodic_safety_backup_interval, "periodic-safety-backup-interval", 120)
@@ -226,6 +229,7 @@ CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
 CONFIG_VARIABLE (double, automation_thinning_factor, "automation-thinning-factor", 20.0)
+CONFIG_VARIABLE (float, automation_prerender_seconds, "automation-prerender-seconds", 0) /* 0: evaluate automation curves in the process thread */
 CONFIG_VARIABLE (samplecnt_t, range_location_minimum, "range-location-minimum", 128) /* samples */
 CONFIG_VARIABLE (EditMode, edit_mode, "edit-mode", Slide)
 CONFIG_VARIABLE (RippleMode, ripple_mode, "ripple-mode", RippleSelected)
@@ -237,6 +241,7 @@ CONFIG_VARIABLE (bool, locate_to_pgm_change, "locate-to-pgm-change", true)
 /* plugin related */
 
 CONFIG_VARIABLE (bool, new_plugins_active, "new-plugins-active", true)
+CONFIG_VARIABLE (bool, defer_plugin_instantiation, "defer-plugin-instantiation", false) /* only instantiate plugins of inactive routes when they are activated */
 CONFIG_VARIABLE (bool, use_plugin_own_gui, "use-plugin-own-gui", true)
 CONFIG_VARIABLE (bool, use_windows_vst, "use-windows-vst", true)
 CONFIG_VARIABLE (bool, use_lxvst, "use-lxvst", true)
@@ -290,3 +295,6 @@ CONFIG_VARIABLE (bool, show_video_server_dialog, "show-video-server-dialog", fal
 CONFIG_VARIABLE (float, export_preroll, "export-preroll", 2.0) // seconds
 CONFIG_VARIABLE (float, export_silence_threshold, "export-silence-threshold", -90) // dB
 CONFIG_VARIABLE (float, ppqn_factor_for_export, "ppqn-factor-for-export", 1) // Temporal::ticks_per_beat
+CONFIG_VARIABLE (bool, offline_export_render, "offline-export-render", false)
+CONFIG_VARIABLE (uint32_t, export_concurrent_timespans, "export-concurrent-timespans", 1)
+CONFIG_VARIABLE (uint32_t, export_normalize_memory, "export-normalize-memory", 1024) /* MiB */
@@ -721,6 +721,8 @@ private:
 	std::vector<std::weak_ptr<Processor> > selfdestruct_sequence;
 	Glib::Threads::Mutex  selfdestruct_lock;
 
+	void instantiate_deferred_processors ();
+
 	bool input_port_count_changing (ChanCount);
 	bool output_port_count_changing (ChanCount);
 
@@ -791,6 +793,7 @@ private:
 	bool    _in_configure_processors;
 	bool    _initial_io_setup;
 	bool    _in_sidechain_setup;
+	bool    _defer_plugins;
 	gain_t  _monitor_gain;
 
 	void add_well_known_ctrl (WellKnownCtrl, std::shared_ptr<PluginInsert>, int param);
@@ -32,12 +32,36 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 
+	/* per-sample gain: apply (or mix with) a gain vector, and apply an
+	 * exponential gain ramp from gain to target: buf[i] *= g; g += coeff * (target - g);
+	 * returning the gain that follows the last sample.
+	 */
+	typedef void  (*apply_gain_vector_to_buffer_t)  (ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+	typedef float (*apply_gain_ramp_to_buffer_t)    (ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*mix_buffers_with_gain_vector_t) (ARDOUR::Sample *, const ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+
+	/* ballistic meters (K, IEC1/2 PPM, VU) of up to 4 channels at once, see ARDOUR::MeterBank.
+	 * z1, z2 and m hold the filter state of one channel each. The channel count (1..4) is
+	 * a hint, vectorized versions always process 4 lanes, and need state and buffers for each.
+	 */
+	typedef void  (*kmeter_bank_t)  (float*, float*, const ARDOUR::Sample* const*, uint32_t, pframes_t, float);
+	typedef void  (*iecppm_bank_t)  (float*, float*, float*, const ARDOUR::Sample* const*, uint32_t, pframes_t, float, float, float);
+	typedef void  (*vumeter_bank_t) (float*, float*, float*, const ARDOUR::Sample* const*, uint32_t, pframes_t, float);
+
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
 	LIBARDOUR_API extern find_peaks_t            find_peaks;
 	LIBARDOUR_API extern apply_gain_to_buffer_t  apply_gain_to_buffer;
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
+
+	LIBARDOUR_API extern apply_gain_vector_to_buffer_t  apply_gain_vector_to_buffer;
+	LIBARDOUR_API extern apply_gain_ramp_to_buffer_t    apply_gain_ramp_to_buffer;
+	LIBARDOUR_API extern mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
+
+	LIBARDOUR_API extern kmeter_bank_t  kmeter_bank;
+	LIBARDOUR_API extern iecppm_bank_t  iecppm_bank;
+	LIBARDOUR_API extern vumeter_bank_t vumeter_bank;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
@@ -114,6 +114,7 @@ namespace PBD {
 class Controllable;
 class Progress;
 class Command;
+class Thread;
 }
 
 namespace luabridge {
@@ -1643,6 +1644,21 @@ private:
 	Glib::Threads::Mutex save_source_lock;
 	Glib::Threads::Mutex peak_cleanup_lock;
 
+	/* pending state is written to disk by a background thread */
+	PBD::Thread*         _state_writer;
+	Glib::Threads::Mutex _state_write_lock;
+	Glib::Threads::Cond  _state_write_cond;
+	XMLTree*             _state_write_queued;
+	XMLTree*             _state_write_last;
+	bool                 _state_writing;
+	bool                 _state_writer_quit;
+
+	void queue_state_write (XMLTree*);
+	void cancel_state_writes ();
+	void stop_state_writer ();
+	void state_writer_thread ();
+	static bool write_state_file (XMLTree&, std::string const& path);
+
 	int        load_options (const XMLNode&);
 	int        load_state (std::string snapshot_name, bool from_template = false);
 	static int parse_stateful_loading_version (const std::string&);
@@ -2053,6 +2069,9 @@ private:
 	XMLNode& get_sources_as_xml ();
 
 	std::shared_ptr<Source> XMLSourceFactory (const XMLNode&);
+	void open_source (XMLNodeList const&, std::vector<std::shared_ptr<Source> >&, size_t);
+
+	void run_load_tasks (std::string const& stage, size_t n_tasks, boost::function<void (size_t)> const& task);
 
 	/* PLAYLISTS */
 
@@ -2260,6 +2279,8 @@ private:
 	XMLNode& get_control_protocol_state () const;
 
 	void set_history_depth (uint32_t depth);
+	void setup_history_spill ();
+	PBD::UndoTransaction* transaction_from_state (XMLNode const&);
 
 	static bool _disable_all_loaded_plugins;
 	static bool _bypass_all_loaded_plugins;
@@ -83,6 +83,9 @@ public:
 	void close ();
 	void flush_midi (const WriterLock& lock);
 
+	/* the file may have been renamed since it was opened */
+	std::string deferred_path () const { return _path; }
+
   private:
 	bool _open;
 	Temporal::Beats   _last_ev_time_beats;
@@ -43,7 +43,7 @@ public:
 
 	static PBD::Signal1<void, std::shared_ptr<Source>> SourceCreated;
 
-	static std::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false);
+	static std::shared_ptr<Source> create (Session&, const XMLNode& node, bool async = false, bool announce = true);
 	static std::shared_ptr<Source> createSilent (Session&, const XMLNode& node, samplecnt_t, float sample_rate);
 	static std::shared_ptr<Source> createExternal (DataType, Session&, const std::string& path, int chn, Source::Flag, bool announce = true, bool async = false);
 	static std::shared_ptr<Source> createWritable (DataType, Session&, const std::string& path, samplecnt_t rate, bool announce = true, bool async = false);
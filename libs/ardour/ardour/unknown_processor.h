@@ -45,7 +45,7 @@ namespace ARDOUR {
 class LIBARDOUR_API UnknownProcessor : public Processor
 {
 public:
-	UnknownProcessor (Session&, XMLNode const&, SessionObject*);
+	UnknownProcessor (Session&, XMLNode const&, SessionObject*, bool with_sidechain = true);
 	virtual ~UnknownProcessor ();
 
 	bool can_support_io_configuration (const ChanCount &, ChanCount &);
@@ -54,9 +54,9 @@ public:
 protected:
 	XMLNode& state () const;
 
-private:
 	XMLNode _state;
 
+private:
 	bool       have_ioconfig;
 	ChanCount* saved_input;
 	ChanCount* saved_output;
@@ -65,6 +65,22 @@ private:
 	std::shared_ptr<SideChain> _sidechain;
 };
 
+/** A stub for a plugin of an inactive Route, which only keeps the plugin's
+ *  state. Unlike an UnknownProcessor it does not indicate a missing plugin:
+ *  the Route replaces it with a PluginInsert when it is activated.
+ */
+class LIBARDOUR_API DeferredProcessor : public UnknownProcessor
+{
+public:
+	DeferredProcessor (Session&, XMLNode const&, SessionObject*);
+
+	XMLNode const& saved_state () const { return _state; }
+	int saved_version () const { return _version; }
+
+private:
+	int _version;
+};
+
 }
 
 #endif
@@ -515,4 +515,302 @@ arm_neon_copy_vector(
 	}
 }
 
+void
+arm_neon_clip_floats(float *buf, uint32_t nframes)
+{
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t mone = vdupq_n_f32(-1.0f);
+
+	while (nframes >= 4) {
+		// select instead of min/max, which would not keep NaN as is
+		float32x4_t x = vld1q_f32(buf);
+		x = vbslq_f32(vcgtq_f32(x, one), one, x);
+		x = vbslq_f32(vcltq_f32(x, mone), mone, x);
+		vst1q_f32(buf, x);
+		buf += 4;
+		nframes -= 4;
+	}
+
+	default_clip_floats(buf, nframes);
+}
+
+void
+arm_neon_apply_gain_vector_to_buffer(float *buf, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		vst1q_f32(buf, vmulq_f32(vld1q_f32(buf), vld1q_f32(gain)));
+		buf += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	default_apply_gain_vector_to_buffer(buf, gain, nframes);
+}
+
+/* The one-pole ramp g += coeff * (target - g) is evaluated in closed form,
+ * g[i] = target + (g[0] - target) * (1 - coeff)^i, 4 samples at a time.
+ */
+float
+arm_neon_apply_gain_ramp_to_buffer(float *buf, uint32_t nframes, float gain, float target, float coeff)
+{
+	if (nframes >= 4) {
+		const float r = 1.f - coeff;
+		const float d[4] = { gain - target, (gain - target) * r, (gain - target) * r * r, (gain - target) * r * r * r };
+
+		const float32x4_t vtarget = vdupq_n_f32(target);
+		const float32x4_t step = vdupq_n_f32(r * r * r * r);
+		float32x4_t delta = vld1q_f32(d);
+
+		while (nframes >= 4) {
+			vst1q_f32(buf, vmulq_f32(vld1q_f32(buf), vaddq_f32(vtarget, delta)));
+			delta = vmulq_f32(delta, step);
+			buf += 4;
+			nframes -= 4;
+		}
+
+		gain = target + vgetq_lane_f32(delta, 0);
+	}
+
+	return default_apply_gain_ramp_to_buffer(buf, nframes, gain, target, coeff);
+}
+
+void
+arm_neon_mix_buffers_with_gain_vector(float *dst, const float *src, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), vld1q_f32(src), vld1q_f32(gain)));
+		dst += 4;
+		src += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	default_mix_buffers_with_gain_vector(dst, src, gain, nframes);
+}
+
+/* VMResampler filter coefficients, see ArdourZita::VMResampler::interpolate_t */
+void
+arm_neon_vmr_interpolate(float *c, const float *cq1, const float *cq2, float aa, float bb, uint32_t hl)
+{
+	uint32_t i = 0;
+	for (; i + 4 <= hl; i += 4) {
+		float32x4_t x = vmulq_n_f32(vld1q_f32(cq1 + i), aa);
+		x = vmlaq_n_f32(x, vld1q_f32(cq1 + i + hl), bb);
+		vst1q_f32(c + i, x);
+	}
+	for (; i < hl; ++i) {
+		c[i] = aa * cq1[i] + bb * cq1[i + hl];
+	}
+
+	// the second half is reversed
+	const float *q = cq2 + hl;
+	for (i = 0; i + 4 <= hl; i += 4) {
+		float32x4_t x = vmulq_n_f32(vld1q_f32(q - 4), aa);
+		x = vmlaq_n_f32(x, vld1q_f32(q - hl - 4), bb);
+		x = vrev64q_f32(x);
+		vst1q_f32(c + hl + i, vcombine_f32(vget_high_f32(x), vget_low_f32(x)));
+		q -= 4;
+	}
+	for (; i < hl; ++i) {
+		--q;
+		c[hl + i] = aa * q[0] + bb * q[-(int)hl];
+	}
+}
+
+float
+arm_neon_vmr_dot_product(const float *c, const float *p, uint32_t n)
+{
+	float32x4_t a0 = vdupq_n_f32(0.f);
+	float32x4_t a1 = vdupq_n_f32(0.f);
+
+	while (n >= 8) {
+		a0 = vmlaq_f32(a0, vld1q_f32(c), vld1q_f32(p));
+		a1 = vmlaq_f32(a1, vld1q_f32(c + 4), vld1q_f32(p + 4));
+		c += 8;
+		p += 8;
+		n -= 8;
+	}
+
+	a0 = vaddq_f32(a0, a1);
+	float32x2_t x = vadd_f32(vget_low_f32(a0), vget_high_f32(a0));
+	float a = vget_lane_f32(vpadd_f32(x, x), 0);
+
+	while (n--) {
+		a += *c++ * *p++;
+	}
+	return a;
+}
+
+/* Convolver spectrum multiply-accumulate, see ArdourZita::Convproc::mac_t.
+ * Blocks of 4 real parts followed by 4 imaginary parts.
+ */
+void
+arm_neon_conv_mac(float *d, const float *a, const float *b, uint32_t n)
+{
+	for (; n > 0; n -= 4) {
+		const float32x4_t ar = vld1q_f32(a);
+		const float32x4_t ai = vld1q_f32(a + 4);
+		const float32x4_t br = vld1q_f32(b);
+		const float32x4_t bi = vld1q_f32(b + 4);
+		float32x4_t re = vmlaq_f32(vld1q_f32(d), ar, br);
+		float32x4_t im = vmlaq_f32(vld1q_f32(d + 4), ar, bi);
+		re = vmlsq_f32(re, ai, bi);
+		im = vmlaq_f32(im, ai, br);
+		vst1q_f32(d, re);
+		vst1q_f32(d + 4, im);
+		a += 8;
+		b += 8;
+		d += 8;
+	}
+}
+
+/* Ballistic meters of 4 channels, see default_kmeter_bank ().
+ * Each vector holds the state of all channels, a 4x4 transpose
+ * turns 4 samples of 4 channels into 4 consecutive samples.
+ * All 4 lanes are always processed, n_chan is ignored.
+ *
+ * vmaxq_f32 returns NaN if either input is NaN, the running maximum
+ * is updated with compare-and-select instead, to keep it when the
+ * filter state is NaN, as the scalar "if (b > mx) mx = b" does.
+ */
+static inline void
+neon_load_4x4(const float *const *bufs, uint32_t i, float32x4_t *s)
+{
+	const float32x4x2_t t01 = vtrnq_f32(vld1q_f32(bufs[0] + i), vld1q_f32(bufs[1] + i));
+	const float32x4x2_t t23 = vtrnq_f32(vld1q_f32(bufs[2] + i), vld1q_f32(bufs[3] + i));
+	s[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+	s[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+	s[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	s[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+void
+arm_neon_kmeter_bank(float *z1, float *z2, const float *const *bufs, uint32_t, uint32_t nframes, float omega)
+{
+	float32x4_t a = vld1q_f32(z1);
+	float32x4_t b = vld1q_f32(z2);
+	float32x4_t s[4];
+
+	for (uint32_t i = 0; i + 4 <= nframes; i += 4) {
+		neon_load_4x4(bufs, i, s);
+		for (int k = 0; k < 4; ++k) {
+			a = vaddq_f32(a, vmulq_n_f32(vsubq_f32(vmulq_f32(s[k], s[k]), a), omega));
+		}
+		b = vaddq_f32(b, vmulq_n_f32(vsubq_f32(a, b), 4 * omega));
+	}
+
+	vst1q_f32(z1, a);
+	vst1q_f32(z2, b);
+}
+
+void
+arm_neon_iecppm_bank(float *z1, float *z2, float *m, const float *const *bufs, uint32_t, uint32_t nframes, float w1, float w2, float w3)
+{
+	float32x4_t a = vld1q_f32(z1);
+	float32x4_t b = vld1q_f32(z2);
+	float32x4_t mx = vld1q_f32(m);
+	float32x4_t s[4];
+
+	for (uint32_t i = 0; i + 4 <= nframes; i += 4) {
+		neon_load_4x4(bufs, i, s);
+		a = vmulq_n_f32(a, w3);
+		b = vmulq_n_f32(b, w3);
+		for (int k = 0; k < 4; ++k) {
+			// rise only
+			const float32x4_t t = vabsq_f32(s[k]);
+			a = vbslq_f32(vcgtq_f32(t, a), vaddq_f32(a, vmulq_n_f32(vsubq_f32(t, a), w1)), a);
+			b = vbslq_f32(vcgtq_f32(t, b), vaddq_f32(b, vmulq_n_f32(vsubq_f32(t, b), w2)), b);
+		}
+		const float32x4_t ab = vaddq_f32(a, b);
+		mx = vbslq_f32(vcgtq_f32(ab, mx), ab, mx);
+	}
+
+	vst1q_f32(z1, a);
+	vst1q_f32(z2, b);
+	vst1q_f32(m, mx);
+}
+
+void
+arm_neon_vumeter_bank(float *z1, float *z2, float *m, const float *const *bufs, uint32_t, uint32_t nframes, float w)
+{
+	float32x4_t a = vld1q_f32(z1);
+	float32x4_t b = vld1q_f32(z2);
+	float32x4_t mx = vld1q_f32(m);
+	float32x4_t s[4];
+
+	for (uint32_t i = 0; i + 4 <= nframes; i += 4) {
+		neon_load_4x4(bufs, i, s);
+		const float32x4_t t = vmulq_n_f32(b, .5f);
+		for (int k = 0; k < 4; ++k) {
+			const float32x4_t x = vsubq_f32(vabsq_f32(s[k]), t);
+			a = vaddq_f32(a, vmulq_n_f32(vsubq_f32(x, a), w));
+		}
+		b = vaddq_f32(b, vmulq_n_f32(vsubq_f32(a, b), 4 * w));
+		mx = vbslq_f32(vcgtq_f32(b, mx), b, mx);
+	}
+
+	vst1q_f32(z1, a);
+	vst1q_f32(z2, b);
+	vst1q_f32(m, mx);
+}
+
+#ifdef __aarch64__
+
+/* Scale, dither and round 4 samples, clamp the result and shift it into place.
+ * vcvtnq rounds to nearest-even and saturates, and NaN becomes 0, the
+ * same as lrintf () on aarch64.
+ */
+static inline int32x4_t
+neon_quantize(const float *src, const float *noise, float32x4_t scale, int32x4_t clamp_l, int32x4_t clamp_u, int32x4_t post_shift)
+{
+	float32x4_t x = vmulq_f32(vld1q_f32(src), scale);
+	if (noise) {
+		x = vsubq_f32(x, vld1q_f32(noise));
+	}
+	int32x4_t i = vcvtnq_s32_f32(x);
+	i = vminq_s32(vmaxq_s32(i, clamp_l), clamp_u);
+	return vshlq_s32(i, post_shift);
+}
+
+void
+arm_neon_float_to_int16(int16_t *dst, const float *src, const float *noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	const float32x4_t vscale = vdupq_n_f32(scale);
+	const int32x4_t vlo = vdupq_n_s32(clamp_l);
+	const int32x4_t vhi = vdupq_n_s32(clamp_u);
+	const int32x4_t vshift = vdupq_n_s32(post_shift);
+
+	while (nframes >= 4) {
+		// vmovn truncates, like a cast
+		vst1_s16(dst, vmovn_s32(neon_quantize(src, noise, vscale, vlo, vhi, vshift)));
+		src += 4;
+		dst += 4;
+		noise = noise ? noise + 4 : 0;
+		nframes -= 4;
+	}
+
+	default_float_to_int16(dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+void
+arm_neon_float_to_int32(int32_t *dst, const float *src, const float *noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	const float32x4_t vscale = vdupq_n_f32(scale);
+	const int32x4_t vlo = vdupq_n_s32(clamp_l);
+	const int32x4_t vhi = vdupq_n_s32(clamp_u);
+	const int32x4_t vshift = vdupq_n_s32(post_shift);
+
+	while (nframes >= 4) {
+		vst1q_s32(dst, neon_quantize(src, noise, vscale, vlo, vhi, vshift));
+		src += 4;
+		dst += 4;
+		noise = noise ? noise + 4 : 0;
+		nframes -= 4;
+	}
+
+	default_float_to_int32(dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+#endif
+
 #endif
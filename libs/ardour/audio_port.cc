@@ -59,67 +59,117 @@ AudioPort::set_buffer_size (pframes_t nframes)
 	cache_aligned_malloc ((void**) &_data, sizeof (Sample) * lrint (floor (nframes * Config->get_max_transport_speed())));
 }
 
-void
-AudioPort::cycle_start (pframes_t nframes)
+/** Process resamplers, and pad the output in case the resampler
+ * did not produce enough samples (end of input).
+ */
+static void
+process_src (ArdourZita::VMResampler* const* src, uint32_t n)
 {
-	/* caller must hold process lock */
-	Port::cycle_start (nframes);
-
-	if (sends_output()) {
-		_buffer->prepare ();
-	} else if (!externally_connected ()) {
-		/* ardour internal port, just silence input, don't resample */
-		_src.reset ();
-		memset (_data, 0, _cycle_nframes * sizeof (float));
-	} else {
-		_src.inp_data  = (float*)port_engine.get_buffer (_port_handle, nframes);
-		_src.inp_count = nframes;
-		_src.out_count = _cycle_nframes;
-		_src.set_rratio (_cycle_nframes / (double)nframes);
-		_src.out_data  = _data;
-		_src.process ();
-		while (_src.out_count > 0) {
-			*_src.out_data =  _src.out_data[-1];
-			++_src.out_data;
-			--_src.out_count;
+	ArdourZita::VMResampler::process (src, n);
+
+	for (uint32_t i = 0; i < n; ++i) {
+		ArdourZita::VMResampler& s (*src[i]);
+		while (s.out_count > 0) {
+			*s.out_data =  s.out_data[-1];
+			++s.out_data;
+			--s.out_count;
 		}
 	}
 }
 
+void
+AudioPort::cycle_start (pframes_t nframes)
+{
+	AudioPort* p = this;
+	cycle_start_batch (&p, 1, nframes);
+}
+
 void
 AudioPort::cycle_end (pframes_t nframes)
 {
-	Port::cycle_end (nframes);
-	if (sends_output() && !_buffer->written() && _port_handle) {
-		if (!_buffer->data (0)) {
-			get_audio_buffer (nframes);
+	AudioPort* p = this;
+	cycle_end_batch (&p, 1, nframes);
+}
+
+void
+AudioPort::cycle_start_batch (AudioPort* const* ports, uint32_t n_ports, pframes_t nframes)
+{
+	/* caller must hold process lock */
+	ArdourZita::VMResampler* src[ArdourZita::VMResampler::MAXSYNC];
+	uint32_t                 n_src = 0;
+
+	for (uint32_t i = 0; i < n_ports; ++i) {
+		AudioPort* p = ports[i];
+		p->Port::cycle_start (nframes);
+
+		if (p->sends_output()) {
+			p->_buffer->prepare ();
+		} else if (!p->externally_connected ()) {
+			/* ardour internal port, just silence input, don't resample */
+			p->_src.reset ();
+			memset (p->_data, 0, _cycle_nframes * sizeof (float));
+		} else {
+			p->_src.inp_data  = (float*)port_engine.get_buffer (p->_port_handle, nframes);
+			p->_src.inp_count = nframes;
+			p->_src.out_count = _cycle_nframes;
+			p->_src.set_rratio (_cycle_nframes / (double)nframes);
+			p->_src.out_data  = p->_data;
+			src[n_src++] = &p->_src;
 		}
-		if (_buffer->capacity() >= nframes) {
-			_buffer->silence (nframes);
+
+		if (n_src == ArdourZita::VMResampler::MAXSYNC) {
+			process_src (src, n_src);
+			n_src = 0;
 		}
 	}
 
-	if (sends_output() && _port_handle) {
+	process_src (src, n_src);
+}
+
+void
+AudioPort::cycle_end_batch (AudioPort* const* ports, uint32_t n_ports, pframes_t nframes)
+{
+	ArdourZita::VMResampler* src[ArdourZita::VMResampler::MAXSYNC];
+	uint32_t                 n_src = 0;
+
+	for (uint32_t i = 0; i < n_ports; ++i) {
+		AudioPort* p = ports[i];
+		p->Port::cycle_end (nframes);
 
-		if (!externally_connected ()) {
+		if (!p->sends_output() || !p->_port_handle) {
+			continue;
+		}
+
+		if (!p->_buffer->written()) {
+			if (!p->_buffer->data (0)) {
+				p->get_audio_buffer (nframes);
+			}
+			if (p->_buffer->capacity() >= nframes) {
+				p->_buffer->silence (nframes);
+			}
+		}
+
+		if (!p->externally_connected ()) {
 			/* ardour internal port, data goes nowhere, skip resampling */
 			// TODO reset resampler only once
-			_src.reset ();
-			return;
+			p->_src.reset ();
+			continue;
 		}
 
-		_src.inp_count = _cycle_nframes;
-		_src.out_count = nframes;
-		_src.set_rratio (nframes / (double)_cycle_nframes);
-		_src.inp_data  = _data;
-		_src.out_data  = (float*)port_engine.get_buffer (_port_handle, nframes);
-		_src.process ();
-		while (_src.out_count > 0) {
-			*_src.out_data =  _src.out_data[-1];
-			++_src.out_data;
-			--_src.out_count;
+		p->_src.inp_count = _cycle_nframes;
+		p->_src.out_count = nframes;
+		p->_src.set_rratio (nframes / (double)_cycle_nframes);
+		p->_src.inp_data  = p->_data;
+		p->_src.out_data  = (float*)port_engine.get_buffer (p->_port_handle, nframes);
+		src[n_src++] = &p->_src;
+
+		if (n_src == ArdourZita::VMResampler::MAXSYNC) {
+			process_src (src, n_src);
+			n_src = 0;
 		}
 	}
+
+	process_src (src, n_src);
 }
 
 void
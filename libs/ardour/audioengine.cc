@@ -39,6 +39,7 @@
 #include "pbd/epa.h"
 #include "pbd/file_utils.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/rcu.h"
 #include "pbd/unknown_type.h"
 
 #include "temporal/superclock.h"
@@ -61,6 +62,7 @@
 #include "ardour/midiport_manager.h"
 #include "ardour/mididm.h"
 #include "ardour/mtdm.h"
+#include "ardour/offline_port_engine.h"
 #include "ardour/port.h"
 #include "ardour/process_thread.h"
 #include "ardour/rc_configuration.h"
@@ -77,6 +79,9 @@ AudioEngine* AudioEngine::_instance = 0;
 
 static std::atomic<int> audioengine_thread_cnt (1);
 
+/** true in the thread created by AudioEngine::start_offline_render */
+static thread_local bool in_offline_render_thread = false;
+
 #ifdef SILENCE_AFTER
 #define SILENCE_AFTER_SECONDS 600
 #endif
@@ -100,6 +105,10 @@ AudioEngine::AudioEngine ()
 	, _started_for_latency (false)
 	, _in_destructor (false)
 	, _last_backend_error_string(AudioBackend::get_error_string(AudioBackend::NoError))
+	, _offline_rendering (false)
+	, _stop_offline_render (false)
+	, _offline_render_thread (0)
+	, _offline_engine (0)
 	, _hw_reset_event_thread(0)
 	, _hw_devicelist_update_thread(0)
 	, _start_cnt (0)
@@ -124,12 +133,14 @@ AudioEngine::AudioEngine ()
 AudioEngine::~AudioEngine ()
 {
 	_in_destructor = true;
+	stop_offline_render ();
 	stop_hw_event_processing();
 	drop_backend ();
 	for (BackendMap::const_iterator i = _backends.begin(); i != _backends.end(); ++i) {
 		i->second->deinstantiate();
 	}
 	delete _main_thread;
+	delete _offline_engine;
 }
 
 AudioEngine*
@@ -235,7 +246,22 @@ int
 AudioEngine::process_callback (pframes_t nframes)
 {
 	TimerRAII tr (dsp_stats[ProcessCallback]);
+	/* the route and port lists may be reclaimed between cycles, see RCUEpoch */
+	RCUEpoch::Online rcu_online;
+
+	if (_offline_rendering.load (std::memory_order_relaxed) && !in_offline_render_thread) {
+		/* the session is processed by the offline render thread */
+		PortManager::silence_backend_outputs (nframes);
+		return 0;
+	}
+
 	Glib::Threads::Mutex::Lock tm (_process_lock, Glib::Threads::TRY_LOCK);
+
+	if (!tm.locked () && in_offline_render_thread) {
+		/* not realtime, we can wait */
+		tm.acquire ();
+	}
+
 	Port::set_varispeed_ratio (1.0);
 
 	PT_TIMING_REF;
@@ -484,7 +510,7 @@ AudioEngine::process_callback (pframes_t nframes)
 
 	if (_session == 0) {
 
-		if (!_freewheeling && !session_deleted) {
+		if (!_freewheeling.load () && !session_deleted) {
 			PortManager::silence_outputs (nframes);
 		}
 
@@ -493,7 +519,7 @@ AudioEngine::process_callback (pframes_t nframes)
 		return 0;
 	}
 
-	if (!_freewheeling || Freewheel.empty()) {
+	if (!_freewheeling.load () || Freewheel.empty()) {
 		/* catch_speed is the speed that we estimate we need to run at
 		   to catch (or remain locked to) a transport master.
 		*/
@@ -538,7 +564,7 @@ AudioEngine::process_callback (pframes_t nframes)
 	 * exporting (which is what Freewheel.empty() tests for).
 	 */
 
-	if (_freewheeling && !Freewheel.empty()) {
+	if (_freewheeling.load () && !Freewheel.empty()) {
 		Freewheel (nframes);
 	} else {
 		samplepos_t start_sample = _session->transport_sample ();
@@ -572,7 +598,7 @@ AudioEngine::process_callback (pframes_t nframes)
 		_session->send_mclk_for_cycle (start_sample, end_sample, nframes, pre_roll);
 	}
 
-	if (_freewheeling) {
+	if (_freewheeling.load ()) {
 		PortManager::cycle_end (nframes, _session);
 		return 0;
 	}
@@ -818,6 +844,8 @@ AudioEngine::set_session (Session *s)
 void
 AudioEngine::remove_session ()
 {
+	stop_offline_render ();
+
 	Glib::Threads::Mutex::Lock lm (_process_lock);
 
 	if (_running) {
@@ -989,6 +1017,10 @@ AudioEngine::current_backend_name() const
 void
 AudioEngine::drop_backend ()
 {
+	stop_offline_render ();
+	delete _offline_engine;
+	_offline_engine = 0;
+
 	if (_backend) {
 		/* see also ::stop() */
 		_backend->stop ();
@@ -1104,6 +1136,8 @@ AudioEngine::stop (bool for_latency)
 		return 0;
 	}
 
+	stop_offline_render ();
+
 	Glib::Threads::Mutex::Lock pl (_process_lock, Glib::Threads::NOT_LOCK);
 
 	if (running()) {
@@ -1172,11 +1206,103 @@ AudioEngine::freewheel (bool start_stop)
 		return -1;
 	}
 
+	if (!start_stop && _offline_rendering.load ()) {
+		/* this may be called from the render thread itself,
+		 * freewheeling() remains true until it has finished.
+		 */
+		_stop_offline_render.store (true);
+		return 0;
+	}
+
 	/* _freewheeling will be set when first Freewheel signal occurs */
 
 	return _backend->freewheel (start_stop);
 }
 
+int
+AudioEngine::start_offline_render ()
+{
+	if (!_backend || !_running || _freewheeling.load ()) {
+		return -1;
+	}
+
+	/* join a previous render thread, that may still be finishing */
+	stop_offline_render ();
+
+	if (!_offline_engine) {
+		_offline_engine = new OfflinePortEngine (*this, *_backend);
+	}
+
+	_stop_offline_render.store (false);
+	_offline_rendering.store (true);
+
+	_offline_render_thread = PBD::Thread::create (boost::bind (&AudioEngine::offline_render_thread, this), X_("OfflineRender"));
+
+	if (!_offline_render_thread) {
+		_offline_rendering.store (false);
+		return -1;
+	}
+	return 0;
+}
+
+void
+AudioEngine::stop_offline_render ()
+{
+	if (!_offline_render_thread) {
+		return;
+	}
+	assert (!_offline_render_thread->caller_is_self ());
+
+	_stop_offline_render.store (true);
+	_offline_render_thread->join ();
+
+	delete _offline_render_thread;
+	_offline_render_thread = 0;
+}
+
+void
+AudioEngine::offline_render_thread ()
+{
+	const string thread_name (X_("OfflineRender"));
+
+	SessionEvent::create_per_thread_pool (thread_name, 512);
+	PBD::notify_event_loops_about_thread_creation (pthread_self(), thread_name, 4096);
+	Temporal::TempoMap::fetch ();
+	RCUEpoch::register_thread ();
+
+	in_offline_render_thread = true;
+
+	const pframes_t nframes = samples_per_cycle ();
+
+	{
+		Glib::Threads::Mutex::Lock pl (_process_lock);
+		_offline_engine->start (*_ports.reader (), nframes);
+		_offline_port_engine.store (_offline_engine, std::memory_order_release);
+		_freewheeling.store (true);
+	}
+
+	while (!_stop_offline_render.load ()) {
+		process_callback (nframes);
+	}
+
+	{
+		/* the backend's callback does not process while we hold the lock */
+		Glib::Threads::Mutex::Lock pl (_process_lock);
+		_offline_port_engine.store (0, std::memory_order_release);
+		_offline_engine->stop ();
+
+		/* resume using the backend's buffers; ports must not be
+		 * re-initialized concurrently with processing.
+		 */
+		PortManager::reinit ();
+
+		_freewheeling.store (false);
+		_offline_rendering.store (false);
+	}
+
+	in_offline_render_thread = false;
+}
+
 float
 AudioEngine::get_dsp_load() const
 {
@@ -1359,6 +1485,9 @@ AudioEngine::join_process_threads ()
 bool
 AudioEngine::in_process_thread ()
 {
+	if (in_offline_render_thread) {
+		return true;
+	}
 	if (!_backend) {
 		return false;
 	}
@@ -1472,6 +1601,7 @@ AudioEngine::thread_init_callback (void* arg)
 	AsyncMIDIPort::set_process_thread (pthread_self());
 
 	Temporal::TempoMap::fetch ();
+	RCUEpoch::register_thread ();
 
 	if (arg) {
 		delete AudioEngine::instance()->_main_thread;
@@ -1494,8 +1624,8 @@ void
 AudioEngine::freewheel_callback (bool onoff)
 {
 	DEBUG_TRACE (DEBUG::BackendCallbacks, string_compose (X_("freewheel callback onoff %1\n"), onoff));
-	_freewheeling = onoff;
-	if (!_freewheeling) {
+	_freewheeling.store (onoff);
+	if (!onoff) {
 		PortManager::reinit ();
 	}
 }
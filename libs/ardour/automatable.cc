@@ -451,7 +451,7 @@ Automatable::non_realtime_locate (samplepos_t now)
 				}
 			}
 
-			l->start_write_pass (timepos_t (now));
+			l->start_write_pass (timepos_t (now), Config->get_automation_thinning_factor ());
 
 			if (rolling && am_touching) {
 				c->start_touch (timepos_t (now));
@@ -31,9 +31,11 @@
 #include "temporal/types_convert.h"
 
 #include "ardour/automation_list.h"
+#include "ardour/automation_prerender.h"
 #include "ardour/event_type_map.h"
 #include "ardour/parameter_descriptor.h"
 #include "ardour/parameter_types.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/evoral_types_convert.h"
 #include "ardour/types_convert.h"
 
@@ -64,6 +66,7 @@ static void dumpit (const AutomationList& al, string prefix = "")
 AutomationList::AutomationList (const Evoral::Parameter& id, const Evoral::ParameterDescriptor& desc, Temporal::TimeDomainProvider const & tdp)
 	: ControlList(id, desc, tdp)
 	, _before (0)
+	, _prerender (0)
 {
 	_state = Off;
 	_touching.store (0);
@@ -78,6 +81,7 @@ AutomationList::AutomationList (const Evoral::Parameter& id, const Evoral::Param
 AutomationList::AutomationList (const Evoral::Parameter& id, Temporal::TimeDomainProvider const & tdp)
 	: ControlList(id, ARDOUR::ParameterDescriptor(id), tdp)
 	, _before (0)
+	, _prerender (0)
 {
 	_state = Off;
 	_touching.store (0);
@@ -93,6 +97,7 @@ AutomationList::AutomationList (const AutomationList& other)
 	: ControlList(other)
 	, StatefulDestructible()
 	, _before (0)
+	, _prerender (0)
 {
 	_state = other._state;
 	_touching.store (other.touching());
@@ -106,6 +111,7 @@ AutomationList::AutomationList (const AutomationList& other)
 AutomationList::AutomationList (const AutomationList& other, timepos_t const & start, timepos_t const & end)
 	: ControlList(other, start, end)
 	, _before (0)
+	, _prerender (0)
 {
 	_state = other._state;
 	_touching.store (other.touching());
@@ -122,6 +128,7 @@ AutomationList::AutomationList (const AutomationList& other, timepos_t const & s
 AutomationList::AutomationList (const XMLNode& node, Evoral::Parameter id)
 	: ControlList(id, ARDOUR::ParameterDescriptor(id), Temporal::TimeDomainProvider (Temporal::AudioTime)) /* domain may change in ::set_state */
 	, _before (0)
+	, _prerender (0)
 {
 	_touching.store (0);
 	_interpolation = default_interpolation ();
@@ -134,6 +141,7 @@ AutomationList::AutomationList (const XMLNode& node, Evoral::Parameter id)
 	}
 
 	create_curve_if_necessary();
+	maybe_create_prerender ();
 
 	assert(_parameter.type() != NullAutomation);
 	AutomationListCreated(this);
@@ -142,6 +150,7 @@ AutomationList::AutomationList (const XMLNode& node, Evoral::Parameter id)
 AutomationList::~AutomationList()
 {
 	delete _before;
+	delete _prerender.load ();
 }
 
 std::shared_ptr<Evoral::ControlList>
@@ -197,6 +206,12 @@ AutomationList::operator= (const AutomationList& other)
 void
 AutomationList::maybe_signal_changed ()
 {
+	AutomationPrerender* p = _prerender.load ();
+
+	if (p) {
+		p->invalidate ();
+	}
+
 	ControlList::maybe_signal_changed ();
 
 	if (!ControlList::frozen()) {
@@ -226,9 +241,45 @@ AutomationList::set_automation_state (AutoState s)
 		}
 	}
 
+	maybe_create_prerender ();
+
 	automation_state_changed (s); /* EMIT SIGNAL */
 }
 
+void
+AutomationList::maybe_create_prerender ()
+{
+	/* Only lists with a curve are read as sample-rate vectors, and the
+	 * buffer is not needed until the list is played back. Once created,
+	 * it is kept until the list is destroyed since the process thread
+	 * may be reading from it at any time.
+	 */
+
+	if (_prerender.load () || !_curve || _state == Off) {
+		return;
+	}
+
+	const float secs = Config->get_automation_prerender_seconds ();
+
+	if (secs <= 0) {
+		return;
+	}
+
+	_prerender.store (new AutomationPrerender (*this, ceil (secs * TEMPORAL_SAMPLE_RATE)));
+}
+
+bool
+AutomationList::rt_safe_get_vector (samplepos_t start, samplepos_t end, float* vec, samplecnt_t veclen) const
+{
+	AutomationPrerender* p = _prerender.load ();
+
+	if (p && end - start == veclen && p->read (start, vec, veclen)) {
+		return true;
+	}
+
+	return curve().rt_safe_get_vector (timepos_t (start), timepos_t (end), vec, veclen);
+}
+
 Evoral::ControlList::InterpolationStyle
 AutomationList::default_interpolation () const
 {
@@ -252,10 +303,10 @@ AutomationList::default_interpolation () const
 }
 
 void
-AutomationList::start_write_pass (timepos_t const & when)
+AutomationList::start_write_pass (timepos_t const & when, double thinning_factor)
 {
 	snapshot_history (true);
-	ControlList::start_write_pass (when);
+	ControlList::start_write_pass (when, thinning_factor);
 }
 
 void
@@ -527,6 +578,8 @@ AutomationList::set_state (const XMLNode& node, int version)
 		_state = Off;
 	}
 
+	maybe_create_prerender ();
+
 	bool have_events = false;
 
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
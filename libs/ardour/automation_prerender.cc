@@ -0,0 +1,223 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "evoral/Curve.h"
+
+#include "ardour/automation_list.h"
+#include "ardour/automation_prerender.h"
+
+using namespace ARDOUR;
+using namespace Temporal;
+
+Glib::Threads::Mutex           AutomationPrerender::_instance_lock;
+std::set<AutomationPrerender*> AutomationPrerender::_instances;
+std::atomic<int>               AutomationPrerender::_refill_wanted (0);
+
+AutomationPrerender::AutomationPrerender (AutomationList& al, samplecnt_t bufsize)
+	: _list (al)
+	, _buf (bufsize)
+	, _read_pos (0)
+	, _write_pos (0)
+	, _seq (0)
+	, _generation (0)
+	, _rendered_generation (-1)
+	, _reset_pending (0)
+	, _next_pos (max_samplepos)
+	, _prev_next_pos (max_samplepos)
+{
+	Glib::Threads::Mutex::Lock lm (_instance_lock);
+	_instances.insert (this);
+}
+
+AutomationPrerender::~AutomationPrerender ()
+{
+	Glib::Threads::Mutex::Lock lm (_instance_lock);
+	_instances.erase (this);
+}
+
+void
+AutomationPrerender::note_position (samplepos_t pos)
+{
+	samplepos_t cur = _next_pos.load ();
+	while (pos < cur && !_next_pos.compare_exchange_weak (cur, pos)) ;
+}
+
+void
+AutomationPrerender::request_reset ()
+{
+	_reset_pending.store (1);
+	_refill_wanted.store (1);
+}
+
+bool
+AutomationPrerender::read (samplepos_t start, float* vec, samplecnt_t nframes)
+{
+	/* Tell the butler what to keep, and where to start over if needed.
+	 * This is @p start rather than the end of the range, since several
+	 * consumers (e.g. a panner, once per input) may ask for the same
+	 * range during one process cycle.
+	 */
+	note_position (start);
+
+	if (_reset_pending.load ()) {
+		/* butler has not caught up yet */
+		return false;
+	}
+
+	const unsigned int seq = _seq.load ();
+
+	if (seq & 1) {
+		/* butler is changing the ring right now */
+		return false;
+	}
+
+	if (_rendered_generation.load () != _generation.load ()) {
+		/* edited */
+		request_reset ();
+		return false;
+	}
+
+	const samplepos_t read_pos = _read_pos.load ();
+
+	if (start < read_pos) {
+		/* located backwards, or too far behind other readers */
+		request_reset ();
+		return false;
+	}
+
+	/* The butler may have restarted rendering a little behind us, or
+	 * a locate moved us forward: skip ahead if we can.
+	 */
+
+	const size_t skip  = start - read_pos;
+	const size_t avail = _buf.read_space ();
+
+	if (avail < skip + nframes) {
+		if (skip + nframes >= _buf.bufsize ()) {
+			/* this can never be rendered in time, start over */
+			request_reset ();
+		} else {
+			_refill_wanted.store (1);
+		}
+		return false;
+	}
+
+	PBD::RingBuffer<float>::rw_vector rv;
+	_buf.get_read_vector (&rv);
+
+	size_t off  = skip;
+	size_t left = nframes;
+
+	for (int n = 0; n < 2 && left > 0; ++n) {
+		if (off >= rv.len[n]) {
+			off -= rv.len[n];
+			continue;
+		}
+		const size_t cnt = std::min (rv.len[n] - off, left);
+		memcpy (vec, rv.buf[n] + off, cnt * sizeof (float));
+		vec  += cnt;
+		left -= cnt;
+		off   = 0;
+	}
+
+	if (_seq.load () != seq) {
+		/* values were discarded, and may have been overwritten, while we copied */
+		return false;
+	}
+
+	if (avail - skip - nframes < _buf.bufsize () / 2) {
+		_refill_wanted.store (1);
+	}
+
+	return true;
+}
+
+void
+AutomationPrerender::refill ()
+{
+	/* Keep everything that a reader asked for since the refill before the
+	 * last one: readers of the same list may run at different positions,
+	 * and not all of them may have run since the last refill.
+	 */
+	const samplepos_t next = _next_pos.exchange (max_samplepos);
+	const samplepos_t keep = std::min (next, _prev_next_pos);
+
+	_prev_next_pos = next;
+
+	if (_reset_pending.load ()) {
+		if (next == max_samplepos) {
+			/* nobody asked for anything yet */
+			return;
+		}
+		/* readers do not copy while a reset is pending, but may just
+		 * have started to before it was requested.
+		 */
+		_seq.fetch_add (1);
+		_buf.reset ();
+		_read_pos.store (next);
+		_write_pos = next;
+		_rendered_generation.store (_generation.load ());
+		_reset_pending.store (0);
+		_seq.fetch_add (1);
+	} else if (keep != max_samplepos && keep > _read_pos.load ()) {
+		const size_t discard = std::min ((size_t) (keep - _read_pos.load ()), _buf.read_space ());
+		_seq.fetch_add (1);
+		_buf.increment_read_idx (discard);
+		_read_pos.store (_read_pos.load () + discard);
+		_seq.fetch_add (1);
+	}
+
+	if (_rendered_generation.load () != _generation.load ()) {
+		/* stale, and the readers will notice. Don't bother rendering more */
+		return;
+	}
+
+	/* render in moderate chunks, so that GUI edits do not wait for the
+	 * list's lock for long
+	 */
+	const size_t chunk = 8192;
+
+	PBD::RingBuffer<float>::rw_vector vec;
+	_buf.get_write_vector (&vec);
+
+	for (int n = 0; n < 2; ++n) {
+		size_t done = 0;
+		while (done < vec.len[n]) {
+			const size_t cnt = std::min (chunk, vec.len[n] - done);
+			_list.curve ().get_vector (timepos_t (_write_pos), timepos_t (_write_pos + cnt), vec.buf[n] + done, cnt);
+			_write_pos += cnt;
+			done += cnt;
+			_buf.increment_write_idx (cnt);
+		}
+	}
+}
+
+void
+AutomationPrerender::refill_all ()
+{
+	_refill_wanted.store (0);
+
+	Glib::Threads::Mutex::Lock lm (_instance_lock);
+
+	for (auto & p : _instances) {
+		if (p->_list.automation_playback ()) {
+			p->refill ();
+		}
+	}
+}
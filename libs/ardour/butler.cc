@@ -39,6 +39,7 @@
 #include "temporal/tempo.h"
 
 #include "ardour/auditioner.h"
+#include "ardour/automation_prerender.h"
 #include "ardour/butler.h"
 #include "ardour/debug.h"
 #include "ardour/disk_io.h"
@@ -314,6 +315,10 @@ Butler::thread_work ()
 		tl->process ();
 		tl.reset ();
 
+		if (should_run && !transport_work_requested () && AutomationPrerender::refill_wanted ()) {
+			AutomationPrerender::refill_all ();
+		}
+
 		if (i != rl_with_auditioner.begin () && i != rl_with_auditioner.end ()) {
 			/* we didn't get to all the streams */
 			disk_work_outstanding = true;
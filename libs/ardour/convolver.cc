@@ -18,6 +18,7 @@
 
 #include <assert.h>
 
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 
@@ -48,6 +49,11 @@ Convolution::Convolution (Session& session, uint32_t n_in, uint32_t n_out)
     , _threaded (false)
     , _n_inputs (n_in)
     , _n_outputs (n_out)
+    , _thread_policy (Realtime)
+    , _n_threads (0)
+    , _min_part (0)
+    , _max_part (0)
+    , _parallel (false)
 {
 	AudioEngine::instance ()->BufferSizeChanged.connect_same_thread (*this, boost::bind (&Convolution::restart, this));
 }
@@ -80,6 +86,28 @@ Convolution::clear_impdata ()
 	_impdata.clear ();
 }
 
+void
+Convolution::set_thread_policy (ThreadPolicy p, uint32_t n_threads)
+{
+	_thread_policy = p;
+	_n_threads     = n_threads;
+}
+
+void
+Convolution::set_partition_size (uint32_t min_part, uint32_t max_part)
+{
+	_min_part = min_part;
+	_max_part = max_part;
+}
+
+static uint32_t
+round_up_power_of_two (uint32_t n)
+{
+	uint32_t power_of_two;
+	for (power_of_two = 0; 1U << power_of_two < n; ++power_of_two) ;
+	return 1 << power_of_two;
+}
+
 bool
 Convolution::ready () const
 {
@@ -91,7 +119,7 @@ Convolution::restart ()
 {
 	_convproc.stop_process ();
 	_convproc.cleanup ();
-	_convproc.set_options (0);
+	_convproc.set_options (Convproc::OPT_VECTOR_MODE);
 
 	if (_impdata.empty ()) {
 		_configured = false;
@@ -102,15 +130,30 @@ Convolution::restart ()
 
 	if (_threaded) {
 		_n_samples = 64;
-		n_part     = Convproc::MAXPART;
+		if (_min_part > 0) {
+			_n_samples = std::max ((uint32_t)Convproc::MINPART, std::min ((uint32_t)Convproc::MAXQUANT, round_up_power_of_two (_min_part)));
+		}
+		n_part = Convproc::MAXPART;
 	} else {
-		_n_samples = _session.get_block_size ();
-		uint32_t power_of_two;
-		for (power_of_two = 1; 1U << power_of_two < _n_samples; ++power_of_two) ;
-		_n_samples = 1 << power_of_two;
+		_n_samples = round_up_power_of_two (std::max<uint32_t> (2, _session.get_block_size ()));
 		n_part     = std::min ((uint32_t)Convproc::MAXPART, _n_samples);
 	}
 
+	if (_max_part > 0 && _threaded) {
+		n_part = std::max (_n_samples, std::min ((uint32_t)Convproc::MAXPART, round_up_power_of_two (_max_part)));
+	}
+
+	/* without background threads there is a single partition level,
+	 * processed by the caller of run (), which never uses helpers.
+	 */
+	if (_thread_policy != Realtime && _threaded) {
+		uint32_t n_threads = _n_threads > 0 ? _n_threads : hardware_concurrency ();
+		_convproc.set_threads (std::max (1U, std::min ((uint32_t)Convproc::MAXTHR, n_threads)));
+	}
+
+	_parallel = _thread_policy == Parallel || (_thread_policy == Export && AudioEngine::instance ()->freewheeling ());
+	_convproc.set_parallel (_parallel);
+
 	_offset    = 0;
 	_max_size  = 0;
 
@@ -227,12 +270,26 @@ Convolution::run (BufferSet& bufs, ChanMapping const& in_map, ChanMapping const&
 		remain  -= ns;
 
 		if (_offset == _n_samples) {
-			_convproc.process ();
+			process ();
 			_offset = 0;
 		}
 	}
 }
 
+void
+Convolution::process ()
+{
+	if (_thread_policy == Export) {
+		/* use all threads while exporting (freewheeling) */
+		bool const parallel = AudioEngine::instance ()->freewheeling ();
+		if (parallel != _parallel) {
+			_parallel = parallel;
+			_convproc.set_parallel (parallel);
+		}
+	}
+	_convproc.process ();
+}
+
 /* ****************************************************************************/
 
 Convolver::Convolver (
@@ -353,7 +410,7 @@ Convolution::run_mono_buffered (float* buf, uint32_t n_samples)
 		remain  -= ns;
 
 		if (_offset == _n_samples) {
-			_convproc.process ();
+			process ();
 			_offset = 0;
 		}
 	}
@@ -383,7 +440,7 @@ Convolver::run_stereo_buffered (float* left, float* right, uint32_t n_samples)
 		remain  -= ns;
 
 		if (_offset == _n_samples) {
-			_convproc.process ();
+			process ();
 			_offset = 0;
 		}
 	}
@@ -413,7 +470,7 @@ Convolution::run_mono_no_latency (float* buf, uint32_t n_samples)
 		memcpy (&in[_offset], &buf[done], sizeof (float) * ns);
 
 		if (_offset + ns == _n_samples) {
-			_convproc.process ();
+			process ();
 			memcpy (&buf[done], &out[_offset], sizeof (float) * ns);
 			_offset = 0;
 		} else {
@@ -448,7 +505,7 @@ Convolver::run_stereo_no_latency (float* left, float* right, uint32_t n_samples)
 		}
 
 		if (_offset + ns == _n_samples) {
-			_convproc.process ();
+			process ();
 			memcpy (&left[done],  &outL[_offset], sizeof (float) * ns);
 			memcpy (&right[done], &outR[_offset], sizeof (float) * ns);
 			_offset = 0;
@@ -1604,8 +1604,10 @@ DiskReader::dec_no_disk_output ()
 
 DiskReader::DeclickAmp::DeclickAmp (samplecnt_t sample_rate)
 {
-	_a = 800.f / (gain_t)sample_rate; // ~ 1/50Hz to fade by 40dB
-	_l = -log1p (_a);
+	/* ~ 1/50Hz to fade by 40dB: a = 800 / SR per 4 samples,
+	 * applied as per-sample ramp: (1 - _a)^4 = 1 - a
+	 */
+	_a = 1.f - powf (1.f - 800.f / (gain_t)sample_rate, .25f);
 	_g = 0;
 }
 
@@ -1623,30 +1625,7 @@ DiskReader::DeclickAmp::apply_gain (AudioBuffer& buf, samplecnt_t n_samples, con
 		return;
 	}
 
-	const float   a      = _a;
-	Sample* const buffer = buf.data ();
-
-	const int max_nproc = 4;
-	uint32_t  remain    = n_samples;
-	uint32_t  offset    = buffer_offset;
-
-	while (remain > 0) {
-		uint32_t n_proc = remain > max_nproc ? max_nproc : remain;
-		for (uint32_t i = 0; i < n_proc; ++i) {
-			buffer[offset + i] *= g;
-		}
-#if 1
-		g += a * (target - g);
-#else /* accurate exponential fade */
-		if (n_proc == max_nproc) {
-			g += a * (target - g);
-		} else {
-			g = target - (target - g) * expf (_l * n_proc / max_nproc);
-		}
-#endif
-		remain -= n_proc;
-		offset += n_proc;
-	}
+	g = apply_gain_ramp_to_buffer (buf.data (buffer_offset), n_samples, g, target, _a);
 
 	if (fabsf (g - target) < GAIN_COEFF_DELTA) {
 		_g = target;
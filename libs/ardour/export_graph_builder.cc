@@ -43,12 +43,14 @@
 #include "audiographer/general/limiter.h"
 #include "audiographer/general/normalizer.h"
 #include "audiographer/general/analyser.h"
+#include "audiographer/general/async_writer.h"
 #include "audiographer/general/peak_reader.h"
 #include "audiographer/general/loudness_reader.h"
 #include "audiographer/general/sample_format_converter.h"
 #include "audiographer/general/sr_converter.h"
 #include "audiographer/general/silence_trimmer.h"
 #include "audiographer/general/threader.h"
+#include "audiographer/sndfile/tmp_buffer.h"
 #include "audiographer/sndfile/tmp_file.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
 #include "audiographer/sndfile/tmp_file_sync.h"
@@ -62,6 +64,7 @@
 #include "ardour/export_graph_builder.h"
 #include "ardour/export_timespan.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session_directory.h"
 #include "ardour/session_metadata.h"
 #include "ardour/sndfile_helpers.h"
@@ -157,7 +160,6 @@ namespace ARDOUR {
 
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
-	, thread_pool (hardware_concurrency())
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
 }
@@ -203,6 +205,72 @@ ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
 	return samples - off;
 }
 
+samplecnt_t
+ExportGraphBuilder::process (samplecnt_t samples, samplepos_t position, ExportChannelReads& reads)
+{
+	assert(samples <= process_buffer_samples);
+	assert (timespan);
+
+	samplepos_t const ts_start = timespan->get_start ();
+	samplepos_t const ts_end   = timespan->get_end ();
+
+	sampleoffset_t off = 0;
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
+		Buffer const* buf = reads.read (it->first, samples);
+
+		if (session.remaining_latency_preroll () >= _master_align + samples) {
+			/* Skip processing during pre-roll, only read/write export ringbuffers */
+			return 0;
+		}
+
+		off = 0;
+		if (session.remaining_latency_preroll () > _master_align) {
+			off = session.remaining_latency_preroll () - _master_align;
+			assert (off < samples);
+		}
+
+		/* only pass on the part of the cycle inside the timespan */
+		samplepos_t const s = std::max (position, ts_start);
+		samplepos_t const e = std::min (position + samples - off, ts_end);
+
+		if (s >= e) {
+			continue;
+		}
+
+		sampleoffset_t const first = off + (s - position);
+		bool const last_cycle = (e == ts_end);
+
+		AudioBuffer const* ab = dynamic_cast<AudioBuffer const*> (buf);
+		MidiBuffer const*  mb;
+		if (ab) {
+			Sample const* process_buffer = ab->data ();
+			ConstProcessContext<Sample> context(&process_buffer[first], e - s, 1);
+			if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+			it->second->process (context);
+		}
+		if  ((mb = dynamic_cast<MidiBuffer const*> (buf))) {
+			it->second->process (*mb, first, e - s, last_cycle);
+		}
+	}
+
+	return samples - off;
+}
+
+Buffer const*
+ExportChannelReads::read (ExportChannelPtr const& channel, samplecnt_t samples)
+{
+	for (std::vector<std::pair<ExportChannel const*, Buffer const*> >::const_iterator i = _reads.begin (); i != _reads.end (); ++i) {
+		if (i->first == channel.get ()) {
+			return i->second;
+		}
+	}
+
+	Buffer const* buf;
+	channel->read (buf, samples);
+	_reads.push_back (std::make_pair (channel.get (), buf));
+	return buf;
+}
+
 bool
 ExportGraphBuilder::post_process ()
 {
@@ -349,10 +417,10 @@ ExportGraphBuilder::Encoder::init (FileSpec const & new_config)
 	config = new_config;
 	if (config.format->format_id() == ExportFormatBase::F_FFMPEG) {
 		init_writer (pipe_writer);
-		return pipe_writer;
+		return init_queue<Sample> (float_queue, pipe_writer);
 	} else {
 		init_writer (float_writer);
-		return float_writer;
+		return init_queue<Sample> (float_queue, float_writer);
 	}
 }
 
@@ -362,7 +430,7 @@ ExportGraphBuilder::Encoder::init (FileSpec const & new_config)
 {
 	config = new_config;
 	init_writer (int_writer);
-	return int_writer;
+	return init_queue<int> (int_queue, int_writer);
 }
 
 template <>
@@ -371,7 +439,7 @@ ExportGraphBuilder::Encoder::init (FileSpec const & new_config)
 {
 	config = new_config;
 	init_writer (short_writer);
-	return short_writer;
+	return init_queue<short> (short_queue, short_writer);
 }
 
 void
@@ -383,6 +451,17 @@ ExportGraphBuilder::Encoder::add_child (FileSpec const & new_config)
 void
 ExportGraphBuilder::Encoder::destroy_writer (bool delete_out_file)
 {
+	/* the encoder threads must not use the writers anymore */
+	if (float_queue) {
+		float_queue->stop ();
+	}
+	if (int_queue) {
+		int_queue->stop ();
+	}
+	if (short_queue) {
+		short_queue->stop ();
+	}
+
 	if (delete_out_file ) {
 
 		if (float_writer) {
@@ -410,6 +489,9 @@ ExportGraphBuilder::Encoder::destroy_writer (bool delete_out_file)
 	int_writer.reset ();
 	short_writer.reset ();
 	pipe_writer.reset ();
+	float_queue.reset ();
+	int_queue.reset ();
+	short_queue.reset ();
 }
 
 bool
@@ -427,6 +509,23 @@ ExportGraphBuilder::Encoder::get_real_format (FileSpec const & config)
 	return format.format_id() | format.sample_format() | format.endianness();
 }
 
+template<typename T>
+std::shared_ptr<AudioGrapher::Sink<T> >
+ExportGraphBuilder::Encoder::init_queue (std::shared_ptr<AudioGrapher::AsyncWriter<T> > & queue, std::shared_ptr<AudioGrapher::Sink<T> > writer)
+{
+	/* Encode in a thread of its own, so that slow encoders do not hold
+	 * up rendering, and multiple formats are encoded concurrently.
+	 * Allow to queue about one second of audio.
+	 */
+	unsigned channels = config.channel_config->get_n_chans();
+	samplecnt_t const chunk_size = 8192 * channels;
+	samplecnt_t const queue_size = std::max<samplecnt_t> (4 * chunk_size, config.format->sample_rate() * channels);
+
+	queue.reset (new AudioGrapher::AsyncWriter<T> (channels, chunk_size, queue_size));
+	queue->add_output (writer);
+	return queue;
+}
+
 template<typename T>
 void
 ExportGraphBuilder::Encoder::init_writer (std::shared_ptr<AudioGrapher::SndfileWriter<T> > & writer)
@@ -770,19 +869,13 @@ ExportGraphBuilder::SFC::operator== (FileSpec const& other_config) const
 	return id;
 }
 
-/* Intermediate (Normalizer, TmpFile) */
+/* Intermediate (Normalizer, TmpBuffer) */
 
 ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, FileSpec const & new_config, samplecnt_t max_samples)
 	: parent (parent)
 	, use_loudness (false)
 	, use_peak (false)
 {
-	std::string tmpfile_path = parent.session.session_directory().export_path();
-	tmpfile_path = Glib::build_filename(tmpfile_path, "XXXXXX");
-	std::vector<char> tmpfile_path_buf(tmpfile_path.size() + 1);
-	std::copy(tmpfile_path.begin(), tmpfile_path.end(), tmpfile_path_buf.begin());
-	tmpfile_path_buf[tmpfile_path.size()] = '\0';
-
 	config = new_config;
 	uint32_t const channels = config.channel_config->get_n_chans();
 	max_samples_out = 4086 - (4086 % channels); // TODO good chunk size
@@ -791,25 +884,44 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 
 	peak_reader.reset (new PeakReader ());
 	loudness_reader.reset (new LoudnessReader (config.format->sample_rate(), channels, max_samples));
-	threader.reset (new Threader<Sample> (parent.thread_pool));
-
-	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
+	assert (parent._worker_pool);
+	threader.reset (new Threader<Sample> (*parent._worker_pool));
 
-	if (parent._realtime) {
-		tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
-	} else {
-		tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
-	}
+	/* Keep the data in memory as far as possible, the file is only
+	 * created when the budget is exhausted. Realtime export must not
+	 * allocate in the process thread, and always uses the file.
+	 */
+	tmp_buffer.reset (new TmpBuffer<float> (boost::bind (&Intermediate::create_tmp_file, this), channels,
+	                                        parent._realtime ? std::shared_ptr<TmpBuffer<float>::Budget> () : parent._tmp_buffer_budget));
 
-	tmp_file->FileWritten.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::prepare_post_processing, this));
-	tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::start_post_processing, this));
+	tmp_buffer->Written.connect_same_thread (post_processing_connection,
+	                                         boost::bind (&Intermediate::prepare_post_processing, this));
+	tmp_buffer->Flushed.connect_same_thread (post_processing_connection,
+	                                         boost::bind (&Intermediate::start_post_processing, this));
 
 	add_child (new_config);
 
 	peak_reader->add_output (loudness_reader);
-	loudness_reader->add_output (tmp_file);
+	loudness_reader->add_output (tmp_buffer);
+}
+
+ExportGraphBuilder::Intermediate::TmpFilePtr
+ExportGraphBuilder::Intermediate::create_tmp_file ()
+{
+	std::string tmpfile_path = parent.session.session_directory().export_path();
+	tmpfile_path = Glib::build_filename(tmpfile_path, "XXXXXX");
+	std::vector<char> tmpfile_path_buf(tmpfile_path.size() + 1);
+	std::copy(tmpfile_path.begin(), tmpfile_path.end(), tmpfile_path_buf.begin());
+	tmpfile_path_buf[tmpfile_path.size()] = '\0';
+
+	uint32_t const channels = config.channel_config->get_n_chans();
+	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
+
+	if (parent._realtime) {
+		return TmpFilePtr (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+	} else {
+		return TmpFilePtr (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+	}
 }
 
 ExportGraphBuilder::FloatSinkPtr
@@ -820,7 +932,7 @@ ExportGraphBuilder::Intermediate::sink ()
 	} else if (use_loudness) {
 		return loudness_reader;
 	} else {
-		return tmp_file;
+		return tmp_buffer;
 	}
 }
 
@@ -861,14 +973,14 @@ ExportGraphBuilder::Intermediate::operator== (FileSpec const & other_config) con
 unsigned
 ExportGraphBuilder::Intermediate::get_postprocessing_cycle_count() const
 {
-	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_file->get_samples_written()) /
+	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_buffer->get_samples_written()) /
 	                                       max_samples_out));
 }
 
 bool
 ExportGraphBuilder::Intermediate::process()
 {
-	samplecnt_t samples_read = tmp_file->read (*buffer);
+	samplecnt_t samples_read = tmp_buffer->read (*buffer);
 	return samples_read != buffer->samples();
 }
 
@@ -884,7 +996,7 @@ ExportGraphBuilder::Intermediate::prepare_post_processing()
 		}
 	}
 
-	tmp_file->add_output (threader);
+	tmp_buffer->add_output (threader);
 	parent.intermediates.push_back (this);
 }
 
@@ -892,10 +1004,10 @@ void
 ExportGraphBuilder::Intermediate::start_post_processing()
 {
 	for (boost::ptr_list<SFC>::iterator i = children.begin(); i != children.end(); ++i) {
-		(*i).set_duration (tmp_file->get_samples_written() / config.channel_config->get_n_chans());
+		(*i).set_duration (tmp_buffer->get_samples_written() / config.channel_config->get_n_chans());
 	}
 
-	tmp_file->seek (0, SEEK_SET);
+	tmp_buffer->rewind ();
 
 	/* called in disk-thread when exporting in realtime,
 	 * to enable freewheeling for post-proc.
@@ -22,11 +22,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
 #include <glibmm/convert.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
+
+#include "audiographer/general/worker_pool.h"
 
 #include "ardour/audioengine.h"
 #include "ardour/audiofile_tagger.h"
@@ -39,6 +44,7 @@
 #include "ardour/export_status.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/soundcloud_upload.h"
 #include "ardour/surround_return.h"
 #include "ardour/system_exec.h"
@@ -116,6 +122,7 @@ ExportHandler::ExportHandler (Session & session)
   , session (session)
   , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
+  , channel_reads (new ExportChannelReads)
   , post_processing (false)
   , cue_tracknum (0)
   , cue_indexnum (0)
@@ -129,6 +136,9 @@ ExportHandler::~ExportHandler ()
 		session.surround_master ()->surround_return ()->finalize_export ();
 	}
 	graph_builder->cleanup (export_status->aborted () );
+	for (std::vector<std::shared_ptr<ExportGraphBuilder> >::const_iterator i = concurrent_graph_builders.begin (); i != concurrent_graph_builders.end (); ++i) {
+		(*i)->cleanup (export_status->aborted ());
+	}
 }
 
 /** Add an export to the `to-do' list */
@@ -166,6 +176,18 @@ ExportHandler::do_export ()
 		}
 	}
 
+	/* One pool of worker threads for all graph builders. The thread
+	 * calling Threader::process takes part as well.
+	 */
+
+	if (!worker_pool) {
+		worker_pool.reset (new AudioGrapher::WorkerPool (std::max<uint32_t> (1, hardware_concurrency ()) - 1));
+	}
+
+	/* One memory budget for all timespans of this export */
+
+	tmp_buffer_budget.reset (new std::atomic<samplecnt_t> ((samplecnt_t) Config->get_export_normalize_memory () * 1048576 / sizeof (Sample)));
+
 	/* Start export */
 
 	Glib::Threads::Mutex::Lock l (export_status->lock());
@@ -190,6 +212,12 @@ ExportHandler::start_timespan ()
 		return -1;
 	}
 
+	std::vector<ExportTimespanPtr> concurrent;
+	collect_concurrent_timespans (concurrent);
+	if (!concurrent.empty ()) {
+		return start_concurrent_timespans (concurrent);
+	}
+
 	export_status->timespan++;
 
 	/* finish_timespan pops the config_map entry that has been done, so
@@ -207,6 +235,8 @@ ExportHandler::start_timespan ()
 	timespan_bounds = config_map.equal_range (current_timespan);
 	graph_builder->reset ();
 	graph_builder->set_current_timespan (current_timespan);
+	graph_builder->set_worker_pool (worker_pool);
+	graph_builder->set_tmp_buffer_budget (tmp_buffer_budget);
 	handle_duplicate_format_extensions();
 	bool realtime = current_timespan->realtime ();
 	bool region_export = true;
@@ -241,6 +271,124 @@ ExportHandler::start_timespan ()
 	return session.start_audio_export (process_position, realtime, region_export);
 }
 
+bool
+ExportHandler::can_export_concurrently (ExportTimespanPtr timespan) const
+{
+	if (timespan->realtime () || !timespan->vapor ().empty ()) {
+		return false;
+	}
+
+	std::pair<ConfigMap::const_iterator, ConfigMap::const_iterator> bounds = config_map.equal_range (timespan);
+	for (ConfigMap::const_iterator it = bounds.first; it != bounds.second; ++it) {
+		if (it->second.channel_config->region_processing_type () != RegionExportChannelFactory::None) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Find timespans that can be exported together with the next one
+ * (the first in config_map). Only timespans that overlap or touch each
+ * other are combined, so that no gaps are rendered.
+ */
+void
+ExportHandler::collect_concurrent_timespans (std::vector<ExportTimespanPtr>& timespans) const
+{
+	timespans.clear ();
+
+	size_t const max_timespans = Config->get_export_concurrent_timespans ();
+
+	if (max_timespans < 2 || !can_export_concurrently (config_map.begin()->first)) {
+		return;
+	}
+
+	ExportTimespanPtr first = config_map.begin()->first;
+	samplepos_t start = first->get_start ();
+	samplepos_t end   = first->get_end ();
+
+	timespans.push_back (first);
+
+	bool added = true;
+	while (added && timespans.size () < max_timespans) {
+		added = false;
+		for (ConfigMap::const_iterator it = config_map.begin(); it != config_map.end() && timespans.size () < max_timespans; it = config_map.upper_bound (it->first)) {
+			ExportTimespanPtr ts = it->first;
+			if (ts->get_start () > end || ts->get_end () < start) {
+				continue;
+			}
+			if (std::find (timespans.begin (), timespans.end (), ts) != timespans.end () || !can_export_concurrently (ts)) {
+				continue;
+			}
+			timespans.push_back (ts);
+			start = std::min (start, ts->get_start ());
+			end   = std::max (end, ts->get_end ());
+			added = true;
+		}
+	}
+
+	if (timespans.size () < 2) {
+		timespans.clear ();
+	}
+}
+
+int
+ExportHandler::start_concurrent_timespans (std::vector<ExportTimespanPtr> const& timespans)
+{
+	samplepos_t start = timespans.front ()->get_start ();
+	samplepos_t end   = timespans.front ()->get_end ();
+	std::string names;
+	size_t      n_channels = 0;
+
+	while (concurrent_graph_builders.size () + 1 < timespans.size ()) {
+		concurrent_graph_builders.push_back (std::shared_ptr<ExportGraphBuilder> (new ExportGraphBuilder (session)));
+	}
+
+	concurrent_timespans.clear ();
+
+	for (std::vector<ExportTimespanPtr>::const_iterator t = timespans.begin (); t != timespans.end (); ++t) {
+		std::shared_ptr<ExportGraphBuilder> gb = (t == timespans.begin ()) ? graph_builder : concurrent_graph_builders[t - timespans.begin () - 1];
+
+		timespan_bounds = config_map.equal_range (*t);
+		gb->reset ();
+		gb->set_current_timespan (*t);
+		gb->set_worker_pool (worker_pool);
+		gb->set_tmp_buffer_budget (tmp_buffer_budget);
+		handle_duplicate_format_extensions();
+		for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+			it->second.filename->set_timespan (it->first);
+			gb->add_config (it->second, false);
+		}
+
+		concurrent_timespans.push_back (ConcurrentTimespan (*t, gb));
+
+		start = std::min (start, (*t)->get_start ());
+		end   = std::max (end, (*t)->get_end ());
+		n_channels += gb->n_channels ();
+		names += (names.empty () ? "" : ", ") + (*t)->name ();
+	}
+
+	for (ConcurrentTimespans::iterator ct = concurrent_timespans.begin (); ct != concurrent_timespans.end (); ++ct) {
+		ct->position = start;
+	}
+
+	channel_reads->reserve (n_channels);
+
+	export_status->timespan += timespans.size ();
+	export_status->total_samples_current_timespan = end - start;
+	export_status->timespan_name = names;
+	export_status->processed_samples_current_timespan = 0;
+
+	current_timespan = timespans.front ();
+
+	/* start export */
+
+	post_processing = false;
+	session.ProcessExport.connect_same_thread (process_connection, boost::bind (&ExportHandler::process, this, _1));
+	process_position = start;
+
+	return session.start_audio_export (process_position, false, false);
+}
+
 void
 ExportHandler::handle_duplicate_format_extensions()
 {
@@ -299,6 +447,10 @@ ExportHandler::process (samplecnt_t samples)
 int
 ExportHandler::process_timespan (samplecnt_t samples)
 {
+	if (!concurrent_timespans.empty ()) {
+		return process_concurrent_timespans (samples);
+	}
+
 	export_status->active_job = ExportStatus::Exporting;
 	/* update position */
 
@@ -345,9 +497,89 @@ ExportHandler::process_timespan (samplecnt_t samples)
 	return 0;
 }
 
+int
+ExportHandler::process_concurrent_timespans (samplecnt_t samples)
+{
+	export_status->active_job = ExportStatus::Exporting;
+
+	samplecnt_t advance  = 0;
+	bool        all_done = true;
+
+	channel_reads->clear ();
+
+	for (ConcurrentTimespans::iterator ct = concurrent_timespans.begin (); ct != concurrent_timespans.end (); ++ct) {
+		if (ct->done) {
+			continue;
+		}
+
+		samplepos_t const start = ct->timespan->get_start ();
+		samplepos_t const end   = ct->timespan->get_end ();
+
+		samplecnt_t const ret = ct->graph_builder->process (samples, ct->position, *channel_reads);
+
+		/* the part of this cycle that was inside the timespan */
+		samplecnt_t const processed = std::min (ct->position + ret, end) - std::max (ct->position, start);
+		if (processed > 0) {
+			export_status->processed_samples += processed;
+		}
+
+		ct->position += ret;
+		advance = std::max (advance, ret);
+
+		if (ct->position >= end) {
+			ct->done = true;
+		} else {
+			all_done = false;
+		}
+	}
+
+	export_status->processed_samples_current_timespan += advance;
+
+	if (!all_done) {
+		return 0;
+	}
+
+	export_status->stop = true;
+
+	/* Start post-processing/normalizing if necessary */
+	unsigned postprocessing_cycles = 0;
+	post_processing = false;
+	for (ConcurrentTimespans::const_iterator ct = concurrent_timespans.begin (); ct != concurrent_timespans.end (); ++ct) {
+		if (ct->graph_builder->need_postprocessing ()) {
+			post_processing = true;
+			postprocessing_cycles = std::max (postprocessing_cycles, ct->graph_builder->get_postprocessing_cycle_count ());
+		}
+	}
+
+	if (post_processing) {
+		export_status->total_postprocessing_cycles = postprocessing_cycles;
+		export_status->current_postprocessing_cycle = 0;
+	} else {
+		finish_timespan ();
+	}
+	return 1; /* trigger realtime_stop() */
+}
+
 int
 ExportHandler::post_process ()
 {
+	if (!concurrent_timespans.empty ()) {
+		bool done = true;
+		for (ConcurrentTimespans::const_iterator ct = concurrent_timespans.begin (); ct != concurrent_timespans.end (); ++ct) {
+			if (!ct->graph_builder->post_process ()) {
+				done = false;
+			}
+		}
+		if (done) {
+			finish_timespan ();
+			export_status->active_job = ExportStatus::Exporting;
+		} else {
+			export_status->active_job = ExportStatus::Normalizing;
+		}
+		export_status->current_postprocessing_cycle++;
+		return 0;
+	}
+
 	if (graph_builder->post_process ()) {
 		finish_timespan ();
 		export_status->active_job = ExportStatus::Exporting;
@@ -387,34 +619,61 @@ ExportHandler::start_timespan_bg (void* eh)
 void
 ExportHandler::finish_timespan ()
 {
-	if (/*!region_export &&*/ !current_timespan->vapor ().empty () && session.surround_master ()) {
-		session.surround_master ()->surround_return ()->finalize_export ();
+	if (!concurrent_timespans.empty ()) {
+		for (ConcurrentTimespans::const_iterator ct = concurrent_timespans.begin (); ct != concurrent_timespans.end (); ++ct) {
+			current_timespan = ct->timespan;
+			timespan_bounds  = config_map.equal_range (current_timespan);
+			finish_files (*ct->graph_builder);
+		}
+		concurrent_timespans.clear ();
+	} else {
+		if (/*!region_export &&*/ !current_timespan->vapor ().empty () && session.surround_master ()) {
+			session.surround_master ()->surround_return ()->finalize_export ();
+		}
+		finish_files (*graph_builder);
 	}
 
-	graph_builder->get_analysis_results (export_status->result_map);
+	/* finish timespan is called in freewheeling rt-context,
+	 * we cannot start a new export from here */
+	assert (AudioEngine::instance()->freewheeling ());
+	pthread_t tid;
+	pthread_create (&tid, NULL, ExportHandler::start_timespan_bg, this);
+	pthread_detach (tid);
+}
+
+/** Tag files, write CD marker files and run post-export commands for the
+ * current timespan, and remove it from config_map.
+ */
+void
+ExportHandler::finish_files (ExportGraphBuilder& gb)
+{
+	gb.get_analysis_results (export_status->result_map);
 
 	/* work-around: split-channel will produce several files
 	 * for a single config, config_map iterator below does not yet
 	 * take that into account.
 	 */
-	for (auto const& f : graph_builder->exported_files ()) {
-		Session::Exported (current_timespan->name(), f, config_map.begin()->second.format->reimport(), current_timespan->get_start ()); /* EMIT SIGNAL */
+	for (auto const& f : gb.exported_files ()) {
+		Session::Exported (current_timespan->name(), f, timespan_bounds.first->second.format->reimport(), current_timespan->get_start ()); /* EMIT SIGNAL */
 	}
 
-	while (config_map.begin() != timespan_bounds.second) {
+	ConfigMap::iterator it = timespan_bounds.first;
+
+	while (it != timespan_bounds.second) {
 
 		// XXX single timespan+format may produce multiple files
 		// e.g export selection == session
 		// -> TagLib::FileRef is null
 
-		FileSpec& config = config_map.begin()->second;
+		FileSpec& config = it->second;
 		ExportFormatSpecPtr fmt = config.format;
+		config.filename->set_timespan (current_timespan);
 		config.filename->set_channel_config (config.channel_config);
 		std::string filename = config.filename->get_path (fmt);
 
 		if (fmt->type () == ExportFormatBase::T_None) {
-			graph_builder->reset ();
-			config_map.erase (config_map.begin());
+			gb.reset ();
+			config_map.erase (it++);
 			continue;
 		}
 
@@ -434,7 +693,7 @@ ExportHandler::finish_timespan ()
 		 * The process cannot access the file because it is being used.
 		 * ditto for post-export and upload.
 		 */
-		graph_builder->reset ();
+		gb.reset ();
 
 		if (fmt->tag()) {
 			/* TODO: check Umlauts and encoding in filename.
@@ -540,22 +799,19 @@ ExportHandler::finish_timespan ()
 			}
 			delete soundcloud_uploader;
 		}
-		config_map.erase (config_map.begin());
+		config_map.erase (it++);
 	}
-
-	/* finish timespan is called in freewheeling rt-context,
-	 * we cannot start a new export from here */
-	assert (AudioEngine::instance()->freewheeling ());
-	pthread_t tid;
-	pthread_create (&tid, NULL, ExportHandler::start_timespan_bg, this);
-	pthread_detach (tid);
 }
 
 void
 ExportHandler::reset ()
 {
 	config_map.clear ();
+	concurrent_timespans.clear ();
 	graph_builder->reset ();
+	for (std::vector<std::shared_ptr<ExportGraphBuilder> >::const_iterator i = concurrent_graph_builders.begin (); i != concurrent_graph_builders.end (); ++i) {
+		(*i)->reset ();
+	}
 }
 
 /*** CD Marker stuff ***/
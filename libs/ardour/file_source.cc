@@ -57,6 +57,7 @@ using namespace PBD;
 using namespace Glib;
 
 PBD::Signal2<int,std::string,std::vector<std::string> > FileSource::AmbiguousFileName;
+thread_local bool FileSource::_ask_about_ambiguous_files = true;
 
 FileSource::FileSource (Session& session, DataType type, const string& path, const string& origin, Source::Flag flag)
 	: Source(session, type, path, flag)
@@ -138,6 +139,12 @@ FileSource::init (const string& pathstr, bool must_exist)
 	return 0;
 }
 
+void
+FileSource::set_ask_about_ambiguous_files (bool yn)
+{
+	_ask_about_ambiguous_files = yn;
+}
+
 int
 FileSource::set_state (const XMLNode& node, int /*version*/)
 {
@@ -292,6 +299,10 @@ FileSource::find (Session& s, DataType type, const string& path, bool must_exist
 
 			/* more than one match: ask the user */
 
+			if (!_ask_about_ambiguous_files) {
+				goto out;
+			}
+
                         int which = FileSource::AmbiguousFileName (path, de_duped_hits).value_or (-1);
 
                         if (which < 0) {
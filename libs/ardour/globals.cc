@@ -132,6 +132,9 @@
 
 #include "audiographer/routines.h"
 
+#include "zita-convolver/zita-convolver.h"
+#include "zita-resampler/vmresampler.h"
+
 #if defined(__APPLE__)
 #include <CoreFoundation/CoreFoundation.h>
 #endif
@@ -155,6 +158,14 @@ mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain   = 0;
 copy_vector_t           ARDOUR::copy_vector           = 0;
 
+apply_gain_vector_to_buffer_t  ARDOUR::apply_gain_vector_to_buffer  = 0;
+apply_gain_ramp_to_buffer_t    ARDOUR::apply_gain_ramp_to_buffer    = 0;
+mix_buffers_with_gain_vector_t ARDOUR::mix_buffers_with_gain_vector = 0;
+
+kmeter_bank_t  ARDOUR::kmeter_bank  = 0;
+iecppm_bank_t  ARDOUR::iecppm_bank  = 0;
+vumeter_bank_t ARDOUR::vumeter_bank = 0;
+
 PBD::Signal1<void, std::string>                    ARDOUR::BootMessage;
 PBD::Signal3<void, std::string, std::string, bool> ARDOUR::PluginScanMessage;
 PBD::Signal1<void, int>                            ARDOUR::PluginScanTimeout;
@@ -189,6 +200,19 @@ setup_hardware_optimization (bool try_optimization)
 {
 	bool generic_mix_functions = true;
 
+	/* sample format conversion for AudioGrapher, bit-identical to the default */
+	AudioGrapher::Routines::float_to_int16_t float_to_int16 = default_float_to_int16;
+	AudioGrapher::Routines::float_to_int32_t float_to_int32 = default_float_to_int32;
+	AudioGrapher::Routines::clip_floats_t    clip_floats    = default_clip_floats;
+
+	/* varispeed resampling of ports */
+	ArdourZita::VMResampler::interpolate_t vmr_interpolate = ArdourZita::VMResampler::default_interpolate;
+	ArdourZita::VMResampler::dot_product_t vmr_dot_product = ArdourZita::VMResampler::default_dot_product;
+
+	/* partitioned convolution, the MAC processes blocks of conv_vlen complex values */
+	ArdourZita::Convproc::mac_t conv_mac  = ArdourZita::Convproc::default_mac;
+	uint32_t                    conv_vlen = 4;
+
 	if (try_optimization) {
 		FPU* fpu = FPU::instance ();
 
@@ -207,6 +231,29 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
 			copy_vector           = x86_avx512f_copy_vector;
 
+			apply_gain_vector_to_buffer  = x86_avx512f_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = x86_avx512f_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = x86_avx512f_mix_buffers_with_gain_vector;
+
+			kmeter_bank           = x86_sse_kmeter_bank;
+			iecppm_bank           = x86_sse_iecppm_bank;
+			vumeter_bank          = x86_sse_vumeter_bank;
+
+			float_to_int16        = x86_avx512f_float_to_int16;
+			float_to_int32        = x86_avx512f_float_to_int32;
+			clip_floats           = x86_avx512f_clip_floats;
+
+#ifdef PLATFORM_WINDOWS
+			vmr_interpolate       = x86_sse_vmr_interpolate;
+			vmr_dot_product       = x86_sse_vmr_dot_product;
+#else
+			vmr_interpolate       = x86_sse_avx_vmr_interpolate;
+			vmr_dot_product       = x86_sse_avx_vmr_dot_product;
+#endif
+
+			conv_mac              = x86_avx512f_conv_mac;
+			conv_vlen             = 16;
+
 			generic_mix_functions = false;
 
 		} else
@@ -224,6 +271,40 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+#ifdef PLATFORM_WINDOWS
+			apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = x86_sse_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+
+			float_to_int16        = x86_sse2_float_to_int16;
+			float_to_int32        = x86_sse2_float_to_int32;
+			clip_floats           = x86_sse_clip_floats;
+
+			vmr_interpolate       = x86_sse_vmr_interpolate;
+			vmr_dot_product       = x86_sse_vmr_dot_product;
+
+			conv_mac              = x86_sse_conv_mac;
+			conv_vlen             = 4;
+#else
+			apply_gain_vector_to_buffer  = x86_sse_avx_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = x86_sse_avx_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+
+			float_to_int16        = x86_sse_avx_float_to_int16;
+			float_to_int32        = x86_sse_avx_float_to_int32;
+			clip_floats           = x86_sse_avx_clip_floats;
+
+			vmr_interpolate       = x86_sse_avx_vmr_interpolate;
+			vmr_dot_product       = x86_sse_avx_vmr_dot_product;
+
+			conv_mac              = x86_sse_avx_conv_mac;
+			conv_vlen             = 8;
+#endif
+
+			kmeter_bank           = x86_sse_kmeter_bank;
+			iecppm_bank           = x86_sse_iecppm_bank;
+			vumeter_bank          = x86_sse_vumeter_bank;
+
 			generic_mix_functions = false;
 
 		} else
@@ -239,6 +320,40 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+#ifdef PLATFORM_WINDOWS
+			apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = x86_sse_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+
+			float_to_int16        = x86_sse2_float_to_int16;
+			float_to_int32        = x86_sse2_float_to_int32;
+			clip_floats           = x86_sse_clip_floats;
+
+			vmr_interpolate       = x86_sse_vmr_interpolate;
+			vmr_dot_product       = x86_sse_vmr_dot_product;
+
+			conv_mac              = x86_sse_conv_mac;
+			conv_vlen             = 4;
+#else
+			apply_gain_vector_to_buffer  = x86_sse_avx_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = x86_sse_avx_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+
+			float_to_int16        = x86_sse_avx_float_to_int16;
+			float_to_int32        = x86_sse_avx_float_to_int32;
+			clip_floats           = x86_sse_avx_clip_floats;
+
+			vmr_interpolate       = x86_sse_avx_vmr_interpolate;
+			vmr_dot_product       = x86_sse_avx_vmr_dot_product;
+
+			conv_mac              = x86_sse_avx_conv_mac;
+			conv_vlen             = 8;
+#endif
+
+			kmeter_bank           = x86_sse_kmeter_bank;
+			iecppm_bank           = x86_sse_iecppm_bank;
+			vumeter_bank          = x86_sse_vumeter_bank;
+
 			generic_mix_functions = false;
 
 		} else if (fpu->has_sse ()) {
@@ -252,6 +367,28 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = x86_sse_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+
+			kmeter_bank           = x86_sse_kmeter_bank;
+			iecppm_bank           = x86_sse_iecppm_bank;
+			vumeter_bank          = x86_sse_vumeter_bank;
+
+#ifdef __SSE2__
+			if (fpu->has_sse2 ()) {
+				float_to_int16    = x86_sse2_float_to_int16;
+				float_to_int32    = x86_sse2_float_to_int32;
+			}
+#endif
+			clip_floats           = x86_sse_clip_floats;
+
+			vmr_interpolate       = x86_sse_vmr_interpolate;
+			vmr_dot_product       = x86_sse_vmr_dot_product;
+
+			conv_mac              = x86_sse_conv_mac;
+			conv_vlen             = 4;
+
 			generic_mix_functions = false;
 		}
 
@@ -267,6 +404,26 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 			copy_vector           = arm_neon_copy_vector;
 
+			apply_gain_vector_to_buffer  = arm_neon_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = arm_neon_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = arm_neon_mix_buffers_with_gain_vector;
+
+			kmeter_bank           = arm_neon_kmeter_bank;
+			iecppm_bank           = arm_neon_iecppm_bank;
+			vumeter_bank          = arm_neon_vumeter_bank;
+
+#ifdef __aarch64__
+			float_to_int16        = arm_neon_float_to_int16;
+			float_to_int32        = arm_neon_float_to_int32;
+#endif
+			clip_floats           = arm_neon_clip_floats;
+
+			vmr_interpolate       = arm_neon_vmr_interpolate;
+			vmr_dot_product       = arm_neon_vmr_dot_product;
+
+			conv_mac              = arm_neon_conv_mac;
+			conv_vlen             = 4;
+
 			generic_mix_functions = false;
 		}
 
@@ -280,6 +437,14 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_vector_to_buffer  = veclib_apply_gain_vector_to_buffer;
+			apply_gain_ramp_to_buffer    = default_apply_gain_ramp_to_buffer;
+			mix_buffers_with_gain_vector = veclib_mix_buffers_with_gain_vector;
+
+			kmeter_bank           = default_kmeter_bank;
+			iecppm_bank           = default_iecppm_bank;
+			vumeter_bank          = default_vumeter_bank;
+
 			generic_mix_functions = false;
 
 			info << "Apple VecLib H/W specific optimizations in use" << endmsg;
@@ -299,11 +464,28 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
 
+		apply_gain_vector_to_buffer  = default_apply_gain_vector_to_buffer;
+		apply_gain_ramp_to_buffer    = default_apply_gain_ramp_to_buffer;
+		mix_buffers_with_gain_vector = default_mix_buffers_with_gain_vector;
+
+		kmeter_bank           = default_kmeter_bank;
+		iecppm_bank           = default_iecppm_bank;
+		vumeter_bank          = default_vumeter_bank;
+
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
 
 	AudioGrapher::Routines::override_compute_peak (compute_peak);
 	AudioGrapher::Routines::override_apply_gain_to_buffer (apply_gain_to_buffer);
+	AudioGrapher::Routines::override_float_to_int16 (float_to_int16);
+	AudioGrapher::Routines::override_float_to_int32 (float_to_int32);
+	AudioGrapher::Routines::override_clip_floats (clip_floats);
+
+	ArdourZita::VMResampler::override_interpolate (vmr_interpolate);
+	ArdourZita::VMResampler::override_dot_product (vmr_dot_product);
+
+	ArdourZita::Convproc::override_mac (conv_mac, conv_vlen);
+	ArdourZita::Convproc::set_max_helpers (std::max<uint32_t> (1, hardware_concurrency ()) - 1);
 }
 
 static void
@@ -3274,6 +3274,8 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("run_mono_buffered", &ARDOUR::DSP::Convolution::run_mono_buffered)
 		.addFunction ("run_mono_no_latency", &ARDOUR::DSP::Convolution::run_mono_no_latency)
 		.addFunction ("restart", &ARDOUR::DSP::Convolution::restart)
+		.addFunction ("set_thread_policy", &ARDOUR::DSP::Convolution::set_thread_policy)
+		.addFunction ("set_partition_size", &ARDOUR::DSP::Convolution::set_partition_size)
 		.addFunction ("ready", &ARDOUR::DSP::Convolution::ready)
 		.addFunction ("latency", &ARDOUR::DSP::Convolution::latency)
 		.addFunction ("n_inputs", &ARDOUR::DSP::Convolution::n_inputs)
@@ -3332,6 +3334,12 @@ LuaBindings::common (lua_State* L)
 		.addConst ("Stereo", DSP::Convolver::Stereo)
 		.endNamespace ()
 
+		.beginNamespace ("ThreadPolicy")
+		.addConst ("Realtime", DSP::Convolution::Realtime)
+		.addConst ("Parallel", DSP::Convolution::Parallel)
+		.addConst ("Export", DSP::Convolution::Export)
+		.endNamespace ()
+
 		.beginClass <DSP::DspShm> ("DspShm")
 		.addConstructor<void (*) (size_t)> ()
 		.addFunction ("allocate", &DSP::DspShm::allocate)
@@ -44,10 +44,7 @@ using namespace ARDOUR;
 PeakMeter::PeakMeter (Session& s, const std::string& name)
 	: Processor (s, string_compose ("meter-%1", name), Temporal::TimeDomainProvider (Temporal::AudioTime))
 {
-	Kmeterdsp::init  (s.nominal_sample_rate ());
-	Iec1ppmdsp::init (s.nominal_sample_rate ());
-	Iec2ppmdsp::init (s.nominal_sample_rate ());
-	Vumeterdsp::init (s.nominal_sample_rate ());
+	MeterBank::init (s.nominal_sample_rate ());
 
 	_pending_active = true;
 	_meter_type     = MeterPeak;
@@ -59,16 +56,6 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 
 PeakMeter::~PeakMeter ()
 {
-	while (_kmeter.size () > 0) {
-		delete _kmeter.back ();
-		delete _iec1meter.back ();
-		delete _iec2meter.back ();
-		delete _vumeter.back ();
-		_kmeter.pop_back ();
-		_iec1meter.pop_back ();
-		_iec2meter.pop_back ();
-		_vumeter.pop_back ();
-	}
 	while (_peak_power.size () > 0) {
 		_peak_buffer.pop_back ();
 		_peak_power.pop_back ();
@@ -175,18 +162,12 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 			}
 		}
 
-		if (_meter_type & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-			_kmeter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
-		if (_meter_type & (MeterIEC1DIN | MeterIEC1NOR)) {
-			_iec1meter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
-		if (_meter_type & (MeterIEC2BBC | MeterIEC2EBU)) {
-			_iec2meter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
-		if (_meter_type & MeterVU) {
-			_vumeter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
+		_audio_data[i] = bufs.get_audio (i).data ();
+	}
+
+	/* ballistic meters, all channels at once */
+	if (n_audio > 0) {
+		_meter_bank.process (_meter_type, &_audio_data[0], n_audio, nframes);
 	}
 
 	/* Zero any excess peaks */
@@ -217,12 +198,7 @@ PeakMeter::reset ()
 	}
 
 	/* these are handled async just fine. */
-	for (size_t n = 0; n < _kmeter.size (); ++n) {
-		_kmeter[n]->reset ();
-		_iec1meter[n]->reset ();
-		_iec2meter[n]->reset ();
-		_vumeter[n]->reset ();
-	}
+	_meter_bank.reset ();
 }
 
 void
@@ -328,26 +304,8 @@ PeakMeter::set_max_channels (const ChanCount& chn)
 	assert (_max_peak_signal.size () == limit);
 
 	/* alloc/free other audio-only meter types. */
-	while (_kmeter.size () > n_audio) {
-		delete _kmeter.back ();
-		delete _iec1meter.back ();
-		delete _iec2meter.back ();
-		delete _vumeter.back ();
-		_kmeter.pop_back ();
-		_iec1meter.pop_back ();
-		_iec2meter.pop_back ();
-		_vumeter.pop_back ();
-	}
-	while (_kmeter.size () < n_audio) {
-		_kmeter.push_back (new Kmeterdsp ());
-		_iec1meter.push_back (new Iec1ppmdsp ());
-		_iec2meter.push_back (new Iec2ppmdsp ());
-		_vumeter.push_back (new Vumeterdsp ());
-	}
-	assert (_kmeter.size () == n_audio);
-	assert (_iec1meter.size () == n_audio);
-	assert (_iec2meter.size () == n_audio);
-	assert (_vumeter.size () == n_audio);
+	_meter_bank.set_channels (n_audio);
+	_audio_data.resize (n_audio);
 
 	reset ();
 	reset_max ();
@@ -358,7 +316,7 @@ PeakMeter::set_max_channels (const ChanCount& chn)
  * of meter size during this call.
  */
 
-#define CHECKSIZE(MTR) (n < MTR.size () + n_midi && n >= n_midi)
+#define CHECKSIZE (n < _meter_bank.n_channels () + n_midi && n >= n_midi)
 
 float
 PeakMeter::meter_level (uint32_t n, MeterType type)
@@ -378,8 +336,8 @@ PeakMeter::meter_level (uint32_t n, MeterType type)
 		case MeterK12:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_kmeter)) {
-					return accurate_coefficient_to_dB (_kmeter[n - n_midi]->read ());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_meter_bank.read (type, n - n_midi));
 				}
 			}
 			break;
@@ -387,8 +345,8 @@ PeakMeter::meter_level (uint32_t n, MeterType type)
 		case MeterIEC1NOR:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_iec1meter)) {
-					return accurate_coefficient_to_dB (_iec1meter[n - n_midi]->read ());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_meter_bank.read (type, n - n_midi));
 				}
 			}
 			break;
@@ -396,16 +354,16 @@ PeakMeter::meter_level (uint32_t n, MeterType type)
 		case MeterIEC2EBU:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_iec2meter)) {
-					return accurate_coefficient_to_dB (_iec2meter[n - n_midi]->read ());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_meter_bank.read (type, n - n_midi));
 				}
 			}
 			break;
 		case MeterVU:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_vumeter)) {
-					return accurate_coefficient_to_dB (_vumeter[n - n_midi]->read ());
+				if (CHECKSIZE) {
+					return accurate_coefficient_to_dB (_meter_bank.read (type, n - n_midi));
 				}
 			}
 			break;
@@ -453,30 +411,8 @@ PeakMeter::set_meter_type (MeterType t)
 
 	_meter_type = t;
 
-	if (t & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_kmeter[n]->reset ();
-		}
-	}
-	if (t & (MeterIEC1DIN | MeterIEC1NOR)) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec1meter[n]->reset ();
-		}
-	}
-	if (t & (MeterIEC2BBC | MeterIEC2EBU)) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec2meter[n]->reset ();
-		}
-	}
-	if (t & MeterVU) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_vumeter[n]->reset ();
-		}
-	}
+	/* only reset the meters that are used from now on */
+	_meter_bank.reset (t);
 
 	MeterTypeChanged (t); /* EMIT SIGNAL */
 }
@@ -0,0 +1,338 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ardour/meter_bank.h"
+#include "ardour/runtime_functions.h"
+
+using namespace ARDOUR;
+
+float MeterBank::_k_omega;
+float MeterBank::_iec1_w1;
+float MeterBank::_iec1_w2;
+float MeterBank::_iec1_w3;
+float MeterBank::_iec1_g;
+float MeterBank::_iec2_w1;
+float MeterBank::_iec2_w2;
+float MeterBank::_iec2_w3;
+float MeterBank::_iec2_g;
+float MeterBank::_vu_w;
+float MeterBank::_vu_g;
+
+static inline float
+clamp (float x, float lo, float hi)
+{
+	return x > hi ? hi : (x < lo ? lo : x);
+}
+
+/** Filter state of one group of channels, as passed to the *_bank () routines.
+ * A partial group runs in a copy, padded by repeating its last channel, so
+ * that the padding lanes never touch the state of other channels.
+ */
+class MeterBank::Group
+{
+public:
+	Group (State& st, uint32_t c, uint32_t nc)
+		: n (nc)
+		, _st (st)
+		, _c (c)
+	{
+		if (n == lanes) {
+			z1 = &st.z1[c];
+			z2 = &st.z2[c];
+			m  = &st.m[c];
+			return;
+		}
+		for (uint32_t l = 0; l < lanes; ++l) {
+			uint32_t const i = c + std::min (l, n - 1);
+			_z1[l] = st.z1[i];
+			_z2[l] = st.z2[i];
+			_m[l]  = st.m[i];
+		}
+		z1 = _z1;
+		z2 = _z2;
+		m  = _m;
+	}
+
+	~Group ()
+	{
+		if (n == lanes) {
+			return;
+		}
+		for (uint32_t l = 0; l < n; ++l) {
+			_st.z1[_c + l] = _z1[l];
+			_st.z2[_c + l] = _z2[l];
+			_st.m[_c + l]  = _m[l];
+		}
+	}
+
+	uint32_t const n;
+	float*         z1;
+	float*         z2;
+	float*         m;
+
+private:
+	State&         _st;
+	uint32_t const _c;
+	float          _z1[lanes];
+	float          _z2[lanes];
+	float          _m[lanes];
+};
+
+MeterBank::MeterBank ()
+	: _n_channels (0)
+{
+}
+
+void
+MeterBank::init (float fsamp)
+{
+	/* same ballistics as Kmeterdsp, Iec1ppmdsp, Iec2ppmdsp and Vumeterdsp */
+	_k_omega = 9.72f / fsamp;
+
+	_iec1_w1 = 450.0f / fsamp;
+	_iec1_w2 = 1300.0f / fsamp;
+	_iec1_w3 = 1.0f - 5.4f / fsamp;
+	_iec1_g  = 0.5108f;
+
+	_iec2_w1 = 200.0f / fsamp;
+	_iec2_w2 = 860.0f / fsamp;
+	_iec2_w3 = 1.0f - 4.0f / fsamp;
+	_iec2_g  = 0.5141f;
+
+	_vu_w = 11.1f / fsamp;
+	_vu_g = 1.5f * 1.571f;
+}
+
+void
+MeterBank::State::resize (uint32_t n)
+{
+	z1.resize (n);
+	z2.resize (n);
+	m.resize (n);
+	res.resize (n);
+}
+
+void
+MeterBank::State::reset (bool r)
+{
+	std::fill (z1.begin (), z1.end (), 0.f);
+	std::fill (z2.begin (), z2.end (), 0.f);
+	std::fill (m.begin (), m.end (), 0.f);
+	std::fill (res.begin (), res.end (), r ? 1 : 0);
+}
+
+void
+MeterBank::set_channels (uint32_t n)
+{
+	_n_channels = n;
+
+	_kmeter.resize (n);
+	_iec1.resize (n);
+	_iec2.resize (n);
+	_vu.resize (n);
+
+	reset ();
+}
+
+void
+MeterBank::reset ()
+{
+	reset (MeterType (MeterKrms | MeterIEC1DIN | MeterIEC2BBC | MeterVU));
+}
+
+void
+MeterBank::reset (MeterType types)
+{
+	if (types & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
+		_kmeter.reset (false);
+	}
+	if (types & (MeterIEC1DIN | MeterIEC1NOR)) {
+		_iec1.reset (true);
+	}
+	if (types & (MeterIEC2BBC | MeterIEC2EBU)) {
+		_iec2.reset (true);
+	}
+	if (types & MeterVU) {
+		_vu.reset (true);
+	}
+}
+
+void
+MeterBank::process (MeterType types, Sample const* const* bufs, uint32_t n_bufs, pframes_t nframes)
+{
+	bool const k    = types & (MeterKrms | MeterK20 | MeterK14 | MeterK12);
+	bool const iec1 = types & (MeterIEC1DIN | MeterIEC1NOR);
+	bool const iec2 = types & (MeterIEC2BBC | MeterIEC2EBU);
+	bool const vu   = types & MeterVU;
+
+	if (!(k || iec1 || iec2 || vu)) {
+		return;
+	}
+
+	uint32_t const n = std::min (n_bufs, _n_channels);
+
+	/* channels without data (n_bufs < n_channels) keep their state */
+	for (uint32_t c = 0; c < n; c += lanes) {
+		uint32_t const nc = n - c < lanes ? n - c : lanes;
+
+		/* pad the last group by repeating its last channel */
+		Sample const* group[lanes];
+		for (uint32_t l = 0; l < lanes; ++l) {
+			group[l] = bufs[c + std::min (l, nc - 1)];
+		}
+
+		if (k) {
+			kmeter (c, nc, group, nframes);
+		}
+		if (iec1) {
+			iecppm (_iec1, _iec1_w1, _iec1_w2, _iec1_w3, c, nc, group, nframes);
+		}
+		if (iec2) {
+			iecppm (_iec2, _iec2_w1, _iec2_w2, _iec2_w3, c, nc, group, nframes);
+		}
+		if (vu) {
+			vumeter (c, nc, group, nframes);
+		}
+	}
+}
+
+void
+MeterBank::kmeter (uint32_t c, uint32_t nc, Sample const* const* bufs, pframes_t nframes)
+{
+	Group  g (_kmeter, c, nc);
+	float* z1 = g.z1;
+	float* z2 = g.z2;
+	float* m  = g.m;
+
+	for (uint32_t l = 0; l < lanes; ++l) {
+		z1[l] = clamp (z1[l], 0, 50);
+		z2[l] = clamp (z2[l], 0, 50);
+	}
+
+	kmeter_bank (z1, z2, bufs, nc, nframes, _k_omega);
+
+	for (uint32_t l = 0; l < nc; ++l) {
+		if (std::isnan (z1[l])) z1[l] = 0;
+		if (std::isnan (z2[l])) z2[l] = 0;
+
+		float const s = sqrtf (2.0f * z2[l]);
+
+		/* The added constants avoid denormals. */
+		z1[l] += 1e-20f;
+		z2[l] += 1e-20f;
+
+		float& rms = m[l];
+		if (_kmeter.res[c + l]) {
+			/* Display thread has read the rms value. */
+			rms                = s;
+			_kmeter.res[c + l] = 0;
+		} else if (s > rms) {
+			rms = s;
+		}
+	}
+}
+
+void
+MeterBank::iecppm (State& st, float w1, float w2, float w3, uint32_t c, uint32_t nc, Sample const* const* bufs, pframes_t nframes)
+{
+	Group  g (st, c, nc);
+	float* z1 = g.z1;
+	float* z2 = g.z2;
+	float* m  = g.m;
+
+	for (uint32_t l = 0; l < lanes; ++l) {
+		z1[l] = clamp (z1[l], 0, 20);
+		z2[l] = clamp (z2[l], 0, 20);
+	}
+	for (uint32_t l = 0; l < nc; ++l) {
+		if (st.res[c + l]) {
+			m[l]          = 0;
+			st.res[c + l] = 0;
+		}
+	}
+
+	iecppm_bank (z1, z2, m, bufs, nc, nframes, w1, w2, w3);
+
+	for (uint32_t l = 0; l < nc; ++l) {
+		z1[l] += 1e-10f;
+		z2[l] += 1e-10f;
+	}
+}
+
+void
+MeterBank::vumeter (uint32_t c, uint32_t nc, Sample const* const* bufs, pframes_t nframes)
+{
+	Group  g (_vu, c, nc);
+	float* z1 = g.z1;
+	float* z2 = g.z2;
+	float* m  = g.m;
+
+	for (uint32_t l = 0; l < lanes; ++l) {
+		z1[l] = clamp (z1[l], -20, 20);
+		z2[l] = clamp (z2[l], -20, 20);
+	}
+	for (uint32_t l = 0; l < nc; ++l) {
+		if (_vu.res[c + l]) {
+			m[l]           = 0;
+			_vu.res[c + l] = 0;
+		}
+	}
+
+	vumeter_bank (z1, z2, m, bufs, nc, nframes, _vu_w);
+
+	for (uint32_t l = 0; l < nc; ++l) {
+		if (std::isnan (z1[l])) z1[l] = 0;
+		if (std::isnan (z2[l])) z2[l] = 0;
+		z2[l] += 1e-10f;
+	}
+}
+
+float
+MeterBank::read (MeterType type, uint32_t chn)
+{
+	if (chn >= _n_channels) {
+		return 0;
+	}
+
+	switch (type) {
+		case MeterKrms:
+		case MeterK20:
+		case MeterK14:
+		case MeterK12:
+			{
+				float const rv = _kmeter.m[chn];
+				_kmeter.res[chn] = 1; // Resets rms in next process ().
+				return rv;
+			}
+		case MeterIEC1DIN:
+		case MeterIEC1NOR:
+			_iec1.res[chn] = 1;
+			return _iec1_g * _iec1.m[chn];
+		case MeterIEC2BBC:
+		case MeterIEC2EBU:
+			_iec2.res[chn] = 1;
+			return _iec2_g * _iec2.m[chn];
+		case MeterVU:
+			_vu.res[chn] = 1;
+			return _vu_g * _vu.m[chn];
+		default:
+			break;
+	}
+	return 0;
+}
@@ -1448,7 +1448,6 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 	TimeType ea  = note->end_time();
 
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<TimeType>(0, TimeType(), TimeType(), note->note()));
 	set<NotePtr> to_be_deleted;
 	bool set_note_length = false;
 	bool set_note_time = false;
@@ -1457,7 +1456,7 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 
 	DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 checking overlaps for note %2 @ %3\n", this, (int)note->note(), note->time()));
 
-	for (Pitches::const_iterator i = p.lower_bound (search_note);
+	for (Pitches::const_iterator i = p.lower_bound (search_note (TimeType(), note->note()));
 	     i != p.end() && (*i)->note() == note->note(); ++i) {
 
 		TimeType sb = (*i)->time();
@@ -1785,14 +1784,34 @@ MidiModel::create_mapping_stash (Temporal::Beats const & src_pos_offset)
 		return;
 	}
 
+	/* notes are sorted by start time, so converting all note-on times
+	 * in one batch is a single pass over the tempo map. Note-off times
+	 * are only roughly sorted, but batching them is never worse than
+	 * converting them one at a time.
+	 */
+
+	std::vector<Beats> on_times;
+	std::vector<Beats> off_times;
+	std::vector<superclock_t> on_audio_times;
+	std::vector<superclock_t> off_audio_times;
+
+	on_times.reserve (notes().size());
+	off_times.reserve (notes().size());
+
 	for (auto const & n : notes()) {
-		Event<Beats>& on (n->on_event());
-		superclock_t audio_time = tmap->superclock_at (src_pos_offset + on.time());
-		tempo_mapping_stash.insert (std::make_pair (&on, audio_time));
+		on_times.push_back (src_pos_offset + n->on_event().time());
+		off_times.push_back (src_pos_offset + n->off_event().time());
+	}
 
-		Event<Beats>& off (n->off_event());
-		audio_time = tmap->superclock_at (src_pos_offset + off.time());
-		tempo_mapping_stash.insert (std::make_pair (&off, audio_time));
+	tmap->superclocks_at (on_times, on_audio_times);
+	tmap->superclocks_at (off_times, off_audio_times);
+
+	size_t i = 0;
+
+	for (auto const & n : notes()) {
+		tempo_mapping_stash.insert (std::make_pair (&n->on_event(), on_audio_times[i]));
+		tempo_mapping_stash.insert (std::make_pair (&n->off_event(), off_audio_times[i]));
+		++i;
 	}
 
 	for (auto const & s : sysexes()) {
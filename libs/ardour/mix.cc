@@ -145,6 +145,143 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+void
+default_apply_gain_vector_to_buffer (ARDOUR::Sample * buf, const ARDOUR::gain_t * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= gain[i];
+	}
+}
+
+float
+default_apply_gain_ramp_to_buffer (ARDOUR::Sample * buf, pframes_t nframes, float gain, float target, float coeff)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		buf[i] *= gain;
+		gain += coeff * (target - gain);
+	}
+	return gain;
+}
+
+void
+default_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; i++) {
+		dst[i] += src[i] * gain[i];
+	}
+}
+
+/* Ballistic meter filters of n_chan (at most 4) channels, the same as Kmeterdsp,
+ * Iec1ppmdsp, Iec2ppmdsp and Vumeterdsp::process. Each state array holds one value
+ * per channel, clamping and denormal protection are up to the caller.
+ */
+void
+default_kmeter_bank (float* z1, float* z2, const ARDOUR::Sample* const* bufs, uint32_t n_chan, pframes_t nframes, float omega)
+{
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		const ARDOUR::Sample* p = bufs[c];
+		float s, a = z1[c], b = z2[c];
+		for (pframes_t n = nframes / 4; n > 0; --n) {
+			s = *p++; s *= s; a += omega * (s - a);
+			s = *p++; s *= s; a += omega * (s - a);
+			s = *p++; s *= s; a += omega * (s - a);
+			s = *p++; s *= s; a += omega * (s - a);
+			b += 4 * omega * (a - b);
+		}
+		z1[c] = a;
+		z2[c] = b;
+	}
+}
+
+void
+default_iecppm_bank (float* z1, float* z2, float* m, const ARDOUR::Sample* const* bufs, uint32_t n_chan, pframes_t nframes, float w1, float w2, float w3)
+{
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		const ARDOUR::Sample* p = bufs[c];
+		float t, a = z1[c], b = z2[c], mx = m[c];
+		for (pframes_t n = nframes / 4; n > 0; --n) {
+			a *= w3;
+			b *= w3;
+			for (int i = 0; i < 4; ++i) {
+				t = fabsf (*p++);
+				if (t > a) a += w1 * (t - a);
+				if (t > b) b += w2 * (t - b);
+			}
+			t = a + b;
+			if (t > mx) mx = t;
+		}
+		z1[c] = a;
+		z2[c] = b;
+		m[c]  = mx;
+	}
+}
+
+void
+default_vumeter_bank (float* z1, float* z2, float* m, const ARDOUR::Sample* const* bufs, uint32_t n_chan, pframes_t nframes, float w)
+{
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		const ARDOUR::Sample* p = bufs[c];
+		float t, a = z1[c], b = z2[c], mx = m[c];
+		for (pframes_t n = nframes / 4; n > 0; --n) {
+			t = b / 2;
+			a += w * (fabsf (*p++) - t - a);
+			a += w * (fabsf (*p++) - t - a);
+			a += w * (fabsf (*p++) - t - a);
+			a += w * (fabsf (*p++) - t - a);
+			b += 4 * w * (a - b);
+			if (b > mx) mx = b;
+		}
+		z1[c] = a;
+		z2[c] = b;
+		m[c]  = mx;
+	}
+}
+
+template <typename T>
+static inline void
+default_float_to_int (T* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	int64_t const post_scale = (int64_t)1 << post_shift;
+
+	for (uint32_t i = 0; i < nframes; ++i) {
+		float tmp = src[i] * scale;
+		if (noise) {
+			tmp -= noise[i];
+		}
+		int64_t clamped = lrintf (tmp);
+		if (clamped > clamp_u) {
+			clamped = clamp_u;
+		} else if (clamped < clamp_l) {
+			clamped = clamp_l;
+		}
+		dst[i] = (T) (clamped * post_scale);
+	}
+}
+
+void
+default_float_to_int16 (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	default_float_to_int<int16_t> (dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+void
+default_float_to_int32 (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	default_float_to_int<int32_t> (dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+void
+default_clip_floats (float* buf, uint32_t nframes)
+{
+	for (uint32_t i = 0; i < nframes; ++i) {
+		if (buf[i] > 1.0f) {
+			buf[i] = 1.0f;
+		} else if (buf[i] < -1.0f) {
+			buf[i] = -1.0f;
+		}
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
@@ -187,6 +324,18 @@ veclib_mix_buffers_no_gain (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pf
 	vDSP_vsma(src, 1, &gain, dst, 1, dst, 1, nframes);
 }
 
+void
+veclib_apply_gain_vector_to_buffer (ARDOUR::Sample * buf, const ARDOUR::gain_t * gain, pframes_t nframes)
+{
+	vDSP_vmul(buf, 1, gain, 1, buf, 1, nframes);
+}
+
+void
+veclib_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const ARDOUR::gain_t * gain, pframes_t nframes)
+{
+	vDSP_vma(src, 1, gain, 1, dst, 1, dst, 1, nframes);
+}
+
 #endif
 
 
@@ -0,0 +1,214 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ardour/offline_port_engine.h"
+#include "ardour/port.h"
+#include "ardour/runtime_functions.h"
+
+using namespace ARDOUR;
+
+OfflinePortEngine::OfflinePortEngine (PortManager& pm, PortEngine& backend)
+	: PortEngine (pm)
+	, _backend (backend)
+	, _nframes (0)
+{
+}
+
+OfflinePortEngine::~OfflinePortEngine ()
+{
+	drop_buffers ();
+}
+
+void
+OfflinePortEngine::drop_buffers ()
+{
+	for (Buffers::iterator i = _buffers.begin (); i != _buffers.end (); ++i) {
+		delete i->second;
+	}
+	_buffers.clear ();
+}
+
+void
+OfflinePortEngine::start (PortManager::Ports const& ports, pframes_t nframes)
+{
+	drop_buffers ();
+
+	_nframes = nframes;
+	_silence.assign (nframes, 0);
+
+	for (PortManager::Ports::const_iterator p = ports.begin (); p != ports.end (); ++p) {
+		PortHandle ph (p->second->port_handle ());
+		if (!ph) {
+			continue;
+		}
+		Buffer* b = new Buffer;
+		b->type   = p->second->type ();
+		b->input  = p->second->receives_input ();
+		if (b->type == DataType::AUDIO) {
+			b->audio.assign (nframes, 0);
+		} else {
+			b->midi.events.reserve (512);
+			b->midi.data.reserve (4096);
+		}
+		_buffers[ph.get ()] = b;
+	}
+
+	/* Connections between our own ports, the sources of every input */
+	for (PortManager::Ports::const_iterator p = ports.begin (); p != ports.end (); ++p) {
+		PortHandle ph (p->second->port_handle ());
+		if (!ph || !p->second->receives_input ()) {
+			continue;
+		}
+		Buffer* b = _buffers[ph.get ()];
+
+		std::vector<std::string> connections;
+		_backend.get_connections (ph, connections);
+
+		for (std::vector<std::string>::const_iterator c = connections.begin (); c != connections.end (); ++c) {
+			PortPtr src = _backend.get_port_by_name (*c);
+			Buffers::const_iterator i = src ? _buffers.find (src.get ()) : _buffers.end ();
+			if (i != _buffers.end () && !i->second->input && i->second->type == b->type) {
+				b->sources.push_back (i->second);
+			}
+		}
+	}
+}
+
+void
+OfflinePortEngine::stop ()
+{
+	drop_buffers ();
+	_silence.clear ();
+}
+
+void*
+OfflinePortEngine::get_buffer (PortHandle ph, pframes_t)
+{
+	Buffers::const_iterator i = _buffers.find (ph.get ());
+
+	if (i == _buffers.end ()) {
+		/* not one of ours, or added after rendering started */
+		if (_backend.port_data_type (ph) == DataType::AUDIO) {
+			memset (&_silence[0], 0, sizeof (Sample) * _nframes);
+			return &_silence[0];
+		}
+		return 0;
+	}
+
+	Buffer& b (*i->second);
+
+	if (b.type == DataType::AUDIO) {
+		return b.input ? mix_audio (b) : &b.audio[0];
+	} else {
+		return b.input ? mix_midi (b) : &b.midi;
+	}
+}
+
+void*
+OfflinePortEngine::mix_audio (Buffer& b)
+{
+	/* Like backends do, use the source's buffer directly if there is
+	 * only one. Inputs are mixed every time they are requested, since
+	 * the process graph only reads them after their sources were written.
+	 */
+	if (b.sources.size () == 1) {
+		return &b.sources.front ()->audio[0];
+	}
+
+	if (b.sources.empty ()) {
+		memset (&b.audio[0], 0, sizeof (Sample) * _nframes);
+	} else {
+		copy_vector (&b.audio[0], &b.sources.front ()->audio[0], _nframes);
+		for (std::vector<Buffer*>::const_iterator s = b.sources.begin () + 1; s != b.sources.end (); ++s) {
+			mix_buffers_no_gain (&b.audio[0], &(*s)->audio[0], _nframes);
+		}
+	}
+	return &b.audio[0];
+}
+
+void*
+OfflinePortEngine::mix_midi (Buffer& b)
+{
+	if (b.sources.size () == 1) {
+		return &b.sources.front ()->midi;
+	}
+
+	b.midi.clear ();
+
+	for (std::vector<Buffer*>::const_iterator s = b.sources.begin (); s != b.sources.end (); ++s) {
+		MidiData const& src ((*s)->midi);
+		for (std::vector<MidiData::Event>::const_iterator e = src.events.begin (); e != src.events.end (); ++e) {
+			b.midi.events.push_back (MidiData::Event (e->time, b.midi.data.size (), e->size));
+			b.midi.data.insert (b.midi.data.end (), src.data.begin () + e->offset, src.data.begin () + e->offset + e->size);
+		}
+	}
+
+	if (b.sources.size () > 1) {
+		std::stable_sort (b.midi.events.begin (), b.midi.events.end (),
+		                  [] (MidiData::Event const& x, MidiData::Event const& y) { return x.time < y.time; });
+	}
+
+	return &b.midi;
+}
+
+int
+OfflinePortEngine::midi_event_get (pframes_t& timestamp, size_t& size, uint8_t const** buf, void* port_buffer, uint32_t event_index)
+{
+	MidiData const* m = static_cast<MidiData const*> (port_buffer);
+	if (!m || event_index >= m->events.size ()) {
+		return -1;
+	}
+	MidiData::Event const& e (m->events[event_index]);
+	timestamp = e.time;
+	size      = e.size;
+	*buf      = &m->data[e.offset];
+	return 0;
+}
+
+int
+OfflinePortEngine::midi_event_put (void* port_buffer, pframes_t timestamp, const uint8_t* buffer, size_t size)
+{
+	MidiData* m = static_cast<MidiData*> (port_buffer);
+	if (!m || size == 0) {
+		return -1;
+	}
+	if (!m->events.empty () && m->events.back ().time > timestamp) {
+		/* events must be added in order, like JACK */
+		return -1;
+	}
+	m->events.push_back (MidiData::Event (timestamp, m->data.size (), size));
+	m->data.insert (m->data.end (), buffer, buffer + size);
+	return 0;
+}
+
+uint32_t
+OfflinePortEngine::get_midi_event_count (void* port_buffer)
+{
+	MidiData const* m = static_cast<MidiData const*> (port_buffer);
+	return m ? m->events.size () : 0;
+}
+
+void
+OfflinePortEngine::midi_clear (void* port_buffer)
+{
+	MidiData* m = static_cast<MidiData*> (port_buffer);
+	if (m) {
+		m->clear ();
+	}
+}
@@ -250,7 +250,8 @@ PortManager::PortMetaData::PortMetaData (XMLNode const& node)
 /* ****************************************************************************/
 
 PortManager::PortManager ()
-	: _ports (new Ports)
+	: _offline_port_engine (0)
+	, _ports (new Ports, true)
 	, _port_remove_in_progress (false)
 	, _port_deletions_pending (8192) /* ick, arbitrary sizing */
 	, _midi_info_dirty (true)
@@ -1290,23 +1291,81 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 		tl = s->rt_tasklist ();
 	}
 	if (tl && fabs (Port::resample_ratio ()) != 1.0) {
-		for (auto const& p : *_cycle_ports) {
-			if (!(p.second->flags () & TransportSyncPort)) {
-				tl->push_back (boost::bind (&Port::cycle_start, p.second, nframes));
-			}
+		Ports::const_iterator b = _cycle_ports->begin ();
+		while (b != _cycle_ports->end ()) {
+			Ports::const_iterator e = next_batch (b);
+			tl->push_back (boost::bind (&PortManager::cycle_start_ports, this, b, e, nframes));
+			b = e;
 		}
 		tl->push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
 		tl->process ();
 	} else {
-		for (auto const& p : *_cycle_ports) {
-			if (!(p.second->flags () & TransportSyncPort)) {
-				p.second->cycle_start (nframes);
-			}
-		}
+		cycle_start_ports (_cycle_ports->begin (), _cycle_ports->end (), nframes);
 		run_input_meters (nframes, s ? s->nominal_sample_rate () : 0);
 	}
 }
 
+/** Ports are processed in batches, so that resampling of audio ports
+ * can share the filter computation (see VMResampler::process).
+ * Batches are processed in parallel, if a tasklist is available.
+ */
+PortManager::Ports::const_iterator
+PortManager::next_batch (Ports::const_iterator i) const
+{
+	for (uint32_t n = 0; n < ArdourZita::VMResampler::MAXSYNC && i != _cycle_ports->end (); ++n) {
+		++i;
+	}
+	return i;
+}
+
+void
+PortManager::cycle_start_ports (Ports::const_iterator b, Ports::const_iterator e, pframes_t nframes)
+{
+	AudioPort* audio[ArdourZita::VMResampler::MAXSYNC];
+	uint32_t   n_audio = 0;
+
+	for (; b != e; ++b) {
+		if (b->second->flags () & TransportSyncPort) {
+			continue;
+		}
+		if (b->second->type () != DataType::AUDIO) {
+			b->second->cycle_start (nframes);
+			continue;
+		}
+		audio[n_audio++] = static_cast<AudioPort*> (b->second.get ());
+		if (n_audio == ArdourZita::VMResampler::MAXSYNC) {
+			AudioPort::cycle_start_batch (audio, n_audio, nframes);
+			n_audio = 0;
+		}
+	}
+
+	AudioPort::cycle_start_batch (audio, n_audio, nframes);
+}
+
+void
+PortManager::cycle_end_ports (Ports::const_iterator b, Ports::const_iterator e, pframes_t nframes)
+{
+	AudioPort* audio[ArdourZita::VMResampler::MAXSYNC];
+	uint32_t   n_audio = 0;
+
+	for (; b != e; ++b) {
+		if (b->second->flags () & TransportSyncPort) {
+			continue;
+		}
+		if (b->second->type () != DataType::AUDIO) {
+			b->second->cycle_end (nframes);
+			continue;
+		}
+		audio[n_audio++] = static_cast<AudioPort*> (b->second.get ());
+		if (n_audio == ArdourZita::VMResampler::MAXSYNC) {
+			AudioPort::cycle_end_batch (audio, n_audio, nframes);
+			n_audio = 0;
+		}
+	}
+
+	AudioPort::cycle_end_batch (audio, n_audio, nframes);
+}
+
 void
 PortManager::cycle_end (pframes_t nframes, Session* s)
 {
@@ -1316,18 +1375,15 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 		tl = s->rt_tasklist ();
 	}
 	if (tl && fabs (Port::resample_ratio ()) != 1.0) {
-		for (auto const& p : *_cycle_ports) {
-			if (!(p.second->flags () & TransportSyncPort)) {
-				tl->push_back (boost::bind (&Port::cycle_end, p.second, nframes));
-			}
+		Ports::const_iterator b = _cycle_ports->begin ();
+		while (b != _cycle_ports->end ()) {
+			Ports::const_iterator e = next_batch (b);
+			tl->push_back (boost::bind (&PortManager::cycle_end_ports, this, b, e, nframes));
+			b = e;
 		}
 		tl->process ();
 	} else {
-		for (auto const& p : *_cycle_ports) {
-			if (!(p.second->flags () & TransportSyncPort)) {
-				p.second->cycle_end (nframes);
-			}
-		}
+		cycle_end_ports (_cycle_ports->begin (), _cycle_ports->end (), nframes);
 	}
 
 	for (auto const& p : *_cycle_ports) {
@@ -1410,6 +1466,31 @@ PortManager::silence_outputs (pframes_t nframes)
 	}
 }
 
+/** Silence the backend buffers of all our output ports, without using
+ * port_engine() and without allocating memory. This is used while the
+ * session is processed elsewhere (see AudioEngine::start_offline_render()).
+ */
+void
+PortManager::silence_backend_outputs (pframes_t nframes)
+{
+	std::shared_ptr<Ports const> plist = _ports.reader ();
+
+	for (Ports::const_iterator p = plist->begin (); p != plist->end (); ++p) {
+		if (!p->second->sends_output () || !p->second->port_handle ()) {
+			continue;
+		}
+		void* buf = _backend->get_buffer (p->second->port_handle (), nframes);
+		if (!buf) {
+			continue;
+		}
+		if (p->second->type () == DataType::AUDIO) {
+			memset (buf, 0, sizeof (float) * nframes);
+		} else if (p->second->type () == DataType::MIDI) {
+			_backend->midi_clear (buf);
+		}
+	}
+}
+
 void
 PortManager::check_monitoring ()
 {
@@ -1434,18 +1515,15 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 		tl = s->rt_tasklist ();
 	}
 	if (tl && fabs (Port::resample_ratio ()) != 1.0) {
-		for (auto const& p : *_cycle_ports) {
-			if (!(p.second->flags () & TransportSyncPort)) {
-				tl->push_back (boost::bind (&Port::cycle_end, p.second, nframes));
-			}
+		Ports::const_iterator b = _cycle_ports->begin ();
+		while (b != _cycle_ports->end ()) {
+			Ports::const_iterator e = next_batch (b);
+			tl->push_back (boost::bind (&PortManager::cycle_end_ports, this, b, e, nframes));
+			b = e;
 		}
 		tl->process ();
 	} else {
-		for (auto const& p : *_cycle_ports) {
-			if (!(p.second->flags () & TransportSyncPort)) {
-				p.second->cycle_end (nframes);
-			}
-		}
+		cycle_end_ports (_cycle_ports->begin (), _cycle_ports->end (), nframes);
 	}
 
 	for (auto const& p : *_cycle_ports) {
@@ -1471,6 +1549,10 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 PortEngine&
 PortManager::port_engine ()
 {
+	PortEngine* pe = _offline_port_engine.load (std::memory_order_acquire);
+	if (pe) {
+		return *pe;
+	}
 	assert (_backend);
 	return *_backend;
 }
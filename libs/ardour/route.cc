@@ -137,6 +137,7 @@ Route::Route (Session& sess, string name, PresentationInfo::Flag flag, DataType
 	, _in_configure_processors (false)
 	, _initial_io_setup (false)
 	, _in_sidechain_setup (false)
+	, _defer_plugins (false)
 	, _monitor_gain (0)
 	, _custom_meter_position_noted (false)
 	, _pinmgr_proxy (0)
@@ -950,6 +951,88 @@ Route::processor_selfdestruct (std::weak_ptr<Processor> wp)
 	selfdestruct_sequence.push_back (wp);
 }
 
+/** Replace the stubs of plugins that were not instantiated while the route
+ * was inactive with the actual plugins.
+ */
+void
+Route::instantiate_deferred_processors ()
+{
+	ProcessorList deferred;
+
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
+		for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+			if (std::dynamic_pointer_cast<DeferredProcessor> (*i)) {
+				deferred.push_back (*i);
+			}
+		}
+	}
+
+	if (deferred.empty ()) {
+		return;
+	}
+
+	/* instantiate the plugins without holding the process lock */
+
+	Temporal::TimeDomainProvider const & tdp (*this);
+	std::vector<std::pair<std::shared_ptr<Processor>, std::shared_ptr<Processor> > > subs;
+
+	for (ProcessorList::const_iterator i = deferred.begin(); i != deferred.end(); ++i) {
+		std::shared_ptr<DeferredProcessor> stub = std::dynamic_pointer_cast<DeferredProcessor> (*i);
+		std::shared_ptr<Processor> processor (new PluginInsert (_session, tdp));
+
+		processor->set_owner (this);
+
+		if (processor->set_state (stub->saved_state (), stub->saved_version ()) != 0) {
+			processor.reset (new UnknownProcessor (_session, stub->saved_state (), this));
+		}
+
+		std::shared_ptr<PluginInsert> pi = std::dynamic_pointer_cast<PluginInsert> (processor);
+		if (pi && _strict_io) {
+			pi->set_strict_io (true);
+		}
+
+		if (pi && pi->has_sidechain ()) {
+			pi->sidechain_input ()->changed.connect_same_thread (*pi, boost::bind (&Route::sidechain_change_handler, this, _1, _2));
+		}
+
+		subs.push_back (std::make_pair (*i, processor));
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
+		Glib::Threads::RWLock::WriterLock lm (_processor_lock);
+
+		for (std::vector<std::pair<std::shared_ptr<Processor>, std::shared_ptr<Processor> > >::const_iterator s = subs.begin (); s != subs.end (); ++s) {
+			ProcessorList::iterator i = find (_processors.begin(), _processors.end(), s->first);
+			if (i != _processors.end ()) {
+				*i = s->second;
+				s->second->ActiveChanged.connect_same_thread (*s->second, boost::bind (&Session::queue_latency_recompute, &_session));
+			}
+		}
+
+		configure_processors_unlocked (0, &lm);
+
+		for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+			std::shared_ptr<PluginInsert> pi;
+			if ((pi = std::dynamic_pointer_cast<PluginInsert>(*i)) != 0) {
+				if (pi->has_no_inputs ()) {
+					_have_internal_generator = true;
+					break;
+				}
+			}
+		}
+	}
+
+	for (ProcessorList::const_iterator i = deferred.begin(); i != deferred.end(); ++i) {
+		(*i)->drop_references ();
+	}
+
+	reset_instrument_info ();
+	processors_changed (RouteProcessorChange ()); /* EMIT SIGNAL */
+	set_processor_positions ();
+}
+
 bool
 Route::add_processor_from_xml_2X (const XMLNode& node, int version)
 {
@@ -2826,8 +2909,16 @@ Route::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	/* plugins of inactive routes are only instantiated when
+	 * the route is activated, see ::set_active()
+	 */
+	bool is_active;
+	_defer_plugins = Config->get_defer_plugin_instantiation () && node.get_property (X_("active"), is_active) && !is_active;
+
 	set_processor_state (processor_state, version);
 
+	_defer_plugins = false;
+
 	// this looks up the internal instrument in processors
 	reset_instrument_info();
 
@@ -2850,7 +2941,6 @@ Route::set_state (const XMLNode& node, int version)
 		_phase_control->set_phase_invert (boost::dynamic_bitset<> (phase_invert_str));
 	}
 
-	bool is_active;
 	if (node.get_property (X_("active"), is_active)) {
 		set_active (is_active, this);
 	}
@@ -3327,6 +3417,8 @@ Route::set_processor_state (XMLNode const& node, int version, XMLProperty const*
 
 			if (_session.get_disable_all_loaded_plugins ()) {
 				processor.reset (new UnknownProcessor (_session, node, this));
+			} else if (_defer_plugins) {
+				processor.reset (new DeferredProcessor (_session, node, this));
 			} else {
 				processor.reset (new PluginInsert (_session, tdp));
 				processor->set_owner (this);
@@ -4842,6 +4934,9 @@ Route::set_active (bool yn, void* src)
 	}
 
 	if (_active != yn) {
+		if (yn) {
+			instantiate_deferred_processors ();
+		}
 		_active = yn;
 		_input->set_active (yn);
 		_output->set_active (yn);
@@ -5070,6 +5165,9 @@ Route::unknown_processors () const
 
 	Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
 	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+		if (std::dynamic_pointer_cast<DeferredProcessor const> (*i)) {
+			continue;
+		}
 		if (std::dynamic_pointer_cast<UnknownProcessor const> (*i)) {
 			p.push_back ((*i)->name ());
 		}
@@ -254,6 +254,11 @@ Session::Session (AudioEngine &eng,
 	, _state_of_the_state (StateOfTheState (CannotSave | InitialConnecting | Loading))
 	, _save_queued (false)
 	, _save_queued_pending (false)
+	, _state_writer (0)
+	, _state_write_queued (0)
+	, _state_write_last (0)
+	, _state_writing (false)
+	, _state_writer_quit (false)
 	, _last_roll_location (0)
 	, _last_roll_or_reversal_location (0)
 	, _last_record_location (0)
@@ -307,7 +312,7 @@ Session::Session (AudioEngine &eng,
 	, midi_control_ui (0)
 	, _punch_or_loop (NoConstraint)
 	, _all_route_group (new RouteGroup (*this, "all"))
-	, routes (new RouteList)
+	, routes (new RouteList, true)
 	, _adding_routes_in_progress (false)
 	, _reconnecting_routes_in_progress (false)
 	, _route_deletion_in_progress (false)
@@ -647,6 +652,7 @@ Session::destroy ()
 	 */
 
 	remove_pending_capture_state ();
+	stop_state_writer ();
 
 	Analyser::flush ();
 
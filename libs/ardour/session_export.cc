@@ -232,6 +232,9 @@ Session::start_audio_export (samplepos_t position, bool realtime, bool region_ex
 		export_status->stop = false;
 		_engine.Freewheel.connect_same_thread (export_freewheel_connection, boost::bind (&Session::process_export_fw, this, _1));
 		reset_xrun_count ();
+		if (Config->get_offline_export_render ()) {
+			return _engine.start_offline_render ();
+		}
 		return _engine.freewheel (true);
 	}
 }
@@ -39,6 +39,7 @@
 
 #include "ardour/audioengine.h"
 #include "ardour/auditioner.h"
+#include "ardour/automation_prerender.h"
 #include "ardour/butler.h"
 #include "ardour/cycle_timer.h"
 #include "ardour/debug.h"
@@ -264,6 +265,10 @@ Session::process_routes (pframes_t nframes, bool& need_butler)
 		(*i)->automation_run (start_sample, nframes);
 	}
 
+	if (AutomationPrerender::refill_wanted ()) {
+		need_butler = true;
+	}
+
 	_global_locate_pending = locate_pending();
 
 	std::shared_ptr<GraphChain> graph_chain = _graph_chain;
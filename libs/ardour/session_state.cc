@@ -39,6 +39,7 @@
 #include <cerrno>
 #include <cstdio> /* snprintf(3) ... grrr */
 #include <cmath>
+#include <memory>
 
 #include <unistd.h>
 #include <climits>
@@ -78,6 +79,7 @@
 #include "evoral/SMF.h"
 
 #include "pbd/basename.h"
+#include "pbd/cpus.h"
 #include "pbd/debug.h"
 #include "pbd/enumwriter.h"
 #include "pbd/error.h"
@@ -104,6 +106,7 @@
 #include "ardour/debug.h"
 #include "ardour/directory_names.h"
 #include "ardour/disk_reader.h"
+#include "ardour/file_source.h"
 #include "ardour/filename_extensions.h"
 #include "ardour/graph.h"
 #include "ardour/io_plug.h"
@@ -195,6 +198,7 @@ Session::pre_engine_init (string fullpath)
 	last_rr_session_dir = session_dirs.begin();
 
 	set_history_depth (Config->get_history_depth());
+	setup_history_spill ();
 
 	/* default: assume simple stereo speaker configuration */
 
@@ -679,6 +683,8 @@ Session::maybe_write_autosave()
 void
 Session::remove_pending_capture_state ()
 {
+	cancel_state_writes ();
+
 	std::string pending_state_file_path(_session_dir->root_path());
 
 	pending_state_file_path = Glib::build_filename (pending_state_file_path, legalize_for_path (_current_snapshot_name) + pending_suffix);
@@ -698,6 +704,159 @@ Session::remove_pending_capture_state ()
 #endif
 }
 
+void
+Session::queue_state_write (XMLTree* tree)
+{
+	Glib::Threads::Mutex::Lock lm (_state_write_lock);
+
+	if (!_state_writer) {
+		_state_writer_quit = false;
+		_state_writer = PBD::Thread::create (boost::bind (&Session::state_writer_thread, this), "StateWriter");
+	}
+
+	if (!_state_writer) {
+		lm.release ();
+		write_state_file (*tree, tree->filename ());
+		delete tree;
+		return;
+	}
+
+	/* only the most recent state is of interest */
+	delete _state_write_queued;
+	_state_write_queued = tree;
+	_state_write_cond.broadcast ();
+}
+
+/** Discard state that has not been written yet, and wait for a write in progress to complete */
+void
+Session::cancel_state_writes ()
+{
+	Glib::Threads::Mutex::Lock lm (_state_write_lock);
+
+	delete _state_write_queued;
+	_state_write_queued = 0;
+
+	while (_state_writing) {
+		_state_write_cond.wait (_state_write_lock);
+	}
+}
+
+void
+Session::stop_state_writer ()
+{
+	if (!_state_writer) {
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (_state_write_lock);
+		_state_writer_quit = true;
+		_state_write_cond.broadcast ();
+	}
+
+	_state_writer->join ();
+	delete _state_writer;
+	_state_writer = 0;
+
+	delete _state_write_last;
+	_state_write_last = 0;
+}
+
+void
+Session::state_writer_thread ()
+{
+	Glib::Threads::Mutex::Lock lm (_state_write_lock);
+
+	while (true) {
+
+		while (!_state_write_queued && !_state_writer_quit) {
+			_state_write_cond.wait (_state_write_lock);
+		}
+
+		/* write anything that is still queued before quitting */
+		if (!_state_write_queued) {
+			break;
+		}
+
+		XMLTree* tree = _state_write_queued;
+		_state_write_queued = 0;
+		_state_writing = true;
+
+		lm.release ();
+
+		/* skip writing if the state is identical to what was last
+		 * written to the same file, and that is still there.
+		 */
+		bool const unchanged = _state_write_last
+			&& _state_write_last->filename () == tree->filename ()
+			&& *_state_write_last->root () == *tree->root ()
+			&& Glib::file_test (tree->filename (), Glib::FILE_TEST_EXISTS);
+
+		if (unchanged) {
+			DEBUG_TRACE (DEBUG::SaveState, string_compose ("state for '%1' is unchanged\n", tree->filename ()));
+			delete tree;
+		} else {
+			delete _state_write_last;
+			_state_write_last = 0;
+			if (write_state_file (*tree, tree->filename ())) {
+				_state_write_last = tree;
+			} else {
+				delete tree;
+			}
+		}
+
+		lm.acquire ();
+
+		_state_writing = false;
+		_state_write_cond.broadcast ();
+	}
+}
+
+/** Write @p tree to a temporary file, flush it to disk and atomically
+ * replace the file at @p xml_path with it.
+ */
+bool
+Session::write_state_file (XMLTree& tree, std::string const& xml_path)
+{
+	const std::string tmp_path = xml_path + temp_suffix;
+
+	DEBUG_TRACE (DEBUG::SaveState, string_compose ("writing state to '%1'\n", tmp_path));
+
+	bool ok = tree.write (tmp_path);
+	tree.set_filename (xml_path);
+
+	if (!ok) {
+		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
+		if (g_remove (tmp_path.c_str()) != 0) {
+			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
+					tmp_path, g_strerror (errno)) << endmsg;
+		}
+		return false;
+	}
+
+#ifndef PLATFORM_WINDOWS
+	int fd = g_open (tmp_path.c_str(), O_RDONLY, 0);
+	if (fd >= 0) {
+		::fsync (fd);
+		::close (fd);
+	}
+#endif
+
+	DEBUG_TRACE (DEBUG::SaveState, string_compose ("renaming state to '%1'\n", xml_path));
+
+	if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
+		error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
+				tmp_path, xml_path, g_strerror(errno)) << endmsg;
+		if (g_remove (tmp_path.c_str()) != 0) {
+			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
+					tmp_path, g_strerror (errno)) << endmsg;
+		}
+		return false;
+	}
+
+	return true;
+}
+
 /** Rename a state file.
  *  @param old_name Old snapshot name.
  *  @param new_name New snapshot name.
@@ -719,7 +878,11 @@ Session::rename_state (string old_name, string new_name)
 	if (::g_rename (old_xml_path.c_str(), new_xml_path.c_str()) != 0) {
 		error << string_compose(_("could not rename snapshot %1 to %2 (%3)"),
 				old_name, new_name, g_strerror(errno)) << endmsg;
+		return;
 	}
+
+	/* the state cache is only used if it matches the state file, renaming it is optional */
+	::g_rename ((old_xml_path + state_cache_suffix).c_str(), (new_xml_path + state_cache_suffix).c_str());
 }
 
 /** Remove a state file.
@@ -749,6 +912,8 @@ Session::remove_state (string snapshot_name)
 				xml_path, g_strerror (errno)) << endmsg;
 	}
 
+	g_remove ((xml_path + state_cache_suffix).c_str());
+
 	StateSaved (snapshot_name); /* EMIT SIGNAL */
 }
 
@@ -861,31 +1026,28 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		xml_path = Glib::build_filename (xml_path, legalize_for_path (snapshot_name) + pending_suffix);
 	}
 
-	std::string tmp_path(_session_dir->root_path());
-	tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
-
-	DEBUG_TRACE (DEBUG::SaveState, string_compose ("writing state to '%1'\n", tmp_path));
+	if (pending && Config->get_save_pending_state_async () && !Profile->get_mixbus ()) {
+		/* periodic saves should not stall the GUI, leave writing
+		 * the file to a background thread.
+		 */
+		XMLTree* async_tree = new XMLTree;
+		async_tree->set_filename (xml_path);
+		async_tree->set_root (tree.root ());
+		tree.set_root (0);
+		queue_state_write (async_tree);
+		return 0;
+	}
 
-	if (!tree.write (tmp_path)) {
-		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
-		if (g_remove (tmp_path.c_str()) != 0) {
-			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-					tmp_path, g_strerror (errno)) << endmsg;
-		}
+	if (!write_state_file (tree, xml_path)) {
 		return -1;
+	}
 
-	} else {
-
-		DEBUG_TRACE (DEBUG::SaveState, string_compose ("renaming state to '%1'\n", xml_path));
-
-		if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
-			error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
-					tmp_path, xml_path, g_strerror(errno)) << endmsg;
-			if (g_remove (tmp_path.c_str()) != 0) {
-				error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-						tmp_path, g_strerror (errno)) << endmsg;
-			}
-			return -1;
+	if (!pending && !for_archive && !template_only && Config->get_save_state_cache ()) {
+		/* a binary copy of the state, used by load_state() as long as the state file is unchanged */
+		const std::string cache_path = xml_path + state_cache_suffix;
+		uint64_t xml_hash;
+		if (!XMLTree::file_hash (xml_path, xml_hash) || !tree.write_binary (cache_path, xml_hash)) {
+			DEBUG_TRACE (DEBUG::SaveState, string_compose ("could not write state cache '%1'\n", cache_path));
 		}
 	}
 
@@ -998,7 +1160,21 @@ Session::load_state (string snapshot_name, bool from_template)
 
 	_writable = exists_and_writable (xmlpath) && exists_and_writable(Glib::path_get_dirname(xmlpath));
 
-	if (!state_tree->read (xmlpath)) {
+	/* prefer the binary copy of the state (see save_state()), if it was
+	 * written along with the current content of the state file
+	 */
+	bool     cached = false;
+	uint64_t xml_hash;
+
+	if (Config->get_save_state_cache () && XMLTree::file_hash (xmlpath, xml_hash)) {
+		cached = state_tree->read_binary (xmlpath + state_cache_suffix, xml_hash);
+		if (cached) {
+			DEBUG_TRACE (DEBUG::SaveState, string_compose ("loaded state from cache for '%1'\n", xmlpath));
+			state_tree->set_filename (xmlpath);
+		}
+	}
+
+	if (!cached && !state_tree->read (xmlpath)) {
 		error << string_compose(_("Could not understand session file %1"), xmlpath) << endmsg;
 		delete state_tree;
 		state_tree = 0;
@@ -1875,6 +2051,8 @@ Session::set_state (const XMLNode& node, int version)
 		AudioFileSource::set_header_position_offset (_session_range_location->start().samples());
 	}
 
+	BootMessage (_("Loading regions"));
+
 	if ((child = find_named_node (node, "Regions")) == 0) {
 		error << _("Session: XML state has no 'Regions' section") << endmsg;
 		goto out;
@@ -1883,6 +2061,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	BootMessage (_("Loading playlists"));
+
 	if ((child = find_named_node (node, "Playlists")) == 0) {
 		error << _("Session: XML state has no 'Playlists' section") << endmsg;
 		goto out;
@@ -2703,11 +2883,38 @@ Session::load_sources (const XMLNode& node)
 	set_dirty();
 	std::map<std::string, std::string> relocation;
 
+	/* Finding and opening (probing) the files of the sources is independent
+	 * for each source, do that on a worker pool first. Sources are then
+	 * announced in order; those that could not be opened take the path
+	 * below, which may ask the user about missing files.
+	 */
+	std::vector<std::shared_ptr<Source> > opened (nlist.size ());
+
+	if (Stateful::loading_state_version >= 3000) {
+#ifdef PLATFORM_WINDOWS
+		int old_mode = SetErrorMode (SEM_FAILCRITICALERRORS);
+#endif
+		run_load_tasks (string_compose (_("Opening %1 sources"), nlist.size ()), nlist.size (),
+		                boost::bind (&Session::open_source, this, boost::cref (nlist), boost::ref (opened), _1));
+#ifdef PLATFORM_WINDOWS
+		SetErrorMode (old_mode);
+#endif
+	}
+
+	BootMessage (_("Adding sources"));
+
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 #ifdef PLATFORM_WINDOWS
 		int old_mode = 0;
 #endif
 
+		std::shared_ptr<Source> const& src (opened[niter - nlist.begin ()]);
+
+		if (src) {
+			SourceFactory::SourceCreated (src);
+			continue;
+		}
+
 		XMLNode srcnode (**niter);
 		bool try_replace_abspath = true;
 
@@ -2827,6 +3034,70 @@ retry:
 	return 0;
 }
 
+void
+Session::open_source (XMLNodeList const& nlist, std::vector<std::shared_ptr<Source> >& opened, size_t n)
+{
+	XMLNode const& node (*nlist[n]);
+
+	if (node.name() != "Source" || node.property ("playlist")) {
+		/* left to load_sources(): playlist sources refer to other
+		 * sources, which must have been added to the session first
+		 */
+		return;
+	}
+
+	/* this runs on a worker thread, never ask the user here */
+	FileSource::set_ask_about_ambiguous_files (false);
+
+	try {
+		opened[n] = SourceFactory::create (*this, node, true, false);
+	} catch (...) {
+		/* load_sources() tries again */
+	}
+
+	FileSource::set_ask_about_ambiguous_files (true);
+}
+
+static void
+load_task_worker (std::atomic<size_t>* next, size_t n_tasks, boost::function<void (size_t)> const* task)
+{
+	Temporal::TempoMap::fetch ();
+
+	for (size_t n = next->fetch_add (1); n < n_tasks; n = next->fetch_add (1)) {
+		(*task) (n);
+	}
+}
+
+/** Call @p task for each index in [0, n_tasks) using all CPU cores, and return
+ * when all calls have completed. The order of calls is unspecified, tasks must
+ * be independent of each other and must not interact with the GUI.
+ */
+void
+Session::run_load_tasks (std::string const& stage, size_t n_tasks, boost::function<void (size_t)> const& task)
+{
+	BootMessage (stage);
+
+	std::atomic<size_t>       next (0);
+	std::vector<PBD::Thread*> workers;
+	size_t const              n_threads = std::min<size_t> (hardware_concurrency (), n_tasks);
+
+	/* the calling thread is one of them */
+	for (size_t i = 1; i < n_threads; ++i) {
+		PBD::Thread* t = PBD::Thread::create (boost::bind (&load_task_worker, &next, n_tasks, &task), string_compose ("LoadWorker-%1", i));
+		if (!t) {
+			break;
+		}
+		workers.push_back (t);
+	}
+
+	load_task_worker (&next, n_tasks, &task);
+
+	for (std::vector<PBD::Thread*>::const_iterator i = workers.begin (); i != workers.end (); ++i) {
+		(*i)->join ();
+		delete *i;
+	}
+}
+
 std::shared_ptr<Source>
 Session::XMLSourceFactory (const XMLNode& node)
 {
@@ -4190,7 +4461,7 @@ Session::instant_xml (const string& node_name)
 int
 Session::save_history (string snapshot_name)
 {
-	XMLTree tree;
+	XMLWriter writer;
 
 	if (!_writable) {
 	        return 0;
@@ -4217,9 +4488,16 @@ Session::save_history (string snapshot_name)
 		return 0;
 	}
 
-	tree.set_root (&_history.get_state (Config->get_saved_history_depth()));
+	/* stream the transactions to disk one at a time, rather than
+	 * building the complete history as a single tree first.
+	 */
+	bool ok = writer.open (xml_path) && writer.start_element ("UndoHistory");
+
+	if (ok) {
+		_history.write_state (writer, Config->get_saved_history_depth());
+	}
 
-	if (!tree.write (xml_path))
+	if (!writer.close () || !ok)
 	{
 		error << string_compose (_("history could not be saved to %1"), xml_path) << endmsg;
 
@@ -4241,7 +4519,7 @@ Session::save_history (string snapshot_name)
 int
 Session::restore_history (string snapshot_name)
 {
-	XMLTree tree;
+	XMLReader reader;
 
 	if (snapshot_name.empty()) {
 		snapshot_name = _current_snapshot_name;
@@ -4258,7 +4536,12 @@ Session::restore_history (string snapshot_name)
 		return 1;
 	}
 
-	if (!tree.read (xml_path)) {
+	/* locate the root node */
+	if (reader.open (xml_path)) {
+		while (reader.read () && reader.type () != XMLReader::Element) {}
+	}
+
+	if (reader.at_end ()) {
 		error << string_compose (_("Could not understand session history file \"%1\""),
 				xml_path) << endmsg;
 		return -1;
@@ -4268,94 +4551,126 @@ Session::restore_history (string snapshot_name)
 	_history.clear();
 
 	try {
-		for (XMLNodeConstIterator it  = tree.root()->children().begin(); it != tree.root()->children().end(); ++it) {
-
-			XMLNode *t = *it;
+		/* parse one transaction at a time, the reader only keeps
+		 * the current one in memory.
+		 */
+		reader.read ();
 
-			std::string name;
-			int64_t tv_sec;
-			int64_t tv_usec;
+		while (!reader.at_end () && reader.depth () > 0) {
 
-			if (!t->get_property ("name", name) || !t->get_property ("tv-sec", tv_sec) ||
-			    !t->get_property ("tv-usec", tv_usec)) {
+			if (reader.type () != XMLReader::Element) {
+				reader.skip ();
 				continue;
 			}
 
-			UndoTransaction* ut = new UndoTransaction ();
-			ut->set_name (name);
+			std::unique_ptr<XMLNode> node (reader.read_node ());
 
-			struct timeval tv;
-			tv.tv_sec = tv_sec;
-			tv.tv_usec = tv_usec;
-			ut->set_timestamp(tv);
+			if (!node) {
+				break;
+			}
 
-			for (XMLNodeConstIterator child_it  = t->children().begin();
-			     child_it != t->children().end(); child_it++)
-			{
-				XMLNode *n = *child_it;
-				Command *c;
+			UndoTransaction* ut = transaction_from_state (*node);
 
-				if (n->name() == "MementoCommand" ||
-				    n->name() == "MementoUndoCommand" ||
-				    n->name() == "MementoRedoCommand") {
+			if (ut) {
+				_history.add (ut);
+			}
+		}
 
-					if ((c = memento_command_factory(n))) {
-						ut->add_command(c);
-					}
+		if (reader.failed ()) {
+			error << string_compose (_("Could not understand session history file \"%1\""),
+					xml_path) << endmsg;
+		}
 
-				} else if (n->name() == "TempoCommand") {
+	} catch (std::exception const & e) {
+		error << string_compose (_("Error during loading undo history (%1). Undo history will be ignored"), e.what()) << endmsg;
+	}
 
-					ut->add_command (new TempoCommand (*n));
+	return 0;
+}
 
-				} else if (n->name() == "NoteDiffCommand") {
-					PBD::ID id (n->property("midi-source")->value());
-					std::shared_ptr<MidiSource> midi_source =
-						std::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
-					if (midi_source) {
-						ut->add_command (new MidiModel::NoteDiffCommand(midi_source->model(), *n));
-					} else {
-						error << _("Failed to downcast MidiSource for NoteDiffCommand") << endmsg;
-					}
+/** Create an undo transaction from its state, as saved in the history file.
+ * @return 0 if @p t is not a valid transaction
+ */
+UndoTransaction*
+Session::transaction_from_state (XMLNode const& t)
+{
+	std::string name;
+	int64_t tv_sec;
+	int64_t tv_usec;
 
-				} else if (n->name() == "SysExDiffCommand") {
+	if (!t.get_property ("name", name) || !t.get_property ("tv-sec", tv_sec) ||
+	    !t.get_property ("tv-usec", tv_usec)) {
+		return 0;
+	}
 
-					PBD::ID id (n->property("midi-source")->value());
-					std::shared_ptr<MidiSource> midi_source =
-						std::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
-					if (midi_source) {
-						ut->add_command (new MidiModel::SysExDiffCommand (midi_source->model(), *n));
-					} else {
-						error << _("Failed to downcast MidiSource for SysExDiffCommand") << endmsg;
-					}
+	UndoTransaction* ut = new UndoTransaction ();
+	ut->set_name (name);
 
-				} else if (n->name() == "PatchChangeDiffCommand") {
+	struct timeval tv;
+	tv.tv_sec = tv_sec;
+	tv.tv_usec = tv_usec;
+	ut->set_timestamp(tv);
 
-					PBD::ID id (n->property("midi-source")->value());
-					std::shared_ptr<MidiSource> midi_source =
-						std::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
-					if (midi_source) {
-						ut->add_command (new MidiModel::PatchChangeDiffCommand (midi_source->model(), *n));
-					} else {
-						error << _("Failed to downcast MidiSource for PatchChangeDiffCommand") << endmsg;
-					}
+	for (XMLNodeConstIterator child_it  = t.children().begin();
+	     child_it != t.children().end(); child_it++)
+	{
+		XMLNode *n = *child_it;
+		Command *c;
 
-				} else if (n->name() == "StatefulDiffCommand") {
-					if ((c = stateful_diff_command_factory (n))) {
-						ut->add_command (c);
-					}
-				} else {
-					error << string_compose(_("Couldn't figure out how to make a Command out of a %1 XMLNode."), n->name()) << endmsg;
-				}
+		if (n->name() == "MementoCommand" ||
+		    n->name() == "MementoUndoCommand" ||
+		    n->name() == "MementoRedoCommand") {
+
+			if ((c = memento_command_factory(n))) {
+				ut->add_command(c);
 			}
 
-			_history.add (ut);
-		}
+		} else if (n->name() == "TempoCommand") {
 
-	} catch (std::exception const & e) {
-		error << string_compose (_("Error during loading undo history (%1). Undo history will be ignored"), e.what()) << endmsg;
+			ut->add_command (new TempoCommand (*n));
+
+		} else if (n->name() == "NoteDiffCommand") {
+			PBD::ID id (n->property("midi-source")->value());
+			std::shared_ptr<MidiSource> midi_source =
+				std::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
+			if (midi_source) {
+				ut->add_command (new MidiModel::NoteDiffCommand(midi_source->model(), *n));
+			} else {
+				error << _("Failed to downcast MidiSource for NoteDiffCommand") << endmsg;
+			}
+
+		} else if (n->name() == "SysExDiffCommand") {
+
+			PBD::ID id (n->property("midi-source")->value());
+			std::shared_ptr<MidiSource> midi_source =
+				std::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
+			if (midi_source) {
+				ut->add_command (new MidiModel::SysExDiffCommand (midi_source->model(), *n));
+			} else {
+				error << _("Failed to downcast MidiSource for SysExDiffCommand") << endmsg;
+			}
+
+		} else if (n->name() == "PatchChangeDiffCommand") {
+
+			PBD::ID id (n->property("midi-source")->value());
+			std::shared_ptr<MidiSource> midi_source =
+				std::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
+			if (midi_source) {
+				ut->add_command (new MidiModel::PatchChangeDiffCommand (midi_source->model(), *n));
+			} else {
+				error << _("Failed to downcast MidiSource for PatchChangeDiffCommand") << endmsg;
+			}
+
+		} else if (n->name() == "StatefulDiffCommand") {
+			if ((c = stateful_diff_command_factory (n))) {
+				ut->add_command (c);
+			}
+		} else {
+			error << string_compose(_("Couldn't figure out how to make a Command out of a %1 XMLNode."), n->name()) << endmsg;
+		}
 	}
 
-	return 0;
+	return ut;
 }
 
 void
@@ -4525,6 +4840,8 @@ Session::config_changed (std::string p, bool ours)
 		setup_fpu ();
 	} else if (p == "history-depth") {
 		set_history_depth (Config->get_history_depth());
+	} else if (p == "history-spill-depth") {
+		_history.set_spill_depth (Config->get_history_spill_depth());
 	} else if (p == "remote-model") {
 		/* XXX DO SOMETHING HERE TO TELL THE GUI THAT WE NEED
 		   TO SET REMOTE ID'S
@@ -4643,6 +4960,14 @@ Session::set_history_depth (uint32_t d)
 	_history.set_depth (d);
 }
 
+void
+Session::setup_history_spill ()
+{
+	_history.set_spill (Glib::build_filename (_path, string (X_("undo")) + history_spill_suffix),
+	                    boost::bind (&Session::transaction_from_state, this, _1));
+	_history.set_spill_depth (Config->get_history_spill_depth());
+}
+
 /** Connect things to the MMC object */
 void
 Session::setup_midi_machine_control ()
@@ -4872,6 +5197,8 @@ Session::rename (const std::string& new_name)
 		return 1;
 	}
 
+	::g_rename ((oldstr + state_cache_suffix).c_str(), (newstr + state_cache_suffix).c_str());
+
 	/* history file */
 
 	oldstr = Glib::build_filename (new_path, _current_snapshot_name) + history_suffix;
@@ -4889,6 +5216,9 @@ Session::rename (const std::string& new_name)
 	remove_recent_sessions (_path);
 	_path = new_path;
 
+	/* the undo log was moved with the session folder */
+	setup_history_spill ();
+
 	/* update file source paths */
 
 	for (SourceMap::iterator i = sources.begin(); i != sources.end(); ++i) {
@@ -5227,6 +5557,8 @@ Session::save_as (SaveAs& saveas)
 	do_not_copy_extensions.push_back (backup_suffix);
 	do_not_copy_extensions.push_back (temp_suffix);
 	do_not_copy_extensions.push_back (history_suffix);
+	do_not_copy_extensions.push_back (state_cache_suffix);
+	do_not_copy_extensions.push_back (history_spill_suffix);
 
 	/* get total size */
 
@@ -5712,6 +6044,8 @@ Session::archive_session (const std::string& dest,
 	do_not_copy_extensions.push_back (backup_suffix);
 	do_not_copy_extensions.push_back (temp_suffix);
 	do_not_copy_extensions.push_back (history_suffix);
+	do_not_copy_extensions.push_back (state_cache_suffix);
+	do_not_copy_extensions.push_back (history_spill_suffix);
 	do_not_copy_extensions.push_back (".DS_Store");
 
 	vector<string> blacklist_dirs;
@@ -5982,6 +6316,8 @@ Session::archive_session (const std::string& dest,
 	/* collect session-state files */
 	do_not_copy_extensions.clear ();
 	do_not_copy_extensions.push_back (history_suffix);
+	do_not_copy_extensions.push_back (state_cache_suffix);
+	do_not_copy_extensions.push_back (history_spill_suffix);
 
 	blacklist_dirs.clear ();
 	blacklist_dirs.push_back (string (externals_dir_name) + G_DIR_SEPARATOR);
@@ -131,7 +131,7 @@ SlavableAutomationControl::masters_curve_multiply (timepos_t const & start, time
 {
 	gain_t* scratch = _session.scratch_automation_buffer ();
 	bool from_list = _list && std::dynamic_pointer_cast<AutomationList>(_list)->automation_playback();
-	bool rv = from_list && list()->curve().rt_safe_get_vector (start, end, scratch, veclen);
+	bool rv = from_list && alist()->rt_safe_get_vector (start.samples (), end.samples (), scratch, veclen);
 	if (rv) {
 		for (samplecnt_t i = 0; i < veclen; ++i) {
 			vec[i] *= scratch[i];
@@ -23,6 +23,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <vector>
 
 #include <sys/time.h>
@@ -42,6 +43,7 @@
 
 #include "evoral/Control.h"
 #include "evoral/SMF.h"
+#include "evoral/SMFReader.h"
 
 #include "temporal/tempo.h"
 
@@ -174,7 +176,10 @@ SMFSource::SMFSource (Session& s, const XMLNode& node, bool must_exist)
 	if (!(_flags & Source::Empty)) {
 		assert (Glib::file_test (_path, Glib::FILE_TEST_EXISTS));
 		existence_check ();
-		if (open (_path, 1, false)) {
+		/* the model is loaded directly from the file, libsmf is only
+		 * needed once the file is read or written through Evoral::SMF
+		 */
+		if (open (_path, 1, false, true)) {
 			throw failed_constructor ();
 		}
 		_open = true;
@@ -633,10 +638,21 @@ SMFSource::safe_midi_file_extension (const string& file)
 	return true;
 }
 
-static bool compare_eventlist (
-	const std::pair< const Evoral::Event<Temporal::Beats>*, gint >& a,
-	const std::pair< const Evoral::Event<Temporal::Beats>*, gint >& b) {
-	return ( a.first->time() < b.first->time() );
+namespace {
+/** An event read from the file, whose data is kept in a shared buffer */
+struct LoadEvent {
+	LoadEvent (Temporal::Beats const & t, size_t o, uint32_t s, Evoral::event_id_t i)
+		: time (t), offset (o), size (s), id (i) {}
+
+	Temporal::Beats    time;
+	size_t             offset;
+	uint32_t           size;
+	Evoral::event_id_t id;
+};
+
+bool compare_load_events (LoadEvent const & a, LoadEvent const & b) {
+	return a.time < b.time;
+}
 }
 
 void
@@ -659,16 +675,15 @@ SMFSource::load_model_unlocked (bool force_reload)
 	}
 
 	_model->start_write();
-	Evoral::SMF::seek_to_start();
 
 	uint64_t time = 0; /* in SMF ticks */
-	Evoral::Event<Temporal::Beats> ev;
 
 	uint32_t scratch_size = 0; // keep track of scratch and minimize reallocs
 
-	uint32_t delta_t = 0;
-	uint32_t size    = 0;
-	uint8_t* buf     = NULL;
+	uint32_t       delta_t = 0;
+	uint32_t       size    = 0;
+	uint8_t*       buf     = NULL;
+	uint8_t const* ev_buf;
 	int ret;
 	Evoral::event_id_t event_id;
 	bool have_event_id;
@@ -678,16 +693,40 @@ SMFSource::load_model_unlocked (bool force_reload)
 	_has_pgm_change   = false;
 	_used_channels.reset ();
 
-	// TODO simplify event allocation
-	std::list< std::pair< Evoral::Event<Temporal::Beats>*, gint > > eventlist;
+	/* If libsmf has not parsed the file (yet), decode it directly, rather
+	 * than having libsmf create an event for every message first.
+	 */
+	Evoral::SMFReader reader;
+	const bool stream = deferred () && reader.open (_path);
+
+	const uint16_t n_tracks  = stream ? reader.num_tracks () : num_tracks ();
+	const uint16_t file_ppqn = stream ? reader.ppqn () : ppqn ();
+
+	/* all events of all tracks, their data is stored in one buffer */
+	std::vector<LoadEvent> eventlist;
+	std::vector<uint8_t>   eventdata;
 
-	for (unsigned i = 1; i <= num_tracks(); ++i) {
-		if (seek_to_track(i)) continue;
+	for (unsigned i = 1; i <= n_tracks; ++i) {
+		if (stream ? !reader.seek_to_track (i) : seek_to_track (i)) continue;
 
 		time = 0;
 		have_event_id = false;
 
-		while ((ret = read_event (&delta_t, &size, &buf, &event_id)) >= 0) {
+		while (true) {
+
+			if (stream) {
+				ret = reader.read_event (&delta_t, &size, &ev_buf, &event_id);
+			} else {
+				// Set size to max capacity to minimize allocs in read_event
+				size   = scratch_size;
+				ret    = read_event (&delta_t, &size, &buf, &event_id);
+				ev_buf = buf;
+				scratch_size = std::max (size, scratch_size);
+			}
+
+			if (ret < 0) {
+				break;
+			}
 
 			time += delta_t;
 
@@ -700,8 +739,8 @@ SMFSource::load_model_unlocked (bool force_reload)
 			}
 
 			/* aggregate information about channels and pgm-changes */
-			uint8_t type = buf[0] & 0xf0;
-			uint8_t chan = buf[0] & 0x0f;
+			uint8_t type = ev_buf[0] & 0xf0;
+			uint8_t chan = ev_buf[0] & 0x0f;
 			if (type >= 0x80 && type <= 0xE0) {
 				_used_channels.set(chan);
 				switch (type) {
@@ -722,13 +761,13 @@ SMFSource::load_model_unlocked (bool force_reload)
 				if (!have_event_id) {
 					event_id = Evoral::next_event_id();
 				}
-				const Temporal::Beats event_time = Temporal::Beats::ticks_at_rate(time, ppqn());
+				const Temporal::Beats event_time = Temporal::Beats::ticks_at_rate(time, file_ppqn);
 #ifndef NDEBUG
 				std::string ss;
 
 				for (uint32_t xx = 0; xx < size; ++xx) {
 					char b[8];
-					snprintf (b, sizeof (b), "0x%x ", buf[xx]);
+					snprintf (b, sizeof (b), "0x%x ", ev_buf[xx]);
 					ss += b;
 				}
 
@@ -736,15 +775,8 @@ SMFSource::load_model_unlocked (bool force_reload)
 							delta_t, time, size, ss, event_id, name()));
 #endif
 
-				eventlist.push_back(make_pair (
-							new Evoral::Event<Temporal::Beats> (
-								Evoral::MIDI_EVENT, event_time,
-								size, buf, true)
-							, event_id));
-
-				// Set size to max capacity to minimize allocs in read_event
-				scratch_size = std::max(size, scratch_size);
-				size = scratch_size;
+				eventlist.push_back (LoadEvent (event_time, eventdata.size (), size, event_id));
+				eventdata.insert (eventdata.end (), ev_buf, ev_buf + size);
 
 				assert (!_length || (_length.time_domain() == Temporal::BeatTime));
 				_length = max (_length, timepos_t (event_time));
@@ -757,12 +789,12 @@ SMFSource::load_model_unlocked (bool force_reload)
 
 	_num_channels = _used_channels.size();
 
-	eventlist.sort(compare_eventlist);
+	std::stable_sort (eventlist.begin (), eventlist.end (), compare_load_events);
 
-	std::list< std::pair< Evoral::Event<Temporal::Beats>*, gint > >::iterator it;
-	for (it=eventlist.begin(); it!=eventlist.end(); ++it) {
-		_model->append (*it->first, it->second);
-		delete it->first;
+	for (std::vector<LoadEvent>::const_iterator it = eventlist.begin(); it != eventlist.end(); ++it) {
+		/* the model copies what it needs, no need to allocate */
+		Evoral::Event<Temporal::Beats> ev (Evoral::MIDI_EVENT, it->time, it->size, &eventdata[it->offset], false);
+		_model->append (ev, it->id);
 	}
 
         // cerr << "----SMF-SRC-----\n";
@@ -19,6 +19,7 @@
 
 #include "ardour/mix.h"
 
+#include <climits>
 #include <immintrin.h>
 #include <xmmintrin.h>
 
@@ -384,6 +385,303 @@ x86_sse_avx_copy_vector(float *dst, const float *src, uint32_t nframes)
 	(void) memcpy(dst, src, nframes * sizeof(float));
 }
 
+/**
+ * @brief x86-64 AVX optimized routine for clipping to [-1, 1]
+ * @param[in,out] buf Pointer to buffer
+ * @param nframes Number of samples to process
+ */
+void
+x86_sse_avx_clip_floats(float *buf, uint32_t nframes)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 mone = _mm256_set1_ps(-1.0f);
+
+	while (nframes >= 8) {
+		// min/max return the 2nd operand if one is NaN, which keeps NaN
+		__m256 x = _mm256_loadu_ps(buf);
+		x = _mm256_max_ps(mone, _mm256_min_ps(one, x));
+		_mm256_storeu_ps(buf, x);
+		buf += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper();
+
+	default_clip_floats(buf, nframes);
+}
+
+/**
+ * @brief x86-64 AVX optimized routine for applying a gain vector
+ * @param[in,out] buf Pointer to buffer
+ * @param[in] gain Pointer to per-sample gain
+ * @param nframes Number of samples to process
+ */
+void
+x86_sse_avx_apply_gain_vector_to_buffer(float *buf, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		_mm256_storeu_ps(buf, _mm256_mul_ps(_mm256_loadu_ps(buf), _mm256_loadu_ps(gain)));
+		buf += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper();
+
+	default_apply_gain_vector_to_buffer(buf, gain, nframes);
+}
+
+/**
+ * @brief x86-64 AVX optimized routine for an exponential gain ramp
+ *
+ * @details The one-pole ramp g += coeff * (target - g) is evaluated in
+ * closed form, g[i] = target + (g[0] - target) * (1 - coeff)^i
+ *
+ * @return gain following the last sample
+ */
+float
+x86_sse_avx_apply_gain_ramp_to_buffer(float *buf, uint32_t nframes, float gain, float target, float coeff)
+{
+	if (nframes >= 8) {
+		const float r = 1.f - coeff;
+		float d[8];
+		float r8 = 1.f;
+		d[0] = gain - target;
+		for (int i = 1; i < 8; ++i) {
+			d[i] = d[i - 1] * r;
+		}
+		for (int i = 0; i < 8; ++i) {
+			r8 *= r;
+		}
+
+		const __m256 vtarget = _mm256_set1_ps(target);
+		const __m256 step = _mm256_set1_ps(r8);
+		__m256 delta = _mm256_loadu_ps(d);
+
+		while (nframes >= 8) {
+			_mm256_storeu_ps(buf, _mm256_mul_ps(_mm256_loadu_ps(buf), _mm256_add_ps(vtarget, delta)));
+			delta = _mm256_mul_ps(delta, step);
+			buf += 8;
+			nframes -= 8;
+		}
+
+		gain = target + _mm256_cvtss_f32(delta);
+
+		_mm256_zeroupper();
+	}
+
+	return default_apply_gain_ramp_to_buffer(buf, nframes, gain, target, coeff);
+}
+
+/**
+ * @brief x86-64 AVX optimized routine for mixing buffers with a gain vector
+ *
+ * @details dst = dst + (gain * src), per element
+ */
+void
+x86_sse_avx_mix_buffers_with_gain_vector(float *dst, const float *src, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		__m256 x = _mm256_mul_ps(_mm256_loadu_ps(src), _mm256_loadu_ps(gain));
+		_mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), x));
+		dst += 8;
+		src += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper();
+
+	default_mix_buffers_with_gain_vector(dst, src, gain, nframes);
+}
+
+/**
+ * @brief x86-64 AVX optimized VMResampler filter coefficients
+ *
+ * @details see ArdourZita::VMResampler::interpolate_t, the second half
+ * is reversed 8 at a time.
+ */
+void
+x86_sse_avx_vmr_interpolate(float *c, const float *cq1, const float *cq2, float aa, float bb, uint32_t hl)
+{
+	const __m256 va = _mm256_set1_ps(aa);
+	const __m256 vb = _mm256_set1_ps(bb);
+
+	uint32_t i = 0;
+	for (; i + 8 <= hl; i += 8) {
+		__m256 x = _mm256_add_ps(_mm256_mul_ps(va, _mm256_loadu_ps(cq1 + i)), _mm256_mul_ps(vb, _mm256_loadu_ps(cq1 + i + hl)));
+		_mm256_storeu_ps(c + i, x);
+	}
+
+	const float *q = cq2 + hl;
+	uint32_t j = 0;
+	for (; j + 8 <= hl; j += 8) {
+		__m256 x = _mm256_add_ps(_mm256_mul_ps(va, _mm256_loadu_ps(q - 8)), _mm256_mul_ps(vb, _mm256_loadu_ps(q - hl - 8)));
+		/* reverse within 128 bit lanes, then swap lanes */
+		x = _mm256_permute_ps(x, _MM_SHUFFLE(0, 1, 2, 3));
+		_mm256_storeu_ps(c + hl + j, _mm256_permute2f128_ps(x, x, 1));
+		q -= 8;
+	}
+
+	_mm256_zeroupper();
+
+	for (; i < hl; ++i) {
+		c[i] = aa * cq1[i] + bb * cq1[i + hl];
+	}
+	for (; j < hl; ++j) {
+		--q;
+		c[hl + j] = aa * q[0] + bb * q[-(int)hl];
+	}
+}
+
+/**
+ * @brief x86-64 AVX optimized dot product for VMResampler
+ */
+float
+x86_sse_avx_vmr_dot_product(const float *c, const float *p, uint32_t n)
+{
+	__m256 a0 = _mm256_setzero_ps();
+	__m256 a1 = _mm256_setzero_ps();
+
+	while (n >= 16) {
+		a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(c), _mm256_loadu_ps(p)));
+		a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_loadu_ps(c + 8), _mm256_loadu_ps(p + 8)));
+		c += 16;
+		p += 16;
+		n -= 16;
+	}
+
+	if (n >= 8) {
+		a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_loadu_ps(c), _mm256_loadu_ps(p)));
+		c += 8;
+		p += 8;
+		n -= 8;
+	}
+
+	a0 = _mm256_add_ps(a0, a1);
+	__m128 x = _mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1));
+	x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+	x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+
+	_mm256_zeroupper();
+
+	float a = _mm_cvtss_f32(x);
+	while (n--) {
+		a += *c++ * *p++;
+	}
+	return a;
+}
+
+/**
+ * @brief x86-64 AVX optimized spectrum multiply-accumulate for the Convolver
+ *
+ * @details Blocks of 8 real parts followed by 8 imaginary parts,
+ * see ArdourZita::Convproc::mac_t
+ */
+void
+x86_sse_avx_conv_mac(float *d, const float *a, const float *b, uint32_t n)
+{
+	for (; n > 0; n -= 8) {
+		const __m256 ar = _mm256_loadu_ps(a);
+		const __m256 ai = _mm256_loadu_ps(a + 8);
+		const __m256 br = _mm256_loadu_ps(b);
+		const __m256 bi = _mm256_loadu_ps(b + 8);
+		const __m256 re = _mm256_sub_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi));
+		const __m256 im = _mm256_add_ps(_mm256_mul_ps(ar, bi), _mm256_mul_ps(ai, br));
+		_mm256_storeu_ps(d, _mm256_add_ps(_mm256_loadu_ps(d), re));
+		_mm256_storeu_ps(d + 8, _mm256_add_ps(_mm256_loadu_ps(d + 8), im));
+		a += 16;
+		b += 16;
+		d += 16;
+	}
+
+	_mm256_zeroupper();
+}
+
+/**
+ * @brief Scale, dither and round 8 samples, clamp and shift the result
+ *
+ * @details Clamping is done before rounding, in the same way as lrintf()
+ * followed by integer clamping: lrintf() returns LONG_MIN for NaN and
+ * values that are too large, which end up at clamp_l. The result is
+ * returned in two halves, since AVX has no 256 bit integer shifts.
+ */
+static inline void
+avx_quantize(const float *src, const float *noise, __m256 scale, __m256 clamp_l, __m256 clamp_u, __m256 limit, __m128i post_shift, __m128i &lo, __m128i &hi)
+{
+	__m256 x = _mm256_mul_ps(_mm256_loadu_ps(src), scale);
+	if (noise) {
+		x = _mm256_sub_ps(x, _mm256_loadu_ps(noise));
+	}
+	const __m256 overflow = _mm256_cmp_ps(x, limit, _CMP_GE_OQ);
+	x = _mm256_min_ps(_mm256_max_ps(x, clamp_l), clamp_u);
+	x = _mm256_blendv_ps(x, clamp_l, overflow);
+
+	const __m256i i = _mm256_cvtps_epi32(x);
+	lo = _mm_sll_epi32(_mm256_castsi256_si128(i), post_shift);
+	hi = _mm_sll_epi32(_mm256_extractf128_si256(i, 1), post_shift);
+}
+
+/**
+ * @brief x86-64 AVX optimized routine for float to 16 bit conversion
+ * @details Bit-identical to default_float_to_int16()
+ */
+void
+x86_sse_avx_float_to_int16(int16_t *dst, const float *src, const float *noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	const __m256 vscale = _mm256_set1_ps(scale);
+	const __m256 vlo = _mm256_set1_ps((float)clamp_l);
+	const __m256 vhi = _mm256_set1_ps((float)clamp_u);
+	const __m256 vlimit = _mm256_set1_ps(-(float)LONG_MIN);
+	const __m128i vshift = _mm_cvtsi32_si128(post_shift);
+
+	while (nframes >= 8) {
+		__m128i lo, hi;
+		avx_quantize(src, noise, vscale, vlo, vhi, vlimit, vshift, lo, hi);
+		// truncate to 16 bit, like a cast
+		lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+		hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(lo, hi));
+		src += 8;
+		dst += 8;
+		noise = noise ? noise + 8 : 0;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper();
+
+	default_float_to_int16(dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+/**
+ * @brief x86-64 AVX optimized routine for float to 32 bit conversion
+ * @details Bit-identical to default_float_to_int32()
+ */
+void
+x86_sse_avx_float_to_int32(int32_t *dst, const float *src, const float *noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	const __m256 vscale = _mm256_set1_ps(scale);
+	const __m256 vlo = _mm256_set1_ps((float)clamp_l);
+	const __m256 vhi = _mm256_set1_ps((float)clamp_u);
+	const __m256 vlimit = _mm256_set1_ps(-(float)LONG_MIN);
+	const __m128i vshift = _mm_cvtsi32_si128(post_shift);
+
+	while (nframes >= 8) {
+		__m128i lo, hi;
+		avx_quantize(src, noise, vscale, vlo, vhi, vlimit, vshift, lo, hi);
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 4), hi);
+		src += 8;
+		dst += 8;
+		noise = noise ? noise + 8 : 0;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper();
+
+	default_float_to_int32(dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
 /**
  * Local helper functions
  */
@@ -17,7 +17,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <climits>
 #include <xmmintrin.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "ardour/mix.h"
 #include "ardour/types.h"
 
 void
@@ -114,5 +119,318 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 	_mm_store_ss(max, work);
 }
 
+void
+x86_sse_clip_floats (float* buf, uint32_t nframes)
+{
+	__m128 const one  = _mm_set1_ps (1.0f);
+	__m128 const mone = _mm_set1_ps (-1.0f);
+
+	while (nframes >= 4) {
+		/* min/max return the 2nd operand if one is NaN, which keeps NaN */
+		__m128 x = _mm_loadu_ps (buf);
+		x = _mm_max_ps (mone, _mm_min_ps (one, x));
+		_mm_storeu_ps (buf, x);
+		buf += 4;
+		nframes -= 4;
+	}
+
+	default_clip_floats (buf, nframes);
+}
+
+void
+x86_sse_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		_mm_storeu_ps (buf, _mm_mul_ps (_mm_loadu_ps (buf), _mm_loadu_ps (gain)));
+		buf += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	default_apply_gain_vector_to_buffer (buf, gain, nframes);
+}
+
+/* The one-pole ramp g += coeff * (target - g) is evaluated in closed form,
+ * g[i] = target + (g[0] - target) * (1 - coeff)^i, 4 samples at a time.
+ */
+float
+x86_sse_apply_gain_ramp_to_buffer (float* buf, uint32_t nframes, float gain, float target, float coeff)
+{
+	if (nframes >= 4) {
+		float const r = 1.f - coeff;
+		float const d = gain - target;
+
+		__m128 const vtarget = _mm_set1_ps (target);
+		__m128 const step    = _mm_set1_ps (r * r * r * r);
+		__m128       delta   = _mm_set_ps (d * r * r * r, d * r * r, d * r, d);
+
+		while (nframes >= 4) {
+			_mm_storeu_ps (buf, _mm_mul_ps (_mm_loadu_ps (buf), _mm_add_ps (vtarget, delta)));
+			delta = _mm_mul_ps (delta, step);
+			buf += 4;
+			nframes -= 4;
+		}
+
+		gain = target + _mm_cvtss_f32 (delta);
+	}
+
+	return default_apply_gain_ramp_to_buffer (buf, nframes, gain, target, coeff);
+}
+
+void
+x86_sse_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		__m128 x = _mm_mul_ps (_mm_loadu_ps (src), _mm_loadu_ps (gain));
+		_mm_storeu_ps (dst, _mm_add_ps (_mm_loadu_ps (dst), x));
+		dst += 4;
+		src += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	default_mix_buffers_with_gain_vector (dst, src, gain, nframes);
+}
+
+/* VMResampler filter coefficients, see ArdourZita::VMResampler::interpolate_t.
+ * The second half is reversed 4 at a time.
+ */
+void
+x86_sse_vmr_interpolate (float* c, float const* cq1, float const* cq2, float aa, float bb, uint32_t hl)
+{
+	__m128 const va = _mm_set1_ps (aa);
+	__m128 const vb = _mm_set1_ps (bb);
+
+	uint32_t i = 0;
+	for (; i + 4 <= hl; i += 4) {
+		__m128 x = _mm_add_ps (_mm_mul_ps (va, _mm_loadu_ps (cq1 + i)), _mm_mul_ps (vb, _mm_loadu_ps (cq1 + i + hl)));
+		_mm_storeu_ps (c + i, x);
+	}
+	for (; i < hl; ++i) {
+		c[i] = aa * cq1[i] + bb * cq1[i + hl];
+	}
+
+	float const* q = cq2 + hl;
+	for (i = 0; i + 4 <= hl; i += 4) {
+		__m128 x = _mm_add_ps (_mm_mul_ps (va, _mm_loadu_ps (q - 4)), _mm_mul_ps (vb, _mm_loadu_ps (q - hl - 4)));
+		_mm_storeu_ps (c + hl + i, _mm_shuffle_ps (x, x, _MM_SHUFFLE (0, 1, 2, 3)));
+		q -= 4;
+	}
+	for (; i < hl; ++i) {
+		--q;
+		c[hl + i] = aa * q[0] + bb * q[-(int)hl];
+	}
+}
+
+float
+x86_sse_vmr_dot_product (float const* c, float const* p, uint32_t n)
+{
+	__m128 a0 = _mm_setzero_ps ();
+	__m128 a1 = _mm_setzero_ps ();
+
+	while (n >= 8) {
+		a0 = _mm_add_ps (a0, _mm_mul_ps (_mm_loadu_ps (c), _mm_loadu_ps (p)));
+		a1 = _mm_add_ps (a1, _mm_mul_ps (_mm_loadu_ps (c + 4), _mm_loadu_ps (p + 4)));
+		c += 8;
+		p += 8;
+		n -= 8;
+	}
+
+	a0 = _mm_add_ps (a0, a1);
+	a0 = _mm_add_ps (a0, _mm_movehl_ps (a0, a0));
+	a0 = _mm_add_ss (a0, _mm_shuffle_ps (a0, a0, 1));
+
+	float a = _mm_cvtss_f32 (a0);
+	while (n--) {
+		a += *c++ * *p++;
+	}
+	return a;
+}
+
+/* Convolver spectrum multiply-accumulate, see ArdourZita::Convproc::mac_t.
+ * Blocks of 4 real parts followed by 4 imaginary parts.
+ */
+void
+x86_sse_conv_mac (float* d, float const* a, float const* b, uint32_t n)
+{
+	for (; n > 0; n -= 4) {
+		__m128 const ar = _mm_loadu_ps (a);
+		__m128 const ai = _mm_loadu_ps (a + 4);
+		__m128 const br = _mm_loadu_ps (b);
+		__m128 const bi = _mm_loadu_ps (b + 4);
+		__m128 const re = _mm_sub_ps (_mm_mul_ps (ar, br), _mm_mul_ps (ai, bi));
+		__m128 const im = _mm_add_ps (_mm_mul_ps (ar, bi), _mm_mul_ps (ai, br));
+		_mm_storeu_ps (d, _mm_add_ps (_mm_loadu_ps (d), re));
+		_mm_storeu_ps (d + 4, _mm_add_ps (_mm_loadu_ps (d + 4), im));
+		a += 8;
+		b += 8;
+		d += 8;
+	}
+}
+
+/* Ballistic meters of 4 channels, see default_kmeter_bank ().
+ * Each vector holds the state of all channels, a 4x4 transpose
+ * turns 4 samples of 4 channels into 4 consecutive samples.
+ * All 4 lanes are always processed, n_chan is ignored.
+ *
+ * _mm_max_ps (x, y) returns y if either is NaN, so the running maximum
+ * is passed last, to keep it when the filter state is NaN, as the
+ * scalar "if (b > mx) mx = b" does.
+ */
+static inline void
+x86_sse_load_4x4 (float const* const* bufs, uint32_t i, __m128& s0, __m128& s1, __m128& s2, __m128& s3)
+{
+	s0 = _mm_loadu_ps (bufs[0] + i);
+	s1 = _mm_loadu_ps (bufs[1] + i);
+	s2 = _mm_loadu_ps (bufs[2] + i);
+	s3 = _mm_loadu_ps (bufs[3] + i);
+	_MM_TRANSPOSE4_PS (s0, s1, s2, s3);
+}
+
+void
+x86_sse_kmeter_bank (float* z1, float* z2, float const* const* bufs, uint32_t, uint32_t nframes, float omega)
+{
+	__m128 const w  = _mm_set1_ps (omega);
+	__m128 const w4 = _mm_set1_ps (4 * omega);
+
+	__m128 a = _mm_loadu_ps (z1);
+	__m128 b = _mm_loadu_ps (z2);
+	__m128 s[4];
+
+	for (uint32_t i = 0; i + 4 <= nframes; i += 4) {
+		x86_sse_load_4x4 (bufs, i, s[0], s[1], s[2], s[3]);
+		for (int k = 0; k < 4; ++k) {
+			a = _mm_add_ps (a, _mm_mul_ps (w, _mm_sub_ps (_mm_mul_ps (s[k], s[k]), a)));
+		}
+		b = _mm_add_ps (b, _mm_mul_ps (w4, _mm_sub_ps (a, b)));
+	}
+
+	_mm_storeu_ps (z1, a);
+	_mm_storeu_ps (z2, b);
+}
+
+void
+x86_sse_iecppm_bank (float* z1, float* z2, float* m, float const* const* bufs, uint32_t, uint32_t nframes, float w1, float w2, float w3)
+{
+	__m128 const sign = _mm_set1_ps (-0.f);
+	__m128 const v1   = _mm_set1_ps (w1);
+	__m128 const v2   = _mm_set1_ps (w2);
+	__m128 const v3   = _mm_set1_ps (w3);
+
+	__m128 a  = _mm_loadu_ps (z1);
+	__m128 b  = _mm_loadu_ps (z2);
+	__m128 mx = _mm_loadu_ps (m);
+	__m128 s[4];
+
+	for (uint32_t i = 0; i + 4 <= nframes; i += 4) {
+		x86_sse_load_4x4 (bufs, i, s[0], s[1], s[2], s[3]);
+		a = _mm_mul_ps (a, v3);
+		b = _mm_mul_ps (b, v3);
+		for (int k = 0; k < 4; ++k) {
+			/* rise only: add the step only where the sample exceeds the state */
+			__m128 const t = _mm_andnot_ps (sign, s[k]);
+			a = _mm_add_ps (a, _mm_and_ps (_mm_cmpgt_ps (t, a), _mm_mul_ps (v1, _mm_sub_ps (t, a))));
+			b = _mm_add_ps (b, _mm_and_ps (_mm_cmpgt_ps (t, b), _mm_mul_ps (v2, _mm_sub_ps (t, b))));
+		}
+		mx = _mm_max_ps (_mm_add_ps (a, b), mx);
+	}
+
+	_mm_storeu_ps (z1, a);
+	_mm_storeu_ps (z2, b);
+	_mm_storeu_ps (m, mx);
+}
+
+void
+x86_sse_vumeter_bank (float* z1, float* z2, float* m, float const* const* bufs, uint32_t, uint32_t nframes, float w)
+{
+	__m128 const sign = _mm_set1_ps (-0.f);
+	__m128 const half = _mm_set1_ps (.5f);
+	__m128 const v    = _mm_set1_ps (w);
+	__m128 const v4   = _mm_set1_ps (4 * w);
 
+	__m128 a  = _mm_loadu_ps (z1);
+	__m128 b  = _mm_loadu_ps (z2);
+	__m128 mx = _mm_loadu_ps (m);
+	__m128 s[4];
 
+	for (uint32_t i = 0; i + 4 <= nframes; i += 4) {
+		x86_sse_load_4x4 (bufs, i, s[0], s[1], s[2], s[3]);
+		__m128 const t = _mm_mul_ps (b, half);
+		for (int k = 0; k < 4; ++k) {
+			__m128 const x = _mm_sub_ps (_mm_andnot_ps (sign, s[k]), t);
+			a = _mm_add_ps (a, _mm_mul_ps (v, _mm_sub_ps (x, a)));
+		}
+		b  = _mm_add_ps (b, _mm_mul_ps (v4, _mm_sub_ps (a, b)));
+		mx = _mm_max_ps (b, mx);
+	}
+
+	_mm_storeu_ps (z1, a);
+	_mm_storeu_ps (z2, b);
+	_mm_storeu_ps (m, mx);
+}
+
+#ifdef __SSE2__
+
+/* Scale, dither, and round 4 samples, clamp the result and shift it into place.
+ * Clamping is done before rounding, lrintf () returns LONG_MIN for NaN
+ * and values that are too large, which end up at clamp_l.
+ */
+static inline __m128i
+x86_sse2_quantize (float const* src, float const* noise, __m128 scale, __m128 clamp_l, __m128 clamp_u, __m128 limit, __m128i post_shift)
+{
+	__m128 x = _mm_mul_ps (_mm_loadu_ps (src), scale);
+	if (noise) {
+		x = _mm_sub_ps (x, _mm_loadu_ps (noise));
+	}
+	__m128 const overflow = _mm_cmpge_ps (x, limit);
+	x = _mm_min_ps (_mm_max_ps (x, clamp_l), clamp_u);
+	x = _mm_or_ps (_mm_and_ps (overflow, clamp_l), _mm_andnot_ps (overflow, x));
+	return _mm_sll_epi32 (_mm_cvtps_epi32 (x), post_shift);
+}
+
+void
+x86_sse2_float_to_int16 (int16_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	__m128 const  vscale = _mm_set1_ps (scale);
+	__m128 const  vlo    = _mm_set1_ps ((float)clamp_l);
+	__m128 const  vhi    = _mm_set1_ps ((float)clamp_u);
+	__m128 const  vlimit = _mm_set1_ps (-(float)LONG_MIN);
+	__m128i const vshift = _mm_cvtsi32_si128 (post_shift);
+
+	while (nframes >= 8) {
+		__m128i a = x86_sse2_quantize (src, noise, vscale, vlo, vhi, vlimit, vshift);
+		__m128i b = x86_sse2_quantize (src + 4, noise ? noise + 4 : 0, vscale, vlo, vhi, vlimit, vshift);
+		/* truncate to 16 bit, like a cast */
+		a = _mm_srai_epi32 (_mm_slli_epi32 (a, 16), 16);
+		b = _mm_srai_epi32 (_mm_slli_epi32 (b, 16), 16);
+		_mm_storeu_si128 ((__m128i*)dst, _mm_packs_epi32 (a, b));
+		src += 8;
+		dst += 8;
+		noise = noise ? noise + 8 : 0;
+		nframes -= 8;
+	}
+
+	default_float_to_int16 (dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+void
+x86_sse2_float_to_int32 (int32_t* dst, float const* src, float const* noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	__m128 const  vscale = _mm_set1_ps (scale);
+	__m128 const  vlo    = _mm_set1_ps ((float)clamp_l);
+	__m128 const  vhi    = _mm_set1_ps ((float)clamp_u);
+	__m128 const  vlimit = _mm_set1_ps (-(float)LONG_MIN);
+	__m128i const vshift = _mm_cvtsi32_si128 (post_shift);
+
+	while (nframes >= 4) {
+		_mm_storeu_si128 ((__m128i*)dst, x86_sse2_quantize (src, noise, vscale, vlo, vhi, vlimit, vshift));
+		src += 4;
+		dst += 4;
+		noise = noise ? noise + 4 : 0;
+		nframes -= 4;
+	}
+
+	default_float_to_int32 (dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "evoral/Curve.h"
+
+#include "ardour/automation_list.h"
+#include "ardour/automation_prerender.h"
+
+#include "automation_prerender_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AutomationPrerenderTest);
+
+using namespace ARDOUR;
+using namespace Temporal;
+
+static const samplecnt_t block = 256;
+
+/* compare a pre-rendered block with the curve itself */
+static bool
+matches_curve (AutomationList& al, samplepos_t start, float const* vec)
+{
+	float ref[block];
+	if (!al.curve ().rt_safe_get_vector (timepos_t (start), timepos_t (start + block), ref, block)) {
+		return true; // list is locked, nothing to compare with
+	}
+	for (samplecnt_t i = 0; i < block; ++i) {
+		if (fabsf (vec[i] - ref[i]) > 1e-5f * (1.f + fabsf (ref[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+AutomationPrerenderTest::setUp ()
+{
+	_list.reset (new AutomationList (Evoral::Parameter (GainAutomation), TimeDomainProvider (AudioTime)));
+	_list->add (timepos_t (0), 0.1, false, false);
+	_list->add (timepos_t (48000), 1.0, false, false);
+	_list->add (timepos_t (60000), 0.5, false, false);
+	_list->add (timepos_t (200000), 2.0, false, false);
+}
+
+void
+AutomationPrerenderTest::tearDown ()
+{
+	_list.reset ();
+}
+
+/* Two readers of the same list (e.g. two routes slaved to a VCA), one of
+ * them 700 samples behind the other. Neither may discard values the other
+ * one still needs.
+ */
+void
+AutomationPrerenderTest::staggeredReadersTest ()
+{
+	AutomationPrerender pr (*_list, 16384);
+
+	samplecnt_t const offset[2] = { 0, 700 };
+	float             vec[block];
+
+	for (int cycle = 0; cycle < 600; ++cycle) {
+		pr.refill ();
+
+		for (int r = 0; r < 2; ++r) {
+			samplepos_t const start = 1000 + cycle * block - offset[r];
+			bool const        ok    = pr.read (start, vec, block);
+
+			if (ok) {
+				CPPUNIT_ASSERT_MESSAGE ("pre-rendered values differ from the curve", matches_curve (*_list, start, vec));
+			}
+			if (cycle > 2) {
+				/* both readers are served once the butler caught up */
+				CPPUNIT_ASSERT_MESSAGE ("staggered reader was not served", ok);
+			}
+		}
+	}
+
+	/* an edit invalidates the rendered data (the list does that for its own instance) */
+	_list->add (timepos_t (180000), 0.3, false, false);
+	pr.invalidate ();
+
+	int served = 0;
+	for (int cycle = 600; cycle < 620; ++cycle) {
+		pr.refill ();
+		for (int r = 0; r < 2; ++r) {
+			samplepos_t const start = 1000 + cycle * block - offset[r];
+			if (pr.read (start, vec, block)) {
+				CPPUNIT_ASSERT_MESSAGE ("stale values after an edit", matches_curve (*_list, start, vec));
+				++served;
+			}
+		}
+	}
+	CPPUNIT_ASSERT (served > 0);
+}
+
+/* The same, with the readers and the butler in threads of their own */
+void
+AutomationPrerenderTest::concurrentReadersTest ()
+{
+	AutomationPrerender pr (*_list, 16384);
+
+	std::atomic<bool> done (false);
+	std::atomic<int>  errors (0);
+	std::atomic<int>  served (0);
+
+	std::thread butler ([&] () {
+		while (!done.load ()) {
+			pr.refill ();
+			std::this_thread::yield ();
+		}
+	});
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 2; ++r) {
+		readers.push_back (std::thread ([&, r] () {
+			float vec[block];
+			for (int cycle = 0; cycle < 2000; ++cycle) {
+				samplepos_t const start = 1000 + (cycle * block) % 150000 - r * 700;
+				if (pr.read (start, vec, block)) {
+					served.fetch_add (1);
+					if (!matches_curve (*_list, start, vec)) {
+						errors.fetch_add (1);
+					}
+				}
+				std::this_thread::yield ();
+			}
+		}));
+	}
+
+	for (auto& t : readers) {
+		t.join ();
+	}
+	done.store (true);
+	butler.join ();
+
+	CPPUNIT_ASSERT_EQUAL (0, errors.load ());
+	CPPUNIT_ASSERT (served.load () > 0);
+}
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <cstring>
+#include <sched.h>
+#include <vector>
+
+#include "pbd/compose.h"
+
+#include "zita-convolver/zita-convolver.h"
+
+#include "convproc_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ConvprocTest);
+
+using namespace ArdourZita;
+
+static const uint32_t n_inp   = 2;
+static const uint32_t n_out   = 3;
+static const uint32_t quantum = 64;
+static const uint32_t ir_len  = 20000;
+
+static void
+setup (Convproc& cp, uint32_t nthr)
+{
+	cp.set_options (Convproc::OPT_VECTOR_MODE | Convproc::OPT_LATE_CONTIN);
+	CPPUNIT_ASSERT_EQUAL (0, cp.set_threads (nthr));
+	CPPUNIT_ASSERT_EQUAL (0, cp.configure (n_inp, n_out, ir_len, quantum, quantum, 1024, 0));
+
+	std::vector<float> ir (ir_len);
+	for (uint32_t i = 0; i < n_inp; ++i) {
+		for (uint32_t o = 0; o < n_out; ++o) {
+			for (uint32_t k = 0; k < ir_len; ++k) {
+				ir[k] = expf (-k * 3e-4f) * sinf (k * (.01f + .03f * i + .007f * o));
+			}
+			CPPUNIT_ASSERT_EQUAL (0, cp.impdata_create (i, o, 1, &ir[0], 0, ir_len));
+		}
+	}
+
+	cp.set_parallel (nthr > 1);
+	/* no realtime privileges needed */
+	CPPUNIT_ASSERT_EQUAL (0, cp.start_process (0, SCHED_OTHER));
+}
+
+/* The output must not depend on how many threads share a partition level,
+ * each input and output is processed by exactly one of them.
+ */
+void
+ConvprocTest::parallelTest ()
+{
+	Convproc::set_max_helpers (6);
+
+	Convproc single;
+	Convproc parallel;
+
+	setup (single, 1);
+	setup (parallel, 4);
+
+	for (uint32_t cycle = 0; cycle < 1000; ++cycle) {
+		for (uint32_t i = 0; i < n_inp; ++i) {
+			float* a = single.inpdata (i);
+			float* b = parallel.inpdata (i);
+			for (uint32_t k = 0; k < quantum; ++k) {
+				uint32_t const t = cycle * quantum + k;
+				a[k] = b[k] = sinf (t * (.05f + .02f * i)) * ((t / 3000) % 2 ? 1.f : .1f);
+			}
+		}
+
+		single.process ();
+		parallel.process ();
+
+		for (uint32_t o = 0; o < n_out; ++o) {
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("cycle: %1 out: %2", cycle, o),
+			                        0 == memcmp (single.outdata (o), parallel.outdata (o), quantum * sizeof (float)));
+		}
+	}
+
+	single.stop_process ();
+	parallel.stop_process ();
+	single.cleanup ();
+	parallel.cleanup ();
+
+	Convproc::set_max_helpers (UINT32_MAX);
+}
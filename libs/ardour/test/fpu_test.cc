@@ -1,4 +1,8 @@
 #include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
 #include "pbd/compose.h"
 #include "pbd/fpu.h"
 #include "pbd/malign.h"
@@ -83,6 +87,280 @@ FPUTest::run (size_t align_max, float const max_diff)
 			CPPUNIT_ASSERT_MESSAGE (string_compose ("Find peaks not aligned off: %1 cnt: %2", off, cnt), fabsf (pk_test - pk_comp) < 2e-6 && fabsf (pk_test_max - pk_comp_max) < 2e-6);
 		}
 	}
+
+	convert (align_max);
+	gain (align_max);
+	resample ();
+	convolve ();
+	meter ();
+}
+
+static bool
+same_or_nan (float a, float b)
+{
+	if (std::isnan (a) || std::isnan (b)) {
+		return std::isnan (a) && std::isnan (b);
+	}
+	return fabsf (a - b) <= 1e-5f * (1.f + fabsf (b));
+}
+
+/* Ballistic meters of 4 channels, a few cycles of different signals per channel */
+void
+FPUTest::meter ()
+{
+	ARDOUR::pframes_t const n = 1024;
+	std::vector<float> data (4 * n);
+	for (size_t i = 0; i < n; ++i) {
+		data[i]         = sinf (i * .01f);
+		data[n + i]     = .5f * sinf (i * .2f) + .3f * cosf (i * .07f);
+		data[2 * n + i] = (i % 64) < 32 ? .8f : -.2f;
+		data[3 * n + i] = 1e-3f * sinf (i * .5f);
+	}
+	ARDOUR::Sample const* bufs[4] = { &data[0], &data[n], &data[2 * n], &data[3 * n] };
+
+	float test[3][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+	float comp[3][4] = { { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+
+	for (int cycle = 0; cycle < 4; ++cycle) {
+		kmeter_bank (test[0], test[1], bufs, 4, n, 9.72f / 48000.f);
+		default_kmeter_bank (comp[0], comp[1], bufs, 4, n, 9.72f / 48000.f);
+		for (int c = 0; c < 4; ++c) {
+			for (int k = 0; k < 2; ++k) {
+				CPPUNIT_ASSERT_MESSAGE (string_compose ("K-meter cycle: %1 chn: %2", cycle, c), fabsf (test[k][c] - comp[k][c]) <= 1e-5f * (1.f + fabsf (comp[k][c])));
+			}
+		}
+	}
+
+	memset (test, 0, sizeof (test));
+	memset (comp, 0, sizeof (comp));
+
+	for (int cycle = 0; cycle < 4; ++cycle) {
+		iecppm_bank (test[0], test[1], test[2], bufs, 4, n, 450.f / 48000.f, 1300.f / 48000.f, 1.f - 5.4f / 48000.f);
+		default_iecppm_bank (comp[0], comp[1], comp[2], bufs, 4, n, 450.f / 48000.f, 1300.f / 48000.f, 1.f - 5.4f / 48000.f);
+		for (int c = 0; c < 4; ++c) {
+			for (int k = 0; k < 3; ++k) {
+				CPPUNIT_ASSERT_MESSAGE (string_compose ("IEC PPM cycle: %1 chn: %2", cycle, c), fabsf (test[k][c] - comp[k][c]) <= 1e-5f * (1.f + fabsf (comp[k][c])));
+			}
+		}
+	}
+
+	memset (test, 0, sizeof (test));
+	memset (comp, 0, sizeof (comp));
+
+	for (int cycle = 0; cycle < 4; ++cycle) {
+		vumeter_bank (test[0], test[1], test[2], bufs, 4, n, 11.1f / 48000.f);
+		default_vumeter_bank (comp[0], comp[1], comp[2], bufs, 4, n, 11.1f / 48000.f);
+		for (int c = 0; c < 4; ++c) {
+			for (int k = 0; k < 3; ++k) {
+				CPPUNIT_ASSERT_MESSAGE (string_compose ("VU meter cycle: %1 chn: %2", cycle, c), fabsf (test[k][c] - comp[k][c]) <= 1e-5f * (1.f + fabsf (comp[k][c])));
+			}
+		}
+	}
+
+	/* NaN in the signal (VU) or filter state (IEC) of one channel: the filter
+	 * state becomes NaN, but the maximum keeps its last value.
+	 */
+	data[n + 100] = std::numeric_limits<float>::quiet_NaN ();
+
+	float const mx[4] = { .1f, .2f, .3f, .4f };
+
+	memset (test, 0, sizeof (test));
+	memset (comp, 0, sizeof (comp));
+	memcpy (test[2], mx, sizeof (mx));
+	memcpy (comp[2], mx, sizeof (mx));
+
+	vumeter_bank (test[0], test[1], test[2], bufs, 4, n, 11.1f / 48000.f);
+	default_vumeter_bank (comp[0], comp[1], comp[2], bufs, 4, n, 11.1f / 48000.f);
+
+	CPPUNIT_ASSERT (std::isnan (comp[1][1]));
+	for (int c = 0; c < 4; ++c) {
+		for (int k = 0; k < 3; ++k) {
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("VU meter NaN chn: %1", c), same_or_nan (test[k][c], comp[k][c]));
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL (.2f, test[2][1]);
+
+	memset (test, 0, sizeof (test));
+	memset (comp, 0, sizeof (comp));
+	memcpy (test[2], mx, sizeof (mx));
+	memcpy (comp[2], mx, sizeof (mx));
+	test[0][2] = comp[0][2] = std::numeric_limits<float>::quiet_NaN ();
+
+	iecppm_bank (test[0], test[1], test[2], bufs, 4, n, 450.f / 48000.f, 1300.f / 48000.f, 1.f - 5.4f / 48000.f);
+	default_iecppm_bank (comp[0], comp[1], comp[2], bufs, 4, n, 450.f / 48000.f, 1300.f / 48000.f, 1.f - 5.4f / 48000.f);
+
+	CPPUNIT_ASSERT (std::isnan (comp[0][2]));
+	for (int c = 0; c < 4; ++c) {
+		for (int k = 0; k < 3; ++k) {
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("IEC PPM NaN chn: %1", c), same_or_nan (test[k][c], comp[k][c]));
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL (.3f, test[2][2]);
+}
+
+/* Convolver spectrum multiply-accumulate, in blocks of conv_vlen real and imaginary parts */
+void
+FPUTest::convolve ()
+{
+	uint32_t const n = 256;
+	std::vector<float> a (2 * n);
+	std::vector<float> b (2 * n);
+	std::vector<float> test (2 * n);
+	std::vector<float> comp (2 * n);
+	for (size_t i = 0; i < 2 * n; ++i) {
+		a[i] = sinf (i * .13f);
+		b[i] = cosf (i * .29f);
+		test[i] = comp[i] = .1f * sinf (i * .7f);
+	}
+
+	conv_mac (&test[0], &a[0], &b[0], n);
+
+	for (uint32_t k = 0; k < 2 * n; k += 2 * conv_vlen) {
+		for (uint32_t i = 0; i < conv_vlen; ++i) {
+			uint32_t const re = k + i;
+			uint32_t const im = k + conv_vlen + i;
+			comp[re] += a[re] * b[re] - a[im] * b[im];
+			comp[im] += a[re] * b[im] + a[im] * b[re];
+		}
+	}
+
+	for (size_t i = 0; i < 2 * n; ++i) {
+		CPPUNIT_ASSERT_MESSAGE (string_compose ("Convolver MAC vlen: %1 i: %2", conv_vlen, i), fabsf (test[i] - comp[i]) <= 4 * FLT_EPSILON);
+	}
+}
+
+/* VMResampler filter, for all filter lengths and input alignments */
+void
+FPUTest::resample ()
+{
+	std::vector<float> table (2048);
+	for (size_t i = 0; i < table.size (); ++i) {
+		table[i] = sinf (i * .3f) / (1.f + i * .01f);
+	}
+
+	for (uint32_t hl = 1; hl <= 96; ++hl) {
+		std::vector<float> test (2 * hl);
+		std::vector<float> comp (2 * hl);
+		float const* cq1 = &table[3];
+		float const* cq2 = &table[table.size () - hl - 5];
+		vmr_interpolate (&test[0], cq1, cq2, .3f, .7f, hl);
+		ArdourZita::VMResampler::default_interpolate (&comp[0], cq1, cq2, .3f, .7f, hl);
+		for (size_t i = 0; i < 2 * hl; ++i) {
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("Resampler interpolate hl: %1", hl), fabsf (test[i] - comp[i]) <= 2 * FLT_EPSILON);
+		}
+
+		for (size_t off = 0; off < 16; ++off) {
+			float const d_test = vmr_dot_product (&comp[0], &_comp1[off], 2 * hl);
+			float const d_comp = ArdourZita::VMResampler::default_dot_product (&comp[0], &_comp1[off], 2 * hl);
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("Resampler dot product hl: %1 off: %2", hl, off), fabsf (d_test - d_comp) <= 1e-5f * (1.f + fabsf (d_comp)));
+		}
+	}
+}
+
+/* per-sample gain, the ramp is computed in closed form by optimized functions */
+void
+FPUTest::gain (size_t align_max)
+{
+	std::vector<float> src (_size);
+	std::vector<float> gv (_size);
+	for (size_t i = 0; i < _size; ++i) {
+		src[i] = 1.2f * sinf (i * .37f);
+		gv[i]  = 1.f - i / (float) _size;
+	}
+
+	for (size_t off = 0; off < align_max; ++off) {
+		for (size_t cnt = 1; cnt < 3 * align_max; ++cnt) {
+			std::vector<float> test (src.begin () + off, src.begin () + off + cnt);
+			std::vector<float> comp (test);
+			apply_gain_vector_to_buffer (&test[0], &gv[off], cnt);
+			default_apply_gain_vector_to_buffer (&comp[0], &gv[off], cnt);
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("Apply gain vector off: %1 cnt: %2", off, cnt), test == comp);
+
+			mix_buffers_with_gain_vector (&test[0], &src[off], &gv[off], cnt);
+			default_mix_buffers_with_gain_vector (&comp[0], &src[off], &gv[off], cnt);
+			for (size_t i = 0; i < cnt; ++i) {
+				CPPUNIT_ASSERT_MESSAGE (string_compose ("Mix buffers w/gain vector off: %1 cnt: %2", off, cnt), fabsf (test[i] - comp[i]) <= 2 * FLT_EPSILON);
+			}
+		}
+	}
+
+	/* fade in and out, 25Hz LPF at 48kHz as used by Amp */
+	float const coeff    = 156.825f / 48000.f;
+	float const ramps[]  = { 0.f, 1.f, 1.f, 0.f, 0.5f, 2.f };
+
+	for (size_t r = 0; r < sizeof (ramps) / sizeof (float); r += 2) {
+		for (size_t cnt = 1; cnt <= _size; cnt = cnt < 3 * align_max ? cnt + 1 : cnt * 2) {
+			std::vector<float> test (src.begin (), src.begin () + cnt);
+			std::vector<float> comp (test);
+			float const g_test = apply_gain_ramp_to_buffer (&test[0], cnt, ramps[r], ramps[r + 1], coeff);
+			float const g_comp = default_apply_gain_ramp_to_buffer (&comp[0], cnt, ramps[r], ramps[r + 1], coeff);
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("Gain ramp result cnt: %1", cnt), fabsf (g_test - g_comp) < 2e-5);
+			for (size_t i = 0; i < cnt; ++i) {
+				CPPUNIT_ASSERT_MESSAGE (string_compose ("Gain ramp cnt: %1", cnt), fabsf (test[i] - comp[i]) < 2e-5);
+			}
+		}
+	}
+}
+
+/* sample format conversion must be bit-identical to gdither, i.e. the default */
+void
+FPUTest::convert (size_t align_max)
+{
+	struct Format {
+		float    scale;
+		int32_t  clamp_l;
+		int32_t  clamp_u;
+		uint32_t post_shift;
+	};
+
+	Format const formats[] = {
+		{ 32768.f, -32768, 32767, 0 },      // 16 bit
+		{ 128.f, -32768, 32767, 8 },        // 8 bit in 16 bit
+		{ 8388608.f, -8388608, 8388607, 8 } // 24 bit in 32 bit
+	};
+
+	float const special[] = { NAN, INFINITY, -INFINITY, 1e20f, -1e20f, 70000.f, -0.f, 0.5f / 32768, 1.5f / 32768, 1.f, -1.f, 1.5f, -1.5f };
+
+	std::vector<float> src (_size);
+	std::vector<float> noise (_size);
+	for (size_t i = 0; i < _size; ++i) {
+		src[i]   = 1.2f * sinf (i * .37f);
+		noise[i] = (i % 7) / 3.5f - 1.f;
+	}
+	for (size_t i = 0; i < sizeof (special) / sizeof (float); ++i) {
+		src[3 + 5 * i] = special[i];
+	}
+
+	for (size_t f = 0; f < sizeof (formats) / sizeof (Format); ++f) {
+		Format const& fmt (formats[f]);
+		for (size_t off = 0; off < align_max; ++off) {
+			for (size_t cnt = 1; cnt < 3 * align_max; ++cnt) {
+				for (int dither = 0; dither < 2; ++dither) {
+					float const* n = dither ? &noise[off] : 0;
+
+					std::vector<int16_t> i16_test (cnt), i16_comp (cnt);
+					float_to_int16 (&i16_test[0], &src[off], n, cnt, fmt.scale, fmt.clamp_l, fmt.clamp_u, fmt.post_shift);
+					default_float_to_int16 (&i16_comp[0], &src[off], n, cnt, fmt.scale, fmt.clamp_l, fmt.clamp_u, fmt.post_shift);
+					CPPUNIT_ASSERT_MESSAGE (string_compose ("Float to int16 format: %1 off: %2 cnt: %3", f, off, cnt), i16_test == i16_comp);
+
+					std::vector<int32_t> i32_test (cnt), i32_comp (cnt);
+					float_to_int32 (&i32_test[0], &src[off], n, cnt, fmt.scale, fmt.clamp_l, fmt.clamp_u, fmt.post_shift);
+					default_float_to_int32 (&i32_comp[0], &src[off], n, cnt, fmt.scale, fmt.clamp_l, fmt.clamp_u, fmt.post_shift);
+					CPPUNIT_ASSERT_MESSAGE (string_compose ("Float to int32 format: %1 off: %2 cnt: %3", f, off, cnt), i32_test == i32_comp);
+				}
+			}
+		}
+	}
+
+	for (size_t off = 0; off < align_max; ++off) {
+		for (size_t cnt = 1; cnt < 3 * align_max; ++cnt) {
+			std::vector<float> test (src.begin () + off, src.begin () + off + cnt);
+			std::vector<float> comp (test);
+			clip_floats (&test[0], cnt);
+			default_clip_floats (&comp[0], cnt);
+			CPPUNIT_ASSERT_MESSAGE (string_compose ("Clip floats off: %1 cnt: %2", off, cnt), memcmp (&test[0], &comp[0], cnt * sizeof (float)) == 0);
+		}
+	}
 }
 
 void
@@ -122,6 +400,33 @@ FPUTest::avxFmaTest ()
 	mix_buffers_with_gain = x86_fma_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 	copy_vector           = x86_sse_avx_copy_vector;
+#ifdef PLATFORM_WINDOWS
+	apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = x86_sse_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+	float_to_int16        = x86_sse2_float_to_int16;
+	float_to_int32        = x86_sse2_float_to_int32;
+	clip_floats           = x86_sse_clip_floats;
+	vmr_interpolate       = x86_sse_vmr_interpolate;
+	vmr_dot_product       = x86_sse_vmr_dot_product;
+	conv_mac              = x86_sse_conv_mac;
+	conv_vlen             = 4;
+#else
+	apply_gain_vector_to_buffer  = x86_sse_avx_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = x86_sse_avx_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+	float_to_int16        = x86_sse_avx_float_to_int16;
+	float_to_int32        = x86_sse_avx_float_to_int32;
+	clip_floats           = x86_sse_avx_clip_floats;
+	vmr_interpolate       = x86_sse_avx_vmr_interpolate;
+	vmr_dot_product       = x86_sse_avx_vmr_dot_product;
+	conv_mac              = x86_sse_avx_conv_mac;
+	conv_vlen             = 8;
+#endif
+
+	kmeter_bank           = x86_sse_kmeter_bank;
+	iecppm_bank           = x86_sse_iecppm_bank;
+	vumeter_bank          = x86_sse_vumeter_bank;
 
 	run (align_max, FLT_EPSILON);
 }
@@ -149,6 +454,33 @@ FPUTest::avxTest ()
 	mix_buffers_with_gain = x86_sse_avx_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 	copy_vector           = x86_sse_avx_copy_vector;
+#ifdef PLATFORM_WINDOWS
+	apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = x86_sse_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+	float_to_int16        = x86_sse2_float_to_int16;
+	float_to_int32        = x86_sse2_float_to_int32;
+	clip_floats           = x86_sse_clip_floats;
+	vmr_interpolate       = x86_sse_vmr_interpolate;
+	vmr_dot_product       = x86_sse_vmr_dot_product;
+	conv_mac              = x86_sse_conv_mac;
+	conv_vlen             = 4;
+#else
+	apply_gain_vector_to_buffer  = x86_sse_avx_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = x86_sse_avx_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+	float_to_int16        = x86_sse_avx_float_to_int16;
+	float_to_int32        = x86_sse_avx_float_to_int32;
+	clip_floats           = x86_sse_avx_clip_floats;
+	vmr_interpolate       = x86_sse_avx_vmr_interpolate;
+	vmr_dot_product       = x86_sse_avx_vmr_dot_product;
+	conv_mac              = x86_sse_avx_conv_mac;
+	conv_vlen             = 8;
+#endif
+
+	kmeter_bank           = x86_sse_kmeter_bank;
+	iecppm_bank           = x86_sse_iecppm_bank;
+	vumeter_bank          = x86_sse_vumeter_bank;
 
 	run (align_max);
 }
@@ -176,6 +508,25 @@ FPUTest::avx512fTest ()
 	mix_buffers_with_gain = x86_avx512f_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
 	copy_vector           = x86_avx512f_copy_vector;
+	apply_gain_vector_to_buffer  = x86_avx512f_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = x86_avx512f_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = x86_avx512f_mix_buffers_with_gain_vector;
+	float_to_int16        = x86_avx512f_float_to_int16;
+	float_to_int32        = x86_avx512f_float_to_int32;
+	clip_floats           = x86_avx512f_clip_floats;
+#ifdef PLATFORM_WINDOWS
+	vmr_interpolate       = x86_sse_vmr_interpolate;
+	vmr_dot_product       = x86_sse_vmr_dot_product;
+#else
+	vmr_interpolate       = x86_sse_avx_vmr_interpolate;
+	vmr_dot_product       = x86_sse_avx_vmr_dot_product;
+#endif
+	conv_mac              = x86_avx512f_conv_mac;
+	conv_vlen             = 16;
+
+	kmeter_bank           = x86_sse_kmeter_bank;
+	iecppm_bank           = x86_sse_iecppm_bank;
+	vumeter_bank          = x86_sse_vumeter_bank;
 
 	run (align_max, FLT_EPSILON);
 }
@@ -203,6 +554,25 @@ FPUTest::sseTest ()
 	mix_buffers_with_gain = x86_sse_mix_buffers_with_gain;
 	mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 	copy_vector           = default_copy_vector;
+	apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = x86_sse_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+#ifdef __SSE2__
+	float_to_int16        = x86_sse2_float_to_int16;
+	float_to_int32        = x86_sse2_float_to_int32;
+#else
+	float_to_int16        = default_float_to_int16;
+	float_to_int32        = default_float_to_int32;
+#endif
+	clip_floats           = x86_sse_clip_floats;
+	vmr_interpolate       = x86_sse_vmr_interpolate;
+	vmr_dot_product       = x86_sse_vmr_dot_product;
+	conv_mac              = x86_sse_conv_mac;
+	conv_vlen             = 4;
+
+	kmeter_bank           = x86_sse_kmeter_bank;
+	iecppm_bank           = x86_sse_iecppm_bank;
+	vumeter_bank          = x86_sse_vumeter_bank;
 
 	run (align_max);
 }
@@ -227,6 +597,25 @@ FPUTest::neonTest ()
 	mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
 	mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 	copy_vector           = arm_neon_copy_vector;
+	apply_gain_vector_to_buffer  = arm_neon_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = arm_neon_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = arm_neon_mix_buffers_with_gain_vector;
+#ifdef __aarch64__
+	float_to_int16        = arm_neon_float_to_int16;
+	float_to_int32        = arm_neon_float_to_int32;
+#else
+	float_to_int16        = default_float_to_int16;
+	float_to_int32        = default_float_to_int32;
+#endif
+	clip_floats           = arm_neon_clip_floats;
+	vmr_interpolate       = arm_neon_vmr_interpolate;
+	vmr_dot_product       = arm_neon_vmr_dot_product;
+	conv_mac              = arm_neon_conv_mac;
+	conv_vlen             = 4;
+
+	kmeter_bank           = arm_neon_kmeter_bank;
+	iecppm_bank           = arm_neon_iecppm_bank;
+	vumeter_bank          = arm_neon_vumeter_bank;
 
 	run (128);
 }
@@ -251,6 +640,20 @@ FPUTest::veclibTest ()
 	mix_buffers_with_gain = veclib_mix_buffers_with_gain;
 	mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 	copy_vector           = default_copy_vector;
+	apply_gain_vector_to_buffer  = veclib_apply_gain_vector_to_buffer;
+	apply_gain_ramp_to_buffer    = default_apply_gain_ramp_to_buffer;
+	mix_buffers_with_gain_vector = veclib_mix_buffers_with_gain_vector;
+	float_to_int16        = default_float_to_int16;
+	float_to_int32        = default_float_to_int32;
+	clip_floats           = default_clip_floats;
+	vmr_interpolate       = ArdourZita::VMResampler::default_interpolate;
+	vmr_dot_product       = ArdourZita::VMResampler::default_dot_product;
+	conv_mac              = ArdourZita::Convproc::default_mac;
+	conv_vlen             = 4;
+
+	kmeter_bank           = default_kmeter_bank;
+	iecppm_bank           = default_iecppm_bank;
+	vumeter_bank          = default_vumeter_bank;
 
 #ifdef  __aarch64__
 	run (16, FLT_EPSILON);
@@ -2,6 +2,9 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "ardour/runtime_functions.h"
+#include "audiographer/routines.h"
+#include "zita-convolver/zita-convolver.h"
+#include "zita-resampler/vmresampler.h"
 
 class FPUTest : public CppUnit::TestFixture
 {
@@ -40,6 +43,11 @@ public:
 private:
 	void run (size_t, float const max_diff = 0);
 	void compare (std::string, size_t, float const max_diff = 0);
+	void convert (size_t);
+	void gain (size_t);
+	void resample ();
+	void convolve ();
+	void meter ();
 
 	ARDOUR::compute_peak_t          compute_peak;
 	ARDOUR::find_peaks_t            find_peaks;
@@ -48,6 +56,24 @@ private:
 	ARDOUR::mix_buffers_no_gain_t   mix_buffers_no_gain;
 	ARDOUR::copy_vector_t           copy_vector;
 
+	ARDOUR::apply_gain_vector_to_buffer_t  apply_gain_vector_to_buffer;
+	ARDOUR::apply_gain_ramp_to_buffer_t    apply_gain_ramp_to_buffer;
+	ARDOUR::mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
+
+	ARDOUR::kmeter_bank_t  kmeter_bank;
+	ARDOUR::iecppm_bank_t  iecppm_bank;
+	ARDOUR::vumeter_bank_t vumeter_bank;
+
+	AudioGrapher::Routines::float_to_int16_t float_to_int16;
+	AudioGrapher::Routines::float_to_int32_t float_to_int32;
+	AudioGrapher::Routines::clip_floats_t    clip_floats;
+
+	ArdourZita::VMResampler::interpolate_t vmr_interpolate;
+	ArdourZita::VMResampler::dot_product_t vmr_dot_product;
+
+	ArdourZita::Convproc::mac_t conv_mac;
+	uint32_t                    conv_vlen;
+
 	size_t _size;
 
 	float* _test1;
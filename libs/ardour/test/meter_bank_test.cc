@@ -0,0 +1,110 @@
+#include <cmath>
+#include <vector>
+
+#include "pbd/compose.h"
+
+#include "ardour/iec1ppmdsp.h"
+#include "ardour/iec2ppmdsp.h"
+#include "ardour/kmeterdsp.h"
+#include "ardour/meter_bank.h"
+#include "ardour/vumeterdsp.h"
+
+#include "meter_bank_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MeterBankTest);
+
+using namespace ARDOUR;
+
+/* two groups of 4, the second one partial */
+static const uint32_t n_chan = 7;
+static const uint32_t n_samp = 256;
+static const float    fsamp  = 48000;
+
+/* channels with data in each cycle, mostly fewer than n_chan */
+static const uint32_t n_bufs[] = { 7, 5, 2, 6, 7, 4, 1, 3 };
+
+static float
+signal (uint32_t c, uint32_t t)
+{
+	return (.2f + .1f * c) * sinf (t * (.01f + .013f * c)) * (((t / 5000) + c) % 2 ? 1.f : .05f);
+}
+
+/* The bank must give exactly the same readings as one Kmeterdsp,
+ * Iec1ppmdsp, Iec2ppmdsp and Vumeterdsp per channel.
+ */
+void
+MeterBankTest::referenceTest ()
+{
+	MeterBank::init (fsamp);
+	Kmeterdsp::init (fsamp);
+	Iec1ppmdsp::init (fsamp);
+	Iec2ppmdsp::init (fsamp);
+	Vumeterdsp::init (fsamp);
+
+	MeterBank bank;
+	bank.set_channels (n_chan);
+	CPPUNIT_ASSERT_EQUAL (n_chan, bank.n_channels ());
+
+	std::vector<Kmeterdsp>  k (n_chan);
+	std::vector<Iec1ppmdsp> iec1 (n_chan);
+	std::vector<Iec2ppmdsp> iec2 (n_chan);
+	std::vector<Vumeterdsp> vu (n_chan);
+
+	std::vector<float> data (n_chan * n_samp);
+	Sample const*      bufs[n_chan];
+
+	for (uint32_t cycle = 0; cycle < 800; ++cycle) {
+		uint32_t const nb = n_bufs[cycle % (sizeof (n_bufs) / sizeof (n_bufs[0]))];
+
+		/* now and then, only some of the meters run */
+		MeterType const types = (cycle % 5 == 4)
+			? MeterType (MeterIEC1NOR | MeterVU)
+			: MeterType (MeterKrms | MeterIEC1DIN | MeterIEC2BBC | MeterVU);
+
+		for (uint32_t c = 0; c < nb; ++c) {
+			for (uint32_t i = 0; i < n_samp; ++i) {
+				data[c * n_samp + i] = signal (c, cycle * n_samp + i);
+			}
+			bufs[c] = &data[c * n_samp];
+
+			if (types & MeterKrms) {
+				k[c].process (bufs[c], n_samp);
+			}
+			if (types & MeterIEC2BBC) {
+				iec2[c].process (bufs[c], n_samp);
+			}
+			iec1[c].process (bufs[c], n_samp);
+			vu[c].process (bufs[c], n_samp);
+		}
+
+		bank.process (types, bufs, nb, n_samp);
+
+		/* read every channel every few cycles, each at a different
+		 * time, which resets its maximum in the next cycle
+		 */
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			if ((cycle + c) % 3) {
+				continue;
+			}
+			std::string const msg = string_compose ("cycle: %1 channel: %2", cycle, c);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, k[c].read (), bank.read (MeterK20, c));
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, iec1[c].read (), bank.read (MeterIEC1NOR, c));
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, iec2[c].read (), bank.read (MeterIEC2EBU, c));
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, vu[c].read (), bank.read (MeterVU, c));
+		}
+
+		/* and start over, in the middle */
+		if (cycle == 400) {
+			bank.reset ();
+			for (uint32_t c = 0; c < n_chan; ++c) {
+				k[c].reset ();
+				iec1[c].reset ();
+				iec2[c].reset ();
+				vu[c].reset ();
+			}
+		}
+	}
+
+	/* channels beyond the bank's */
+	CPPUNIT_ASSERT_EQUAL (0.f, bank.read (MeterVU, n_chan));
+}
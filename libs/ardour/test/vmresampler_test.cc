@@ -0,0 +1,116 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "pbd/compose.h"
+
+#include "zita-resampler/vmresampler.h"
+
+#include "vmresampler_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (VMResamplerTest);
+
+using namespace ArdourZita;
+
+/* in-sync resamplers, plus one that is not */
+static const unsigned int n_sync = 5;
+static const unsigned int n_res  = n_sync + 1;
+static const unsigned int hlen   = 32;
+
+static float
+signal (unsigned int c, unsigned int t)
+{
+	return sinf (t * (.013f + .007f * c)) * (((t / 1000) + c) % 2 ? 1.f : .2f);
+}
+
+/* A resampler that is set up and processed alike the others, but does not
+ * share their phase. The batch is split around it.
+ */
+static const unsigned int odd = 2;
+
+static void
+setup (VMResampler* r)
+{
+	for (unsigned int c = 0; c < n_res; ++c) {
+		CPPUNIT_ASSERT_EQUAL (0, r[c].setup (hlen));
+		r[c].set_rrfilt (8);
+	}
+	r[odd].set_phase (.3);
+}
+
+/* Processing the resamplers in one batch must give exactly the same
+ * result as processing each of them on its own.
+ */
+void
+VMResamplerTest::batchTest ()
+{
+	VMResampler single[n_res];
+	VMResampler batch[n_res];
+	VMResampler* b[n_res];
+
+	setup (single);
+	setup (batch);
+
+	for (unsigned int c = 0; c < n_res; ++c) {
+		b[c] = &batch[c];
+	}
+
+	/* absolute position of the next input sample of each resampler */
+	unsigned int pos[n_res] = { 0 };
+	unsigned int n_wrap = 0;
+
+	for (unsigned int cycle = 0; cycle < 500; ++cycle) {
+		/* vary the ratio, and the cycle size, from less to more than
+		 * the delay line (_inmax) of each resampler
+		 */
+		const double       ratio = 1.0 + .2 * sin (cycle * .05) + .01;
+		const unsigned int n_out = 16 + (cycle * 97) % 700;
+		const unsigned int n_inp = n_out * 1.3 + 2 * hlen;
+
+		std::vector<float> inp (n_res * n_inp);
+		std::vector<float> out_single (n_res * n_out, 0);
+		std::vector<float> out_batch (n_res * n_out, 0);
+
+		for (unsigned int c = 0; c < n_res; ++c) {
+			for (unsigned int k = 0; k < n_inp; ++k) {
+				inp[c * n_inp + k] = signal (c, pos[c] + k);
+			}
+
+			CPPUNIT_ASSERT_EQUAL (single[c].set_rratio (ratio), batch[c].set_rratio (ratio));
+
+			single[c].inp_count = batch[c].inp_count = n_inp;
+			single[c].out_count = batch[c].out_count = n_out;
+			single[c].inp_data  = batch[c].inp_data  = &inp[c * n_inp];
+			single[c].out_data  = &out_single[c * n_out];
+			batch[c].out_data   = &out_batch[c * n_out];
+		}
+
+		for (unsigned int c = 0; c < n_res; ++c) {
+			single[c].process ();
+		}
+
+		VMResampler::process (b, n_res);
+
+		for (unsigned int c = 0; c < n_res; ++c) {
+			const std::string msg = string_compose ("cycle: %1 resampler: %2", cycle, c);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, single[c].inp_count, batch[c].inp_count);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, single[c].out_count, batch[c].out_count);
+			CPPUNIT_ASSERT_MESSAGE (msg, single[c].inp_data == batch[c].inp_data);
+			CPPUNIT_ASSERT_EQUAL_MESSAGE (msg, single[c].inpdist (), batch[c].inpdist ());
+			CPPUNIT_ASSERT_MESSAGE (msg, 0 == memcmp (&out_single[c * n_out], &out_batch[c * n_out], n_out * sizeof (float)));
+
+			pos[c] += n_inp - single[c].inp_count;
+		}
+
+		/* reading more than the delay line holds wraps it within the cycle */
+		if (n_inp - single[0].inp_count > 250) {
+			++n_wrap;
+		}
+
+		/* the odd one is still out, and the others are still in sync */
+		CPPUNIT_ASSERT (single[odd].inpdist () != single[0].inpdist ());
+		CPPUNIT_ASSERT_EQUAL (single[0].inpdist (), single[n_sync].inpdist ());
+	}
+
+	CPPUNIT_ASSERT (n_wrap > 0);
+}
@@ -57,7 +57,7 @@ proc_type_map (std::string const& str)
   }
 }
 
-UnknownProcessor::UnknownProcessor (Session&s, XMLNode const &state, SessionObject* o)
+UnknownProcessor::UnknownProcessor (Session&s, XMLNode const &state, SessionObject* o, bool with_sidechain)
 	: Processor (s, "", Temporal::TimeDomainProvider (Temporal::AudioTime))
 	, _state (state)
 	, have_ioconfig (false)
@@ -92,7 +92,7 @@ UnknownProcessor::UnknownProcessor (Session&s, XMLNode const &state, SessionObje
 		/* sidechain is a Processor (IO)
 		 * add a SC port to retain connections
 		 */
-		if ((*i)->name () ==  Processor::state_node_name) {
+		if (with_sidechain && (*i)->name () ==  Processor::state_node_name) {
 			add_sidechain_from_xml (**i, Stateful::loading_state_version);
 		}
 	}
@@ -104,6 +104,16 @@ UnknownProcessor::~UnknownProcessor () {
 	delete saved_output;
 }
 
+/* The sidechain ports are not needed while the route is inactive. The
+ * plugin's state retains their connections, and the PluginInsert that
+ * replaces this re-creates them.
+ */
+DeferredProcessor::DeferredProcessor (Session& s, XMLNode const& state, SessionObject* o)
+	: UnknownProcessor (s, state, o, false)
+	, _version (Stateful::loading_state_version)
+{
+}
+
 XMLNode &
 UnknownProcessor::state () const
 {
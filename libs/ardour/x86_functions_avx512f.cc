@@ -20,6 +20,7 @@
 
 #include "ardour/mix.h"
 
+#include <climits>
 #include <immintrin.h>
 
 #define IS_ALIGNED_TO(ptr, bytes) \
@@ -1146,4 +1147,217 @@ x86_avx512f_copy_vector(float *dst, const float *src, uint32_t nframes)
 	_mm256_zeroupper(); // zeros the upper portion of YMM register
 }
 
+/**
+ * @brief x86-64 AVX-512F optimized routine for clipping to [-1, 1]
+ * @param[in,out] buf Pointer to buffer
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_clip_floats(float *buf, uint32_t nframes)
+{
+	const __m512 one = _mm512_set1_ps(1.0f);
+	const __m512 mone = _mm512_set1_ps(-1.0f);
+
+	while (nframes >= 16) {
+		// min/max return the 2nd operand if one is NaN, which keeps NaN
+		__m512 x = _mm512_loadu_ps(buf);
+		x = _mm512_max_ps(mone, _mm512_min_ps(one, x));
+		_mm512_storeu_ps(buf, x);
+		buf += 16;
+		nframes -= 16;
+	}
+
+	_mm256_zeroupper();
+
+	default_clip_floats(buf, nframes);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for applying a gain vector
+ * @param[in,out] buf Pointer to buffer
+ * @param[in] gain Pointer to per-sample gain
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_apply_gain_vector_to_buffer(float *buf, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps(buf, _mm512_mul_ps(_mm512_loadu_ps(buf), _mm512_loadu_ps(gain)));
+		buf += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	_mm256_zeroupper();
+
+	default_apply_gain_vector_to_buffer(buf, gain, nframes);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for an exponential gain ramp
+ *
+ * @details The one-pole ramp g += coeff * (target - g) is evaluated in
+ * closed form, g[i] = target + (g[0] - target) * (1 - coeff)^i
+ *
+ * @return gain following the last sample
+ */
+float
+x86_avx512f_apply_gain_ramp_to_buffer(float *buf, uint32_t nframes, float gain, float target, float coeff)
+{
+	if (nframes >= 16) {
+		const float r = 1.f - coeff;
+		float d[16];
+		float r16 = 1.f;
+		d[0] = gain - target;
+		for (int i = 1; i < 16; ++i) {
+			d[i] = d[i - 1] * r;
+		}
+		for (int i = 0; i < 16; ++i) {
+			r16 *= r;
+		}
+
+		const __m512 vtarget = _mm512_set1_ps(target);
+		const __m512 step = _mm512_set1_ps(r16);
+		__m512 delta = _mm512_loadu_ps(d);
+
+		while (nframes >= 16) {
+			_mm512_storeu_ps(buf, _mm512_mul_ps(_mm512_loadu_ps(buf), _mm512_add_ps(vtarget, delta)));
+			delta = _mm512_mul_ps(delta, step);
+			buf += 16;
+			nframes -= 16;
+		}
+
+		gain = target + _mm512_cvtss_f32(delta);
+
+		_mm256_zeroupper();
+	}
+
+	return default_apply_gain_ramp_to_buffer(buf, nframes, gain, target, coeff);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffers with a gain vector
+ *
+ * @details dst = dst + (gain * src), per element
+ */
+void
+x86_avx512f_mix_buffers_with_gain_vector(float *dst, const float *src, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		__m512 x = _mm512_loadu_ps(dst);
+		x = _mm512_fmadd_ps(_mm512_loadu_ps(src), _mm512_loadu_ps(gain), x);
+		_mm512_storeu_ps(dst, x);
+		dst += 16;
+		src += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	_mm256_zeroupper();
+
+	default_mix_buffers_with_gain_vector(dst, src, gain, nframes);
+}
+
+/**
+ * @brief Scale, dither and round 16 samples, clamp and shift the result
+ *
+ * @details Clamping is done before rounding, in the same way as lrintf()
+ * followed by integer clamping: lrintf() returns LONG_MIN for NaN and
+ * values that are too large, which end up at clamp_l.
+ */
+static inline __m512i
+avx512f_quantize(const float *src, const float *noise, __m512 scale, __m512 clamp_l, __m512 clamp_u, __m512 limit, __m128i post_shift)
+{
+	__m512 x = _mm512_mul_ps(_mm512_loadu_ps(src), scale);
+	if (noise) {
+		x = _mm512_sub_ps(x, _mm512_loadu_ps(noise));
+	}
+	const __mmask16 overflow = _mm512_cmp_ps_mask(x, limit, _CMP_GE_OQ);
+	x = _mm512_min_ps(_mm512_max_ps(x, clamp_l), clamp_u);
+	x = _mm512_mask_blend_ps(overflow, x, clamp_l);
+	return _mm512_sll_epi32(_mm512_cvtps_epi32(x), post_shift);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for float to 16 bit conversion
+ * @details Bit-identical to default_float_to_int16()
+ */
+void
+x86_avx512f_float_to_int16(int16_t *dst, const float *src, const float *noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	const __m512 vscale = _mm512_set1_ps(scale);
+	const __m512 vlo = _mm512_set1_ps((float)clamp_l);
+	const __m512 vhi = _mm512_set1_ps((float)clamp_u);
+	const __m512 vlimit = _mm512_set1_ps(-(float)LONG_MIN);
+	const __m128i vshift = _mm_cvtsi32_si128(post_shift);
+
+	while (nframes >= 16) {
+		const __m512i x = avx512f_quantize(src, noise, vscale, vlo, vhi, vlimit, vshift);
+		// truncate to 16 bit, like a cast
+		_mm256_storeu_si256((__m256i *)dst, _mm512_cvtepi32_epi16(x));
+		src += 16;
+		dst += 16;
+		noise = noise ? noise + 16 : 0;
+		nframes -= 16;
+	}
+
+	_mm256_zeroupper();
+
+	default_float_to_int16(dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for float to 32 bit conversion
+ * @details Bit-identical to default_float_to_int32()
+ */
+void
+x86_avx512f_float_to_int32(int32_t *dst, const float *src, const float *noise, uint32_t nframes, float scale, int32_t clamp_l, int32_t clamp_u, uint32_t post_shift)
+{
+	const __m512 vscale = _mm512_set1_ps(scale);
+	const __m512 vlo = _mm512_set1_ps((float)clamp_l);
+	const __m512 vhi = _mm512_set1_ps((float)clamp_u);
+	const __m512 vlimit = _mm512_set1_ps(-(float)LONG_MIN);
+	const __m128i vshift = _mm_cvtsi32_si128(post_shift);
+
+	while (nframes >= 16) {
+		_mm512_storeu_si512(dst, avx512f_quantize(src, noise, vscale, vlo, vhi, vlimit, vshift));
+		src += 16;
+		dst += 16;
+		noise = noise ? noise + 16 : 0;
+		nframes -= 16;
+	}
+
+	_mm256_zeroupper();
+
+	default_float_to_int32(dst, src, noise, nframes, scale, clamp_l, clamp_u, post_shift);
+}
+
+
+/**
+ * @brief x86-64 AVX-512F optimized spectrum multiply-accumulate for the Convolver
+ *
+ * @details Blocks of 16 real parts followed by 16 imaginary parts,
+ * see ArdourZita::Convproc::mac_t
+ */
+void
+x86_avx512f_conv_mac(float *d, const float *a, const float *b, uint32_t n)
+{
+	for (; n > 0; n -= 16) {
+		const __m512 ar = _mm512_loadu_ps(a);
+		const __m512 ai = _mm512_loadu_ps(a + 16);
+		const __m512 br = _mm512_loadu_ps(b);
+		const __m512 bi = _mm512_loadu_ps(b + 16);
+		__m512 re = _mm512_fmadd_ps(ar, br, _mm512_loadu_ps(d));
+		__m512 im = _mm512_fmadd_ps(ar, bi, _mm512_loadu_ps(d + 16));
+		re = _mm512_fnmadd_ps(ai, bi, re);
+		im = _mm512_fmadd_ps(ai, br, im);
+		_mm512_storeu_ps(d, re);
+		_mm512_storeu_ps(d + 16, im);
+		a += 32;
+		b += 32;
+		d += 32;
+	}
+
+	_mm256_zeroupper();
+}
 #endif // FPU_AVX512F_SUPPORT
@@ -0,0 +1,244 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AUDIOGRAPHER_ASYNC_WRITER_H
+#define AUDIOGRAPHER_ASYNC_WRITER_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+
+#include "pbd/pthread_utils.h"
+#include "pbd/ringbuffer.h"
+#include "pbd/semutils.h"
+
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/sink.h"
+#include "audiographer/throwing.h"
+#include "audiographer/types.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/** Passes data on to its outputs from a thread of its own.
+ *
+ * Data given to process() is queued in a lock-free ringbuffer, and an
+ * encoder thread calls the outputs (usually a single file writer). This
+ * allows rendering and (slow) encoding to overlap. When the queue is full,
+ * process() blocks until the encoder caught up.
+ *
+ * process() returns from the context with EndOfInput only after all
+ * outputs processed all data, so that a file is complete once the
+ * last cycle was processed. Exceptions thrown by outputs are re-thrown
+ * by the next call to process().
+ */
+template <typename T = DefaultSampleType>
+class AsyncWriter
+	: public ListedSource<T>
+	, public Sink<T>
+	, public Throwing<>
+	, public FlagDebuggable<>
+{
+  public:
+	/** Constructor
+	 * \param channels channel count
+	 * \param chunk_size maximum number of samples passed to the outputs at once
+	 * \param queue_size number of samples that can be queued
+	 */
+	AsyncWriter (ChannelCount channels, samplecnt_t chunk_size, samplecnt_t queue_size)
+		: _channels (channels)
+		, _chunk_size (std::max<samplecnt_t> (channels, chunk_size - (chunk_size % channels)))
+		, _buffer (_chunk_size)
+		, _rb (std::max (queue_size, 2 * _chunk_size))
+		, _data ("AsyncWriterData", 0)
+		, _space ("AsyncWriterSpace", 0)
+		, _done ("AsyncWriterDone", 0)
+		, _thread (0)
+	{
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+
+		_end.store (false);
+		_quit.store (false);
+		_failed.store (false);
+		_encoder_waiting.store (false);
+		_producer_waiting.store (false);
+
+		_thread = PBD::Thread::create (boost::bind (&AsyncWriter::encoder_thread, this), "ExportEncoder");
+	}
+
+	~AsyncWriter ()
+	{
+		stop ();
+	}
+
+	/** Queue data, and wake up the encoder thread.
+	 * Blocks while the queue is full, and at the end of input until
+	 * the outputs processed everything.
+	 */
+	void process (ProcessContext<T> const & c)
+	{
+		check_flags (*this, c);
+
+		if (throw_level (ThrowStrict) && c.channels () != _channels) {
+			throw Exception (*this, boost::str (boost::format
+				("Wrong number of channels given to process(), %1% instead of %2%")
+				% c.channels () % _channels));
+		}
+
+		if (!_thread) {
+			/* no encoder thread (could not be created, or stopped): process in place */
+			ListedSource<T>::output (c);
+			return;
+		}
+
+		rethrow_failure ();
+
+		T const*    data   = c.data ();
+		samplecnt_t remain = c.samples ();
+
+		while (remain > 0) {
+			samplecnt_t n = std::min<samplecnt_t> (remain, _rb.write_space ());
+			n -= n % _channels;
+			if (n == 0) {
+				/* back-pressure: wait for the encoder to make room */
+				_producer_waiting.store (true);
+				if ((samplecnt_t) _rb.write_space () < _channels) {
+					_space.wait ();
+				}
+				_producer_waiting.store (false);
+				rethrow_failure ();
+				continue;
+			}
+			_rb.write (data, n);
+			data   += n;
+			remain -= n;
+			wake_encoder ();
+		}
+
+		if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			_end.store (true);
+			wake_encoder ();
+			_done.wait ();
+			rethrow_failure ();
+		}
+	}
+
+	using Sink<T>::process;
+
+	/** Terminate the encoder thread, dropping any queued data.
+	 * Must not be called concurrently with process()
+	 */
+	void stop ()
+	{
+		if (!_thread) {
+			return;
+		}
+		_quit.store (true);
+		_encoder_waiting.store (false);
+		_data.signal ();
+		_thread->join ();
+		delete _thread;
+		_thread = 0;
+	}
+
+  private:
+	AsyncWriter (AsyncWriter const &);
+
+	void encoder_thread ()
+	{
+		while (!_quit.load ()) {
+			/* all data is queued, once the end was flagged */
+			bool const  end = _end.load ();
+			samplecnt_t n   = std::min<samplecnt_t> (_rb.read_space (), _chunk_size);
+
+			if (n == 0 && !end) {
+				_encoder_waiting.store (true);
+				if (_rb.read_space () == 0 && !_end.load () && !_quit.load ()) {
+					_data.wait ();
+				}
+				_encoder_waiting.store (false);
+				continue;
+			}
+
+			_rb.read (&_buffer[0], n);
+			if (_producer_waiting.exchange (false)) {
+				_space.signal ();
+			}
+
+			bool const last = end && _rb.read_space () == 0;
+
+			if (!_failed.load ()) {
+				ProcessContext<T> c_out (&_buffer[0], n, _channels);
+				if (last) {
+					c_out.set_flag (ProcessContext<T>::EndOfInput);
+				}
+				try {
+					ListedSource<T>::output (c_out);
+				} catch (...) {
+					/* keep draining the queue, so that process() does not block */
+					_exception = std::current_exception ();
+					_failed.store (true);
+				}
+			}
+
+			if (last) {
+				_end.store (false);
+				_done.signal ();
+			}
+		}
+	}
+
+	void wake_encoder ()
+	{
+		if (_encoder_waiting.exchange (false)) {
+			_data.signal ();
+		}
+	}
+
+	void rethrow_failure ()
+	{
+		if (_failed.load ()) {
+			std::rethrow_exception (_exception);
+		}
+	}
+
+	ChannelCount       _channels;
+	samplecnt_t        _chunk_size;
+	std::vector<T>     _buffer;
+	PBD::RingBuffer<T> _rb;
+
+	PBD::Semaphore     _data;
+	PBD::Semaphore     _space;
+	PBD::Semaphore     _done;
+
+	std::atomic<bool>  _end;
+	std::atomic<bool>  _quit;
+	std::atomic<bool>  _failed;
+	std::atomic<bool>  _encoder_waiting;
+	std::atomic<bool>  _producer_waiting;
+	std::exception_ptr _exception;
+
+	PBD::Thread*       _thread;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_ASYNC_WRITER_H
@@ -55,13 +55,30 @@ class LIBAUDIOGRAPHER_API SampleFormatConverter
   private:
 	void reset();
 	void init_common (samplecnt_t max_samples); // not-template-specialized part of init
+	void init_routines (samplecnt_t max_samples, int type, int bit_depth, int data_width, int32_t clamp_l, int32_t clamp_u);
 	void check_sample_and_channel_count (samplecnt_t samples, ChannelCount channels_);
 
+	bool          convert (float const * data, samplecnt_t samples);
+	float const * dither_noise (samplecnt_t samples);
+
 	ChannelCount channels;
 	GDither      dither;
 	samplecnt_t   data_out_size;
 	TOut *       data_out;
 
+	/* Conversion by Routines::float_to_int16/32, used for all but shaped dither */
+	static const unsigned int noise_streams = 8;
+
+	bool         use_routines;
+	int          dither_type;
+	float        scale;
+	int32_t      clamp_l;
+	int32_t      clamp_u;
+	uint32_t     post_shift;
+	float *      noise;
+	float *      tri_state;
+	uint32_t     noise_state[noise_streams];
+
 	bool         clip_floats;
 
 };
@@ -1,23 +1,18 @@
 #ifndef AUDIOGRAPHER_THREADER_H
 #define AUDIOGRAPHER_THREADER_H
 
-#include <atomic>
+#include <memory>
 #include <vector>
 #include <algorithm>
 
-#include <glibmm/threadpool.h>
-#include <glibmm/timeval.h>
-#include <sigc++/slot.h>
+#include <glibmm/threads.h>
 #include <boost/format.hpp>
 
-#include <glib.h>
-
-#include "pbd/atomic.h"
-
 #include "audiographer/visibility.h"
 #include "audiographer/source.h"
 #include "audiographer/sink.h"
 #include "audiographer/exception.h"
+#include "audiographer/general/worker_pool.h"
 
 namespace AudioGrapher
 {
@@ -37,7 +32,7 @@ class /*LIBAUDIOGRAPHER_API*/ ThreaderException : public Exception
 
 /// Class for distributing processing across several threads
 template <typename T = DefaultSampleType>
-class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>
+class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>, private WorkerPool::Job
 {
   private:
 	typedef std::vector<typename Source<T>::SinkPtr> OutputVec;
@@ -46,14 +41,12 @@ class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>
 
 	/** Constructor
 	  * \n RT safe
-	  * \param thread_pool a thread pool from which all tasks are scheduled
-	  * \param wait_timeout_milliseconds maximum time allowed for threads to use in processing
+	  * \param worker_pool a pool of threads which processes the outputs
 	  */
-	Threader (Glib::ThreadPool & thread_pool, long wait_timeout_milliseconds = 500)
-	  : thread_pool (thread_pool)
-	  , wait_timeout (wait_timeout_milliseconds)
+	Threader (WorkerPool & worker_pool)
+	  : worker_pool (worker_pool)
+	  , context (0)
 	{
-		readers.store (0);
 	}
 
 	virtual ~Threader () {}
@@ -70,64 +63,43 @@ class /*LIBAUDIOGRAPHER_API*/ Threader : public Source<T>, public Sink<T>
 		outputs.erase (new_end, outputs.end());
 	}
 
-	/// Processes context concurrently by scheduling each output separately to the given thread pool
+	/** Processes context concurrently, each output is a task of the worker pool.
+	  * All outputs share the given context, which remains valid since this
+	  * only returns once all outputs are done.
+	  */
 	void process (ProcessContext<T> const & c)
 	{
-		wait_mutex.lock();
-
 		exception.reset();
 
-		unsigned int outs = outputs.size();
-		(void) readers.fetch_add (outs);
-		for (unsigned int i = 0; i < outs; ++i) {
-			thread_pool.push (sigc::bind (sigc::mem_fun (this, &Threader::process_output), c, i));
-		}
+		context = &c;
+		worker_pool.run (*this, outputs.size ());
+		context = 0;
 
-		wait();
+		if (exception) {
+			throw *exception;
+		}
 	}
 
 	using Sink<T>::process;
 
   private:
 
-	void wait()
-	{
-		while (readers.load () != 0) {
-			gint64 end_time = g_get_monotonic_time () + (wait_timeout * G_TIME_SPAN_MILLISECOND);
-			wait_cond.wait_until(wait_mutex, end_time);
-		}
-
-		wait_mutex.unlock();
-
-		if (exception) {
-			throw *exception;
-		}
-	}
-
-	void process_output(ProcessContext<T> const & c, unsigned int output)
+	void run (unsigned int output)
 	{
 		try {
-			outputs[output]->process (c);
+			outputs[output]->process (*context);
 		} catch (std::exception const & e) {
 			// Only first exception will be passed on
 			exception_mutex.lock();
 			if(!exception) { exception.reset (new ThreaderException (*this, e)); }
 			exception_mutex.unlock();
 		}
-
-		if (PBD::atomic_dec_and_test (readers)) {
-			wait_cond.signal();
-		}
 	}
 
 	OutputVec outputs;
 
-	Glib::ThreadPool&    thread_pool;
-	Glib::Threads::Mutex wait_mutex;
-	Glib::Threads::Cond  wait_cond;
-
-	std::atomic<int> readers;
-	long         wait_timeout;
+	WorkerPool&              worker_pool;
+	ProcessContext<T> const* context;
 
 	Glib::Threads::Mutex exception_mutex;
 	std::shared_ptr<ThreaderException> exception;
@@ -0,0 +1,103 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AUDIOGRAPHER_WORKER_POOL_H
+#define AUDIOGRAPHER_WORKER_POOL_H
+
+#include <atomic>
+#include <vector>
+
+#include "pbd/semutils.h"
+
+#include "audiographer/visibility.h"
+
+namespace PBD {
+	class Thread;
+}
+
+namespace AudioGrapher
+{
+
+/** Persistent set of threads to run the outputs of a Threader in parallel.
+ *
+ * A job consists of a number of tasks, identified by their index. The thread
+ * that calls run() processes tasks itself, while idle workers steal tasks
+ * from all jobs that are currently running. Jobs may be nested: a task may
+ * run another job on the same pool.
+ *
+ * Running a job does not allocate memory.
+ */
+class LIBAUDIOGRAPHER_API WorkerPool
+{
+  public:
+	class LIBAUDIOGRAPHER_API Job
+	{
+	  public:
+		virtual ~Job () {}
+		/** Process a single task, must not throw */
+		virtual void run (unsigned int index) = 0;
+	};
+
+	/** Constructor
+	 * \param n_workers number of threads to start, in addition to the
+	 * thread(s) calling run()
+	 */
+	WorkerPool (unsigned int n_workers);
+	~WorkerPool ();
+
+	/** Process all tasks [0, n_tasks) of \a job, return when they are done.
+	 * \n RT safe
+	 */
+	void run (Job& job, unsigned int n_tasks);
+
+	unsigned int n_workers () const { return _threads.size (); }
+
+  private:
+	WorkerPool (WorkerPool const&);
+
+	struct Slot {
+		Slot () : job (0), done ("WorkerPoolSlot", 0) {
+			in_use.store (false);
+			users.store (0);
+			n_tasks.store (0);
+			next.store (0);
+			finished.store (0);
+		}
+
+		std::atomic<bool>         in_use;
+		std::atomic<int>          users;
+		std::atomic<Job*>         job;
+		std::atomic<unsigned int> n_tasks;
+		std::atomic<unsigned int> next;
+		std::atomic<unsigned int> finished;
+		PBD::Semaphore            done;
+	};
+
+	static const size_t max_jobs = 32;
+
+	bool steal (Slot&);
+	void finish_task (Slot&, unsigned int n_tasks);
+	void worker ();
+
+	Slot                     _slots[max_jobs];
+	std::vector<PBD::Thread*> _threads;
+	PBD::Semaphore           _wake;
+	std::atomic<bool>        _quit;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_WORKER_POOL_H
@@ -18,9 +18,15 @@ class LIBAUDIOGRAPHER_API Routines
 
 	typedef float (*compute_peak_t)          (float const *, uint_type, float);
 	typedef void  (*apply_gain_to_buffer_t)  (float *, uint_type, float);
+	typedef void  (*float_to_int16_t)        (int16_t *, float const *, float const *, uint_type, float, int32_t, int32_t, uint_type);
+	typedef void  (*float_to_int32_t)        (int32_t *, float const *, float const *, uint_type, float, int32_t, int32_t, uint_type);
+	typedef void  (*clip_floats_t)           (float *, uint_type);
 
 	static void override_compute_peak         (compute_peak_t func)         { _compute_peak = func; }
 	static void override_apply_gain_to_buffer (apply_gain_to_buffer_t func) { _apply_gain_to_buffer = func; }
+	static void override_float_to_int16       (float_to_int16_t func)       { _float_to_int16 = func; }
+	static void override_float_to_int32       (float_to_int32_t func)       { _float_to_int32 = func; }
+	static void override_clip_floats          (clip_floats_t func)          { _clip_floats = func; }
 
 	/** Computes peak in float buffer
 	  * \n RT safe
@@ -45,6 +51,39 @@ class LIBAUDIOGRAPHER_API Routines
 		(*_apply_gain_to_buffer) (data, samples, gain);
 	}
 
+	/** Converts floats to integers, the way gdither does for non-shaped dither types
+	 * \n RT safe
+	 * \n For each sample, the rounded value of \a data * \a scale - \a noise is clamped
+	 * to [\a clamp_l, \a clamp_u], and shifted left by \a post_shift bits. Integer
+	 * overflow wraps around.
+	 * \param dst output buffer
+	 * \param data input buffer
+	 * \param noise dither noise, or 0 if no dither is used
+	 * \param samples length of \a dst, \a data and \a noise
+	 */
+	static inline void float_to_int16 (int16_t * dst, float const * data, float const * noise, uint_type samples,
+	                                   float scale, int32_t clamp_l, int32_t clamp_u, uint_type post_shift)
+	{
+		(*_float_to_int16) (dst, data, noise, samples, scale, clamp_l, clamp_u, post_shift);
+	}
+
+	/// 32 bit version of \a float_to_int16
+	static inline void float_to_int32 (int32_t * dst, float const * data, float const * noise, uint_type samples,
+	                                   float scale, int32_t clamp_l, int32_t clamp_u, uint_type post_shift)
+	{
+		(*_float_to_int32) (dst, data, noise, samples, scale, clamp_l, clamp_u, post_shift);
+	}
+
+	/** Clips float buffer to [-1.0, 1.0], NaN is left as is
+	 * \n RT safe
+	 * \param data data that is clipped
+	 * \param samples length of data
+	 */
+	static inline void clip_floats (float * data, uint_type samples)
+	{
+		(*_clip_floats) (data, samples);
+	}
+
   private:
 	static inline float default_compute_peak (float const * data, uint_type samples, float current_peak)
 	{
@@ -62,8 +101,34 @@ class LIBAUDIOGRAPHER_API Routines
 		}
 	}
 
+	template <typename T>
+	static inline void default_float_to_int (T * dst, float const * data, float const * noise, uint_type samples,
+	                                         float scale, int32_t clamp_l, int32_t clamp_u, uint_type post_shift)
+	{
+		int64_t const post_scale = (int64_t)1 << post_shift;
+		for (uint_type i = 0; i < samples; ++i) {
+			float tmp = data[i] * scale;
+			if (noise) { tmp -= noise[i]; }
+			int64_t clamped = lrintf (tmp);
+			if (clamped > clamp_u) { clamped = clamp_u; }
+			else if (clamped < clamp_l) { clamped = clamp_l; }
+			dst[i] = (T) (clamped * post_scale);
+		}
+	}
+
+	static inline void default_clip_floats (float * data, uint_type samples)
+	{
+		for (uint_type i = 0; i < samples; ++i) {
+			if (data[i] > 1.0f) { data[i] = 1.0f; }
+			else if (data[i] < -1.0f) { data[i] = -1.0f; }
+		}
+	}
+
 	static compute_peak_t          _compute_peak;
 	static apply_gain_to_buffer_t  _apply_gain_to_buffer;
+	static float_to_int16_t        _float_to_int16;
+	static float_to_int32_t        _float_to_int32;
+	static clip_floats_t           _clip_floats;
 };
 
 } // namespace
@@ -0,0 +1,233 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef AUDIOGRAPHER_TMP_BUFFER_H
+#define AUDIOGRAPHER_TMP_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include "pbd/signals.h"
+
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/sink.h"
+#include "audiographer/utils/listed_source.h"
+
+#include "tmp_file.h"
+
+namespace AudioGrapher
+{
+
+/** Temporary storage of a stream, which is kept in memory as long as a
+ * memory budget allows, and written to a TmpFile beyond that. The file
+ * is only created if it is needed.
+ *
+ * Once the end of input was processed and Flushed was emitted, the data
+ * can be read back, like from a TmpFile.
+ */
+template<typename T = DefaultSampleType>
+class TmpBuffer
+	: public ListedSource<T>
+	, public Sink<T>
+	, public Throwing<>
+	, public FlagDebuggable<>
+{
+  public:
+	/// Number of samples that may still be allocated, shared by all users
+	typedef std::atomic<samplecnt_t> Budget;
+
+	/// Creates the file for the data that does not fit into memory
+	typedef std::function<std::shared_ptr<TmpFile<T> > ()> FileFactory;
+
+	/** Constructor
+	 * \param create_file called once the budget is exhausted, in the thread
+	 * that calls process(). The file must not have outputs.
+	 * \param channels channel count
+	 * \param budget memory budget to use, or 0 to write everything to a
+	 * file, which is then created right away
+	 */
+	TmpBuffer (FileFactory const & create_file, ChannelCount channels, std::shared_ptr<Budget> budget)
+		: _create_file (create_file)
+		, _budget (budget)
+		, _channels (channels)
+		, _chunk_size (chunk_frames * channels)
+		, _stored (0)
+		, _read_pos (0)
+		, _spilled (false)
+	{
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+
+		if (!_budget) {
+			open_file ();
+		}
+	}
+
+	~TmpBuffer ()
+	{
+		if (_budget) {
+			_budget->fetch_add (_chunks.size () * _chunk_size);
+		}
+	}
+
+	/// Stores data in memory, or passes it on to the file
+	void process (ProcessContext<T> const & c)
+	{
+		check_flags (*this, c);
+
+		if (throw_level (ThrowStrict) && c.channels() != _channels) {
+			throw Exception (*this, boost::str (boost::format
+				("Wrong number of channels given to process(), %1% instead of %2%")
+				% c.channels() % _channels));
+		}
+
+		samplecnt_t const stored = _spilled ? 0 : store (c.data (), c.samples ());
+
+		if (stored < c.samples () && !_spilled) {
+			if (!_file) {
+				open_file ();
+			}
+			_spilled = true;
+		}
+
+		if (_spilled) {
+			if (stored < c.samples () || c.has_flag (ProcessContext<T>::EndOfInput)) {
+				ConstProcessContext<T> rest (c, c.data () + stored, c.samples () - stored);
+				_file->process (rest);
+			}
+		} else if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			Written ();
+			Flushed ();
+		}
+	}
+
+	using Sink<T>::process;
+
+	/** Read data into buffer in \a context, and pass it on to the outputs.
+	 * Sets EndOfInput if less data than requested remained.
+	 * \return number of samples read
+	 */
+	samplecnt_t read (ProcessContext<T> & context)
+	{
+		samplecnt_t done = 0;
+
+		while (done < context.samples () && _read_pos < _stored) {
+			samplecnt_t const offset = _read_pos % _chunk_size;
+			samplecnt_t const n = std::min (std::min (context.samples () - done, _chunk_size - offset), _stored - _read_pos);
+			memcpy (context.data () + done, &_chunks[_read_pos / _chunk_size][offset], n * sizeof (T));
+			done += n;
+			_read_pos += n;
+		}
+
+		if (done < context.samples () && _spilled) {
+			done += _file->SndfileHandle::read (context.data () + done, context.samples () - done);
+		}
+
+		ProcessContext<T> c_out = context.beginning (done);
+		if (done < context.samples ()) {
+			c_out.set_flag (ProcessContext<T>::EndOfInput);
+		}
+		this->output (c_out);
+		return done;
+	}
+
+	/// Start reading from the beginning
+	void rewind ()
+	{
+		_read_pos = 0;
+		if (_spilled) {
+			_file->seek (0, SEEK_SET);
+		}
+	}
+
+	samplecnt_t get_samples_written () const
+	{
+		return _stored + (_spilled ? _file->get_samples_written () : 0);
+	}
+
+	/// Number of samples that are kept in memory
+	samplecnt_t samples_in_memory () const { return _stored; }
+
+	/// Emitted when the end of input was processed
+	PBD::Signal0<void> Written;
+	/// Emitted when all data can be read
+	PBD::Signal0<void> Flushed;
+
+  private:
+	static const samplecnt_t chunk_frames = 65536;
+
+	samplecnt_t store (T const * data, samplecnt_t samples)
+	{
+		samplecnt_t done = 0;
+
+		while (done < samples) {
+			samplecnt_t const offset = _stored % _chunk_size;
+			if (offset == 0 && !allocate_chunk ()) {
+				break;
+			}
+			samplecnt_t const n = std::min (samples - done, _chunk_size - offset);
+			memcpy (&_chunks.back ()[offset], data + done, n * sizeof (T));
+			done += n;
+			_stored += n;
+		}
+
+		return done;
+	}
+
+	bool allocate_chunk ()
+	{
+		if (!_budget) {
+			return false;
+		}
+		if (_budget->fetch_sub (_chunk_size) < _chunk_size) {
+			_budget->fetch_add (_chunk_size);
+			return false;
+		}
+		_chunks.push_back (std::vector<T> (_chunk_size));
+		return true;
+	}
+
+	void open_file ()
+	{
+		_file = _create_file ();
+		_file->FileWritten.connect_same_thread (_connections, boost::bind (&TmpBuffer::file_written, this));
+		_file->FileFlushed.connect_same_thread (_connections, boost::bind (&TmpBuffer::file_flushed, this));
+	}
+
+	void file_written () { Written (); }
+	void file_flushed () { Flushed (); }
+
+	FileFactory                  _create_file;
+	std::shared_ptr<TmpFile<T> > _file;
+	std::shared_ptr<Budget>      _budget;
+	ChannelCount                 _channels;
+	samplecnt_t                  _chunk_size;
+	std::vector<std::vector<T> > _chunks;
+	samplecnt_t                  _stored;
+	samplecnt_t                  _read_pos;
+	bool                         _spilled;
+
+	PBD::ScopedConnectionList    _connections;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_TMP_BUFFER_H
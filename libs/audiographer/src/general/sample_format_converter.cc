@@ -22,20 +22,49 @@
 #include "audiographer/general/sample_format_converter.h"
 
 #include "audiographer/exception.h"
+#include "audiographer/routines.h"
 #include "audiographer/type_utils.h"
 #include "private/gdither/gdither.h"
 
+#include <algorithm>
+
 #include <boost/format.hpp>
 
 namespace AudioGrapher
 {
 
+/* gdither's noise generator, advanced by SampleFormatConverter::noise_streams
+ * steps at once, so that independent streams produce the same sequence.
+ */
+static const uint32_t noise_seed = 23232323;
+static const uint32_t noise_mul  = 196314165;
+static const uint32_t noise_add  = 907633515;
+
+static void
+noise_step (uint32_t steps, uint32_t& mul, uint32_t& add)
+{
+	mul = 1;
+	add = 0;
+	for (uint32_t i = 0; i < steps; ++i) {
+		mul = mul * noise_mul;
+		add = add * noise_mul + noise_add;
+	}
+}
+
 template <typename TOut>
 SampleFormatConverter<TOut>::SampleFormatConverter (ChannelCount channels) :
   channels (channels),
   dither (0),
   data_out_size (0),
   data_out (0),
+  use_routines (false),
+  dither_type (GDitherNone),
+  scale (0),
+  clamp_l (0),
+  clamp_u (0),
+  post_shift (0),
+  noise (0),
+  tri_state (0),
   clip_floats (false)
 {
 }
@@ -65,6 +94,7 @@ SampleFormatConverter<int32_t>::init (samplecnt_t max_samples, int type, int dat
 
 	init_common (max_samples);
 	dither = gdither_new ((GDitherType) type, channels, GDither32bit, data_width);
+	init_routines (max_samples, type, 32, data_width, -8388608, 8388607);
 }
 
 template <>
@@ -78,6 +108,7 @@ SampleFormatConverter<int16_t>::init (samplecnt_t max_samples, int type, int dat
 	}
 	init_common (max_samples);
 	dither = gdither_new ((GDitherType) type, channels, GDither16bit, data_width);
+	init_routines (max_samples, type, 16, data_width, -32768, 32767);
 }
 
 template <>
@@ -107,6 +138,42 @@ SampleFormatConverter<TOut>::init_common (samplecnt_t max_samples)
 	}
 }
 
+/* Set up the same quantization as gdither_new () */
+template <typename TOut>
+void
+SampleFormatConverter<TOut>::init_routines (samplecnt_t max_samples, int type, int bit_depth, int data_width, int32_t clamp_l_, int32_t clamp_u_)
+{
+	if (type == GDitherShaped) {
+		/* error feedback is sequential, leave it to gdither */
+		return;
+	}
+
+	if (data_width <= 0 || data_width > bit_depth) {
+		data_width = bit_depth;
+	}
+
+	use_routines = true;
+	dither_type  = type;
+	scale        = (float)(1LL << (data_width - 1));
+	clamp_l      = clamp_l_;
+	clamp_u      = clamp_u_;
+	post_shift   = bit_depth - data_width;
+
+	if (type == GDitherNone) {
+		return;
+	}
+
+	noise     = new float[max_samples];
+	tri_state = new float[channels];
+	std::fill_n (tri_state, channels, 0.f);
+
+	uint32_t rnd = noise_seed;
+	for (unsigned int i = 0; i < noise_streams; ++i) {
+		rnd = rnd * noise_mul + noise_add;
+		noise_state[i] = rnd;
+	}
+}
+
 template <typename TOut>
 SampleFormatConverter<TOut>::~SampleFormatConverter ()
 {
@@ -126,9 +193,86 @@ SampleFormatConverter<TOut>::reset()
 	data_out_size = 0;
 	data_out = 0;
 
+	delete[] noise;
+	delete[] tri_state;
+	noise = 0;
+	tri_state = 0;
+	use_routines = false;
+
 	clip_floats = false;
 }
 
+/* Rectangular or triangular dither noise for the interleaved data, in the
+ * range of gdither's: [0, 1) and (-1, 1) respectively.
+ */
+template <typename TOut>
+float const *
+SampleFormatConverter<TOut>::dither_noise (samplecnt_t samples)
+{
+	if (dither_type == GDitherNone) {
+		return 0;
+	}
+
+	uint32_t mul;
+	uint32_t add;
+	noise_step (noise_streams, mul, add);
+
+	/* independent streams, so that the compiler can vectorize this */
+	samplecnt_t i = 0;
+	for (; i + noise_streams <= samples; i += noise_streams) {
+		for (unsigned int s = 0; s < noise_streams; ++s) {
+			noise_state[s] = noise_state[s] * mul + add;
+			noise[i + s] = noise_state[s] * 2.3283064365387e-10f;
+		}
+	}
+	for (unsigned int s = 0; i < samples; ++i, ++s) {
+		noise_state[s] = noise_state[s] * mul + add;
+		noise[i] = noise_state[s] * 2.3283064365387e-10f;
+	}
+
+	if (dither_type == GDitherTri) {
+		/* difference of subsequent noise samples of each channel */
+		for (i = 0; i + channels <= samples; i += channels) {
+			for (ChannelCount c = 0; c < channels; ++c) {
+				float r = noise[i + c] - 0.5f;
+				noise[i + c] = r - tri_state[c];
+				tri_state[c] = r;
+			}
+		}
+	}
+
+	return noise;
+}
+
+template <typename TOut>
+bool
+SampleFormatConverter<TOut>::convert (float const *, samplecnt_t)
+{
+	return false;
+}
+
+template <>
+bool
+SampleFormatConverter<int16_t>::convert (float const * data, samplecnt_t samples)
+{
+	if (!use_routines) {
+		return false;
+	}
+	Routines::float_to_int16 (data_out, data, dither_noise (samples), samples, scale, clamp_l, clamp_u, post_shift);
+	return true;
+}
+
+template <>
+bool
+SampleFormatConverter<int32_t>::convert (float const * data, samplecnt_t samples)
+{
+	if (!use_routines) {
+		return false;
+	}
+	Routines::float_to_int32 (data_out, data, dither_noise (samples), samples, scale, clamp_l, clamp_u, post_shift);
+	return true;
+}
+
 /* Basic const version of process() */
 template <typename TOut>
 void
@@ -138,10 +282,12 @@ SampleFormatConverter<TOut>::process (ProcessContext<float> const & c_in)
 
 	check_sample_and_channel_count (c_in.samples (), c_in.channels ());
 
-	/* Do conversion */
+	/* Do conversion, all channels at once if possible */
 
-	for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
-		gdither_runf (dither, chn, c_in.samples_per_channel (), data, data_out);
+	if (!convert (data, c_in.samples ())) {
+		for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
+			gdither_runf (dither, chn, c_in.samples_per_channel (), data, data_out);
+		}
 	}
 
 	/* Write forward */
@@ -167,13 +313,7 @@ SampleFormatConverter<float>::process (ProcessContext<float> & c_in)
 	float * data = c_in.data();
 
 	if (clip_floats) {
-		for (samplecnt_t x = 0; x < samples; ++x) {
-			if (data[x] > 1.0f) {
-				data[x] = 1.0f;
-			} else if (data[x] < -1.0f) {
-				data[x] = -1.0f;
-			}
-		}
+		Routines::clip_floats (data, samples);
 	}
 
 	output (c_in);
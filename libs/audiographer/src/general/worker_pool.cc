@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/smart_ptr/detail/yield_k.hpp>
+
+#include "pbd/pthread_utils.h"
+
+#include "audiographer/general/worker_pool.h"
+
+using namespace AudioGrapher;
+
+WorkerPool::WorkerPool (unsigned int n_workers)
+	: _wake ("WorkerPool", 0)
+{
+	_quit.store (false);
+
+	for (unsigned int i = 0; i < n_workers; ++i) {
+		PBD::Thread* t = PBD::Thread::create (boost::bind (&WorkerPool::worker, this), "ExportWorker");
+		if (!t) {
+			break;
+		}
+		_threads.push_back (t);
+	}
+}
+
+WorkerPool::~WorkerPool ()
+{
+	_quit.store (true);
+
+	for (size_t i = 0; i < _threads.size (); ++i) {
+		_wake.signal ();
+	}
+
+	for (std::vector<PBD::Thread*>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+		(*i)->join ();
+		delete *i;
+	}
+}
+
+void
+WorkerPool::run (Job& job, unsigned int n_tasks)
+{
+	if (n_tasks == 0) {
+		return;
+	}
+
+	Slot* slot = 0;
+
+	if (n_tasks > 1 && !_threads.empty ()) {
+		for (size_t i = 0; i < max_jobs; ++i) {
+			bool expected = false;
+			if (_slots[i].in_use.compare_exchange_strong (expected, true)) {
+				slot = &_slots[i];
+				break;
+			}
+		}
+	}
+
+	if (!slot) {
+		/* single task, no workers, or too deeply nested: process in place */
+		for (unsigned int i = 0; i < n_tasks; ++i) {
+			job.run (i);
+		}
+		return;
+	}
+
+	slot->n_tasks.store (n_tasks);
+	slot->next.store (0);
+	slot->finished.store (0);
+	slot->job.store (&job);
+
+	/* wake up workers to help, the calling thread takes part as well */
+	for (size_t i = std::min<size_t> (n_tasks - 1, _threads.size ()); i > 0; --i) {
+		_wake.signal ();
+	}
+
+	while (steal (*slot)) ;
+
+	/* wait for tasks that were taken by other threads */
+	slot->done.wait ();
+
+	/* unpublish the job, and wait for workers that are about to look at it */
+	slot->job.store (0);
+	for (unsigned int i = 0; slot->users.load () != 0; ++i) {
+		/* they will not claim a task, since all are done. Back off,
+		 * in case one of them was preempted. */
+		boost::detail::yield (i);
+	}
+
+	slot->in_use.store (false);
+}
+
+/** Claim and process one task of the job in the given slot.
+ * @return true if a task was processed
+ */
+bool
+WorkerPool::steal (Slot& slot)
+{
+	slot.users.fetch_add (1);
+
+	Job* job = slot.job.load ();
+	if (!job) {
+		slot.users.fetch_sub (1);
+		return false;
+	}
+
+	unsigned int const index = slot.next.fetch_add (1);
+	unsigned int const n     = slot.n_tasks.load ();
+
+	/* once a task was claimed, the job remains valid until it is finished */
+	slot.users.fetch_sub (1);
+
+	if (index >= n) {
+		return false;
+	}
+
+	job->run (index);
+	finish_task (slot, n);
+	return true;
+}
+
+void
+WorkerPool::finish_task (Slot& slot, unsigned int n_tasks)
+{
+	/* the slot may be re-used as soon as the last task is finished */
+	if (slot.finished.fetch_add (1) + 1 == n_tasks) {
+		slot.done.signal ();
+	}
+}
+
+void
+WorkerPool::worker ()
+{
+	while (true) {
+		_wake.wait ();
+
+		if (_quit.load ()) {
+			return;
+		}
+
+		/* help with any job, until there is nothing left to do */
+		bool found = true;
+		while (found) {
+			found = false;
+			for (size_t i = 0; i < max_jobs; ++i) {
+				if (_slots[i].in_use.load () && steal (_slots[i])) {
+					found = true;
+				}
+			}
+		}
+	}
+}
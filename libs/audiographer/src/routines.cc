@@ -23,4 +23,7 @@ namespace AudioGrapher
 {
 Routines::compute_peak_t Routines::_compute_peak = &Routines::default_compute_peak;
 Routines::apply_gain_to_buffer_t Routines::_apply_gain_to_buffer = &Routines::default_apply_gain_to_buffer;
+Routines::float_to_int16_t Routines::_float_to_int16 = &Routines::default_float_to_int<int16_t>;
+Routines::float_to_int32_t Routines::_float_to_int32 = &Routines::default_float_to_int<int32_t>;
+Routines::clip_floats_t Routines::_clip_floats = &Routines::default_clip_floats;
 }
@@ -0,0 +1,120 @@
+#include "tests/utils.h"
+
+#include "audiographer/general/async_writer.h"
+
+using namespace AudioGrapher;
+
+class EndCountingSink : public AppendingVectorSink<float>
+{
+  public:
+	EndCountingSink () : ends (0) {}
+
+	void process (ProcessContext<float> const & c)
+	{
+		AppendingVectorSink<float>::process (c);
+		if (c.has_flag (ProcessContext<float>::EndOfInput)) {
+			++ends;
+		}
+	}
+	using Sink<float>::process;
+
+	int ends;
+};
+
+class AsyncWriterTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (AsyncWriterTest);
+  CPPUNIT_TEST (testProcess);
+  CPPUNIT_TEST (testRepeatedProcess);
+  CPPUNIT_TEST (testException);
+  CPPUNIT_TEST (testStop);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		channels = 2;
+		samples = 100000;
+		random_data = TestUtils::init_random_data (samples);
+		sink.reset (new EndCountingSink ());
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+	}
+
+	void testProcess()
+	{
+		// queue is much smaller than the data, to test blocking
+		writer.reset (new AsyncWriter<float> (channels, 256, 1024));
+		writer->add_output (sink);
+
+		process_all (1000);
+
+		// everything was processed once process() returned
+		CPPUNIT_ASSERT_EQUAL (1, sink->ends);
+		CPPUNIT_ASSERT_EQUAL ((size_t) samples, sink->get_data ().size ());
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, sink->get_array (), samples));
+	}
+
+	void testRepeatedProcess()
+	{
+		// contexts larger than the queue
+		writer.reset (new AsyncWriter<float> (channels, 512, 2048));
+		writer->add_output (sink);
+
+		process_all (5000);
+		process_all (5000);
+
+		CPPUNIT_ASSERT_EQUAL (2, sink->ends);
+		CPPUNIT_ASSERT_EQUAL ((size_t) 2 * samples, sink->get_data ().size ());
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, sink->get_array () + samples, samples));
+	}
+
+	void testException()
+	{
+		writer.reset (new AsyncWriter<float> (channels, 256, 1024));
+		writer->add_output (std::shared_ptr<ThrowingSink<float> > (new ThrowingSink<float> ()));
+
+		// thrown at the latest when waiting for the end of input
+		CPPUNIT_ASSERT_THROW (process_all (1000), Exception);
+	}
+
+	void testStop()
+	{
+		writer.reset (new AsyncWriter<float> (channels, 256, 1024));
+		writer->add_output (sink);
+
+		ProcessContext<float> c (random_data, 1000, channels);
+		writer->process (c);
+		writer->stop ();
+
+		// no thread: processed in place
+		sink->reset ();
+		process_all (1000);
+		CPPUNIT_ASSERT_EQUAL (1, sink->ends);
+		CPPUNIT_ASSERT_EQUAL ((size_t) samples, sink->get_data ().size ());
+	}
+
+  private:
+	void process_all (samplecnt_t block)
+	{
+		for (samplecnt_t pos = 0; pos < samples; pos += block) {
+			ProcessContext<float> c (random_data + pos, std::min (block, samples - pos), channels);
+			if (pos + block >= samples) {
+				c.set_flag (ProcessContext<float>::EndOfInput);
+			}
+			writer->process (c);
+		}
+	}
+
+	std::shared_ptr<AsyncWriter<float> > writer;
+	std::shared_ptr<EndCountingSink>     sink;
+
+	float * random_data;
+	samplecnt_t samples;
+	ChannelCount channels;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (AsyncWriterTest);
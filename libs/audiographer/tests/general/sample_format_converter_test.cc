@@ -1,6 +1,7 @@
 #include "tests/utils.h"
 
 #include "audiographer/general/sample_format_converter.h"
+#include "private/gdither/gdither.h"
 
 using namespace AudioGrapher;
 
@@ -15,6 +16,8 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
   CPPUNIT_TEST (testInt16);
   CPPUNIT_TEST (testUint8);
   CPPUNIT_TEST (testChannelCount);
+  CPPUNIT_TEST (testSameAsGDither);
+  CPPUNIT_TEST (testDither);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -204,8 +207,80 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (TestUtils::array_filled(sink->get_array(), pc.samples()));
 	}
 
+	void testSameAsGDither()
+	{
+		// Include out of range values, and values that round to even
+		random_data[0] = 1.5;
+		random_data[1] = -1.5;
+		random_data[2] = 1.0;
+		random_data[3] = -1.0;
+		random_data[4] = 0.5 / 32768;
+		random_data[5] = -1.5 / 32768;
+		random_data[6] = -0.0;
+
+		compare_with_gdither<int16_t> (GDither16bit, 16);
+		compare_with_gdither<int16_t> (GDither16bit, 12);
+		compare_with_gdither<int16_t> (GDither16bit, 8);
+		compare_with_gdither<int32_t> (GDither32bit, 24);
+		compare_with_gdither<int32_t> (GDither32bit, 16);
+	}
+
+	void testDither()
+	{
+		samplecnt_t new_sample_count = samples - (samples % 3);
+
+		for (int type = D_Rect; type <= D_Tri; ++type) {
+			std::shared_ptr<SampleFormatConverter<int16_t> > converter (new SampleFormatConverter<int16_t>(3));
+			std::shared_ptr<SampleFormatConverter<int16_t> > plain (new SampleFormatConverter<int16_t>(3));
+			std::shared_ptr<VectorSink<int16_t> > sink (new VectorSink<int16_t>());
+			std::shared_ptr<VectorSink<int16_t> > plain_sink (new VectorSink<int16_t>());
+
+			converter->init (samples, type, 16);
+			converter->add_output (sink);
+			plain->init (samples, D_None, 16);
+			plain->add_output (plain_sink);
+
+			ProcessContext<float> pc(random_data, new_sample_count, 3);
+			converter->process (pc);
+			plain->process (pc);
+
+			// Dither changes the output by at most one LSB
+			samplecnt_t changed = 0;
+			for (samplecnt_t i = 0; i < new_sample_count; ++i) {
+				int diff = sink->get_data()[i] - plain_sink->get_data()[i];
+				CPPUNIT_ASSERT (diff >= -1 && diff <= 1);
+				if (diff != 0) { ++changed; }
+			}
+			CPPUNIT_ASSERT (changed > 0);
+		}
+	}
+
   private:
 
+	template<typename TOut>
+	void compare_with_gdither (GDitherSize bit_depth, int data_width)
+	{
+		ChannelCount const channels = 3;
+		samplecnt_t new_sample_count = samples - (samples % channels);
+
+		std::shared_ptr<SampleFormatConverter<TOut> > converter (new SampleFormatConverter<TOut>(channels));
+		std::shared_ptr<VectorSink<TOut> > sink (new VectorSink<TOut>());
+
+		converter->init (samples, D_None, data_width);
+		converter->add_output (sink);
+		converter->process (ProcessContext<float> (random_data, new_sample_count, channels));
+
+		TOut * expected = new TOut[new_sample_count];
+		GDither dither = gdither_new (GDitherNone, channels, bit_depth, data_width);
+		for (ChannelCount c = 0; c < channels; ++c) {
+			gdither_runf (dither, c, new_sample_count / channels, random_data, expected);
+		}
+		gdither_free (dither);
+
+		CPPUNIT_ASSERT (TestUtils::array_equals (sink->get_array(), expected, new_sample_count));
+		delete [] expected;
+	}
+
 	float * random_data;
 	samplecnt_t samples;
 };
@@ -22,8 +22,8 @@ class ThreaderTest : public CppUnit::TestFixture
 		zero_data = new float[samples];
 		memset (zero_data, 0, samples * sizeof(float));
 
-		thread_pool = new Glib::ThreadPool (3);
-		threader.reset (new Threader<float> (*thread_pool));
+		worker_pool = new WorkerPool (3);
+		threader.reset (new Threader<float> (*worker_pool));
 
 		sink_a.reset (new VectorSink<float>());
 		sink_b.reset (new VectorSink<float>());
@@ -40,8 +40,8 @@ class ThreaderTest : public CppUnit::TestFixture
 		delete [] random_data;
 		delete [] zero_data;
 
-		thread_pool->shutdown();
-		delete thread_pool;
+		threader.reset ();
+		delete worker_pool;
 	}
 
 	void testProcess()
@@ -135,7 +135,7 @@ class ThreaderTest : public CppUnit::TestFixture
 	}
 
   private:
-	Glib::ThreadPool * thread_pool;
+	WorkerPool * worker_pool;
 
 	std::shared_ptr<Threader<float> > threader;
 	std::shared_ptr<VectorSink<float> > sink_a;
@@ -0,0 +1,107 @@
+#include "tests/utils.h"
+
+#include <atomic>
+#include <thread>
+
+#include "audiographer/general/worker_pool.h"
+
+using namespace AudioGrapher;
+
+class CountingJob : public WorkerPool::Job
+{
+  public:
+	CountingJob (unsigned int n) : counts (n) {
+		for (unsigned int i = 0; i < n; ++i) {
+			counts[i].store (0);
+		}
+	}
+
+	void run (unsigned int index) {
+		counts[index].fetch_add (1);
+	}
+
+	bool all_ran_once () const {
+		for (size_t i = 0; i < counts.size (); ++i) {
+			if (counts[i].load () != 1) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<std::atomic<int> > counts;
+};
+
+class NestedJob : public WorkerPool::Job
+{
+  public:
+	NestedJob (WorkerPool& pool, unsigned int n_outer, unsigned int n_inner)
+		: pool (pool)
+	{
+		for (unsigned int i = 0; i < n_outer; ++i) {
+			inner.push_back (std::shared_ptr<CountingJob> (new CountingJob (n_inner)));
+		}
+	}
+
+	void run (unsigned int index) {
+		pool.run (*inner[index], inner[index]->counts.size ());
+	}
+
+	WorkerPool& pool;
+	std::vector<std::shared_ptr<CountingJob> > inner;
+};
+
+class WorkerPoolTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (WorkerPoolTest);
+  CPPUNIT_TEST (testRun);
+  CPPUNIT_TEST (testNoWorkers);
+  CPPUNIT_TEST (testNested);
+  CPPUNIT_TEST (testConcurrentCallers);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void testRun ()
+	{
+		WorkerPool pool (3);
+		for (int cycle = 0; cycle < 100; ++cycle) {
+			CountingJob job (17);
+			pool.run (job, 17);
+			CPPUNIT_ASSERT (job.all_ran_once ());
+		}
+	}
+
+	void testNoWorkers ()
+	{
+		WorkerPool pool (0);
+		CountingJob job (5);
+		pool.run (job, 5);
+		CPPUNIT_ASSERT (job.all_ran_once ());
+	}
+
+	void testNested ()
+	{
+		WorkerPool pool (3);
+		NestedJob job (pool, 8, 16);
+		pool.run (job, 8);
+		for (size_t i = 0; i < job.inner.size (); ++i) {
+			CPPUNIT_ASSERT (job.inner[i]->all_ran_once ());
+		}
+	}
+
+	void testConcurrentCallers ()
+	{
+		WorkerPool pool (2);
+		CountingJob a (1000);
+		CountingJob b (1000);
+
+		std::thread t ([&pool, &a] () { pool.run (a, 1000); });
+		pool.run (b, 1000);
+		t.join ();
+
+		CPPUNIT_ASSERT (a.all_ran_once ());
+		CPPUNIT_ASSERT (b.all_ran_once ());
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (WorkerPoolTest);
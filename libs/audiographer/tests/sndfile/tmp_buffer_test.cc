@@ -0,0 +1,119 @@
+#include "tests/utils.h"
+#include "audiographer/sndfile/tmp_buffer.h"
+#include "audiographer/sndfile/tmp_file_sync.h"
+
+using namespace AudioGrapher;
+
+class TmpBufferTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (TmpBufferTest);
+  CPPUNIT_TEST (testMemory);
+  CPPUNIT_TEST (testSpill);
+  CPPUNIT_TEST (testNoBudget);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		channels = 2;
+		samples = 300000; // more than two chunks
+		random_data = TestUtils::init_random_data(samples);
+		written = 0;
+		flushed = 0;
+		files_created = 0;
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+	}
+
+	void testMemory()
+	{
+		std::shared_ptr<TmpBuffer<float>::Budget> budget (new TmpBuffer<float>::Budget (10 * samples));
+		write_and_read (budget);
+		CPPUNIT_ASSERT_EQUAL (samples, buffer->samples_in_memory ());
+		CPPUNIT_ASSERT_EQUAL (0, files_created);
+
+		buffer.reset ();
+		CPPUNIT_ASSERT_EQUAL (10 * samples, budget->load ());
+	}
+
+	void testSpill()
+	{
+		// Room for one chunk only
+		std::shared_ptr<TmpBuffer<float>::Budget> budget (new TmpBuffer<float>::Budget (samples / 2));
+		write_and_read (budget);
+		CPPUNIT_ASSERT (buffer->samples_in_memory () > 0);
+		CPPUNIT_ASSERT (buffer->samples_in_memory () < samples);
+		CPPUNIT_ASSERT_EQUAL (1, files_created);
+	}
+
+	void testNoBudget()
+	{
+		write_and_read (std::shared_ptr<TmpBuffer<float>::Budget> ());
+		CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 0, buffer->samples_in_memory ());
+		CPPUNIT_ASSERT_EQUAL (1, files_created);
+	}
+
+  private:
+	void write_and_read (std::shared_ptr<TmpBuffer<float>::Budget> budget)
+	{
+		buffer.reset (new TmpBuffer<float> (boost::bind (&TmpBufferTest::create_file, this), channels, budget));
+		buffer->Written.connect_same_thread (connections, boost::bind (&TmpBufferTest::on_written, this));
+		buffer->Flushed.connect_same_thread (connections, boost::bind (&TmpBufferTest::on_flushed, this));
+
+		samplecnt_t const block = 1024;
+		for (samplecnt_t pos = 0; pos < samples; pos += block) {
+			ProcessContext<float> c (random_data + pos, std::min (block, samples - pos), channels);
+			if (pos + block >= samples) {
+				c.set_flag (ProcessContext<float>::EndOfInput);
+			}
+			buffer->process (c);
+		}
+
+		CPPUNIT_ASSERT_EQUAL (1, written);
+		CPPUNIT_ASSERT_EQUAL (1, flushed);
+		CPPUNIT_ASSERT_EQUAL (samples, buffer->get_samples_written ());
+
+		std::shared_ptr<VectorSink<float> > sink (new VectorSink<float>());
+		buffer->add_output (sink);
+
+		// read twice, to test rewind
+		for (int i = 0; i < 2; ++i) {
+			buffer->rewind ();
+			std::vector<float> result;
+			AllocatingProcessContext<float> c (4000, channels);
+			samplecnt_t read;
+			do {
+				read = buffer->read (c);
+				result.insert (result.end (), c.data (), c.data () + read);
+			} while (read == c.samples ());
+
+			CPPUNIT_ASSERT (sink->get_data ().size () == (size_t) (samples % c.samples ()));
+			CPPUNIT_ASSERT_EQUAL ((size_t) samples, result.size ());
+			CPPUNIT_ASSERT (TestUtils::array_equals (random_data, &result[0], samples));
+		}
+	}
+
+	std::shared_ptr<TmpFile<float> > create_file ()
+	{
+		++files_created;
+		return std::shared_ptr<TmpFile<float> > (new TmpFileSync<float>(SF_FORMAT_RAW | SF_FORMAT_FLOAT, channels, 44100));
+	}
+
+	void on_written () { ++written; }
+	void on_flushed () { ++flushed; }
+
+	std::shared_ptr<TmpBuffer<float> > buffer;
+	PBD::ScopedConnectionList connections;
+
+	float * random_data;
+	samplecnt_t samples;
+	ChannelCount channels;
+	int written;
+	int flushed;
+	int files_created;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TmpBufferTest);
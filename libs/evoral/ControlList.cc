@@ -35,6 +35,7 @@
 
 #define GUARD_POINT_DELTA(foo) ((foo).time_domain () == Temporal::AudioTime ? Temporal::timecnt_t (64) : Temporal::timecnt_t (Beats (0, 1)))
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -84,6 +85,8 @@ ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc,
 	did_write_during_pass       = false;
 	insert_position             = timepos_t::max (time_domain());
 	most_recent_insert_iterator = _events.end ();
+	_write_pass_thinning_factor = 0.0;
+	_write_pass_run             = 0;
 }
 
 ControlList::ControlList (const ControlList& other)
@@ -104,6 +107,8 @@ ControlList::ControlList (const ControlList& other)
 	did_write_during_pass       = false;
 	insert_position             = timepos_t::max (time_domain());
 	most_recent_insert_iterator = _events.end ();
+	_write_pass_thinning_factor = 0.0;
+	_write_pass_run             = 0;
 
 	// XXX copy_events() emits Dirty, but this is just assignment copy/construction
 	copy_events (other);
@@ -137,6 +142,8 @@ ControlList::ControlList (const ControlList& other, timepos_t const& start, time
 	did_write_during_pass       = false;
 	insert_position             = timepos_t::max (time_domain());
 	most_recent_insert_iterator = _events.end ();
+	_write_pass_thinning_factor = 0.0;
+	_write_pass_run             = 0;
 
 	mark_dirty ();
 }
@@ -179,6 +186,9 @@ ControlList::operator= (const ControlList& other)
 		did_write_during_pass = false;
 		insert_position       = timepos_t::max (time_domain());
 
+		_write_pass_thinning_factor = 0.0;
+		_write_pass_run             = 0;
+
 		_parameter     = other._parameter;
 		_desc          = other._desc;
 		_interpolation = other._interpolation;
@@ -376,6 +386,24 @@ struct ControlEventTimeComparator {
 	}
 };
 
+double
+ControlList::thinning_area (ControlEvent const* prevprev, ControlEvent const* prev, ControlEvent const* cur) const
+{
+	/* compute the area of the triangle formed by 3 points */
+
+	const double ppw = prevprev->when.samples ();
+	const double pw  = prev->when.samples ();
+	const double cw  = cur->when.samples ();
+
+	const float ppv = _desc.to_interface (prevprev->value);
+	const float cv  = _desc.to_interface (cur->value);
+	const float pv  = _desc.to_interface (prev->value);
+
+	return fabs ((ppw * (pv - cv)) +
+	             (pw * (cv - ppv)) +
+	             (cw * (ppv - pv)));
+}
+
 void
 ControlList::thin (double thinning_factor)
 {
@@ -411,21 +439,7 @@ ControlList::thin (double thinning_factor)
 			counter++;
 
 			if (counter > 2) {
-				/* compute the area of the triangle formed by 3 points */
-
-				const double ppw = prevprev->when.samples ();
-				const double pw  = prev->when.samples ();
-				const double cw  = cur->when.samples ();
-
-				const float ppv = _desc.to_interface (prevprev->value);
-				const float cv  = _desc.to_interface (cur->value);
-				const float pv  = _desc.to_interface (prev->value);
-
-				double area = fabs ((ppw * (pv - cv)) +
-				                    (pw * (cv - ppv)) +
-				                    (cw * (ppv - pv)));
-
-				if (area < thinning_factor) {
+				if (thinning_area (prevprev, prev, cur) < thinning_factor) {
 					iterator tmp = pprev;
 
 					/* pprev will change to current
@@ -496,7 +510,7 @@ ControlList::unlocked_remove_duplicates ()
 	iterator prev = i++;
 	while (i != _events.end ()) {
 		if ((*prev)->when == (*i)->when && (*prev)->value == (*i)->value) {
-			i = _events.erase (i);
+			i = unlocked_erase (i);
 		} else {
 			++prev;
 			++i;
@@ -505,16 +519,20 @@ ControlList::unlocked_remove_duplicates ()
 }
 
 void
-ControlList::start_write_pass (timepos_t const& time)
+ControlList::start_write_pass (timepos_t const& time, double thinning_factor)
 {
 	Glib::Threads::RWLock::WriterLock lm (_lock);
 
 	timepos_t when = ensure_time_domain (time);
 
-	DEBUG_TRACE (DEBUG::ControlList, string_compose ("%1: setup write pass @ %2\n", this, when));
+	DEBUG_TRACE (DEBUG::ControlList, string_compose ("%1: setup write pass @ %2 thin: %3\n", this, when, thinning_factor));
 
 	insert_position = when;
 
+	/* see ::thin() for the compat. factor */
+	_write_pass_thinning_factor = _desc.toggled ? 0.0 : thinning_factor * .7071;
+	_write_pass_run             = 0;
+
 	/* leave the insert iterator invalid, so that we will do the lookup
 	   of where it should be in a "lazy" way - deferring it until
 	   we actually add the first point (which may never happen).
@@ -543,11 +561,15 @@ ControlList::write_pass_finished (timepos_t const& /*when*/, double thinning_fac
 	DEBUG_TRACE (DEBUG::ControlList, "write pass finished\n");
 
 	if (did_write_during_pass) {
-		thin (thinning_factor);
+		if (_write_pass_thinning_factor == 0.0) {
+			thin (thinning_factor);
+		}
 		did_write_during_pass = false;
 	}
-	new_write_pass = true;
-	_in_write_pass = false;
+	new_write_pass              = true;
+	_in_write_pass              = false;
+	_write_pass_thinning_factor = 0.0;
+	_write_pass_run             = 0;
 }
 
 void
@@ -623,7 +645,7 @@ ControlList::add_guard_point (timepos_t const& time, timecnt_t const& offset)
 
 	if (most_recent_insert_iterator == _events.end ()) {
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert iterator at end, adding eval-value there %2\n", this, eval_value));
-		_events.push_back (new ControlEvent (when, eval_value));
+		unlocked_insert (_events.end (), new ControlEvent (when, eval_value));
 		/* leave insert iterator at the end */
 
 	} else if ((*most_recent_insert_iterator)->when == when) {
@@ -647,7 +669,7 @@ ControlList::add_guard_point (timepos_t const& time, timecnt_t const& offset)
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert eval-value %2 just before iterator @ %3\n",
 		                                                 this, eval_value, (*most_recent_insert_iterator)->when));
 
-		most_recent_insert_iterator = _events.insert (most_recent_insert_iterator, new ControlEvent (when, eval_value));
+		most_recent_insert_iterator = unlocked_insert (most_recent_insert_iterator, new ControlEvent (when, eval_value));
 
 		/* advance most_recent_insert_iterator so that the "real"
 		 * insert occurs in the right place, since it
@@ -688,7 +710,7 @@ ControlList::editor_add (timepos_t const& time, double value, bool with_guard)
 			 */
 
 			if (when >= 1) {
-				_events.insert (_events.end (), new ControlEvent (timepos_t (time_domain()), value));
+				unlocked_insert (_events.end (), new ControlEvent (timepos_t (time_domain()), value));
 				DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
 			}
 		}
@@ -702,13 +724,13 @@ ControlList::editor_add (timepos_t const& time, double value, bool with_guard)
 
 		iterator result;
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
-		result = _events.insert (i, new ControlEvent (when, value));
+		result = unlocked_insert (i, new ControlEvent (when, value));
 
 		if (i == result) {
 			return false;
 		}
 
-		mark_dirty ();
+		mark_lookups_dirty ();
 	}
 	maybe_signal_changed ();
 
@@ -812,8 +834,8 @@ ControlList::maybe_add_insert_guard (timepos_t const& time)
 			   going to go, so add a new point to avoid changing the shape of
 			   the line too much.  The insert iterator needs to point to the
 			   new control point so that our insert will happen correctly. */
-			most_recent_insert_iterator = _events.insert (most_recent_insert_iterator,
-			                                              new ControlEvent (when + GUARD_POINT_DELTA (when), (*most_recent_insert_iterator)->value));
+			most_recent_insert_iterator = unlocked_insert (most_recent_insert_iterator,
+			                                               new ControlEvent (when + GUARD_POINT_DELTA (when), (*most_recent_insert_iterator)->value));
 
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added insert guard point @ %2 = %3\n",
 			                                                 this, when + GUARD_POINT_DELTA (when),
@@ -922,7 +944,8 @@ ControlList::add (timepos_t const& time, double value, bool with_guards, bool wi
 				most_recent_insert_iterator = lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
 			}
 			WritePassStarted (); /* EMIT SIGNAL w/WriteLock */
-			new_write_pass = false;
+			new_write_pass  = false;
+			_write_pass_run = 0;
 
 		} else if (_in_write_pass &&
 		           (most_recent_insert_iterator == _events.end () || when > (*most_recent_insert_iterator)->when)) {
@@ -946,6 +969,12 @@ ControlList::add (timepos_t const& time, double value, bool with_guards, bool wi
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("compute(b) MRI for position %1\n", when));
 			ControlEvent cp (when, 0.0f);
 			most_recent_insert_iterator = lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
+
+		} else {
+			/* writing backwards (e.g. during a loop): the previous
+			 * point is not part of the run we are thinning.
+			 */
+			_write_pass_run = 0;
 		}
 
 		/* OK, now we're really ready to add a new point */
@@ -1025,11 +1054,65 @@ ControlList::add (timepos_t const& time, double value, bool with_guards, bool wi
 			}
 		}
 
+		if (_in_write_pass && _write_pass_thinning_factor > 0.0) {
+			unlocked_thin_write_pass (when);
+		}
+
 		mark_dirty ();
 	}
 	maybe_signal_changed ();
 }
 
+/** Apply ::thin() incrementally while recording, so that a write pass
+ * does not accumulate one point per control-change, and does not need
+ * to thin the complete list once it is finished.
+ *
+ * ::thin() walks forward over the list and compares every point with
+ * the survivors before it and the point after it. Here the point
+ * just added at @p when is the "point after", and the two before it
+ * have already been thinned, so the result is the same, except that
+ * points that pre-date this write pass are left alone.
+ */
+void
+ControlList::unlocked_thin_write_pass (timepos_t const& when)
+{
+	iterator cur;
+
+	if (most_recent_insert_iterator != _events.end () && (*most_recent_insert_iterator)->when == when) {
+		cur = most_recent_insert_iterator;
+	} else if (!_events.empty () && _events.back ()->when == when) {
+		cur = _events.end ();
+		--cur;
+	} else {
+		_write_pass_run = 0;
+		return;
+	}
+
+	/* only thin points that were written during this (part of the)
+	 * pass, never the guard point written when it started.
+	 */
+	if (++_write_pass_run < 3 || cur == _events.begin ()) {
+		return;
+	}
+
+	iterator prev = cur;
+	--prev;
+
+	if (prev == _events.begin ()) {
+		return;
+	}
+
+	iterator prevprev = prev;
+	--prevprev;
+
+	if (thinning_area (*prevprev, *prev, *cur) < _write_pass_thinning_factor) {
+		assert (prev != most_recent_insert_iterator);
+		delete *prev;
+		_events.erase (prev);
+		--_write_pass_run;
+	}
+}
+
 void
 ControlList::erase (iterator i)
 {
@@ -1038,8 +1121,8 @@ ControlList::erase (iterator i)
 		if (most_recent_insert_iterator == i) {
 			unlocked_invalidate_insert_iterator ();
 		}
-		_events.erase (i);
-		mark_dirty ();
+		unlocked_erase (i);
+		mark_lookups_dirty ();
 	}
 	maybe_signal_changed ();
 }
@@ -1071,13 +1154,13 @@ ControlList::erase (timepos_t const& time, double value)
 		}
 
 		if (i != end ()) {
-			_events.erase (i);
 			if (most_recent_insert_iterator == i) {
 				unlocked_invalidate_insert_iterator ();
 			}
+			unlocked_erase (i);
 		}
 
-		mark_dirty ();
+		mark_lookups_dirty ();
 	}
 	maybe_signal_changed ();
 }
@@ -1243,15 +1326,23 @@ ControlList::modify (iterator iter, timepos_t const& time, double val)
 			abort ();
 		}
 
-		if (!_frozen) {
-			_events.sort (event_time_less_than);
+		if (_frozen) {
+			_sort_pending     = true;
+			_eval_index.valid = false;
+		} else {
+			/* the list only needs to be sorted if the point moved past one of its neighbours */
+			iterator prev = iter;
+			iterator next = iter;
+			++next;
+			if ((iter != _events.begin () && when < (*--prev)->when) || (next != _events.end () && (*next)->when < when)) {
+				_events.sort (event_time_less_than);
+				_eval_index.valid = false;
+			}
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
-		} else {
-			_sort_pending = true;
 		}
 
-		mark_dirty ();
+		mark_lookups_dirty ();
 	}
 	maybe_signal_changed ();
 }
@@ -1310,6 +1401,7 @@ ControlList::thaw ()
 
 		if (_sort_pending) {
 			_events.sort (event_time_less_than);
+			_eval_index.valid = false;
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
@@ -1320,6 +1412,13 @@ ControlList::thaw ()
 
 void
 ControlList::mark_dirty () const
+{
+	mark_lookups_dirty ();
+	_eval_index.valid = false;
+}
+
+void
+ControlList::mark_lookups_dirty () const
 {
 	_lookup_cache.left         = timepos_t::max (time_domain());
 	_lookup_cache.range.first  = _events.end ();
@@ -1332,6 +1431,120 @@ ControlList::mark_dirty () const
 	}
 }
 
+static bool
+eval_index_time_less (ControlList::const_iterator const& i, timepos_t const& x)
+{
+	return (*i)->when < x;
+}
+
+static bool
+time_less_eval_index (timepos_t const& x, ControlList::const_iterator const& i)
+{
+	return x < (*i)->when;
+}
+
+void
+ControlList::build_eval_index_if_necessary () const
+{
+	/* caller must hold (at least) a read lock. Other readers only use the
+	 * index once it is valid, and skip building it while one of them does.
+	 */
+
+	if (_eval_index.valid || _sort_pending || _in_write_pass) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_eval_index.build_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked () || _eval_index.valid) {
+		return;
+	}
+
+	_eval_index.iter.clear ();
+	_eval_index.iter.reserve (_events.size ());
+
+	for (const_iterator i = _events.begin (); i != _events.end (); ++i) {
+		_eval_index.iter.push_back (i);
+	}
+
+	_eval_index.valid = true;
+}
+
+/** @return position of @p i in the eval index, which must be valid */
+size_t
+ControlList::unlocked_eval_index_position (const_iterator i) const
+{
+	if (i == _events.end ()) {
+		return _eval_index.iter.size ();
+	}
+
+	std::vector<const_iterator>::const_iterator p = std::lower_bound (_eval_index.iter.begin (), _eval_index.iter.end (), (*i)->when, eval_index_time_less);
+
+	/* skip other events at the same time */
+	while (*p != i) {
+		++p;
+		assert (p != _eval_index.iter.end ());
+	}
+
+	return p - _eval_index.iter.begin ();
+}
+
+/** Insert @p ev before @p pos, and update the eval index if it is valid.
+ * Caller must hold the write lock.
+ */
+ControlList::iterator
+ControlList::unlocked_insert (iterator pos, ControlEvent* ev)
+{
+	iterator i = _events.insert (pos, ev);
+
+	if (_eval_index.valid) {
+		_eval_index.iter.insert (_eval_index.iter.begin () + unlocked_eval_index_position (pos), i);
+	}
+
+	return i;
+}
+
+/** Erase @p i, and update the eval index if it is valid.
+ * Caller must hold the write lock.
+ */
+ControlList::iterator
+ControlList::unlocked_erase (iterator i)
+{
+	if (_eval_index.valid) {
+		_eval_index.iter.erase (_eval_index.iter.begin () + unlocked_eval_index_position (i));
+	}
+
+	return _events.erase (i);
+}
+
+ControlList::const_iterator
+ControlList::unlocked_lower_bound (timepos_t const& x) const
+{
+	if (!_eval_index.valid) {
+		const ControlEvent cp (x, 0);
+		return lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
+	}
+
+	std::vector<const_iterator>::const_iterator i = std::lower_bound (_eval_index.iter.begin (), _eval_index.iter.end (), x, eval_index_time_less);
+
+	return (i == _eval_index.iter.end ()) ? _events.end () : *i;
+}
+
+std::pair<ControlList::const_iterator, ControlList::const_iterator>
+ControlList::unlocked_equal_range (timepos_t const& x) const
+{
+	if (!_eval_index.valid) {
+		const ControlEvent cp (x, 0);
+		return equal_range (_events.begin (), _events.end (), &cp, time_comparator);
+	}
+
+	std::vector<const_iterator>::const_iterator first  = std::lower_bound (_eval_index.iter.begin (), _eval_index.iter.end (), x, eval_index_time_less);
+	std::vector<const_iterator>::const_iterator second = std::upper_bound (first, _eval_index.iter.end (), x, time_less_eval_index);
+
+	return std::make_pair (first == _eval_index.iter.end () ? _events.end () : *first,
+	                       second == _eval_index.iter.end () ? _events.end () : *second);
+}
+
 void
 ControlList::truncate_end (timepos_t const& last_time)
 {
@@ -1608,8 +1821,7 @@ ControlList::multipoint_eval (timepos_t const& xtime) const
 	/* "Stepped" lookup (no interpolation) */
 	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
-		const ControlEvent        cp (xtime, 0);
-		EventList::const_iterator i = lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
+		EventList::const_iterator i = unlocked_lower_bound (xtime);
 
 		// shouldn't have made it to multipoint_eval
 		assert (i != _events.end ());
@@ -1626,9 +1838,7 @@ ControlList::multipoint_eval (timepos_t const& xtime) const
 	    ((_lookup_cache.left > xtime) ||
 	     (_lookup_cache.range.first == _events.end ()) ||
 	     ((*_lookup_cache.range.second)->when < xtime))) {
-		const ControlEvent cp (xtime, 0);
-
-		_lookup_cache.range = equal_range (_events.begin (), _events.end (), &cp, time_comparator);
+		_lookup_cache.range = unlocked_equal_range (xtime);
 	}
 
 	pair<const_iterator, const_iterator> range = _lookup_cache.range;
@@ -1694,9 +1904,7 @@ ControlList::build_search_cache_if_necessary (timepos_t const& start_time) const
 	} else if ((_search_cache.left == timepos_t::max (time_domain())) || (_search_cache.left > start)) {
 		/* Marked dirty (left == max), or we're too far forward, re-search. */
 
-		const ControlEvent start_point (start, 0);
-
-		_search_cache.first = lower_bound (_events.begin (), _events.end (), &start_point, time_comparator);
+		_search_cache.first = unlocked_lower_bound (start);
 		_search_cache.left  = start;
 	}
 
@@ -2268,6 +2476,7 @@ ControlList::finish_domain_bounce (Temporal::DomainBounceInfo& dbi)
 			t.set_time_domain (dbi.from);
 			e->when = t;
 		}
+		mark_dirty ();
 	}
 
 	maybe_signal_changed ();
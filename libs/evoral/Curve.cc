@@ -396,9 +396,7 @@ Curve::multipoint_eval (Temporal::timepos_t const & x) const
 	     (lookup_cache.range.first == _list.events().end()) ||
 	     ((*lookup_cache.range.second)->when < x))) {
 
-		ControlEvent cp (x, 0.0);
-
-		lookup_cache.range = equal_range (_list.events().begin(), _list.events().end(), &cp, ControlList::time_comparator);
+		lookup_cache.range = _list.unlocked_equal_range (x);
 	}
 
 	range = lookup_cache.range;
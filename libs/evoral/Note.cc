@@ -18,6 +18,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <glib.h>
@@ -31,8 +32,8 @@ namespace Evoral {
 
 template<typename Time>
 Note<Time>::Note(uint8_t chan, Time t, Time l, uint8_t n, uint8_t v)
-	: _on_event (MIDI_EVENT, t, 3, NULL, true)
-	, _off_event (MIDI_EVENT, t + l, 3, NULL, true)
+	: _on_event (MIDI_EVENT, t, 3, _buf, false)
+	, _off_event (MIDI_EVENT, t + l, 3, _buf + 3, false)
 {
 	assert(chan < 16);
 
@@ -55,20 +56,17 @@ Note<Time>::Note(uint8_t chan, Time t, Time l, uint8_t n, uint8_t v)
 
 template<typename Time>
 Note<Time>::Note(const Note<Time>& copy)
-	: _on_event(copy._on_event, true)
-	, _off_event(copy._off_event, true)
+	: _on_event (copy._on_event.event_type (), copy._on_event.time (), 3, _buf, false)
+	, _off_event (copy._off_event.event_type (), copy._off_event.time (), 3, _buf + 3, false)
 {
-	assert(_on_event.buffer());
-	assert(_off_event.buffer());
-	/*
-	  assert(copy._on_event.size == 3);
-	  _on_event.buffer = _on_event_buffer;
-	  memcpy(_on_event_buffer, copy._on_event_buffer, 3);
-
-	  assert(copy._off_event.size == 3);
-	  _off_event.buffer = _off_event_buffer;
-	  memcpy(_off_event_buffer, copy._off_event_buffer, 3);
-	*/
+	assert(copy._on_event.size() == 3);
+	assert(copy._off_event.size() == 3);
+
+	memcpy (_buf, copy._on_event.buffer (), 3);
+	memcpy (_buf + 3, copy._off_event.buffer (), 3);
+
+	_on_event.set_id (copy._on_event.id ());
+	_off_event.set_id (copy._off_event.id ());
 
 	assert(time() == copy.time());
 	assert(end_time() == copy.end_time());
@@ -35,6 +35,7 @@
 
 #include "evoral/Event.h"
 #include "evoral/SMF.h"
+#include "evoral/SMFReader.h"
 #include "evoral/midi_util.h"
 
 #ifdef COMPILER_MSVC
@@ -49,6 +50,11 @@ SMF::SMF()
 	: _smf (0)
 	, _smf_track (0)
 	, _empty (true)
+	, _deferred (false)
+	, _deferred_track (0)
+	, _deferred_format (0)
+	, _deferred_ppqn (0)
+	, _deferred_num_tracks (0)
 	, _n_note_on_events (0)
 	, _has_pgm_change (false)
 	, _num_channels (0)
@@ -62,23 +68,85 @@ SMF::~SMF()
 int
 SMF::smf_format () const
 {
-	return _smf ? _smf->format : 0;
+	return _smf ? _smf->format : _deferred_format;
 }
 
 uint16_t
 SMF::num_tracks() const
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
-	return (uint16_t) (_smf ? _smf->number_of_tracks : 0);
+	return (uint16_t) (_smf ? _smf->number_of_tracks : _deferred_num_tracks);
 }
 
 uint16_t
 SMF::ppqn() const
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	if (!_smf) {
+		return _deferred_ppqn;
+	}
 	return _smf->ppqn;
 }
 
+bool
+SMF::deferred () const
+{
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	return _deferred;
+}
+
+void
+SMF::clear_deferred ()
+{
+	_deferred = false;
+	_deferred_path.clear ();
+	_deferred_track      = 0;
+	_deferred_format     = 0;
+	_deferred_ppqn       = 0;
+	_deferred_num_tracks = 0;
+}
+
+/** Parse a file that was opened deferred, if it has not been parsed yet.
+ * Must be called with _smf_lock held.
+ *
+ * \return true if libsmf data is available
+ */
+bool
+SMF::load_deferred_unlocked () const
+{
+	if (!_deferred) {
+		return _smf != 0;
+	}
+
+	/* whatever happens, only try once */
+	_deferred = false;
+
+	const std::string path = deferred_path ();
+
+	FILE* f = g_fopen (path.c_str(), "r");
+	if (f == 0) {
+		cerr << "WARNING: SMF cannot open " << path << endl;
+		return false;
+	}
+
+	_smf = smf_load (f);
+	fclose (f);
+
+	if (!_smf) {
+		cerr << "WARNING: SMF cannot parse " << path << endl;
+		return false;
+	}
+
+	if ((_smf_track = smf_get_track_by_number (_smf, _deferred_track)) == 0) {
+		smf_delete (_smf);
+		_smf = 0;
+		return false;
+	}
+
+	_smf_track->next_event_number = (_smf_track->number_of_events == 0) ? 0 : 1;
+	return true;
+}
+
 /** Seek to the specified track (1-based indexing)
  * \return 0 on success
  */
@@ -86,6 +154,9 @@ int
 SMF::seek_to_track(int track)
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	if (!load_deferred_unlocked ()) {
+		return -1;
+	}
 	_smf_track = smf_get_track_by_number(_smf, track);
 	if (_smf_track != NULL) {
 		_smf_track->next_event_number = (_smf_track->number_of_events == 0) ? 0 : 1;
@@ -121,13 +192,18 @@ SMF::test(const std::string& path)
 }
 
 /** Attempt to open the SMF file for reading and/or writing.
+ *
+ * With \a deferred (and without \a scan) only the file header and the
+ * track chunk headers are read, and parsing the file with libsmf is
+ * postponed until its events are accessed through this object. Until then,
+ * the file can be read with an SMFReader.
  *
  * \return  0 on success
  *         -1 if the file can not be opened or created
  *         -2 if the file exists but specified track does not exist
  */
 int
-SMF::open(const std::string& path, int track, bool scan)
+SMF::open(const std::string& path, int track, bool scan, bool deferred)
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
@@ -139,6 +215,28 @@ SMF::open(const std::string& path, int track, bool scan)
 	assert(track >= 1);
 	if (_smf) {
 		smf_delete(_smf);
+		_smf       = 0;
+		_smf_track = 0;
+	}
+
+	clear_deferred ();
+
+	if (deferred && !scan) {
+		SMFReader reader;
+		if (!reader.open (path, true)) {
+			/* not something we can handle, try libsmf */
+		} else if (track > reader.num_tracks ()) {
+			return -2;
+		} else {
+			_deferred            = true;
+			_deferred_path       = path;
+			_deferred_track      = track;
+			_deferred_format     = reader.type ();
+			_deferred_ppqn       = reader.ppqn ();
+			_deferred_num_tracks = reader.num_tracks ();
+			_empty               = reader.track_is_empty (track);
+			return 0;
+		}
 	}
 
 	FILE* f = g_fopen(path.c_str(), "r");
@@ -233,6 +331,8 @@ SMF::create(const std::string& path, int track, uint16_t ppqn)
 		smf_delete(_smf);
 	}
 
+	clear_deferred ();
+
 	_smf = smf_new();
 
 	if (_smf == NULL) {
@@ -289,12 +389,15 @@ SMF::close()
 		_smf_track = 0;
 		_num_channels = 0;
 	}
+
+	clear_deferred ();
 }
 
 void
 SMF::seek_to_start() const
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	load_deferred_unlocked ();
 	if (_smf_track) {
 		_smf_track->next_event_number = std::min(_smf_track->number_of_events, (size_t)1);
 	} else {
@@ -331,6 +434,10 @@ SMF::read_event(uint32_t* delta_t, uint32_t* size, uint8_t** buf, event_id_t* no
 	assert(buf);
 	assert(note_id);
 
+	if (!load_deferred_unlocked ()) {
+		return -1;
+	}
+
 	if ((event = smf_track_get_next_event(_smf_track)) != NULL) {
 
 		*delta_t = event->delta_time_pulses;
@@ -398,7 +505,7 @@ SMF::append_event_delta(uint32_t delta_t, uint32_t size, const uint8_t* buf, eve
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
-	if (size == 0) {
+	if (size == 0 || !load_deferred_unlocked ()) {
 		return;
 	}
 
@@ -494,6 +601,8 @@ SMF::begin_write()
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
+	load_deferred_unlocked ();
+
 	assert(_smf_track);
 	smf_track_delete(_smf_track);
 
@@ -509,7 +618,7 @@ SMF::end_write(string const & path)
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
-	if (!_smf) {
+	if (!load_deferred_unlocked ()) {
 		return;
 	}
 
@@ -542,14 +651,14 @@ static bool invalid_char (unsigned char c)
 void
 SMF::track_names(vector<string>& names) const
 {
-	if (!_smf) {
-		return;
-	}
-
 	names.clear ();
 
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
+	if (!load_deferred_unlocked ()) {
+		return;
+	}
+
 	for (uint16_t n = 0; n < _smf->number_of_tracks; ++n) {
 		smf_track_t* trk = smf_get_track_by_number (_smf, n+1);
 		if (!trk) {
@@ -571,14 +680,14 @@ SMF::track_names(vector<string>& names) const
 void
 SMF::instrument_names(vector<string>& names) const
 {
-	if (!_smf) {
-		return;
-	}
-
 	names.clear ();
 
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
+	if (!load_deferred_unlocked ()) {
+		return;
+	}
+
 	for (uint16_t n = 0; n < _smf->number_of_tracks; ++n) {
 		smf_track_t* trk = smf_get_track_by_number (_smf, n+1);
 		if (!trk) {
@@ -610,6 +719,8 @@ SMF::Tempo::Tempo (smf_tempo_t* smft)
 int
 SMF::num_tempos () const
 {
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	load_deferred_unlocked ();
 	assert (_smf);
 	return smf_get_tempo_count (_smf);
 }
@@ -617,6 +728,8 @@ SMF::num_tempos () const
 SMF::Tempo*
 SMF::nth_tempo (size_t n) const
 {
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	load_deferred_unlocked ();
 	assert (_smf);
 
 	smf_tempo_t* t = smf_get_tempo_by_number (_smf, n);
@@ -630,12 +743,12 @@ SMF::nth_tempo (size_t n) const
 void
 SMF::load_markers ()
 {
-	if (!_smf_track) {
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+
+	if (!load_deferred_unlocked () || !_smf_track) {
 		return;
 	}
 
-	Glib::Threads::Mutex::Lock lm (_smf_lock);
-
 	if (_smf_track) {
 		_smf_track->next_event_number = std::min(_smf_track->number_of_events, (size_t)1);
 	}
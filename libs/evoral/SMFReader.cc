@@ -16,13 +16,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 #include <cassert>
 #include <iostream>
 
 #include <glib/gstdio.h>
-#include <glibmm/miscutils.h>
 
 #include "evoral/midi_util.h"
 #include "evoral/SMFReader.h"
@@ -31,255 +31,310 @@ using namespace std;
 
 namespace Evoral {
 
+static inline uint16_t
+read_be16 (uint8_t const* p)
+{
+	return (p[0] << 8) | p[1];
+}
 
-SMFReader::SMFReader(const string& filename)
-	: _fd(NULL)
-	, _ppqn(0)
-	, _track(0)
-	, _track_size(0)
+static inline uint32_t
+read_be32 (uint8_t const* p)
 {
-	if (filename.length() > 0) {
-		open(filename);
-	}
+	return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
 }
 
+/** Decode a variable length quantity of at most 4 bytes (like libsmf's smf_extract_vlq) */
+static bool
+decode_vlq (uint8_t const* buf, size_t len, uint32_t& value, size_t& used)
+{
+	uint32_t val = 0;
+
+	for (size_t i = 0; i < 4 && i < len; ++i) {
+		val = (val << 7) | (buf[i] & 0x7f);
+		if (!(buf[i] & 0x80)) {
+			value = val;
+			used  = i + 1;
+			return true;
+		}
+	}
+
+	return false;
+}
 
-SMFReader::~SMFReader()
+SMFReader::SMFReader ()
+	: _type (0)
+	, _ppqn (0)
+	, _pos (0)
+	, _end (0)
+	, _running_status (0)
 {
-	if (_fd)
-		close();
 }
 
+SMFReader::~SMFReader ()
+{
+	close ();
+}
 
 bool
-SMFReader::open(const string& filename) throw (logic_error, UnsupportedTime)
+SMFReader::open (string const & path, bool header_only)
 {
-	if (_fd)
-		throw logic_error("Attempt to start new read while write in progress.");
-
-	cout << "Opening SMF file " << filename << " for reading." << endl;
-
-	_fd = g_fopen(filename.c_str(), "r+b");
-
-	if (_fd) {
-		// Read type (bytes 8..9)
-		fseek(_fd, 0, SEEK_SET);
-		char mthd[5];
-		mthd[4] = '\0';
-		fread(mthd, 1, 4, _fd);
-		if (strcmp(mthd, "MThd")) {
-			cerr << filename << " is not an SMF file, aborting." << endl;
-			fclose(_fd);
-			_fd = NULL;
-			return false;
-		}
-
-		// Read type (bytes 8..9)
-		fseek(_fd, 8, SEEK_SET);
-		uint16_t type_be = 0;
-		fread(&type_be, 2, 1, _fd);
-		_type = GUINT16_FROM_BE(type_be);
+	close ();
 
-		// Read number of tracks (bytes 10..11)
-		uint16_t num_tracks_be = 0;
-		fread(&num_tracks_be, 2, 1, _fd);
-		_num_tracks = GUINT16_FROM_BE(num_tracks_be);
+	FILE* f = g_fopen (path.c_str (), "rb");
 
-		// Read PPQN (bytes 12..13)
-		uint16_t ppqn_be = 0;
-		fread(&ppqn_be, 2, 1, _fd);
-		_ppqn = GUINT16_FROM_BE(ppqn_be);
+	if (!f) {
+		return false;
+	}
 
-		// TODO: Absolute (SMPTE seconds) time support
-		if ((_ppqn & 0x8000) != 0)
-			throw UnsupportedTime();
+	if (fseek (f, 0, SEEK_END) != 0) {
+		fclose (f);
+		return false;
+	}
 
-		seek_to_track(1);
+	const long len = ftell (f);
+	uint8_t    hdr[14];
 
-		return true;
-	} else {
+	if (len < 14 || fseek (f, 0, SEEK_SET) != 0 || fread (hdr, 1, 14, f) != 14 || memcmp (hdr, "MThd", 4)) {
+		fclose (f);
 		return false;
 	}
-}
 
+	const uint32_t header_size = read_be32 (&hdr[4]);
 
-/** Seek to the start of a given track, starting from 1.
- * Returns true if specified track was found.
- */
-bool
-SMFReader::seek_to_track(unsigned track) throw (std::logic_error)
-{
-	if (track == 0)
-		throw logic_error("Seek to track 0 out of range (must be >= 1)");
+	_type = read_be16 (&hdr[8]);
+	_ppqn = read_be16 (&hdr[12]);
 
-	if (!_fd)
-		throw logic_error("Attempt to seek to track on unopened SMF file.");
+	if (header_size < 6 || (_ppqn & 0x8000)) {
+		/* TODO: Absolute (SMPTE seconds) time support */
+		fclose (f);
+		close ();
+		return false;
+	}
 
-	unsigned track_pos = 0;
+	/* locate track chunks, skipping any unknown chunks. Only the chunk
+	 * headers are read here, so that a header_only open does not read
+	 * the event data.
+	 */
 
-	fseek(_fd, 14, SEEK_SET);
-	char id[5];
-	id[4] = '\0';
-	uint32_t chunk_size = 0;
+	size_t offset = 8 + header_size;
 
-	while (!feof(_fd)) {
-		fread(id, 1, 4, _fd);
+	while (offset + 8 <= (size_t) len) {
+		uint8_t chunk[8];
 
-		if (!strcmp(id, "MTrk")) {
-			++track_pos;
-		} else {
-			std::cerr << "Unknown chunk ID " << id << endl;
+		if (fseek (f, offset, SEEK_SET) != 0 || fread (chunk, 1, 8, f) != 8) {
+			break;
 		}
 
-		uint32_t chunk_size_be;
-		fread(&chunk_size_be, 4, 1, _fd);
-		chunk_size = GUINT32_FROM_BE(chunk_size_be);
+		const uint32_t chunk_size = read_be32 (&chunk[4]);
+		const size_t   start      = offset + 8;
+		const size_t   avail      = len - start;
+
+		if (!memcmp (chunk, "MTrk", 4)) {
+			_tracks.push_back (Track (start, std::min ((size_t) chunk_size, avail)));
+		}
 
-		if (track_pos == track)
+		if (chunk_size > avail) {
 			break;
+		}
 
-		fseek(_fd, chunk_size, SEEK_CUR);
+		offset = start + chunk_size;
 	}
 
-	if (!feof(_fd) && track_pos == track) {
-		_track = track;
-		_track_size = chunk_size;
+	if (header_only) {
+		fclose (f);
 		return true;
-	} else {
+	}
+
+	_data.resize (len);
+
+	if (fseek (f, 0, SEEK_SET) != 0 || fread (&_data[0], 1, len, f) != (size_t) len) {
+		fclose (f);
+		close ();
 		return false;
 	}
-}
 
+	fclose (f);
 
-/** Read an event from the current position in file.
- *
- * File position MUST be at the beginning of a delta time, or this will die very messily.
- * ev.buffer must be of size ev.size, and large enough for the event.  The returned event
- * will have it's time field set to it's delta time (so it's the caller's responsibility
- * to keep track of delta time, even for ignored events).
- *
- * Returns event length (including status byte) on success, 0 if event was
- * skipped (eg a meta event), or -1 on EOF (or end of track).
- *
- * If @a buf is not large enough to hold the event, 0 will be returned, but ev_size
- * set to the actual size of the event.
- */
-int
-SMFReader::read_event(size_t    buf_len,
-                      uint8_t*  buf,
-                      uint32_t* ev_size,
-                      uint32_t* delta_time)
-		throw (std::logic_error, PrematureEOF, CorruptFile)
+	seek_to_track (1);
+
+	return true;
+}
+
+void
+SMFReader::close ()
 {
-	if (_track == 0)
-		throw logic_error("Attempt to read from unopened SMF file");
+	_data.clear ();
+	_tracks.clear ();
+	_type = 0;
+	_ppqn = 0;
+	_pos  = 0;
+	_end  = 0;
+	_running_status = 0;
+}
 
-	if (!_fd || feof(_fd)) {
-		return -1;
+bool
+SMFReader::track_is_empty (unsigned track) const
+{
+	if (track == 0 || track > _tracks.size ()) {
+		return true;
 	}
+	return _tracks[track - 1].size == 0;
+}
 
-	assert(buf_len > 0);
-	assert(buf);
-	assert(ev_size);
-	assert(delta_time);
-
-	// Running status state
-	static uint8_t  last_status = 0;
-	static uint32_t last_size   = 0;
-
-	*delta_time = read_var_len(_fd);
-	int status = fgetc(_fd);
-	if (status == EOF)
-		throw PrematureEOF();
-	else if (status > 0xFF)
-		throw CorruptFile();
-
-	if (status < 0x80) {
-		if (last_status == 0)
-			throw CorruptFile();
-		status = last_status;
-		*ev_size = last_size;
-		fseek(_fd, -1, SEEK_CUR);
-	} else {
-		last_status = status;
-		*ev_size = midi_event_size(status);
-		last_size = *ev_size;
+bool
+SMFReader::seek_to_track (unsigned track)
+{
+	if (track == 0 || track > _tracks.size () || _data.empty ()) {
+		_pos = _end = 0;
+		return false;
 	}
 
-	buf[0] = (uint8_t)status;
-
-	if (status == 0xFF) {
-		*ev_size = 0;
-		if (feof(_fd))
-			throw PrematureEOF();
-		uint8_t type = fgetc(_fd);
-		const uint32_t size = read_var_len(_fd);
-		/*cerr.flags(ios::hex);
-		cerr << "SMF - meta 0x" << (int)type << ", size = ";
-		cerr.flags(ios::dec);
-		cerr << size << endl;*/
-
-		if ((uint8_t)type == 0x2F) {
-			return -1; // we hit the logical EOF anyway...
-		} else {
-			fseek(_fd, size, SEEK_CUR);
-			return 0;
-		}
+	_pos = _tracks[track - 1].offset;
+	_end = _pos + _tracks[track - 1].size;
+	_running_status = 0;
+
+	return true;
+}
+
+bool
+SMFReader::read_vlq (uint32_t& value)
+{
+	size_t used;
+
+	if (_pos >= _end || !decode_vlq (_data.data () + _pos, _end - _pos, value, used)) {
+		return false;
 	}
 
-	if (*ev_size > buf_len || *ev_size == 0 || feof(_fd)) {
-		//cerr << "SMF - Skipping event" << endl;
-		// Skip event, return 0
-		fseek(_fd, *ev_size - 1, SEEK_CUR);
-		return 0;
-	} else {
-		// Read event, return size
-		if (ferror(_fd))
-			throw CorruptFile();
+	_pos += used;
+	return true;
+}
 
-		fread(buf+1, 1, *ev_size - 1, _fd);
+int
+SMFReader::read_event (uint32_t* delta_t, uint32_t* size, uint8_t const** buf, event_id_t* note_id)
+{
+	assert (delta_t);
+	assert (size);
+	assert (buf);
+	assert (note_id);
 
-		if ((buf[0] & 0xF0) == 0x90 && buf[2] == 0) {
-			buf[0] = (0x80 | (buf[0] & 0x0F));
-			buf[2] = 0x40;
-		}
+	if (_pos >= _end || !read_vlq (*delta_t) || _pos >= _end) {
+		_pos = _end;
+		return -1;
+	}
 
-		return *ev_size;
+	uint8_t status = _data[_pos];
+
+	if (status & 0x80) {
+		++_pos;
+	} else if (_running_status >= 0x80 && _running_status < 0xf0) {
+		/* running status, only for channel messages */
+		status = _running_status;
+	} else {
+		cerr << "WARNING: SMF invalid running status" << endl;
+		_pos = _end;
+		return -1;
 	}
-}
 
+	uint32_t len;
+	bool     ok = false;
 
-void
-SMFReader::close()
-{
-	if (_fd)
-		fclose(_fd);
+	switch (status) {
+	case 0xff:
+		/* meta event */
+		if (_pos >= _end) {
+			break;
+		}
+		{
+			const uint8_t type = _data[_pos++];
+
+			if (!read_vlq (len) || len > _end - _pos) {
+				break;
+			}
+
+			uint8_t const* data = _data.data () + _pos;
+			_pos += len;
+
+			*note_id = -1; // "no note id in this meta-event */
+
+			if (type == 0x2f) {
+				/* end of track */
+				_pos = _end;
+			} else if (type == 0x7f && len > 2 && data[0] == 0x99 && data[1] == 0x01) {
+				/* sequencer-specific: Evoral Note ID */
+				uint32_t id;
+				size_t   idlen;
+				if (decode_vlq (&data[2], len - 2, id, idlen)) {
+					*note_id = id;
+				}
+			}
+		}
+		return 0; /* this is a meta-event */
 
-	_fd = NULL;
-}
+	case 0xf0:
+		/* sysex: status, length, data (usually including 0xf7) */
+		if (!read_vlq (len) || len > _end - _pos) {
+			break;
+		}
+		_sysex.resize (len + 1);
+		_sysex[0] = status;
+		memcpy (&_sysex[1], _data.data () + _pos, len);
+		_pos += len;
+		*buf  = &_sysex[0];
+		*size = len + 1;
+		ok    = true;
+		_running_status = 0;
+		break;
+
+	case 0xf7:
+		/* escaped event: arbitrary bytes */
+		if (!read_vlq (len) || len == 0 || len > _end - _pos) {
+			break;
+		}
+		*buf  = &_data[_pos];
+		*size = len;
+		_pos += len;
+		ok    = true;
+		_running_status = 0;
+		break;
+
+	default:
+		{
+			const int ev_size = midi_event_size (status);
+			if (ev_size < 1 || (size_t) (ev_size - 1) > _end - _pos) {
+				break;
+			}
+			_msg[0] = status;
+			memcpy (&_msg[1], &_data[_pos], ev_size - 1);
+			_pos += ev_size - 1;
+			_running_status = status;
+
+			if ((_msg[0] & 0xf0) == 0x90 && _msg[2] == 0) {
+				/* normalize note on with velocity 0 to proper note off */
+				_msg[0] = 0x80 | (_msg[0] & 0x0f);  /* note off */
+				_msg[2] = 0x40;  /* default velocity */
+			}
+
+			*buf  = _msg;
+			*size = ev_size;
+			ok    = true;
+		}
+		break;
+	}
 
+	if (!ok) {
+		cerr << "WARNING: SMF unexpected end of track" << endl;
+		_pos = _end;
+		return -1;
+	}
 
-uint32_t
-SMFReader::read_var_len(FILE* fd) throw (PrematureEOF)
-{
-	if (feof(fd))
-		throw PrematureEOF();
-
-	uint32_t value;
-	uint8_t  c;
-
-	if ( (value = getc(fd)) & 0x80 ) {
-		value &= 0x7F;
-		do {
-			if (feof(fd))
-				throw PrematureEOF();
-			value = (value << 7) + ((c = getc(fd)) & 0x7F);
-		} while (c & 0x80);
+	if (!midi_event_is_valid (*buf, *size)) {
+		cerr << "WARNING: SMF ignoring illegal MIDI event" << endl;
+		*size = 0;
+		_pos = _end;
+		return -1;
 	}
 
-	return value;
+	return *size;
 }
 
-
 } // namespace Evoral
-
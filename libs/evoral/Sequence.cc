@@ -62,6 +62,85 @@ static Temporal::Beats const time_between_interpolated_controller_outputs = Temp
 
 namespace Evoral {
 
+/** Fixed-size blocks for notes (together with their shared_ptr control
+ * block), allocated in slabs so that notes which are read in order are
+ * also stored in order, rather than scattered across the heap.
+ * Released blocks are re-used, slabs are freed with the last note.
+ */
+class NoteSlabs
+{
+public:
+	NoteSlabs () : _size (0), _used (slab_blocks), _free (0) {}
+
+	~NoteSlabs ()
+	{
+		for (std::vector<char*>::const_iterator i = _slabs.begin (); i != _slabs.end (); ++i) {
+			::operator delete (*i);
+		}
+	}
+
+	void* alloc (size_t size)
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+
+		if (_size == 0) {
+			_size = std::max (size, sizeof (void*));
+		}
+		if (size > _size) {
+			return ::operator new (size);
+		}
+		if (_free) {
+			void* p = _free;
+			_free   = *(void**)p;
+			return p;
+		}
+		if (_used == slab_blocks) {
+			_slabs.push_back ((char*)::operator new (slab_blocks * _size));
+			_used = 0;
+		}
+		return _slabs.back () + _size * _used++;
+	}
+
+	void release (void* p, size_t size)
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+
+		if (size > _size) {
+			::operator delete (p);
+			return;
+		}
+		*(void**)p = _free;
+		_free      = p;
+	}
+
+private:
+	static const size_t slab_blocks = 256;
+
+	Glib::Threads::Mutex _lock;
+	size_t               _size;
+	size_t               _used;
+	void*                _free;
+	std::vector<char*>   _slabs;
+};
+
+/** Allocator for std::allocate_shared, which keeps the slabs alive */
+template<typename T>
+struct NoteSlabAllocator
+{
+	typedef T value_type;
+
+	NoteSlabAllocator (std::shared_ptr<NoteSlabs> const& s) : slabs (s) {}
+	template<typename U> NoteSlabAllocator (NoteSlabAllocator<U> const& other) : slabs (other.slabs) {}
+
+	T*   allocate (size_t n)             { return (T*) slabs->alloc (n * sizeof (T)); }
+	void deallocate (T* p, size_t n)     { slabs->release (p, n * sizeof (T)); }
+
+	template<typename U> bool operator== (NoteSlabAllocator<U> const& other) const { return slabs == other.slabs; }
+	template<typename U> bool operator!= (NoteSlabAllocator<U> const& other) const { return slabs != other.slabs; }
+
+	std::shared_ptr<NoteSlabs> slabs;
+};
+
 // Read iterator (const_iterator)
 
 template<typename Time>
@@ -479,6 +558,7 @@ Sequence<Time>::Sequence(const TypeMap& type_map)
 	, _overlap_pitch_resolution (FirstOnFirstOff)
 	, _writing(false)
 	, _type_map(type_map)
+	, _note_slabs (new NoteSlabs)
 	, _end_iter(*this, std::numeric_limits<Time>::max(), false, std::set<Evoral::Parameter> ())
 	, _lowest_note(127)
 	, _highest_note(0)
@@ -500,12 +580,13 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 	, _overlap_pitch_resolution (other._overlap_pitch_resolution)
 	, _writing(false)
 	, _type_map(other._type_map)
+	, _note_slabs (new NoteSlabs)
 	, _end_iter(*this, std::numeric_limits<Time>::max(), false, std::set<Evoral::Parameter> ())
 	, _lowest_note(other._lowest_note)
 	, _highest_note(other._highest_note)
 {
 	for (typename Notes::const_iterator i = other._notes.begin(); i != other._notes.end(); ++i) {
-		NotePtr n (new Note<Time> (**i));
+		NotePtr n (new_note (**i));
 		_notes.insert (n);
 	}
 
@@ -846,9 +927,7 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 			 * so the search_note has all other properties unset.
 			 */
 
-			NotePtr search_note (new Note<Time>(0, Time(), Time(), note->note(), 0));
-
-			for (j = p.lower_bound (search_note); j != p.end() && (*j)->note() == note->note(); ++j) {
+			for (j = p.lower_bound (search_note (Time(), note->note())); j != p.end() && (*j)->note() == note->note(); ++j) {
 
 				if ((*j) == note) {
 					DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\terasing pitch %2 @ %3\n", this, (int)(*j)->note(), (*j)->time()));
@@ -1006,7 +1085,7 @@ Sequence<Time>::append_note_on_unlocked (const Event<Time>& ev, event_id_t evid)
 	/* nascent (incoming notes without a note-off ...yet) have a duration
 	   that extends to Beats::max()
 	*/
-	NotePtr note(new Note<Time>(ev.channel(), ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(), ev.note(), ev.velocity()));
+	NotePtr note (new_note (ev.channel(), ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(), ev.note(), ev.velocity()));
 	assert (note->end_time() == std::numeric_limits<Temporal::Beats>::max());
 	note->set_id (evid);
 
@@ -1077,7 +1156,7 @@ Sequence<Time>::append_note_off_unlocked (const Event<Time>& ev)
 		   this note-off was received.
 		*/
 		/* Can there any better guess at the velocity value ? */
-		NotePtr note (new Note<Time> (ev.channel(), Time(), ev.time(), ev.note(), 64));
+		NotePtr note (new_note (ev.channel(), Time(), ev.time(), ev.note(), 64));
 		note->set_off_velocity (ev.velocity());
 		add_note_unlocked (note);
 	}
@@ -1158,9 +1237,8 @@ bool
 Sequence<Time>::contains_unlocked (const NotePtr& note) const
 {
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
 
-	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
+	for (typename Pitches::const_iterator i = p.lower_bound (search_note (Time(), note->note()));
 	     i != p.end() && (*i)->note() == note->note(); ++i) {
 
 		if (**i == *note) {
@@ -1187,9 +1265,8 @@ Sequence<Time>::overlaps_unlocked (const NotePtr& note, const NotePtr& without)
 	Time ea  = note->end_time();
 
 	const Pitches& p (pitches (note->channel()));
-	NotePtr search_note(new Note<Time>(0, Time(), Time(), note->note()));
 
-	for (typename Pitches::const_iterator i = p.lower_bound (search_note);
+	for (typename Pitches::const_iterator i = p.lower_bound (search_note (Time(), note->note()));
 	     i != p.end() && (*i)->note() == note->note(); ++i) {
 
 		if (without && (**i) == *without) {
@@ -1217,6 +1294,32 @@ Sequence<Time>::set_notes (const typename Sequence<Time>::Notes& n)
 	_notes = n;
 }
 
+template<typename Time>
+typename Sequence<Time>::NotePtr
+Sequence<Time>::new_note (uint8_t chan, Time time, Time length, uint8_t note, uint8_t vel)
+{
+	return std::allocate_shared<Note<Time> > (NoteSlabAllocator<Note<Time> > (_note_slabs), chan, time, length, note, vel);
+}
+
+template<typename Time>
+typename Sequence<Time>::NotePtr
+Sequence<Time>::new_note (Note<Time> const& other)
+{
+	return std::allocate_shared<Note<Time> > (NoteSlabAllocator<Note<Time> > (_note_slabs), other);
+}
+
+template<typename Time>
+typename Sequence<Time>::NotePtr const &
+Sequence<Time>::search_note (Time const & t, uint8_t note)
+{
+	static thread_local NotePtr sn (new Note<Time> (0, Time(), Time(), 0, 0));
+
+	sn->set_time (t);
+	sn->set_note (note);
+
+	return sn;
+}
+
 // CONST iterator implementations (x3)
 
 /** Return the earliest note with time >= t */
@@ -1224,8 +1327,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::const_iterator
 Sequence<Time>::note_lower_bound (Time t) const
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
-	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(search_note);
+	typename Sequence<Time>::Notes::const_iterator i = _notes.lower_bound(search_note (t, 0));
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
 }
@@ -1259,8 +1361,7 @@ template<typename Time>
 typename Sequence<Time>::Notes::iterator
 Sequence<Time>::note_lower_bound (Time t)
 {
-	NotePtr search_note(new Note<Time>(0, t, Time(), 0, 0));
-	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(search_note);
+	typename Sequence<Time>::Notes::iterator i = _notes.lower_bound(search_note (t, 0));
 	assert(i == _notes.end() || (*i)->time() >= t);
 	return i;
 }
@@ -1321,44 +1422,38 @@ Sequence<Time>::get_notes_by_pitch (Notes& n, NoteOperator op, uint8_t val, int
 		}
 
 		const Pitches& p (pitches (c));
-		NotePtr search_note(new Note<Time>(0, Time(), Time(), val, 0));
 		typename Pitches::const_iterator i;
+		typename Pitches::const_iterator e;
+
+		/* pitches are sorted by note number */
 		switch (op) {
 		case PitchEqual:
-			i = p.lower_bound (search_note);
-			while (i != p.end() && (*i)->note() == val) {
-				n.insert (*i);
-			}
+			i = p.lower_bound (search_note (Time(), val));
+			e = p.upper_bound (search_note (Time(), val));
 			break;
 		case PitchLessThan:
-			i = p.upper_bound (search_note);
-			while (i != p.end() && (*i)->note() < val) {
-				n.insert (*i);
-			}
+			i = p.begin ();
+			e = p.lower_bound (search_note (Time(), val));
 			break;
 		case PitchLessThanOrEqual:
-			i = p.upper_bound (search_note);
-			while (i != p.end() && (*i)->note() <= val) {
-				n.insert (*i);
-			}
+			i = p.begin ();
+			e = p.upper_bound (search_note (Time(), val));
 			break;
 		case PitchGreater:
-			i = p.lower_bound (search_note);
-			while (i != p.end() && (*i)->note() > val) {
-				n.insert (*i);
-			}
+			i = p.upper_bound (search_note (Time(), val));
+			e = p.end ();
 			break;
 		case PitchGreaterThanOrEqual:
-			i = p.lower_bound (search_note);
-			while (i != p.end() && (*i)->note() >= val) {
-				n.insert (*i);
-			}
+			i = p.lower_bound (search_note (Time(), val));
+			e = p.end ();
 			break;
 
 		default:
 			//fatal << string_compose (_("programming error: %1 %2", X_("get_notes_by_pitch() called with illegal operator"), op)) << endmsg;
 			abort(); /* NOTREACHED*/
 		}
+
+		n.insert (i, e);
 	}
 }
 
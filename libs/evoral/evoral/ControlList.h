@@ -23,8 +23,10 @@
 #ifndef EVORAL_CONTROL_LIST_HPP
 #define EVORAL_CONTROL_LIST_HPP
 
+#include <atomic>
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -261,6 +263,7 @@ public:
 	 */
 	double eval (Temporal::timepos_t const & where) const {
 		Glib::Threads::RWLock::ReaderLock lm (_lock);
+		build_eval_index_if_necessary ();
 		return unlocked_eval (where);
 	}
 
@@ -315,6 +318,14 @@ public:
 	 */
 	double unlocked_eval (Temporal::timepos_t const & x) const;
 
+	/** Binary-search equivalents of std::lower_bound() and
+	 * std::equal_range() over the event list, using the eval index
+	 * when it is valid and falling back to walking the list when it is
+	 * not. Caller must hold (at least) a read lock.
+	 */
+	const_iterator unlocked_lower_bound (Temporal::timepos_t const & x) const;
+	std::pair<const_iterator,const_iterator> unlocked_equal_range (Temporal::timepos_t const & x) const;
+
 	bool rt_safe_earliest_event_discrete_unlocked (Temporal::timepos_t const & start, Temporal::timepos_t & x, double& y, bool inclusive) const;
 	bool rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const & start, Temporal::timepos_t & x, double& y, bool inclusive, Temporal::timecnt_t min_x_delta = Temporal::timecnt_t::max()) const;
 
@@ -355,7 +366,12 @@ public:
 	virtual bool touching() const { return false; }
 	virtual bool writing() const { return false; }
 	virtual bool touch_enabled() const { return false; }
-	void start_write_pass (Temporal::timepos_t const &);
+	/** Start writing at the given position.
+	 *
+	 * @param thinning_factor if non-zero, thin the recorded points while they
+	 * are added (see ::thin()), rather than when the write pass is finished.
+	 */
+	void start_write_pass (Temporal::timepos_t const &, double thinning_factor = 0.0);
 	void write_pass_finished (Temporal::timepos_t const &, double thinning_factor=0.0);
 	void set_in_write_pass (bool, bool add_point = false, Temporal::timepos_t = std::numeric_limits<Temporal::timepos_t>::min());
 	/** @return true if transport is running and this list is in write mode */
@@ -396,6 +412,30 @@ public:
 	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
 
+	/** Iterators to all events, in list order, so that eval and search
+	 * can binary-search instead of walking the list.
+	 *
+	 * Adding, removing or modifying a single point updates the index in
+	 * place. Other edits invalidate it with mark_dirty(), and it is
+	 * rebuilt by the next eval(). It is not used while invalid, and never
+	 * built by realtime readers.
+	 */
+	struct EvalIndex {
+		EvalIndex () : valid (false) {}
+		std::vector<const_iterator> iter;
+		std::atomic<bool>           valid;
+		Glib::Threads::Mutex        build_lock;
+	};
+
+	mutable EvalIndex     _eval_index;
+
+	void   build_eval_index_if_necessary () const;
+	size_t unlocked_eval_index_position (const_iterator) const;
+	void   mark_lookups_dirty () const;
+
+	iterator unlocked_insert (iterator, ControlEvent*);
+	iterator unlocked_erase (iterator);
+
 	mutable Glib::Threads::RWLock _lock;
 
 	Parameter             _parameter;
@@ -414,6 +454,11 @@ public:
 	bool       new_write_pass;
 	bool       did_write_during_pass;
 	bool       _in_write_pass;
+	double     _write_pass_thinning_factor;
+	int        _write_pass_run;
+
+	double thinning_area (ControlEvent const*, ControlEvent const*, ControlEvent const*) const;
+	void   unlocked_thin_write_pass (Temporal::timepos_t const &);
 
 	void unlocked_remove_duplicates ();
 	void unlocked_invalidate_insert_iterator ();
@@ -64,7 +64,9 @@ public:
 	virtual ~SMF();
 
 	static bool test(const std::string& path);
-	int open (const std::string& path, int track = 1, bool scan = true);
+	int open (const std::string& path, int track = 1, bool scan = true, bool deferred = false);
+	/** @return true if the file was opened deferred, and has not been parsed yet */
+	bool deferred () const;
 	// XXX 19200 = 10 * Temporal::ticks_per_beat
 	int  create(const std::string& path, int track=1, uint16_t ppqn=19200);
 	void close();
@@ -137,15 +139,31 @@ public:
 	void load_markers ();
 
   private:
-	smf_t*       _smf;
-	smf_track_t* _smf_track;
-	bool         _empty; ///< true iff file contains(non-empty) events
+	mutable smf_t*       _smf;
+	mutable smf_track_t* _smf_track;
+	bool                 _empty; ///< true iff file contains(non-empty) events
 
 	mutable Glib::Threads::Mutex _smf_lock;
 
+	/* file opened, but not yet loaded by libsmf */
+	mutable bool _deferred;
+	std::string  _deferred_path;
+	int          _deferred_track;
+	int          _deferred_format;
+	uint16_t     _deferred_ppqn;
+	uint16_t     _deferred_num_tracks;
+
+	bool load_deferred_unlocked () const;
+	void clear_deferred ();
+
 	mutable Markers _markers;
 
   protected:
+	/** @return the file to parse, after it was opened deferred.
+	 * Derived classes that move the file should return its current path.
+	 */
+	virtual std::string deferred_path () const { return _deferred_path; }
+
 	uint64_t     _n_note_on_events;
 	bool         _has_pgm_change;
 	int          _num_channels;
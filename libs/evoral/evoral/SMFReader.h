@@ -19,70 +19,88 @@
 #ifndef EVORAL_SMF_READER_HPP
 #define EVORAL_SMF_READER_HPP
 
-#include <exception>
-#include <stdexcept>
 #include <string>
-#include <inttypes.h>
+#include <vector>
+#include <stdint.h>
 
 #include "evoral/visibility.h"
+#include "evoral/types.h"
 
 namespace Evoral {
 
-
-/** Standard MIDI File (Type 0) Reader
+/** Streaming Standard MIDI File reader.
+ *
+ * Unlike SMF, which uses libsmf to parse a complete file into one
+ * heap-allocated event per message, this reads the file into a single
+ * buffer and decodes the events of a track in place, one at a time.
+ *
+ * Events are returned in the same form as SMF::read_event() returns them,
+ * so that both can be used interchangeably to build a model.
  *
  * Currently this only reads SMF files with tempo-based timing.
  */
 class LIBEVORAL_API SMFReader {
 public:
-	class PrematureEOF : public std::exception {
-		const char* what() const throw() { return "Unexpected end of file"; }
-	};
-	class CorruptFile : public std::exception {
-		const char* what() const throw() { return "Corrupted file"; }
+	SMFReader ();
+	~SMFReader ();
+
+	/** Read the file and locate its tracks.
+	 *
+	 * With \a header_only, only the file header and the track chunk
+	 * headers are read: the file's format, ppqn and tracks are known, but
+	 * no events can be read.
+	 *
+	 * @return true on success
+	 */
+	bool open (std::string const & path, bool header_only = false);
+	void close ();
+
+	uint16_t type ()       const { return _type; }
+	uint16_t ppqn ()       const { return _ppqn; }
+	uint16_t num_tracks () const { return (uint16_t) _tracks.size (); }
+
+	/** @return true if the given track (1-based) does not contain any event */
+	bool track_is_empty (unsigned track) const;
+
+	/** Seek to the start of the given track (1-based).
+	 * @return true if the track exists and its events were read
+	 */
+	bool seek_to_track (unsigned track);
+
+	/** Decode the next event of the current track.
+	 *
+	 * @param buf set to point to the event data, which remains valid until
+	 * the next call.
+	 *
+	 * \return event length (including status byte) on success, 0 if event was
+	 * a meta event, or -1 at the end of the track (or on error).
+	 *
+	 * @see SMF::read_event
+	 */
+	int read_event (uint32_t* delta_t, uint32_t* size, uint8_t const** buf, event_id_t* note_id);
+
+private:
+	struct Track {
+		Track (size_t o, size_t s) : offset (o), size (s) {}
+		size_t offset;
+		size_t size;
 	};
-	class UnsupportedTime : public std::exception {
-		const char* what() const throw() { return "Unsupported time stamp type (SMPTE)"; }
-	};
-
-	SMFReader(const std::string& filename="");
-	~SMFReader();
-
-	bool open(const std::string& filename) throw (std::logic_error, UnsupportedTime);
 
-	bool seek_to_track(unsigned track) throw (std::logic_error);
+	std::vector<uint8_t> _data;
+	std::vector<Track>   _tracks;
+	uint16_t             _type;
+	uint16_t             _ppqn;
 
-	const std::string& filename() const { return _filename; };
+	size_t  _pos;
+	size_t  _end;
+	uint8_t _running_status;
 
-	uint16_t type()       const { return _type; }
-	uint16_t ppqn()       const { return _ppqn; }
-	uint16_t num_tracks() const { return _num_tracks; }
+	uint8_t              _msg[3];
+	std::vector<uint8_t> _sysex;
 
-	int read_event(size_t    buf_len,
-	               uint8_t*  buf,
-	               uint32_t* ev_size,
-	               uint32_t* ev_delta_time)
-		throw (std::logic_error, PrematureEOF, CorruptFile);
-
-	void close();
-
-	static uint32_t read_var_len(FILE* fd) throw (PrematureEOF);
-
-protected:
-	/** size of SMF header, including MTrk chunk header */
-	static const uint32_t HEADER_SIZE = 22;
-
-	std::string _filename;
-	FILE*       _fd;
-	uint16_t    _type;
-	uint16_t    _ppqn;
-	uint16_t    _num_tracks;
-	uint32_t    _track;
-	uint32_t    _track_size;
+	bool read_vlq (uint32_t&);
 };
 
-
 } // namespace Evoral
 
 #endif // EVORAL_SMF_READER_HPP
-
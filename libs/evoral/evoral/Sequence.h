@@ -45,6 +45,7 @@ class TypeMap;
 template<typename Time> class EventSink;
 template<typename Time> class Note;
 template<typename Time> class Event;
+class NoteSlabs;
 
 /** An iterator over (the x axis of) a 2-d double coordinate space.
  */
@@ -332,6 +333,12 @@ protected:
 	inline       Pitches& pitches(uint8_t chan)       { return _pitches[chan&0xf]; }
 	inline const Pitches& pitches(uint8_t chan) const { return _pitches[chan&0xf]; }
 
+	/** @return a note with the given time and pitch to search _notes or
+	 * _pitches with. It is re-used (per thread), since creating a note for
+	 * every lookup is comparatively expensive.
+	 */
+	static NotePtr const & search_note (Time const & t, uint8_t note);
+
 	virtual void control_list_marked_dirty ();
 
 private:
@@ -349,6 +356,9 @@ private:
 	void get_notes_by_pitch (Notes&, NoteOperator, uint8_t val, int chan_mask = 0) const;
 	void get_notes_by_velocity (Notes&, NoteOperator, uint8_t val, int chan_mask = 0) const;
 
+	NotePtr new_note (uint8_t chan, Time time, Time length, uint8_t note, uint8_t vel);
+	NotePtr new_note (Note<Time> const&);
+
 	const TypeMap& _type_map;
 
 	Notes        _notes;       // notes indexed by time
@@ -359,6 +369,12 @@ private:
 	typedef std::multiset<NotePtr, EarlierNoteComparator> WriteNotes;
 	WriteNotes _write_notes[16];
 
+	/** Storage of the notes that this sequence creates (when reading or
+	 * copying), contiguous in the order they were created. It lives as
+	 * long as any of these notes.
+	 */
+	std::shared_ptr<NoteSlabs> _note_slabs;
+
 	/** Current bank number on each channel so that we know what
 	 *  to put in PatchChange events when program changes are
 	 *  seen.
@@ -1,6 +1,7 @@
 #include "CurveTest.h"
 #include "evoral/ControlList.h"
 #include "evoral/Curve.h"
+#include <math.h>
 #include <stdlib.h>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (CurveTest);
@@ -523,3 +524,148 @@ CurveTest::constrainedCubic ()
 		CPPUNIT_ASSERT_DOUBLES_EQUAL(v, g[x], 0.000008);
 	}
 }
+
+void
+CurveTest::ctrlListIndexedEval ()
+{
+	std::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+
+	for (int i = 0; i < 2000; ++i) {
+		cl->fast_simple_add (timepos_t (i * 10), (i % 7) * 0.125);
+	}
+
+	static const int n_eval = 4000;
+	double linear[n_eval];
+	double discrete[n_eval];
+
+	/* unlocked_eval() does not build the eval index, this walks the list */
+
+	cl->set_interpolation (ControlList::Linear);
+	for (int i = 0; i < n_eval; ++i) {
+		linear[i] = cl->unlocked_eval (timepos_t (i * 5 + 3));
+	}
+
+	cl->set_interpolation (ControlList::Discrete);
+	for (int i = 0; i < n_eval; ++i) {
+		discrete[i] = cl->unlocked_eval (timepos_t (i * 5 + 3));
+	}
+
+	/* eval() builds the index */
+
+	cl->set_interpolation (ControlList::Linear);
+	for (int i = 0; i < n_eval; ++i) {
+		CPPUNIT_ASSERT_EQUAL (linear[i], cl->eval (timepos_t (i * 5 + 3)));
+	}
+
+	/* evaluate backwards as well, to exercise lookup cache misses */
+	for (int i = n_eval - 1; i >= 0; --i) {
+		CPPUNIT_ASSERT_EQUAL (linear[i], cl->eval (timepos_t (i * 5 + 3)));
+	}
+
+	cl->set_interpolation (ControlList::Discrete);
+	for (int i = 0; i < n_eval; ++i) {
+		CPPUNIT_ASSERT_EQUAL (discrete[i], cl->eval (timepos_t (i * 5 + 3)));
+	}
+
+	/* events exactly on control points, and the search cache */
+
+	timepos_t x;
+	double y;
+
+	for (int i = 0; i < 1999; ++i) {
+		CPPUNIT_ASSERT_EQUAL ((i % 7) * 0.125, cl->eval (timepos_t (i * 10)));
+		CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (timepos_t (i * 10 + 1), x, y, true));
+		CPPUNIT_ASSERT (x == timepos_t ((i + 1) * 10));
+	}
+
+	/* single point edits update the index in place, compare the
+	 * result with walking the list after every edit
+	 */
+
+	cl->set_interpolation (ControlList::Linear);
+
+	for (int e = 0; e < 60; ++e) {
+		/* build the index */
+		cl->eval (timepos_t (0));
+
+		switch (e % 4) {
+		case 0:
+			/* add between two points */
+			cl->editor_add (timepos_t (e * 311 + 5), 0.5, false);
+			break;
+		case 1:
+			/* erase a point */
+			{
+				ControlList::iterator i = cl->begin ();
+				std::advance (i, 100 + e * 13);
+				cl->erase (i);
+			}
+			break;
+		case 2:
+			/* modify a point, keeping its position in the list */
+			{
+				ControlList::iterator i = cl->begin ();
+				std::advance (i, 50 + e * 17);
+				cl->modify (i, (*i)->when + timecnt_t (1), 0.25);
+			}
+			break;
+		case 3:
+			/* modify a point, moving it past its neighbours */
+			{
+				ControlList::iterator i = cl->begin ();
+				std::advance (i, 70 + e * 19);
+				cl->modify (i, (*i)->when + timecnt_t (25), 0.75);
+			}
+			break;
+		}
+
+		for (int i = 0; i < n_eval; i += 7) {
+			linear[i] = cl->unlocked_eval (timepos_t (i * 5 + 3));
+		}
+
+		cl->mark_dirty ();
+
+		for (int i = 0; i < n_eval; i += 7) {
+			CPPUNIT_ASSERT_EQUAL (cl->unlocked_eval (timepos_t (i * 5 + 3)), linear[i]);
+		}
+	}
+}
+
+void
+CurveTest::ctrlListWriteThin ()
+{
+	std::shared_ptr<Evoral::ControlList> ref = TestCtrlList();
+	std::shared_ptr<Evoral::ControlList> cl  = TestCtrlList();
+
+	const double thinning_factor = 20.0;
+
+	/* record a pass, thin it when finished */
+	ref->set_in_write_pass (true);
+	ref->start_write_pass (timepos_t (0));
+
+	/* record the same pass, thinning while writing */
+	cl->set_in_write_pass (true);
+	cl->start_write_pass (timepos_t (0), thinning_factor);
+
+	for (int i = 0; i < 5000; ++i) {
+		/* a few slow sweeps and a few fast ones */
+		const double v = 0.5 + 0.4 * sin (i * ((i / 500) % 2 ? 0.05 : 0.003));
+		ref->add (timepos_t (i * 256), v, false, true);
+		cl->add (timepos_t (i * 256), v, false, true);
+	}
+
+	/* most points should be gone well before the pass ends */
+	CPPUNIT_ASSERT (cl->size () < 5000 / 2);
+
+	ref->write_pass_finished (timepos_t (5000 * 256), thinning_factor);
+	cl->write_pass_finished (timepos_t (5000 * 256), thinning_factor);
+
+	CPPUNIT_ASSERT (ref->size () < 5000);
+	CPPUNIT_ASSERT_EQUAL (ref->size (), cl->size ());
+
+	ControlList::const_iterator r = ref->begin ();
+	for (ControlList::const_iterator i = cl->begin (); i != cl->end (); ++i, ++r) {
+		CPPUNIT_ASSERT ((*i)->when == (*r)->when);
+		CPPUNIT_ASSERT_EQUAL ((*r)->value, (*i)->value);
+	}
+}
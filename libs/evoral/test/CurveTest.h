@@ -15,6 +15,8 @@ class CurveTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (threePointDiscete);
 	CPPUNIT_TEST (constrainedCubic);
 	CPPUNIT_TEST (ctrlListEval);
+	CPPUNIT_TEST (ctrlListIndexedEval);
+	CPPUNIT_TEST (ctrlListWriteThin);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -25,6 +27,8 @@ public:
 	void threePointDiscete ();
 	void constrainedCubic ();
 	void ctrlListEval ();
+	void ctrlListIndexedEval ();
+	void ctrlListWriteThin ();
 
 private:
 	std::shared_ptr<Evoral::ControlList> TestCtrlList() {
@@ -13,8 +13,17 @@ void
 NoteTest::copyTest ()
 {
 	Note<Time> a(0, Time::from_double(1.0), Time::from_double(2.0), 60, 0x40);
+	a.set_id(42);
 	Note<Time> b(a);
 	CPPUNIT_ASSERT (a == b);
+	CPPUNIT_ASSERT_EQUAL (42, b.id());
+
+	// Copies do not share event buffers
+	b.set_note(61);
+	b.set_velocity(0x50);
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 60, a.note());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 0x40, a.velocity());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 61, b.off_event().note());
 
 	// Broken due to event double free!
 	// Note<Time> c(1, Beats(3.0), Beats(4.0), 61, 0x41);
@@ -116,3 +116,105 @@ SMFTest::writeTest ()
 
 	// TODO: Check files are actually equivalent
 }
+
+void
+SMFTest::readerTest ()
+{
+	string testdata_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TakeFive.mid", testdata_path));
+
+	/* write a copy with note IDs */
+	TestSMF smf;
+	smf.open(testdata_path);
+
+	TestSMF out;
+	const string output_dir_path = PBD::tmp_writable_directory (PACKAGE, "readerTest");
+	const string new_file_path   = Glib::build_filename (output_dir_path, "TakeFiveIDs.mid");
+	CPPUNIT_ASSERT_EQUAL (0, out.create(new_file_path, 1, 1920));
+	out.begin_write();
+
+	uint32_t delta_t = 0;
+	uint32_t size    = 0;
+	uint8_t* buf     = NULL;
+	event_id_t id    = 0;
+	while (smf.read_event(&delta_t, &size, &buf) >= 0) {
+		out.append_event_delta(delta_t, size, buf, ++id);
+	}
+	out.end_write(new_file_path);
+	out.close();
+
+	const string paths[] = { testdata_path, new_file_path };
+
+	for (int n = 0; n < 2; ++n) {
+		TestSMF ref;
+		CPPUNIT_ASSERT_EQUAL (0, ref.open (paths[n]));
+
+		/* deferred open only reads the header */
+		TestSMF deferred;
+		CPPUNIT_ASSERT_EQUAL (0, deferred.open (paths[n], true));
+		CPPUNIT_ASSERT (deferred.deferred ());
+		CPPUNIT_ASSERT_EQUAL (ref.ppqn (), deferred.ppqn ());
+		CPPUNIT_ASSERT_EQUAL (ref.num_tracks (), deferred.num_tracks ());
+		CPPUNIT_ASSERT_EQUAL (ref.is_empty (), deferred.is_empty ());
+
+		/* which is what a header-only reader finds */
+		SMFReader header;
+		CPPUNIT_ASSERT (header.open (paths[n], true));
+		CPPUNIT_ASSERT_EQUAL (ref.ppqn (), header.ppqn ());
+		CPPUNIT_ASSERT_EQUAL (ref.num_tracks (), header.num_tracks ());
+		CPPUNIT_ASSERT_EQUAL (ref.is_empty (), header.track_is_empty (1));
+		CPPUNIT_ASSERT (!header.seek_to_track (1));
+
+		SMFReader reader;
+		CPPUNIT_ASSERT (reader.open (paths[n]));
+		CPPUNIT_ASSERT_EQUAL (ref.ppqn (), reader.ppqn ());
+		CPPUNIT_ASSERT_EQUAL (ref.num_tracks (), reader.num_tracks ());
+		CPPUNIT_ASSERT (reader.seek_to_track (1));
+
+		/* the reader must produce exactly what libsmf does */
+		size_t n_events = 0;
+		size_t n_ids    = 0;
+
+		while (true) {
+			uint32_t       ref_delta_t;
+			uint32_t       rdr_delta_t;
+			uint32_t       rdr_size;
+			uint8_t const* rdr_buf;
+			event_id_t     ref_id;
+			event_id_t     rdr_id;
+
+			const int ref_ret = static_cast<SMF&>(ref).read_event (&ref_delta_t, &size, &buf, &ref_id);
+			const int rdr_ret = reader.read_event (&rdr_delta_t, &rdr_size, &rdr_buf, &rdr_id);
+
+			CPPUNIT_ASSERT_EQUAL (ref_ret, rdr_ret);
+
+			if (ref_ret < 0) {
+				break;
+			}
+
+			CPPUNIT_ASSERT_EQUAL (ref_delta_t, rdr_delta_t);
+
+			if (ref_ret == 0) {
+				CPPUNIT_ASSERT_EQUAL (ref_id, rdr_id);
+				if (rdr_id >= 0) {
+					++n_ids;
+				}
+			} else {
+				CPPUNIT_ASSERT_EQUAL (size, rdr_size);
+				CPPUNIT_ASSERT (0 == memcmp (buf, rdr_buf, size));
+				++n_events;
+			}
+		}
+
+		CPPUNIT_ASSERT (n_events > 3833);
+		if (n == 1) {
+			CPPUNIT_ASSERT (n_ids > 0);
+		}
+
+		/* and the deferred SMF parses the file once it is used */
+		CPPUNIT_ASSERT (deferred.read_event (&delta_t, &size, &buf) >= 0);
+		CPPUNIT_ASSERT (!deferred.deferred ());
+	}
+
+	free (buf);
+}
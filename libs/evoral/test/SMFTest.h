@@ -26,6 +26,7 @@
 #include "temporal/beats.h"
 #include "temporal/tempo.h"
 #include "evoral/SMF.h"
+#include "evoral/SMFReader.h"
 #include "SequenceTest.h"
 
 using namespace Evoral;
@@ -34,9 +35,9 @@ class TestSMF : public SMF {
 public:
 	std::string path() const { return _path; }
 
-	int open(const std::string& path) {
+	int open(const std::string& path, bool deferred = false) {
 		_path = path;
-		return SMF::open(path);
+		return SMF::open(path, 1, !deferred, deferred);
 	}
 
 	void close() {
@@ -58,6 +59,7 @@ class SMFTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(createNewFileTest);
 	CPPUNIT_TEST(takeFiveTest);
 	CPPUNIT_TEST(writeTest);
+	CPPUNIT_TEST(readerTest);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -79,6 +81,7 @@ public:
 	void createNewFileTest();
 	void takeFiveTest();
 	void writeTest();
+	void readerTest();
 
 private:
 	DummyTypeMap*     type_map;
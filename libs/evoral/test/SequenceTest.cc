@@ -195,3 +195,125 @@ SequenceTest::controlInterpolationTest ()
 		last_value = i->second;
 	}
 }
+
+void
+SequenceTest::notesByPitchTest ()
+{
+	/* test_notes have pitches 64 .. 75 */
+	for (Notes::const_iterator i = test_notes.begin(); i != test_notes.end(); ++i) {
+		seq->add_note_unlocked (*i);
+	}
+
+	CPPUNIT_ASSERT_EQUAL (size_t (12), seq->notes().size());
+
+	MySequence<Time>::Notes n;
+
+	seq->get_notes (n, MySequence<Time>::PitchEqual, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), n.size());
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 70, (*n.begin())->note());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchLessThan, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t (6), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchLessThanOrEqual, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t (7), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchGreater, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t (5), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchGreaterThanOrEqual, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t (6), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchEqual, 70, 0x2);
+	CPPUNIT_ASSERT_EQUAL (size_t (0), n.size());
+
+	/* time lookup */
+	CPPUNIT_ASSERT ((*seq->note_lower_bound (Time::from_double (250)))->time() == Time::from_double (300));
+	CPPUNIT_ASSERT (seq->note_lower_bound (Time::from_double (1200)) == seq->notes().end());
+
+	/* remove via the pitch index */
+	seq->remove_note_unlocked (test_notes[6]);
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchEqual, 70);
+	CPPUNIT_ASSERT_EQUAL (size_t (0), n.size());
+	CPPUNIT_ASSERT_EQUAL (size_t (11), seq->notes().size());
+}
+
+void
+SequenceTest::notesByPitchDuplicatesTest ()
+{
+	/* Several notes of the same pitch, on two channels. Before, equal
+	 * pitches never terminated the loop, and "greater than" included
+	 * equal pitches, while "less than" started above the value.
+	 */
+	for (int i = 0; i < 4; ++i) {
+		seq->add_note_unlocked (std::shared_ptr<Note<Time> > (new Note<Time> (0, Time::from_double (i * 100), Time::from_double (50), 60 + (i % 2), 64)));
+		seq->add_note_unlocked (std::shared_ptr<Note<Time> > (new Note<Time> (1, Time::from_double (i * 100 + 10), Time::from_double (50), 60, 64)));
+	}
+
+	MySequence<Time>::Notes n;
+
+	seq->get_notes (n, MySequence<Time>::PitchEqual, 60);
+	CPPUNIT_ASSERT_EQUAL (size_t (6), n.size());
+	for (MySequence<Time>::Notes::const_iterator i = n.begin(); i != n.end(); ++i) {
+		CPPUNIT_ASSERT_EQUAL ((uint8_t) 60, (*i)->note());
+	}
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchEqual, 60, 0x1);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchLessThan, 61);
+	CPPUNIT_ASSERT_EQUAL (size_t (6), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchLessThan, 60);
+	CPPUNIT_ASSERT_EQUAL (size_t (0), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchGreater, 60);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), n.size());
+
+	n.clear ();
+	seq->get_notes (n, MySequence<Time>::PitchGreaterThanOrEqual, 60, 0x2);
+	CPPUNIT_ASSERT_EQUAL (size_t (4), n.size());
+}
+
+void
+SequenceTest::noteStorageTest ()
+{
+	/* notes that the sequence creates while reading outlive it */
+	MySequence<Time>::NotePtr note;
+	{
+		DummyTypeMap      map;
+		MySequence<Time>* s = new MySequence<Time> (map);
+
+		s->start_write ();
+		for (Notes::const_iterator i = test_notes.begin(); i != test_notes.end(); ++i) {
+			s->append ((*i)->on_event(), next_event_id ());
+			s->append ((*i)->off_event(), next_event_id ());
+		}
+		s->end_write (Sequence<Time>::Relax);
+
+		CPPUNIT_ASSERT_EQUAL (size_t (12), s->notes().size());
+		note = *s->notes().begin();
+
+		/* copies are separate notes */
+		MySequence<Time> c (*s);
+		CPPUNIT_ASSERT_EQUAL (size_t (12), c.notes().size());
+		CPPUNIT_ASSERT (*c.notes().begin() != note);
+		CPPUNIT_ASSERT (**c.notes().begin() == *note);
+
+		delete s;
+	}
+
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 64, note->note());
+	CPPUNIT_ASSERT (note->time() == Time::from_double (0));
+	CPPUNIT_ASSERT (note->length() == Time::from_double (100));
+}
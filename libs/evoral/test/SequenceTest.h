@@ -121,6 +121,9 @@ class SequenceTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (preserveEventOrderingTest);
 	CPPUNIT_TEST (iteratorSeekTest);
 	CPPUNIT_TEST (controlInterpolationTest);
+	CPPUNIT_TEST (notesByPitchTest);
+	CPPUNIT_TEST (notesByPitchDuplicatesTest);
+	CPPUNIT_TEST (noteStorageTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -151,6 +154,9 @@ public:
 	void preserveEventOrderingTest ();
 	void iteratorSeekTest ();
 	void controlInterpolationTest ();
+	void notesByPitchTest ();
+	void notesByPitchDuplicatesTest ();
+	void noteStorageTest ();
 
 private:
 	DummyTypeMap*       type_map;
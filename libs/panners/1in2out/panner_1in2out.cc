@@ -268,7 +268,7 @@ Panner1in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 
 	/* fetch positional data */
 
-	if (!_pannable->pan_azimuth_control->list ()->curve ().rt_safe_get_vector (timepos_t (start), timepos_t (end), position, nframes)) {
+	if (!_pannable->pan_azimuth_control->alist ()->rt_safe_get_vector (start, end, position, nframes)) {
 		/* fallback */
 		distribute_one (srcbuf, obufs, 1.0, nframes, which);
 		return;
@@ -305,9 +305,7 @@ Panner1in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 	dst  = obufs.get_audio (0).data ();
 	pbuf = buffers[0];
 
-	for (pframes_t n = 0; n < nframes; ++n) {
-		dst[n] += src[n] * pbuf[n];
-	}
+	mix_buffers_with_gain_vector (dst, src, pbuf, nframes);
 
 	/* XXX it would be nice to mark the buffer as written to */
 
@@ -316,9 +314,7 @@ Panner1in2out::distribute_one_automated (AudioBuffer& srcbuf, BufferSet& obufs,
 	dst  = obufs.get_audio (1).data ();
 	pbuf = buffers[1];
 
-	for (pframes_t n = 0; n < nframes; ++n) {
-		dst[n] += src[n] * pbuf[n];
-	}
+	mix_buffers_with_gain_vector (dst, src, pbuf, nframes);
 
 	/* XXX it would be nice to mark the buffer as written to */
 }
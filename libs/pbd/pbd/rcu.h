@@ -23,6 +23,7 @@
 #include <atomic>
 #include <mutex>
 #include <memory>
+#include <stdint.h>
 
 #include "boost/smart_ptr/detail/yield_k.hpp"
 
@@ -36,6 +37,49 @@
  * The design consists of two parts: an RCUManager and an RCUWriter.
 */
 
+/** RCUEpoch tracks quiescent states of registered threads, in order to allow
+ * SerializedRCUManager to reclaim old values without waiting for readers
+ * (see SerializedRCUManager::SerializedRCUManager).
+ *
+ * A registered thread is either online, or offline. While it is online, it must
+ * periodically call quiescent() at a point where it holds no reference obtained
+ * from RCUManager::reader(). It must also go offline before it blocks for
+ * a long time. Realtime threads typically go online at the start of each
+ * process cycle and offline at its end.
+ *
+ * A value that was retired at a given epoch can be reclaimed once every
+ * registered thread has been offline or passed a quiescent point since then.
+ * All methods except register_thread() are lock-free and realtime safe.
+ */
+class LIBPBD_API RCUEpoch
+{
+public:
+	/** Register the calling thread. This is done implicitly by the first call
+	 * to online(), but may allocate memory. Threads are unregistered when they
+	 * exit.
+	 */
+	static void register_thread ();
+
+	static void online ();
+	static void offline ();
+	static void quiescent ();
+
+	/** Start a new epoch after a value was replaced.
+	 * @return the epoch that needs to have passed before the old value can be reclaimed
+	 */
+	static uint64_t retire ();
+
+	/** @return true if every registered thread was offline or passed a quiescent point since @a epoch started */
+	static bool passed (uint64_t epoch);
+
+	/** Keeps the calling thread online during its lifetime */
+	class LIBPBD_API Online {
+	public:
+		Online () { RCUEpoch::online (); }
+		~Online () { RCUEpoch::offline (); }
+	};
+};
+
 /** An RCUManager is an object which takes over management of a pointer to another object.
  *
  * It provides three key methods:
@@ -132,6 +176,13 @@ private:
  * calls to write_copy() to ensure that we do not inadvertently leave objects
  * around for excessive periods of time.
  *
+ * Alternatively, SerializedRCUManager can use epoch based reclamation (see
+ * RCUEpoch). In this mode update() does not wait for readers, and old values
+ * are not kept in the "dead wood" list. They are released by the first call to
+ * write_copy(), update() or reclaim() after every registered thread has passed
+ * a quiescent point. Threads that may drop the last reference to an old value in
+ * a realtime context must be registered with RCUEpoch, other threads do not need to.
+ *
  * For extremely well defined circumstances (i.e. it is known that there are no
  * other writer objects in existence), SerializedRCUManager also provides a
  * flush() method that will unconditionally clear out the "dead wood" list. It
@@ -142,10 +193,18 @@ template <class T>
 class /*LIBPBD_API*/ SerializedRCUManager : public RCUManager<T>
 {
 public:
-	SerializedRCUManager(T* new_managed_object)
+	SerializedRCUManager(T* new_managed_object, bool epoch_reclamation = false)
 		: RCUManager<T>(new_managed_object)
 		, _current_write_old (0)
+		, _epoch_reclamation (epoch_reclamation)
+	{
+	}
+
+	~SerializedRCUManager ()
 	{
+		for (typename std::list<Retired>::iterator i = _retired.begin (); i != _retired.end (); ++i) {
+			delete i->value;
+		}
 	}
 
 	void init (std::shared_ptr<T> object_to_be_managed) {
@@ -169,6 +228,8 @@ public:
 			}
 		}
 
+		reclaim_unlocked ();
+
 		/* store the current so that we can do compare and exchange
 		 * when someone calls update(). Notice that we hold
 		 * a lock, so this store of managed_object is atomic.
@@ -207,7 +268,14 @@ public:
 
 		bool ret = RCUManager<T>::managed_object.compare_exchange_strong (_current_write_old, new_spp);
 
-		if (ret) {
+		if (ret && _epoch_reclamation) {
+			/* successful update. Do not wait for readers, the old
+			 * value is deleted once it is no longer in use.
+			 */
+			_retired.push_back (Retired (RCUEpoch::retire (), _current_write_old));
+			reclaim_unlocked ();
+
+		} else if (ret) {
 			/* successful update
 			 *
 			 * wait until there are no active readers. This ensures that any
@@ -266,16 +334,58 @@ public:
 		_lock.unlock ();
 	}
 
+	/** Delete old values that are no longer in use (when using epoch based
+	 * reclamation). This is done by every write, but can also be called
+	 * periodically.
+	 */
+	void reclaim ()
+	{
+		std::lock_guard<std::mutex> lm (_lock);
+		reclaim_unlocked ();
+	}
+
 	void flush ()
 	{
 		std::lock_guard<std::mutex> lm (_lock);
 		_dead_wood.clear ();
+
+		if (!_retired.empty ()) {
+			for (unsigned i = 0; RCUManager<T>::active_read (); ++i) {
+				boost::detail::yield (i);
+			}
+			for (typename std::list<Retired>::iterator i = _retired.begin (); i != _retired.end (); ++i) {
+				delete i->value;
+			}
+			_retired.clear ();
+		}
 	}
 
 private:
+	struct Retired {
+		Retired (uint64_t e, typename RCUManager<T>::PtrToSharedPtr v) : epoch (e), value (v) {}
+		uint64_t                               epoch;
+		typename RCUManager<T>::PtrToSharedPtr value;
+	};
+
+	void reclaim_unlocked ()
+	{
+		/* Readers that were copying an old value when it was replaced
+		 * are done if there is no active reader now.
+		 */
+		if (_retired.empty () || RCUManager<T>::active_read ()) {
+			return;
+		}
+		while (!_retired.empty () && RCUEpoch::passed (_retired.front ().epoch)) {
+			delete _retired.front ().value;
+			_retired.pop_front ();
+		}
+	}
+
 	std::mutex                             _lock;
 	typename RCUManager<T>::PtrToSharedPtr _current_write_old;
 	std::list<std::shared_ptr<T> >         _dead_wood;
+	bool                                   _epoch_reclamation;
+	std::list<Retired>                     _retired;
 };
 
 /** RCUWriter is a convenience object that implements write_copy/update via
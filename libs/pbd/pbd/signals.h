@@ -26,6 +26,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #ifdef nil
 #undef nil
@@ -41,6 +42,7 @@
 #include <boost/function.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/optional.hpp>
+#include <boost/smart_ptr/detail/yield_k.hpp>
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/event_loop.h"
@@ -63,6 +65,7 @@ class LIBPBD_API SignalBase
 public:
 	SignalBase ()
 	: _in_dtor (false)
+	, _active_reads (0)
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	, _debug_connection (false)
 #endif
@@ -76,6 +79,73 @@ public:
 protected:
 	mutable Glib::Threads::Mutex _mutex;
 	std::atomic<bool>            _in_dtor;
+
+	/* Number of emissions that are taking a reference to the
+	 * current list of slots, see SlotList.
+	 */
+	mutable std::atomic<int>     _active_reads;
+
+	/** Take a reference to the list of slots that @a p points to.
+	 * @return 0 if there are no slots
+	 */
+	template<typename L>
+	L const* read_slots (std::atomic<L*> const& p) const {
+		if (!p.load (std::memory_order_relaxed)) {
+			return 0;
+		}
+		_active_reads.fetch_add (1);
+		L const* l = p.load ();
+		if (l) {
+			l->ref ();
+		}
+		_active_reads.fetch_sub (1);
+		return l;
+	}
+
+	/** Make @a p point to the list @a l, and move the previous list to
+	 * @a retired. Must be called with _mutex held.
+	 *
+	 * An emission may still use the previous list, and may run in a
+	 * realtime thread, which must not free memory. So retired lists are
+	 * only freed here (or when the signal is destroyed), once no emission
+	 * uses them any more.
+	 */
+	template<typename L>
+	void replace_slots (std::atomic<L*>& p, L* l, L*& retired) {
+		L* old = p.exchange (l);
+		/* wait until every emission that may have loaded the old
+		 * pointer has taken its reference.
+		 */
+		for (unsigned i = 0; _active_reads.load () != 0; ++i) {
+			boost::detail::yield (i);
+		}
+		if (old) {
+			old->unref ();
+			old->set_next (retired);
+			retired = old;
+		}
+		free_slots (retired, false);
+	}
+
+	/** Free the lists in @a retired that are no longer used, or all of them
+	 * if @a all is true. Must be called with _mutex held.
+	 */
+	template<typename L>
+	static void free_slots (L*& retired, bool all) {
+		L* keep = 0;
+		while (retired) {
+			L* l = retired;
+			retired = l->next ();
+			if (all || l->unused ()) {
+				delete l;
+			} else {
+				l->set_next (keep);
+				keep = l;
+			}
+		}
+		retired = keep;
+	}
+
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	bool _debug_connection;
 #endif
@@ -109,6 +179,12 @@ public:
 		}
 	}
 
+	/** @return false once this connection was disconnected, or its signal was destroyed */
+	bool connected () const
+	{
+		return _signal.load (std::memory_order_acquire) != 0;
+	}
+
 	void disconnected ()
 	{
 		if (_invalidation_record) {
@@ -140,6 +216,77 @@ private:
 	PBD::EventLoop::InvalidationRecord* _invalidation_record;
 };
 
+/** An immutable, reference counted list of the slots of a signal.
+ *
+ * Connecting or disconnecting a slot replaces the signal's list with a modified
+ * copy (with the signal's mutex held). Emission only takes a reference to the
+ * current list, and does neither lock nor allocate nor free.
+ */
+template<typename F>
+class /*LIBPBD_API*/ SlotList
+{
+public:
+	typedef std::pair<std::shared_ptr<Connection>, F> Slot;
+	typedef typename std::vector<Slot>::const_iterator const_iterator;
+
+	SlotList () : _refs (1), _next (0) {}
+	SlotList (SlotList const& other) : _refs (1), _next (0), _slots (other._slots) {}
+
+	void ref () const {
+		_refs.fetch_add (1, std::memory_order_relaxed);
+	}
+
+	/** Drop a reference. This never frees the list, see SignalBase::replace_slots */
+	void unref () const {
+		_refs.fetch_sub (1, std::memory_order_release);
+	}
+
+	bool unused () const {
+		return _refs.load (std::memory_order_acquire) == 0;
+	}
+
+	SlotList* next () const { return _next; }
+	void set_next (SlotList* l) { _next = l; }
+
+	const_iterator begin () const { return _slots.begin (); }
+	const_iterator end () const { return _slots.end (); }
+	size_t size () const { return _slots.size (); }
+
+	void add (std::shared_ptr<Connection> const& c, F const& f) {
+		_slots.push_back (Slot (c, f));
+	}
+
+	void remove (std::shared_ptr<Connection> const& c) {
+		for (typename std::vector<Slot>::iterator i = _slots.begin (); i != _slots.end (); ++i) {
+			if (i->first == c) {
+				_slots.erase (i);
+				break;
+			}
+		}
+	}
+
+	/** Holds a reference to a list until it goes out of scope */
+	class Reader : public boost::noncopyable
+	{
+	public:
+		Reader (SlotList const* l) : _list (l) {}
+		~Reader () {
+			if (_list) {
+				_list->unref ();
+			}
+		}
+		SlotList const* get () const { return _list; }
+
+	private:
+		SlotList const* _list;
+	};
+
+private:
+	mutable std::atomic<int> _refs;
+	SlotList*                _next;
+	std::vector<Slot>        _slots;
+};
+
 template<typename R>
 class /*LIBPBD_API*/ OptionalLastValue
 {
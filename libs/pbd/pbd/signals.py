@@ -101,22 +101,35 @@ def signal(f, n, v):
     print("private:", file=f)
 
     print("""
-\t/** The slots that this signal will call on emission */
-\ttypedef std::map<std::shared_ptr<Connection>, slot_function_type> Slots;
-\tSlots _slots;
+\t/** The slots that this signal will call on emission, in the order
+\t *  that they were connected, or 0 if there are none.
+\t */
+\ttypedef SlotList<slot_function_type> Slots;
+\tstd::atomic<Slots*> _slots;
+
+\t/** Previous lists of slots, until no emission uses them any more */
+\tSlots* _retired;
 """, file=f)
 
     print("public:", file=f)
     print("", file=f)
+    print("\tSignal%d () : _slots (0), _retired (0) {}" % n, file=f)
+    print("", file=f)
     print("\t~Signal%d () {" % n, file=f)
 
     print("\t\t_in_dtor.store (true, std::memory_order_release);", file=f)
     print("\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = _slots.begin(); i != _slots.end(); ++i) {" % typename, file=f)
-
-    print("\t\t\ti->first->signal_going_away ();", file=f)
+    print("\t\tSlots* s = _slots.load ();", file=f)
+    print("\t\tif (s) {", file=f)
+    print("\t\t\ts->ref ();", file=f)
+    print("\t\t\treplace_slots (_slots, (Slots*) 0, _retired);", file=f)
+    print("\t\t\t/* Tell our connection objects that we are going away, so they don't try to call us */", file=f)
+    print("\t\t\tfor (%sSlots::const_iterator i = s->begin(); i != s->end(); ++i) {" % typename, file=f)
+    print("\t\t\t\ti->first->signal_going_away ();", file=f)
+    print("\t\t\t}", file=f)
+    print("\t\t\ts->unref ();", file=f)
     print("\t\t}", file=f)
+    print("\t\tfree_slots (_retired, true);", file=f)
     print("\t}", file=f)
     print("", file=f)
 
@@ -231,34 +244,30 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
+    print("""\t\t/* First, take a reference to our list of slots as it is now. This
+\t\t * neither locks nor allocates; the list itself is never modified,
+\t\t * (dis)connecting a slot replaces it.
+\t\t */""", file=f)
     print("", file=f)
-    print("\t\tSlots s;", file=f)
-    print("\t\t{", file=f)
-    print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
-    print("\t\t}", file=f)
+    print("\t\t%sSlots::Reader s (read_slots (_slots));" % typename, file=f)
     print("", file=f)
     if not v:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+        print("", file=f)
+    print("\t\tif (s.get ()) {", file=f)
+    print("\t\t\tfor (%sSlots::const_iterator i = s.get()->begin(); i != s.get()->end(); ++i) {" % typename, file=f)
     print("""
-\t\t\t/* We may have just called a slot, and this may have resulted in
-\t\t\t * disconnection of other slots from us.  The list copy means that
-\t\t\t * this won't cause any problems with invalidated iterators, but we
-\t\t\t * must check to see if the slot we are about to call is still on the list.
-\t\t\t */
-\t\t\tbool still_there = false;
-\t\t\t{
-\t\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);
-\t\t\t\tstill_there = _slots.find (i->first) != _slots.end ();
-\t\t\t}
-
-\t\t\tif (still_there) {""", file=f)
+\t\t\t\t/* We may have just called a slot, and this may have resulted in
+\t\t\t\t * disconnection of other slots from us. That replaces the list
+\t\t\t\t * rather than modifying the one we iterate over, but we must check
+\t\t\t\t * to see if the slot we are about to call is still connected.
+\t\t\t\t */
+\t\t\t\tif (i->first->connected ()) {""", file=f)
     if v:
-        print("\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
+        print("\t\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
     else:
-        print("\t\t\t\tr.push_back ((i->second)(%s));" % comma_separated(an), file=f)
+        print("\t\t\t\t\tr.push_back ((i->second)(%s));" % comma_separated(an), file=f)
+    print("\t\t\t\t}", file=f)
     print("\t\t\t}", file=f)
     print("\t\t}", file=f)
     print("", file=f)
@@ -271,13 +280,14 @@ def signal(f, n, v):
     print("""
 \tbool empty () const {
 \t\tGlib::Threads::Mutex::Lock lm (_mutex);
-\t\treturn _slots.empty ();
+\t\treturn !_slots.load ();
 \t}
 """, file=f)
     print("""
 \tsize_t size () const {
 \t\tGlib::Threads::Mutex::Lock lm (_mutex);
-\t\treturn _slots.size ();
+\t\tSlots const* s = _slots.load ();
+\t\treturn s ? s->size () : 0;
 \t}
 """, file=f)
 
@@ -295,10 +305,13 @@ def signal(f, n, v):
 \t{
 \t\tstd::shared_ptr<Connection> c (new Connection (this, ir));
 \t\tGlib::Threads::Mutex::Lock lm (_mutex);
-\t\t_slots[c] = f;
+\t\tSlots* old = _slots.load ();
+\t\tSlots* s = old ? new Slots (*old) : new Slots;
+\t\ts->add (c, f);
+\t\treplace_slots (_slots, s, _retired);
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 \t\tif (_debug_connection) {
-\t\t\tstd::cerr << "+++++++ CONNECT " << this << " size now " << _slots.size() << std::endl;
+\t\t\tstd::cerr << "+++++++ CONNECT " << this << " size now " << s->size() << std::endl;
 \t\t\tPBD::stacktrace (std::cerr, 10);
 \t\t}
 #endif
@@ -318,13 +331,22 @@ def signal(f, n, v):
 \t\t\t/* Spin */
 \t\t\tlm.try_acquire ();
 \t\t}
-\t\t_slots.erase (c);
+\t\tSlots* old = _slots.load ();
+\t\tSlots* s = 0;
+\t\tif (old && old->size () > 1) {
+\t\t\ts = new Slots (*old);
+\t\t\ts->remove (c);
+\t\t}
+\t\treplace_slots (_slots, s, _retired);
+#ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
+\t\tsize_t const size = s ? s->size () : 0;
+#endif
 \t\tlm.release ();
 
 \t\tc->disconnected ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 \t\tif (_debug_connection) {
-\t\t\tstd::cerr << "------- DISCCONNECT " << this << " size now " << _slots.size() << std::endl;
+\t\t\tstd::cerr << "------- DISCCONNECT " << this << " size now " << size << std::endl;
 \t\t\tPBD::stacktrace (std::cerr, 10);
 \t\t}
 #endif
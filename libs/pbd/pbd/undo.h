@@ -27,6 +27,8 @@
 #include <map>
 #include <string>
 
+#include <boost/function.hpp>
+
 #include <sigc++/bind.h>
 #include <sigc++/slot.h>
 
@@ -39,6 +41,8 @@
 #include "pbd/command.h"
 #include "pbd/libpbd_visibility.h"
 
+class XMLWriter;
+
 namespace PBD {
 
 typedef sigc::slot<void> UndoAction;
@@ -98,7 +102,7 @@ public:
 
 	unsigned long undo_depth () const
 	{
-		return UndoList.size ();
+		return UndoList.size () + _spilled.size ();
 	}
 	unsigned long redo_depth () const
 	{
@@ -107,7 +111,10 @@ public:
 
 	std::string next_undo () const
 	{
-		return (UndoList.empty () ? std::string () : UndoList.back ()->name ());
+		if (UndoList.empty ()) {
+			return (_spilled.empty () ? std::string () : _spilled.back ().name);
+		}
+		return UndoList.back ()->name ();
 	}
 	std::string next_redo () const
 	{
@@ -129,8 +136,25 @@ public:
 	XMLNode& get_state (int32_t depth = 0);
 	void     save_state ();
 
+	/* like get_state(), but writes each transaction as soon
+	 * as its state was created, without building the complete
+	 * history in memory.
+	 */
+	void write_state (XMLWriter&, int32_t depth);
+
 	void set_depth (uint32_t);
 
+	typedef boost::function<UndoTransaction* (XMLNode const&)> TransactionFactory;
+
+	/* Transactions beyond the spill depth are removed from memory, and
+	 * their state is appended to a log file at @p path. When they are
+	 * undone, @p factory re-creates them from their state.
+	 *
+	 * This can be called again to change @p path after the file was moved.
+	 */
+	void set_spill (std::string const& path, TransactionFactory factory);
+	void set_spill_depth (uint32_t);
+
 	PBD::Signal0<void> Changed;
 	PBD::Signal0<void> BeginUndoRedo;
 	PBD::Signal0<void> EndUndoRedo;
@@ -141,7 +165,27 @@ private:
 	std::list<UndoTransaction*> UndoList;
 	std::list<UndoTransaction*> RedoList;
 
+	struct SpilledTransaction {
+		SpilledTransaction (std::string const& n, int64_t o, size_t s) : name (n), offset (o), size (s) {}
+		std::string name;
+		int64_t     offset;
+		size_t      size;
+	};
+
+	/* transactions older than those in UndoList, oldest first */
+	std::list<SpilledTransaction> _spilled;
+	std::string                   _spill_path;
+	uint32_t                      _spill_depth;
+	int64_t                       _spill_end;
+	TransactionFactory            _spill_factory;
+
 	void remove (UndoTransaction*);
+	void trim (uint32_t depth);
+	bool spill ();
+	bool unspill ();
+	void compact_spilled ();
+	void clear_spilled ();
+	XMLNode* spilled_state (SpilledTransaction const&) const;
 };
 
 } /* namespace */
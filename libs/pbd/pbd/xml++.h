@@ -36,10 +36,13 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <stdint.h>
 #include <vector>
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
 
 #include <glibmm/ustring.h>
 
@@ -100,11 +103,40 @@ public:
 
 	const std::string& write_buffer() const;
 
+	/** Write the tree to @p fn in a compact binary encoding, which can be
+	 * loaded much faster than XML.
+	 *
+	 * @param tag stored with the data and checked by read_binary(),
+	 * usually the hash of the XML file the tree was saved to.
+	 */
+	bool write_binary (const std::string& fn, uint64_t tag) const;
+
+	/** Replace the tree with one written by write_binary().
+	 *
+	 * This does not change the filename, nor provide a document for find().
+	 * @return false if @p fn cannot be read, or was written with a
+	 * different @p tag or format version.
+	 */
+	bool read_binary (const std::string& fn, uint64_t tag);
+
+	/** Encode @p node and its subtree in the binary format of write_binary() */
+	static void encode_binary (XMLNode const& node, uint64_t tag, std::string& buf);
+
+	/** Decode a node encoded with encode_binary(). The caller owns the returned node.
+	 * @return 0 if @p data is invalid, or was encoded with a different @p tag
+	 */
+	static XMLNode* decode_binary (uint8_t const* data, size_t len, uint64_t tag);
+
+	/** Compute a 64 bit (FNV-1a) hash of the contents of the file @p fn */
+	static bool file_hash (const std::string& fn, uint64_t& hash);
+
 	std::shared_ptr<XMLSharedNodeList> find(const std::string xpath, XMLNode* = 0) const;
 
 private:
 	bool read_internal(bool validate);
 
+	static XMLNode* read_binary_node (uint8_t const*&, uint8_t const*, std::vector<std::string> const&, uint32_t depth);
+
 	std::string _filename;
 	XMLNode*    _root;
 	xmlDocPtr   _doc;
@@ -204,9 +236,127 @@ private:
 	XMLPropertyList     _proplist;
 	mutable XMLNodeList _selected_children;
 
+	friend class XMLTree;
+
 	void clear_lists ();
 };
 
+/** Pull reader for XML files.
+ *
+ * Unlike XMLTree, which parses the complete document into a tree of
+ * XMLNodes, this reads a file one node at a time. Subtrees of interest can
+ * be turned into XMLNodes one at a time using read_node(), so only one of
+ * them needs to be in memory at once.
+ */
+class LIBPBD_API XMLReader {
+public:
+	enum NodeType {
+		Element,
+		EndElement,
+		Text,
+		Other
+	};
+
+	XMLReader ();
+	~XMLReader ();
+
+	bool open (const std::string& fn);
+	void close ();
+
+	/** Advance to the next node, in document order.
+	 * @return false at the end of the document, or on error
+	 */
+	bool read ();
+
+	/** Advance to the next sibling of the current node, skipping its subtree.
+	 * @return false at the end of the document, or on error
+	 */
+	bool skip ();
+
+	/** Return the current element and its subtree, and advance to its next sibling.
+	 * The caller owns the returned node.
+	 * @return 0 if the current node is not an element, or on error
+	 */
+	XMLNode* read_node ();
+
+	bool        at_end () const { return _at_end; }
+	bool        failed () const { return _failed; }
+	NodeType    type () const;
+	std::string name () const;
+	/** @return depth of the current node; the root element is at depth 0 */
+	int         depth () const;
+	/** @return true if the current element has no children (<Foo/>) */
+	bool        is_empty_element () const;
+
+	bool get_property (const char* name, std::string& value) const;
+
+	template <class T>
+	bool get_property (const char* name, T& value) const
+	{
+		std::string str;
+		if (!get_property (name, str)) {
+			return false;
+		}
+		return PBD::string_to<T> (str, value);
+	}
+
+private:
+	xmlTextReaderPtr _reader;
+	bool             _at_end;
+	bool             _failed;
+
+	bool advance (int);
+};
+
+/** Streaming writer for XML files.
+ *
+ * Elements are written to the file as they are added, rather than
+ * building a tree of the complete document first as XMLTree::write() does.
+ * The output is formatted in the same way.
+ */
+class LIBPBD_API XMLWriter {
+public:
+	XMLWriter ();
+	~XMLWriter ();
+
+	bool open (const std::string& fn, int compression = 0);
+	/** End all open elements and the document, and close the file.
+	 * @return false if any error occurred while writing
+	 */
+	bool close ();
+
+	bool start_element (const char* name);
+	bool end_element ();
+
+	bool set_property (const char* name, const std::string& value);
+
+	bool set_property (const char* name, const char* cstr) {
+		return set_property (name, std::string (cstr));
+	}
+
+	template <class T>
+	bool set_property (const char* name, const T& value)
+	{
+		std::string str;
+		if (!PBD::to_string<T> (value, str)) {
+			return false;
+		}
+		return set_property (name, str);
+	}
+
+	bool add_content (const std::string&);
+
+	/** Write @p node and its subtree as a child of the current element */
+	bool write_node (const XMLNode& node);
+
+private:
+	xmlTextWriterPtr _writer;
+	bool             _indent;
+	bool             _failed;
+
+	bool check (int);
+};
+
 class LIBPBD_API XMLException: public std::exception {
 public:
 	explicit XMLException(const std::string msg) : _message(msg) {}
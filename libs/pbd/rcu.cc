@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pbd/rcu.h"
+
+namespace {
+
+/* Process threads and their helpers */
+static const int max_registered_threads = 128;
+
+/* The value of a registered thread's epoch while it is offline */
+static const uint64_t offline_epoch = UINT64_MAX;
+
+struct RegisteredThread {
+	std::atomic<bool>     in_use;
+	std::atomic<uint64_t> epoch;
+};
+
+static RegisteredThread registered_threads[max_registered_threads];
+static std::atomic<uint64_t> current_epoch (1);
+
+/* Releases the calling thread's slot when the thread exits */
+struct Registration {
+	Registration () : slot (-1) {}
+
+	~Registration () {
+		if (slot >= 0) {
+			registered_threads[slot].epoch.store (offline_epoch);
+			registered_threads[slot].in_use.store (false);
+		}
+	}
+
+	int slot;
+};
+
+static thread_local Registration registration;
+
+}
+
+void
+RCUEpoch::register_thread ()
+{
+	if (registration.slot >= 0) {
+		return;
+	}
+
+	for (int i = 0; i < max_registered_threads; ++i) {
+		bool expected = false;
+		if (registered_threads[i].in_use.compare_exchange_strong (expected, true)) {
+			registered_threads[i].epoch.store (offline_epoch);
+			registration.slot = i;
+			return;
+		}
+	}
+
+	/* no free slot: the thread remains unregistered */
+}
+
+void
+RCUEpoch::online ()
+{
+	if (registration.slot < 0) {
+		register_thread ();
+		if (registration.slot < 0) {
+			return;
+		}
+	}
+
+	/* A value retired after this load is not yet in use by this thread,
+	 * one that was retired before remains until the next quiescent point.
+	 */
+	registered_threads[registration.slot].epoch.store (current_epoch.load ());
+}
+
+void
+RCUEpoch::offline ()
+{
+	if (registration.slot >= 0) {
+		registered_threads[registration.slot].epoch.store (offline_epoch);
+	}
+}
+
+void
+RCUEpoch::quiescent ()
+{
+	if (registration.slot >= 0 && registered_threads[registration.slot].epoch.load (std::memory_order_relaxed) != offline_epoch) {
+		registered_threads[registration.slot].epoch.store (current_epoch.load ());
+	}
+}
+
+uint64_t
+RCUEpoch::retire ()
+{
+	return current_epoch.fetch_add (1) + 1;
+}
+
+bool
+RCUEpoch::passed (uint64_t epoch)
+{
+	for (int i = 0; i < max_registered_threads; ++i) {
+		if (registered_threads[i].in_use.load () && registered_threads[i].epoch.load () < epoch) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -139,3 +139,46 @@ RCUTest::write_thread ()
 	}
 	_values.flush ();
 }
+
+/* ****************************************************************************/
+
+void
+RCUTest::epoch_reclamation ()
+{
+	SerializedRCUManager<Values> values (new Values, true);
+
+	RCUEpoch::online ();
+
+	{
+		RCUWriter<Values> writer (values);
+		writer.get_copy ()->insert (make_pair ("foo", new Value ("foo")));
+	}
+
+	std::weak_ptr<Values const> old = values.reader ();
+
+	{
+		RCUWriter<Values> writer (values);
+		writer.get_copy ()->insert (make_pair ("bar", new Value ("bar")));
+	}
+
+	/* this thread is online, and has not passed a quiescent point yet */
+	values.reclaim ();
+	CPPUNIT_ASSERT (!old.expired ());
+
+	RCUEpoch::quiescent ();
+	values.reclaim ();
+	CPPUNIT_ASSERT (old.expired ());
+
+	old = values.reader ();
+
+	{
+		RCUWriter<Values> writer (values);
+		writer.get_copy ()->clear ();
+	}
+
+	/* offline threads do not hold back reclamation */
+	RCUEpoch::offline ();
+	values.reclaim ();
+	CPPUNIT_ASSERT (old.expired ());
+	CPPUNIT_ASSERT (values.reader ()->empty ());
+}
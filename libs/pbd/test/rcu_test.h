@@ -9,12 +9,14 @@ class RCUTest : public CppUnit::TestFixture
 {
 	CPPUNIT_TEST_SUITE (RCUTest);
 	CPPUNIT_TEST (race);
+	CPPUNIT_TEST (epoch_reclamation);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
 	RCUTest ();
 	void setUp ();
 	void race ();
+	void epoch_reclamation ();
 
 	void read_thread ();
 	void write_thread ();
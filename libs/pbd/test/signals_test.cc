@@ -2,6 +2,7 @@
 
 #include "signals_test.h"
 #include "pbd/signals.h"
+#include "pbd/timing.h"
 
 using namespace std;
 
@@ -89,3 +90,97 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+static PBD::ScopedConnection victim;
+
+void
+disconnect_victim ()
+{
+	++N;
+	victim.disconnect ();
+}
+
+void
+SignalsTest::testDisconnectDuringEmission ()
+{
+	Emitter* e = new Emitter;
+	PBD::ScopedConnection c;
+	e->Fred.connect_same_thread (c, boost::bind (&disconnect_victim));
+	e->Fred.connect_same_thread (victim, boost::bind (&receiver));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, e->Fred.size ());
+
+	/* the second slot must not be called once the first one disconnected it */
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (1, N);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, e->Fred.size ());
+
+	c.disconnect ();
+	CPPUNIT_ASSERT (e->Fred.empty ());
+
+	N = 0;
+	e->emit ();
+	CPPUNIT_ASSERT_EQUAL (0, N);
+
+	delete e;
+}
+
+void
+SignalsTest::testManySlots ()
+{
+	const int n_slots[] = { 0, 1, 16 };
+	const int emissions = 1000;
+
+	for (size_t n = 0; n < sizeof (n_slots) / sizeof (n_slots[0]); ++n) {
+		Emitter e;
+		PBD::ScopedConnectionList connections;
+
+		for (int i = 0; i < n_slots[n]; ++i) {
+			e.Fred.connect_same_thread (connections, boost::bind (&receiver));
+		}
+		CPPUNIT_ASSERT_EQUAL ((size_t) n_slots[n], e.Fred.size ());
+
+		N = 0;
+		for (int i = 0; i < emissions; ++i) {
+			e.emit ();
+		}
+		CPPUNIT_ASSERT_EQUAL (n_slots[n] * emissions, N);
+
+		connections.drop_connections ();
+		CPPUNIT_ASSERT (e.Fred.empty ());
+	}
+}
+
+void
+SignalsTest::testPerfEmission ()
+{
+	const uint32_t n_slots[] = { 0, 1, 16 };
+	const uint32_t iterations = 10;
+	const uint32_t emissions = 100000;
+
+	std::cerr << std::endl;
+
+	for (size_t n = 0; n < sizeof (n_slots) / sizeof (n_slots[0]); ++n) {
+		Emitter e;
+		PBD::ScopedConnectionList connections;
+
+		for (uint32_t i = 0; i < n_slots[n]; ++i) {
+			e.Fred.connect_same_thread (connections, boost::bind (&receiver));
+		}
+
+		PBD::TimingData timing_data;
+		N = 0;
+
+		for (uint32_t iter = 0; iter < iterations; ++iter) {
+			timing_data.start_timing ();
+			for (uint32_t i = 0; i < emissions; ++i) {
+				e.emit ();
+			}
+			timing_data.add_elapsed ();
+		}
+
+		CPPUNIT_ASSERT_EQUAL ((int) (n_slots[n] * iterations * emissions), N);
+
+		std::cerr << "   " << emissions << " emissions, " << n_slots[n] << " slots : " << timing_data.summary ();
+	}
+}
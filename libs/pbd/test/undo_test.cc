@@ -0,0 +1,175 @@
+#include <algorithm>
+
+#include <glib/gstdio.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/undo.h"
+#include "pbd/xml++.h"
+
+#include "undo_test.h"
+#include "test_common.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (UndoTest);
+
+using namespace std;
+using namespace PBD;
+
+namespace {
+
+/** Set an integer from one value to another */
+class SetValueCommand : public Command
+{
+public:
+	SetValueCommand (int& v, int from, int to)
+		: _value (v)
+		, _from (from)
+		, _to (to)
+	{}
+
+	~SetValueCommand () { drop_references (); }
+
+	void operator() () { _value = _to; }
+	void undo () { _value = _from; }
+
+	XMLNode& get_state () const
+	{
+		XMLNode* node = new XMLNode ("SetValueCommand");
+		node->set_property ("from", _from);
+		node->set_property ("to", _to);
+		return *node;
+	}
+
+private:
+	int& _value;
+	int  _from;
+	int  _to;
+};
+
+int value = 0;
+
+UndoTransaction*
+transaction_from_state (XMLNode const& node)
+{
+	UndoTransaction* ut = new UndoTransaction ();
+	ut->set_name (node.property ("name")->value ());
+
+	for (XMLNodeConstIterator i = node.children ().begin (); i != node.children ().end (); ++i) {
+		int from, to;
+		if ((*i)->get_property ("from", from) && (*i)->get_property ("to", to)) {
+			ut->add_command (new SetValueCommand (value, from, to));
+		}
+	}
+	return ut;
+}
+
+}
+
+void
+UndoTest::testSpill ()
+{
+	const string spill_path = Glib::build_filename (test_output_directory ("testSpill"), "undo.spill");
+
+	UndoHistory history;
+	history.set_spill (spill_path, &transaction_from_state);
+	history.set_spill_depth (4);
+
+	value = 0;
+
+	for (int i = 1; i <= 20; ++i) {
+		UndoTransaction* ut = new UndoTransaction ();
+		ut->set_name (string_compose ("set %1", i));
+		ut->add_command (new SetValueCommand (value, value, i));
+		(*ut) ();
+		history.add (ut);
+	}
+
+	CPPUNIT_ASSERT_EQUAL (20, value);
+	CPPUNIT_ASSERT_EQUAL (20UL, history.undo_depth ());
+	CPPUNIT_ASSERT (Glib::file_test (spill_path, Glib::FILE_TEST_EXISTS));
+
+	/* the complete history includes spilled transactions */
+	XMLNode& state (history.get_state (-1));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 20, state.children ().size ());
+	CPPUNIT_ASSERT_EQUAL (string ("set 1"), state.children ().front ()->property ("name")->value ());
+	delete &state;
+
+	/* undo into the spilled part, and redo some of it */
+	history.undo (10);
+	CPPUNIT_ASSERT_EQUAL (10, value);
+	CPPUNIT_ASSERT_EQUAL (string ("set 10"), history.next_undo ());
+
+	history.redo (5);
+	CPPUNIT_ASSERT_EQUAL (15, value);
+
+	history.undo (15);
+	CPPUNIT_ASSERT_EQUAL (0, value);
+	CPPUNIT_ASSERT_EQUAL (0UL, history.undo_depth ());
+	CPPUNIT_ASSERT_EQUAL (20UL, history.redo_depth ());
+
+	/* the log is removed once nothing refers to it */
+	CPPUNIT_ASSERT (!Glib::file_test (spill_path, Glib::FILE_TEST_EXISTS));
+
+	/* the history limit also applies to spilled transactions */
+	history.redo (20);
+	history.set_depth (8);
+	CPPUNIT_ASSERT_EQUAL (8UL, history.undo_depth ());
+
+	history.undo (8);
+	CPPUNIT_ASSERT_EQUAL (12, value);
+
+	history.clear ();
+	CPPUNIT_ASSERT (!Glib::file_test (spill_path, Glib::FILE_TEST_EXISTS));
+}
+
+void
+UndoTest::testTrimSpill ()
+{
+	const string spill_path = Glib::build_filename (test_output_directory ("testTrimSpill"), "undo.spill");
+
+	UndoHistory history;
+	history.set_spill (spill_path, &transaction_from_state);
+	history.set_spill_depth (4);
+	history.set_depth (8);
+
+	value = 0;
+
+	GStatBuf sb;
+	int64_t  first_size = 0;
+	int64_t  max_size   = 0;
+
+	for (int i = 1; i <= 200; ++i) {
+		UndoTransaction* ut = new UndoTransaction ();
+		ut->set_name (string_compose ("set %1", i));
+		ut->add_command (new SetValueCommand (value, value, i));
+		(*ut) ();
+		history.add (ut);
+
+		CPPUNIT_ASSERT (history.undo_depth () <= 8);
+
+		if (g_stat (spill_path.c_str (), &sb) == 0) {
+			if (first_size == 0) {
+				first_size = sb.st_size;
+			}
+			max_size = std::max<int64_t> (max_size, sb.st_size);
+		}
+	}
+
+	/* at most 4 transactions are live in the log, and trimmed ones are
+	 * compacted away rather than accumulating for 192 transactions.
+	 */
+	CPPUNIT_ASSERT (first_size > 0);
+	CPPUNIT_ASSERT (max_size <= 12 * first_size);
+
+	/* spilled transactions are still intact after compaction */
+	history.undo (8);
+	CPPUNIT_ASSERT_EQUAL (192, value);
+	CPPUNIT_ASSERT_EQUAL (0UL, history.undo_depth ());
+
+	history.redo (8);
+	CPPUNIT_ASSERT_EQUAL (200, value);
+
+	history.clear ();
+	CPPUNIT_ASSERT (!Glib::file_test (spill_path, Glib::FILE_TEST_EXISTS));
+}
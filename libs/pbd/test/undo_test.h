@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class UndoTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (UndoTest);
+	CPPUNIT_TEST (testSpill);
+	CPPUNIT_TEST (testTrimSpill);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testSpill ();
+	void testTrimSpill ();
+};
@@ -304,3 +304,141 @@ XMLTest::testPerfLargeXMLDocument ()
 
 	test_xml_document ("testPerfLargeXMLDocument", node_options);
 }
+
+void
+XMLTest::testBinaryXMLDocument ()
+{
+	std::vector<NodeOptions> node_options;
+
+	node_options.push_back (NodeOptions (child_node_name, 32, 2));
+	node_options.push_back (NodeOptions (grandchild_node_name, 128, 16, get_event_content (32)));
+	node_options.push_back (NodeOptions (great_grandchild_node_name, 16, 8));
+
+	const string test_output_dir = test_output_directory ("testBinaryXMLDocument");
+	const string xml_path = Glib::build_filename (test_output_dir, "testBinaryXMLDocument.xml");
+	const string bin_path = xml_path + ".cache";
+
+	XMLTree test_xml;
+	CPPUNIT_ASSERT (create_xml_doc (test_xml, node_options));
+
+	/* mixed and whitespace-only content, which reading XML partially drops */
+	XMLNode* mixed = test_xml.root()->add_child ("Mixed");
+	mixed->add_content ("  ");
+	mixed->add_child ("Element");
+	mixed->add_content (" text ");
+	mixed->add_child ("Blank")->add_content (" \n ");
+
+	CPPUNIT_ASSERT (test_xml.write (xml_path));
+
+	uint64_t hash;
+	CPPUNIT_ASSERT (XMLTree::file_hash (xml_path, hash));
+	CPPUNIT_ASSERT (test_xml.write_binary (bin_path, hash));
+
+	TimingData xml_timing_data, bin_timing_data;
+
+	for (uint32_t iter = 0; iter < test_iterations; ++iter) {
+
+		xml_timing_data.start_timing ();
+		XMLTree xml_doc (xml_path);
+		xml_timing_data.add_elapsed ();
+
+		bin_timing_data.start_timing ();
+		XMLTree bin_doc;
+		CPPUNIT_ASSERT (bin_doc.read_binary (bin_path, hash));
+		bin_timing_data.add_elapsed ();
+
+		/* the binary tree must be identical to the tree read from XML */
+		CPPUNIT_ASSERT (*xml_doc.root() == *bin_doc.root());
+	}
+
+	/* a different tag (modified XML file) must be rejected */
+	XMLTree stale;
+	CPPUNIT_ASSERT (!stale.read_binary (bin_path, hash + 1));
+	CPPUNIT_ASSERT (!stale.root ());
+
+	CPPUNIT_ASSERT (g_remove (xml_path.c_str ()) == 0);
+	CPPUNIT_ASSERT (g_remove (bin_path.c_str ()) == 0);
+
+	std::cerr << std::endl;
+	std::cerr << "   Read XML : " << xml_timing_data.summary ();
+	std::cerr << "   Read Binary : " << bin_timing_data.summary ();
+}
+
+void
+XMLTest::testStreamingXMLDocument ()
+{
+	std::vector<NodeOptions> node_options;
+
+	node_options.push_back (NodeOptions (child_node_name, 32, 2));
+	node_options.push_back (NodeOptions (grandchild_node_name, 128, 16, get_event_content (32)));
+
+	const string test_output_dir = test_output_directory ("testStreamingXMLDocument");
+	const string tree_path = Glib::build_filename (test_output_dir, "testStreamingXMLDocumentTree.xml");
+	const string stream_path = Glib::build_filename (test_output_dir, "testStreamingXMLDocumentStream.xml");
+
+	XMLTree test_xml;
+	CPPUNIT_ASSERT (create_xml_doc (test_xml, node_options));
+
+	XMLNode* mixed = test_xml.root()->add_child ("Mixed");
+	mixed->add_content ("  ");
+	mixed->add_child ("Element");
+	mixed->add_content (" text ");
+
+	CPPUNIT_ASSERT (test_xml.write (tree_path));
+
+	/* write the same document node by node */
+	XMLNode const* root = test_xml.root ();
+
+	XMLWriter writer;
+	CPPUNIT_ASSERT (writer.open (stream_path));
+	CPPUNIT_ASSERT (writer.start_element (root->name ().c_str ()));
+
+	for (XMLPropertyConstIterator i = root->properties ().begin (); i != root->properties ().end (); ++i) {
+		CPPUNIT_ASSERT (writer.set_property ((*i)->name ().c_str (), (*i)->value ()));
+	}
+	for (XMLNodeConstIterator i = root->children ().begin (); i != root->children ().end (); ++i) {
+		CPPUNIT_ASSERT (writer.write_node (**i));
+	}
+	CPPUNIT_ASSERT (writer.close ());
+
+	XMLTree tree_doc (tree_path);
+	XMLTree stream_doc (stream_path);
+	CPPUNIT_ASSERT (tree_doc.root ());
+	CPPUNIT_ASSERT (stream_doc.root ());
+	CPPUNIT_ASSERT (*tree_doc.root () == *stream_doc.root ());
+
+	/* read the children of the root one at a time */
+	XMLReader reader;
+	CPPUNIT_ASSERT (reader.open (stream_path));
+
+	while (reader.read () && reader.type () != XMLReader::Element) {}
+
+	CPPUNIT_ASSERT_EQUAL (root->name (), reader.name ());
+	CPPUNIT_ASSERT_EQUAL (0, reader.depth ());
+
+	reader.read ();
+
+	XMLNodeList const& children = tree_doc.root ()->children ();
+	size_t n = 0;
+
+	while (!reader.at_end () && reader.depth () > 0) {
+		if (reader.type () != XMLReader::Element) {
+			reader.skip ();
+			continue;
+		}
+		XMLNode* node = reader.read_node ();
+		CPPUNIT_ASSERT (node);
+		CPPUNIT_ASSERT (n < children.size ());
+		CPPUNIT_ASSERT (*node == *children[n]);
+		delete node;
+		++n;
+	}
+
+	CPPUNIT_ASSERT (!reader.failed ());
+	CPPUNIT_ASSERT_EQUAL (children.size (), n);
+
+	reader.close ();
+
+	CPPUNIT_ASSERT (g_remove (tree_path.c_str ()) == 0);
+	CPPUNIT_ASSERT (g_remove (stream_path.c_str ()) == 0);
+}
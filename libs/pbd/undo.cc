@@ -23,8 +23,11 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 #include <time.h>
 
+#include <glib/gstdio.h>
+
 #include "pbd/undo.h"
 #include "pbd/xml++.h"
 
@@ -177,38 +180,42 @@ private:
 
 UndoHistory::UndoHistory ()
 {
-	_clearing = false;
-	_depth    = 0;
+	_clearing    = false;
+	_depth       = 0;
+	_spill_depth = 0;
+	_spill_end   = 0;
 }
 
 void
 UndoHistory::set_depth (uint32_t d)
 {
-	uint32_t current_depth = UndoList.size ();
-
 	_depth = d;
 
-	if (d > current_depth) {
-		/* not even transactions to meet request */
-		return;
-	}
-
 	if (_depth > 0) {
-		uint32_t cnt = current_depth - d;
+		trim (_depth);
+	}
+}
 
-		while (cnt--) {
-			UndoTransaction* ut = UndoList.front ();
-			UndoList.pop_front ();
-			delete ut;
+/** Remove the oldest transactions, until at most @p depth remain */
+void
+UndoHistory::trim (uint32_t depth)
+{
+	while (undo_depth () > depth) {
+		if (!_spilled.empty ()) {
+			_spilled.pop_front ();
+			continue;
 		}
+		UndoTransaction* ut = UndoList.front ();
+		UndoList.pop_front ();
+		delete ut;
 	}
+
+	compact_spilled ();
 }
 
 void
 UndoHistory::add (UndoTransaction* const ut)
 {
-	uint32_t current_depth = UndoList.size ();
-
 	ut->DropReferences.connect_same_thread (*this, boost::bind (&UndoHistory::remove, this, ut));
 
 	/* if the current undo history is larger than or equal to the currently
@@ -216,15 +223,8 @@ UndoHistory::add (UndoTransaction* const ut)
 		 at the back for new one.
 		 */
 
-	if ((_depth > 0) && current_depth && (current_depth >= _depth)) {
-		uint32_t cnt = 1 + (current_depth - _depth);
-
-		while (cnt--) {
-			UndoTransaction* ut;
-			ut = UndoList.front ();
-			UndoList.pop_front ();
-			delete ut;
-		}
+	if (_depth > 0) {
+		trim (_depth - 1);
 	}
 
 	UndoList.push_back (ut);
@@ -238,9 +238,210 @@ UndoHistory::add (UndoTransaction* const ut)
 
 	/* we are now owners of the transaction and must delete it when finished with it */
 
+	while (_spill_depth > 0 && UndoList.size () > _spill_depth && spill ()) {
+		;
+	}
+
 	Changed (); /* EMIT SIGNAL */
 }
 
+void
+UndoHistory::set_spill (std::string const& path, TransactionFactory factory)
+{
+	_spill_path    = path;
+	_spill_factory = factory;
+}
+
+void
+UndoHistory::set_spill_depth (uint32_t d)
+{
+	_spill_depth = d;
+
+	while (_spill_depth > 0 && UndoList.size () > _spill_depth && spill ()) {
+		;
+	}
+}
+
+/** Move the oldest transaction in memory to the end of the log */
+bool
+UndoHistory::spill ()
+{
+	if (_spill_path.empty () || !_spill_factory || UndoList.empty ()) {
+		return false;
+	}
+
+	UndoTransaction* ut = UndoList.front ();
+
+	std::string buf;
+	XMLNode&    node (ut->get_state ());
+	XMLTree::encode_binary (node, 0, buf);
+	delete &node;
+
+	/* start a new log once all transactions in it are gone */
+	FILE* f = g_fopen (_spill_path.c_str (), _spill_end > 0 ? "ab" : "wb");
+
+	if (!f) {
+		return false;
+	}
+
+	/* after a failed write, the log may be longer than expected */
+	long const offset = fseek (f, 0, SEEK_END) == 0 ? ftell (f) : -1;
+
+	bool ok = offset >= 0 && fwrite (buf.data (), 1, buf.size (), f) == buf.size ();
+
+	if (fclose (f) != 0) {
+		ok = false;
+	}
+
+	if (!ok) {
+		/* keep it in memory */
+		return false;
+	}
+
+	_spilled.push_back (SpilledTransaction (ut->name (), offset, buf.size ()));
+	_spill_end = offset + buf.size ();
+
+	UndoList.pop_front ();
+	delete ut;
+
+	return true;
+}
+
+/** Re-create the most recent spilled transaction, and add it to the end of UndoList
+ * @return false if there are no (more) spilled transactions
+ */
+bool
+UndoHistory::unspill ()
+{
+	while (!_spilled.empty ()) {
+
+		XMLNode* node = spilled_state (_spilled.back ());
+
+		_spilled.pop_back ();
+
+		compact_spilled ();
+
+		/* this fails if the objects that the transaction refers to are
+		 * gone, in the same way as restoring a saved history would.
+		 */
+		UndoTransaction* ut = 0;
+
+		try {
+			if (node) {
+				ut = _spill_factory (*node);
+			}
+		} catch (std::exception const&) {
+			ut = 0;
+		}
+
+		delete node;
+
+		if (!ut) {
+			continue;
+		}
+
+		if (ut->empty ()) {
+			delete ut;
+			continue;
+		}
+
+		ut->DropReferences.connect_same_thread (*this, boost::bind (&UndoHistory::remove, this, ut));
+		UndoList.push_back (ut);
+		return true;
+	}
+
+	return false;
+}
+
+XMLNode*
+UndoHistory::spilled_state (SpilledTransaction const& st) const
+{
+	FILE* f = g_fopen (_spill_path.c_str (), "rb");
+
+	if (!f) {
+		return 0;
+	}
+
+	std::vector<uint8_t> buf (st.size);
+
+	bool ok = fseek (f, st.offset, SEEK_SET) == 0 && fread (&buf[0], 1, st.size, f) == st.size;
+
+	fclose (f);
+
+	return ok ? XMLTree::decode_binary (&buf[0], st.size, 0) : 0;
+}
+
+/** Rewrite the log once the transactions that were removed from it
+ * take up more space than those that remain, so that it does not grow
+ * for the whole session when both the history and spill depth are limited.
+ */
+void
+UndoHistory::compact_spilled ()
+{
+	if (_spilled.empty ()) {
+		clear_spilled ();
+		return;
+	}
+
+	int64_t live = 0;
+	for (std::list<SpilledTransaction>::const_iterator i = _spilled.begin (); i != _spilled.end (); ++i) {
+		live += i->size;
+	}
+
+	if (_spill_end - live <= live) {
+		return;
+	}
+
+	std::string const tmp = _spill_path + ".tmp";
+
+	FILE* in  = g_fopen (_spill_path.c_str (), "rb");
+	FILE* out = in ? g_fopen (tmp.c_str (), "wb") : 0;
+
+	bool                 ok     = out != 0;
+	int64_t              offset = 0;
+	std::vector<int64_t> offsets;
+	std::vector<uint8_t> buf;
+
+	for (std::list<SpilledTransaction>::const_iterator i = _spilled.begin (); ok && i != _spilled.end (); ++i) {
+		buf.resize (i->size);
+		ok = fseek (in, i->offset, SEEK_SET) == 0
+		     && fread (&buf[0], 1, i->size, in) == i->size
+		     && fwrite (&buf[0], 1, i->size, out) == i->size;
+		offsets.push_back (offset);
+		offset += i->size;
+	}
+
+	if (in) {
+		fclose (in);
+	}
+	if (out && fclose (out) != 0) {
+		ok = false;
+	}
+
+	if (!ok || ::g_rename (tmp.c_str (), _spill_path.c_str ()) != 0) {
+		/* keep using the old log, and try again next time */
+		::g_remove (tmp.c_str ());
+		return;
+	}
+
+	std::vector<int64_t>::const_iterator o = offsets.begin ();
+	for (std::list<SpilledTransaction>::iterator i = _spilled.begin (); i != _spilled.end (); ++i, ++o) {
+		i->offset = *o;
+	}
+	_spill_end = offset;
+}
+
+void
+UndoHistory::clear_spilled ()
+{
+	_spilled.clear ();
+
+	if (_spill_end > 0) {
+		::g_remove (_spill_path.c_str ());
+		_spill_end = 0;
+	}
+}
+
 void
 UndoHistory::remove (UndoTransaction* const ut)
 {
@@ -268,7 +469,7 @@ UndoHistory::undo (unsigned int n)
 		UndoRedoSignaller exception_safe_signaller (*this);
 
 		while (n--) {
-			if (UndoList.size () == 0) {
+			if (UndoList.empty () && !unspill ()) {
 				return;
 			}
 			UndoTransaction* ut = UndoList.back ();
@@ -328,6 +529,8 @@ UndoHistory::clear_undo ()
 	UndoList.clear ();
 	_clearing = false;
 
+	clear_spilled ();
+
 	Changed (); /* EMIT SIGNAL */
 }
 
@@ -347,27 +550,55 @@ UndoHistory::get_state (int32_t depth)
 
 	if (depth == 0) {
 		return (*node);
+	}
 
-	} else if (depth < 0) {
-		/* everything */
+	/* everything, or just the last "depth" transactions */
+	size_t skip = (depth > 0 && (unsigned long) depth < undo_depth ()) ? undo_depth () - depth : 0;
 
-		for (list<UndoTransaction*>::iterator it = UndoList.begin (); it != UndoList.end (); ++it) {
+	for (list<SpilledTransaction>::const_iterator it = _spilled.begin (); it != _spilled.end (); ++it) {
+		if (skip) {
+			--skip;
+		} else if (XMLNode* child = spilled_state (*it)) {
+			node->add_child_nocopy (*child);
+		}
+	}
+
+	for (list<UndoTransaction*>::iterator it = UndoList.begin (); it != UndoList.end (); ++it) {
+		if (skip) {
+			--skip;
+		} else {
 			node->add_child_nocopy ((*it)->get_state ());
 		}
+	}
 
-	} else {
-		/* just the last "depth" transactions */
+	return *node;
+}
+
+void
+UndoHistory::write_state (XMLWriter& writer, int32_t depth)
+{
+	if (depth == 0) {
+		return;
+	}
 
-		list<UndoTransaction*> in_order;
+	size_t skip = (depth > 0 && (unsigned long) depth < undo_depth ()) ? undo_depth () - depth : 0;
 
-		for (list<UndoTransaction*>::reverse_iterator it = UndoList.rbegin (); it != UndoList.rend () && depth; ++it, depth--) {
-			in_order.push_front (*it);
+	for (list<SpilledTransaction>::const_iterator it = _spilled.begin (); it != _spilled.end (); ++it) {
+		if (skip) {
+			--skip;
+		} else if (XMLNode* node = spilled_state (*it)) {
+			writer.write_node (*node);
+			delete node;
 		}
+	}
 
-		for (list<UndoTransaction*>::iterator it = in_order.begin (); it != in_order.end (); it++) {
-			node->add_child_nocopy ((*it)->get_state ());
+	for (list<UndoTransaction*>::iterator it = UndoList.begin (); it != UndoList.end (); ++it) {
+		if (skip) {
+			--skip;
+		} else {
+			XMLNode& node ((*it)->get_state ());
+			writer.write_node (node);
+			delete &node;
 		}
 	}
-
-	return *node;
 }
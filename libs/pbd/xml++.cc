@@ -5,10 +5,15 @@
  * Modified for Ardour and released under the same terms.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <string.h>
 #include <iostream>
+#include <map>
 
+#include <glib.h>
+
+#include "pbd/gstdio_compat.h"
 #include "pbd/utf8_utils.h"
 #include "pbd/xml++.h"
 
@@ -230,6 +235,325 @@ XMLTree::write_buffer() const
 	return retval;
 }
 
+/* Binary encoding, see XMLTree::write_binary():
+ *
+ *   magic, format version, tag,
+ *   string table: number of strings, followed by length and bytes of each,
+ *   root node.
+ *
+ * A node is: name, flags, [content,] number of properties, name and value
+ * of each property, number of children, children. Strings are referred to
+ * by their index in the table. All integers are unsigned LEB128, so the
+ * encoding does not depend on the byte order of the host.
+ */
+
+static const char     xml_binary_magic[8]   = { 'A', 'R', 'D', 'X', 'M', 'L', 'B', '\0' };
+static const uint64_t xml_binary_version    = 1;
+static const uint32_t xml_binary_max_depth  = 1024;
+static const uint64_t xml_binary_is_content = 0x1;
+
+static void
+put_uint (string& buf, uint64_t v)
+{
+	while (v >= 0x80) {
+		buf += (char) ((v & 0x7f) | 0x80);
+		v >>= 7;
+	}
+	buf += (char) v;
+}
+
+static bool
+get_uint (uint8_t const*& p, uint8_t const* end, uint64_t& v)
+{
+	v = 0;
+	for (unsigned int shift = 0; p < end && shift < 64; shift += 7) {
+		uint8_t const b = *p++;
+		v |= (uint64_t) (b & 0x7f) << shift;
+		if (!(b & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+namespace {
+
+struct XMLBinaryWriter {
+	XMLBinaryWriter () : n_strings (0) {}
+
+	string                   strings;
+	string                   nodes;
+	uint64_t                 n_strings;
+	std::map<string, uint64_t> index;
+
+	uint64_t intern (string const& s)
+	{
+		std::pair<std::map<string, uint64_t>::iterator, bool> i = index.insert (make_pair (s, n_strings));
+		if (i.second) {
+			put_uint (strings, s.length ());
+			strings += s;
+			++n_strings;
+		}
+		return i.first->second;
+	}
+
+	void write (XMLNode const& node)
+	{
+		/* libxml names text nodes "text" */
+		put_uint (nodes, intern (node.is_content () ? "text" : node.name ()));
+
+		if (node.is_content ()) {
+			put_uint (nodes, xml_binary_is_content);
+			put_uint (nodes, intern (node.content ()));
+		} else {
+			put_uint (nodes, 0);
+		}
+
+		XMLPropertyList const& props (node.properties ());
+
+		put_uint (nodes, props.size ());
+		for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+			put_uint (nodes, intern ((*i)->name ()));
+			put_uint (nodes, intern ((*i)->value ()));
+		}
+
+		std::vector<XMLNode const*> children;
+		kept_children (node.children (), children);
+
+		put_uint (nodes, children.size ());
+		for (std::vector<XMLNode const*>::const_iterator i = children.begin (); i != children.end (); ++i) {
+			write (**i);
+		}
+	}
+
+	/* Reading XML drops some whitespace-only text (see xmlKeepBlanksDefault).
+	 * Follow libxml's heuristic (areBlanks() in parser.c) so that the binary
+	 * tree matches the tree that is read from the XML file written with it.
+	 */
+	static void kept_children (XMLNodeList const& children, std::vector<XMLNode const*>& kept)
+	{
+		for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+			XMLNode const* n = *i;
+			if (n->is_content () && n->content ().find_first_not_of (" \t\r\n") == string::npos) {
+				if (kept.empty ()) {
+					/* kept only when followed by the parent's end tag */
+					if (i + 1 != children.end ()) {
+						continue;
+					}
+				} else if (!kept.back ()->is_content () && !kept.front ()->is_content ()) {
+					continue;
+				}
+			}
+			kept.push_back (n);
+		}
+	}
+};
+
+}
+
+void
+XMLTree::encode_binary (XMLNode const& node, uint64_t tag, string& buf)
+{
+	XMLBinaryWriter w;
+	w.write (node);
+
+	buf.assign (xml_binary_magic, sizeof (xml_binary_magic));
+	put_uint (buf, xml_binary_version);
+	put_uint (buf, tag);
+	put_uint (buf, w.n_strings);
+	buf += w.strings;
+	buf += w.nodes;
+}
+
+bool
+XMLTree::write_binary (const string& fn, uint64_t tag) const
+{
+	if (!_root) {
+		return false;
+	}
+
+	string buf;
+	encode_binary (*_root, tag, buf);
+
+	FILE* f = g_fopen (fn.c_str (), "wb");
+
+	if (!f) {
+		return false;
+	}
+
+	bool ok = fwrite (buf.data (), 1, buf.size (), f) == buf.size ();
+
+	if (fclose (f) != 0) {
+		ok = false;
+	}
+
+	if (!ok) {
+		::g_remove (fn.c_str ());
+	}
+
+	return ok;
+}
+
+XMLNode*
+XMLTree::read_binary_node (uint8_t const*& p, uint8_t const* end, vector<string> const& strings, uint32_t depth)
+{
+	uint64_t name;
+	uint64_t flags;
+	uint64_t n;
+
+	if (depth > xml_binary_max_depth || !get_uint (p, end, name) || name >= strings.size () || !get_uint (p, end, flags)) {
+		return 0;
+	}
+
+	XMLNode* node = new XMLNode (strings[name]);
+
+	if (flags & xml_binary_is_content) {
+		uint64_t content;
+		if (!get_uint (p, end, content) || content >= strings.size ()) {
+			delete node;
+			return 0;
+		}
+		node->_is_content = true;
+		node->_content    = strings[content];
+	}
+
+	/* every entry takes at least one byte per integer, which bounds
+	 * the counts before anything is allocated for them
+	 */
+
+	if (!get_uint (p, end, n) || n > (uint64_t) (end - p)) {
+		delete node;
+		return 0;
+	}
+
+	node->_proplist.reserve (n);
+
+	for (uint64_t i = 0; i < n; ++i) {
+		uint64_t k, v;
+		if (!get_uint (p, end, k) || k >= strings.size () || !get_uint (p, end, v) || v >= strings.size ()) {
+			delete node;
+			return 0;
+		}
+		/* values were sanitized when they were set, do not repeat that */
+		node->_proplist.push_back (new XMLProperty (strings[k], strings[v]));
+	}
+
+	if (!get_uint (p, end, n) || n > (uint64_t) (end - p)) {
+		delete node;
+		return 0;
+	}
+
+	node->_children.reserve (n);
+
+	for (uint64_t i = 0; i < n; ++i) {
+		XMLNode* child = read_binary_node (p, end, strings, depth + 1);
+		if (!child) {
+			delete node;
+			return 0;
+		}
+		node->_children.push_back (child);
+	}
+
+	return node;
+}
+
+XMLNode*
+XMLTree::decode_binary (uint8_t const* p, size_t len, uint64_t tag)
+{
+	uint8_t const* end  = p + len;
+	XMLNode*       root = 0;
+
+	uint64_t version;
+	uint64_t data_tag;
+	uint64_t n_strings;
+
+	if (len <= sizeof (xml_binary_magic) || memcmp (p, xml_binary_magic, sizeof (xml_binary_magic))) {
+		return 0;
+	}
+
+	p += sizeof (xml_binary_magic);
+
+	if (!get_uint (p, end, version) || version != xml_binary_version
+	    || !get_uint (p, end, data_tag) || data_tag != tag
+	    || !get_uint (p, end, n_strings) || n_strings > (uint64_t) (end - p)) {
+		return 0;
+	}
+
+	vector<string> strings;
+	strings.reserve (n_strings);
+
+	for (uint64_t i = 0; i < n_strings; ++i) {
+		uint64_t slen;
+		if (!get_uint (p, end, slen) || slen > (uint64_t) (end - p)) {
+			return 0;
+		}
+		strings.push_back (string ((char const*) p, slen));
+		p += slen;
+	}
+
+	root = read_binary_node (p, end, strings, 0);
+
+	if (root && p != end) {
+		/* trailing garbage */
+		delete root;
+		root = 0;
+	}
+
+	return root;
+}
+
+bool
+XMLTree::read_binary (const string& fn, uint64_t tag)
+{
+	GMappedFile* mf = g_mapped_file_new (fn.c_str (), FALSE, NULL);
+
+	if (!mf) {
+		return false;
+	}
+
+	XMLNode* root = decode_binary ((uint8_t const*) g_mapped_file_get_contents (mf), g_mapped_file_get_length (mf), tag);
+
+	g_mapped_file_unref (mf);
+
+	if (!root) {
+		return false;
+	}
+
+	delete _root;
+	_root = root;
+
+	if (_doc) {
+		xmlFreeDoc (_doc);
+		_doc = 0;
+	}
+
+	return true;
+}
+
+bool
+XMLTree::file_hash (const string& fn, uint64_t& hash)
+{
+	GMappedFile* mf = g_mapped_file_new (fn.c_str (), FALSE, NULL);
+
+	if (!mf) {
+		return false;
+	}
+
+	size_t const   len = g_mapped_file_get_length (mf);
+	uint8_t const* p   = (uint8_t const*) g_mapped_file_get_contents (mf);
+
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < len; ++i) {
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+
+	g_mapped_file_unref (mf);
+
+	hash = h;
+	return true;
+}
+
 static const int PROPERTY_RESERVE_COUNT = 16;
 
 XMLNode::XMLNode(const string& n)
@@ -739,7 +1063,8 @@ readnode(xmlNodePtr node)
 
 	tmp = new XMLNode(name);
 
-	for (attr = node->properties; attr; attr = attr->next) {
+	/* text nodes may store short content in place of properties (XML_PARSE_COMPACT) */
+	for (attr = node->type == XML_ELEMENT_NODE ? node->properties : 0; attr; attr = attr->next) {
 		content = "";
 		if (attr->children) {
 			content = (char*)attr->children->content;
@@ -846,3 +1171,311 @@ XMLNode::dump (ostream& s, string p) const
 		s << p << "</" << _name << ">\n";
 	}
 }
+
+XMLReader::XMLReader ()
+	: _reader (0)
+	, _at_end (true)
+	, _failed (false)
+{
+}
+
+XMLReader::~XMLReader ()
+{
+	close ();
+}
+
+bool
+XMLReader::open (const string& fn)
+{
+	close ();
+
+	/* drop whitespace-only text, as XMLTree does (see xmlKeepBlanksDefault) */
+	_reader = xmlReaderForFile (fn.c_str (), NULL, XML_PARSE_HUGE | XML_PARSE_NOBLANKS);
+
+	if (!_reader) {
+		return false;
+	}
+
+	_at_end = false;
+	_failed = false;
+
+	return true;
+}
+
+void
+XMLReader::close ()
+{
+	if (_reader) {
+		xmlFreeTextReader (_reader);
+		_reader = 0;
+	}
+
+	_at_end = true;
+}
+
+bool
+XMLReader::advance (int rv)
+{
+	if (rv < 0) {
+		_failed = true;
+	}
+
+	if (rv != 1) {
+		_at_end = true;
+	}
+
+	return !_at_end;
+}
+
+bool
+XMLReader::read ()
+{
+	if (_at_end) {
+		return false;
+	}
+
+	return advance (xmlTextReaderRead (_reader));
+}
+
+bool
+XMLReader::skip ()
+{
+	if (_at_end) {
+		return false;
+	}
+
+	return advance (xmlTextReaderNext (_reader));
+}
+
+XMLNode*
+XMLReader::read_node ()
+{
+	if (_at_end || xmlTextReaderNodeType (_reader) != XML_READER_TYPE_ELEMENT) {
+		return 0;
+	}
+
+	/* this only parses the current element, and the reader releases it
+	 * again once it moves on.
+	 */
+	xmlNodePtr node = xmlTextReaderExpand (_reader);
+
+	if (!node) {
+		_failed = true;
+		_at_end = true;
+		return 0;
+	}
+
+	XMLNode* rv = readnode (node);
+
+	skip ();
+
+	return rv;
+}
+
+XMLReader::NodeType
+XMLReader::type () const
+{
+	if (_at_end) {
+		return Other;
+	}
+
+	switch (xmlTextReaderNodeType (_reader)) {
+		case XML_READER_TYPE_ELEMENT:
+			return Element;
+		case XML_READER_TYPE_END_ELEMENT:
+			return EndElement;
+		case XML_READER_TYPE_TEXT:
+		case XML_READER_TYPE_CDATA:
+			return Text;
+		default:
+			break;
+	}
+
+	return Other;
+}
+
+string
+XMLReader::name () const
+{
+	if (_at_end) {
+		return string ();
+	}
+
+	const xmlChar* n = xmlTextReaderConstName (_reader);
+
+	return n ? string ((const char*) n) : string ();
+}
+
+int
+XMLReader::depth () const
+{
+	if (_at_end) {
+		return -1;
+	}
+
+	return xmlTextReaderDepth (_reader);
+}
+
+bool
+XMLReader::is_empty_element () const
+{
+	return !_at_end && xmlTextReaderIsEmptyElement (_reader) == 1;
+}
+
+bool
+XMLReader::get_property (const char* name, std::string& value) const
+{
+	if (_at_end) {
+		return false;
+	}
+
+	xmlChar* v = xmlTextReaderGetAttribute (_reader, (const xmlChar*) name);
+
+	if (!v) {
+		return false;
+	}
+
+	value = (const char*) v;
+	xmlFree (v);
+
+	return true;
+}
+
+XMLWriter::XMLWriter ()
+	: _writer (0)
+	, _indent (false)
+	, _failed (false)
+{
+}
+
+XMLWriter::~XMLWriter ()
+{
+	close ();
+}
+
+bool
+XMLWriter::check (int rv)
+{
+	if (rv < 0) {
+		_failed = true;
+	}
+
+	return rv >= 0;
+}
+
+bool
+XMLWriter::open (const string& fn, int compression)
+{
+	close ();
+
+	_failed = false;
+	_writer = xmlNewTextWriterFilename (fn.c_str (), std::max (0, std::min (9, compression)));
+
+	if (!_writer) {
+		return false;
+	}
+
+	/* same format as XMLTree::write() */
+	xmlTextWriterSetIndent (_writer, 1);
+	_indent = true;
+	xmlTextWriterSetIndentString (_writer, (const xmlChar*) "  ");
+
+	return check (xmlTextWriterStartDocument (_writer, "1.0", "UTF-8", NULL));
+}
+
+bool
+XMLWriter::close ()
+{
+	if (!_writer) {
+		return false;
+	}
+
+	check (xmlTextWriterEndDocument (_writer));
+	check (xmlTextWriterFlush (_writer));
+
+	xmlFreeTextWriter (_writer);
+	_writer = 0;
+
+	return !_failed;
+}
+
+bool
+XMLWriter::start_element (const char* name)
+{
+	return _writer && check (xmlTextWriterStartElement (_writer, (const xmlChar*) name));
+}
+
+bool
+XMLWriter::end_element ()
+{
+	return _writer && check (xmlTextWriterEndElement (_writer));
+}
+
+bool
+XMLWriter::set_property (const char* name, const string& value)
+{
+	string const v = PBD::sanitize_utf8 (value);
+	return _writer && check (xmlTextWriterWriteAttribute (_writer, (const xmlChar*) name, (const xmlChar*) v.c_str ()));
+}
+
+bool
+XMLWriter::add_content (const string& c)
+{
+	return _writer && check (xmlTextWriterWriteString (_writer, (const xmlChar*) c.c_str ()));
+}
+
+bool
+XMLWriter::write_node (const XMLNode& node)
+{
+	if (node.is_content ()) {
+		return add_content (node.content ());
+	}
+
+	if (!start_element (node.name ().c_str ())) {
+		return false;
+	}
+
+	/* property values of XMLNodes are sanitized already */
+	const XMLPropertyList& props = node.properties ();
+
+	for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+		if (!check (xmlTextWriterWriteAttribute (_writer, (const xmlChar*) (*i)->name ().c_str (), (const xmlChar*) (*i)->value ().c_str ()))) {
+			return false;
+		}
+	}
+
+	const XMLNodeList& children = node.children ();
+
+	/* like XMLTree::write(), do not format the contents of elements
+	 * with text content, that would add whitespace to the text.
+	 */
+	bool mixed = false;
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		if ((*i)->is_content ()) {
+			mixed = true;
+			break;
+		}
+	}
+
+	bool const unindent = mixed && _indent;
+
+	if (unindent) {
+		xmlTextWriterSetIndent (_writer, 0);
+		_indent = false;
+	}
+
+	bool ok = true;
+
+	for (XMLNodeConstIterator i = children.begin (); ok && i != children.end (); ++i) {
+		ok = write_node (**i);
+	}
+
+	ok = ok && end_element ();
+
+	if (unindent) {
+		xmlTextWriterSetIndent (_writer, 1);
+		_indent = true;
+	}
+
+	return ok;
+}
@@ -0,0 +1,65 @@
+/* Compare superclock <-> sample conversion through PBD::muldiv_* with the
+ * precomputed SuperclockSampleConverter.
+ *
+ * Usage: superclock_conversion [SAMPLE-RATE [ITERATIONS]]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "temporal/superclock.h"
+
+using namespace Temporal;
+
+template<typename F>
+static double
+time_it (char const * what, int64_t iterations, F f)
+{
+	volatile int64_t sink = 0;
+	int64_t acc = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+
+	for (int64_t n = 0; n < iterations; ++n) {
+		/* vary the input so that nothing can be hoisted out of the loop */
+		acc += f (n * 1000003 - (iterations / 2));
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now ();
+	sink = acc;
+	(void) sink;
+
+	const double ns = std::chrono::duration<double, std::nano> (end - start).count () / iterations;
+	printf ("%-32s %8.3f ns/call\n", what, ns);
+	return ns;
+}
+
+int
+main (int argc, char* argv[])
+{
+	const int sr = argc > 1 ? atoi (argv[1]) : 48000;
+	const int64_t iterations = argc > 2 ? atoll (argv[2]) : 50000000;
+	const superclock_t scts = 282240000;
+
+	set_superclock_ticks_per_second (scts);
+	set_sample_rate (sr);
+
+	const SuperclockSampleConverter c (scts, sr);
+
+	if (!c.exact ()) {
+		printf ("%d does not divide %lld, the converter is not used at this rate\n", sr, (long long) scts);
+		return 1;
+	}
+
+	printf ("superclock rate %lld, sample rate %d, %lld iterations\n", (long long) scts, sr, (long long) iterations);
+
+	const double a = time_it ("muldiv_floor (sc -> samples)", iterations, [&] (int64_t v) { return PBD::muldiv_floor (v, sr, scts); });
+	const double b = time_it ("converter (sc -> samples)", iterations, [&] (int64_t v) { return c.to_samples (v); });
+	const double d = time_it ("muldiv_round (samples -> sc)", iterations, [&] (int64_t v) { return PBD::muldiv_round (v >> 16, scts, superclock_t (sr)); });
+	const double e = time_it ("converter (samples -> sc)", iterations, [&] (int64_t v) { return c.to_superclock (v >> 16); });
+
+	printf ("\nspeedup: sc -> samples %.2fx, samples -> sc %.2fx\n", a / b, d / e);
+
+	return 0;
+}
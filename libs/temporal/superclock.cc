@@ -16,20 +16,99 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <vector>
+
+#include <glibmm/threads.h>
+
 #include "temporal/superclock.h"
 
 int Temporal::most_recent_engine_sample_rate = 48000; /* have to pick something as a default */
 
 Temporal::superclock_t Temporal::_superclock_ticks_per_second = 0;
 
+static const Temporal::SuperclockSampleConverter default_superclock_sample_converter;
+
+std::atomic<Temporal::SuperclockSampleConverter const*> Temporal::_superclock_sample_converter (&default_superclock_sample_converter);
+
+Temporal::SuperclockSampleConverter::SuperclockSampleConverter (superclock_t scts, int sr)
+	: _scts (scts)
+	, _sr (sr)
+	, _exact (false)
+	, _superclocks_per_sample (0)
+	, _magic (0)
+	, _shift (0)
+{
+	/* sr == 1 is excluded because muldiv_round() does not round exactly
+	 * for negative values with a divisor of 1.
+	 */
+
+	if (scts <= 0 || sr <= 1 || (scts % sr) != 0) {
+		return;
+	}
+
+	const uint64_t d = scts / sr;
+
+	/* Granlund & Montgomery: with l = ceil (log2 (d)), p = 63 + l and
+	 * m = ceil (2^p / d), m fits into 64 bits and (m * n) >> p == n / d
+	 * for all 0 <= n <= 2^63, which covers the magnitude of every
+	 * int64_t.
+	 */
+
+	int l = 0;
+	while (l < 64 && ((uint64_t) 1 << l) < d) {
+		++l;
+	}
+
+	_superclocks_per_sample = d;
+	_shift = 63 + l;
+
+#ifdef COMPILER_INT128_SUPPORT
+	const unsigned __int128 two_p = (unsigned __int128) 1 << _shift;
+	_magic = (uint64_t) ((two_p + d - 1) / d);
+#endif
+
+	_exact = true;
+}
+
+static void
+reset_superclock_sample_converter ()
+{
+	using namespace Temporal;
+
+	/* Other threads may still use the previous converter, so converters
+	 * are never freed. There is one per combination of rates, and only a
+	 * few of those are used during the lifetime of the process.
+	 */
+	static Glib::Threads::Mutex lock;
+	static std::vector<SuperclockSampleConverter const*> converters;
+
+	Glib::Threads::Mutex::Lock lm (lock);
+
+	superclock_t const scts = _superclock_ticks_per_second;
+	int const          sr   = most_recent_engine_sample_rate;
+
+	for (std::vector<SuperclockSampleConverter const*>::const_iterator i = converters.begin (); i != converters.end (); ++i) {
+		if ((*i)->superclock_ticks_per_second () == scts && (*i)->sample_rate () == sr) {
+			_superclock_sample_converter.store (*i, std::memory_order_release);
+			return;
+		}
+	}
+
+	SuperclockSampleConverter const* c = new SuperclockSampleConverter (scts, sr);
+	converters.push_back (c);
+	_superclock_sample_converter.store (c, std::memory_order_release);
+}
+
 void
 Temporal::set_sample_rate (int sr)
 {
 	most_recent_engine_sample_rate = sr;
+	reset_superclock_sample_converter ();
 }
 
 void
 Temporal::set_superclock_ticks_per_second (Temporal::superclock_t sc)
 {
 	_superclock_ticks_per_second = sc;
+	reset_superclock_sample_converter ();
 }
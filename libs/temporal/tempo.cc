@@ -2362,6 +2362,71 @@ TempoMap::superclock_at (timepos_t const & pos) const
 	return pos.superclocks();
 }
 
+void
+TempoMap::superclocks_at (Temporal::Beats const * in, superclock_t* out, size_t n) const
+{
+	TEMPO_MAP_ASSERT (!_tempos.empty());
+
+	if (n == 0) {
+		return;
+	}
+
+	/* Same choice of tempo as ::metric_at (Beats, true): the last tempo
+	 * at or before the given position. Keep it (and the next one) around
+	 * and only move forward when the input passes the next tempo.
+	 */
+
+	Tempos::const_iterator t = _tempos.begin();
+	Tempos::const_iterator nxt = t;
+	++nxt;
+
+	for (size_t i = 0; i < n; ++i) {
+
+		if (i > 0 && in[i] < in[i-1]) {
+			t = _tempos.begin();
+			nxt = t;
+			++nxt;
+		}
+
+		while (nxt != _tempos.end() && nxt->beats() <= in[i]) {
+			t = nxt;
+			++nxt;
+		}
+
+		out[i] = t->superclock_at (in[i]);
+	}
+}
+
+void
+TempoMap::quarters_at_superclocks (superclock_t const * in, Temporal::Beats* out, size_t n) const
+{
+	TEMPO_MAP_ASSERT (!_tempos.empty());
+
+	if (n == 0) {
+		return;
+	}
+
+	Tempos::const_iterator t = _tempos.begin();
+	Tempos::const_iterator nxt = t;
+	++nxt;
+
+	for (size_t i = 0; i < n; ++i) {
+
+		if (i > 0 && in[i] < in[i-1]) {
+			t = _tempos.begin();
+			nxt = t;
+			++nxt;
+		}
+
+		while (nxt != _tempos.end() && nxt->sclock() <= in[i]) {
+			t = nxt;
+			++nxt;
+		}
+
+		out[i] = t->quarters_at_superclock (in[i]);
+	}
+}
+
 #define S2Sc(s) (samples_to_superclock ((s), TEMPORAL_SAMPLE_RATE))
 #define Sc2S(s) (superclock_to_samples ((s), TEMPORAL_SAMPLE_RATE))
 
@@ -19,6 +19,7 @@
 #ifndef __ardour_superclock_h__
 #define __ardour_superclock_h__
 
+#include <atomic>
 #include <stdint.h>
 
 #include "pbd/integer_division.h"
@@ -46,8 +47,87 @@ static inline superclock_t superclock_ticks_per_second() {
 static inline superclock_t superclock_ticks_per_second() { return _superclock_ticks_per_second; }
 #endif
 
-static inline superclock_t superclock_to_samples (superclock_t s, int sr) { return PBD::muldiv_floor (s, sr, superclock_ticks_per_second()); }
-static inline superclock_t samples_to_superclock (int64_t samples, int sr) { return PBD::muldiv_round (samples, superclock_ticks_per_second(), superclock_t (sr)); }
+/* Division-free conversion between superclocks and samples for one
+ * (superclock_ticks_per_second, sample rate) pair.
+ *
+ * superclock_ticks_per_second is chosen so that all common sample rates
+ * divide it exactly. When that holds, a sample is an integer number of
+ * superclocks, samples -> superclock is a single multiply, and
+ * superclock -> samples is a division by a constant that we replace with
+ * a precomputed multiply-and-shift. Both give results identical to the
+ * PBD::muldiv_floor() and PBD::muldiv_round() based versions.
+ *
+ * If the sample rate does not divide superclock_ticks_per_second, the
+ * converter is not exact() and callers must use the generic path.
+ */
+
+class LIBTEMPORAL_API SuperclockSampleConverter
+{
+  public:
+	SuperclockSampleConverter () : _scts (0), _sr (0), _exact (false), _superclocks_per_sample (0), _magic (0), _shift (0) {}
+	SuperclockSampleConverter (superclock_t scts, int sr);
+
+	superclock_t superclock_ticks_per_second() const { return _scts; }
+	int sample_rate() const { return _sr; }
+	bool exact() const { return _exact; }
+
+	bool usable_for (superclock_t scts, int sr) const {
+		return _exact && _sr == sr && _scts == scts;
+	}
+
+	/* Same result as PBD::muldiv_floor (s, sample_rate(), superclock_ticks_per_second()),
+	 * i.e. truncated towards zero.
+	 */
+	superclock_t to_samples (superclock_t s) const {
+#ifdef COMPILER_INT128_SUPPORT
+		const uint64_t n = (s < 0) ? (uint64_t) 0 - (uint64_t) s : (uint64_t) s;
+		const uint64_t q = (uint64_t) (((unsigned __int128) _magic * n) >> _shift);
+		return (superclock_t) ((s < 0) ? (uint64_t) 0 - q : q);
+#else
+		return s / (superclock_t) _superclocks_per_sample;
+#endif
+	}
+
+	/* Same result as PBD::muldiv_round (samples, superclock_ticks_per_second(), sample_rate()) */
+	superclock_t to_superclock (int64_t samples) const {
+		return (superclock_t) ((uint64_t) samples * _superclocks_per_sample);
+	}
+
+  private:
+	superclock_t _scts;
+	int          _sr;
+	bool         _exact;
+	uint64_t     _superclocks_per_sample;
+	uint64_t     _magic;
+	int          _shift;
+};
+
+/* converter for the current superclock rate and most recent engine sample
+ * rate. set_sample_rate() and set_superclock_ticks_per_second() publish a
+ * new instance. Instances are never modified or freed, so that realtime
+ * threads can use them without locking.
+ */
+LIBTEMPORAL_API extern std::atomic<SuperclockSampleConverter const*> _superclock_sample_converter;
+
+static inline SuperclockSampleConverter const& superclock_sample_converter () {
+	return *_superclock_sample_converter.load (std::memory_order_acquire);
+}
+
+static inline superclock_t superclock_to_samples (superclock_t s, int sr) {
+	SuperclockSampleConverter const& c (superclock_sample_converter ());
+	if (c.usable_for (superclock_ticks_per_second(), sr)) {
+		return c.to_samples (s);
+	}
+	return PBD::muldiv_floor (s, sr, superclock_ticks_per_second());
+}
+
+static inline superclock_t samples_to_superclock (int64_t samples, int sr) {
+	SuperclockSampleConverter const& c (superclock_sample_converter ());
+	if (c.usable_for (superclock_ticks_per_second(), sr)) {
+		return c.to_superclock (samples);
+	}
+	return PBD::muldiv_round (samples, superclock_ticks_per_second(), superclock_t (sr));
+}
 
 LIBTEMPORAL_API extern int most_recent_engine_sample_rate;
 
@@ -947,6 +947,28 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 	LIBTEMPORAL_API	samplepos_t sample_at (BBT_Argument const & b) const { return superclock_to_samples (superclock_at (b), TEMPORAL_SAMPLE_RATE); }
 	LIBTEMPORAL_API	samplepos_t sample_at (timepos_t const & t) const { return superclock_to_samples (superclock_at (t), TEMPORAL_SAMPLE_RATE); }
 
+	/* Batched conversions. These convert @p n values from @p in into @p
+	 * out (which may not alias @p in) in a single sweep along the tempo
+	 * map, reusing the tempo in effect for the previous value rather than
+	 * looking it up again for every item.
+	 *
+	 * The input is expected to be sorted in ascending order, which makes
+	 * the whole conversion a linear pass. Unsorted input is still
+	 * converted correctly, but every backwards step restarts the sweep
+	 * from the start of the map.
+	 */
+	LIBTEMPORAL_API void superclocks_at (Beats const * in, superclock_t* out, size_t n) const;
+	LIBTEMPORAL_API void quarters_at_superclocks (superclock_t const * in, Beats* out, size_t n) const;
+
+	LIBTEMPORAL_API void superclocks_at (std::vector<Beats> const & in, std::vector<superclock_t>& out) const {
+		out.resize (in.size());
+		superclocks_at (in.data(), out.data(), in.size());
+	}
+	LIBTEMPORAL_API void quarters_at_superclocks (std::vector<superclock_t> const & in, std::vector<Beats>& out) const {
+		out.resize (in.size());
+		quarters_at_superclocks (in.data(), out.data(), in.size());
+	}
+
 	/* ways to walk along the tempo map, measure distance between points,
 	 * etc.
 	 */
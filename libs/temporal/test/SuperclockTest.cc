@@ -0,0 +1,117 @@
+#include <stdint.h>
+#include <limits>
+#include <random>
+
+#include "SuperclockTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SuperclockTest);
+
+using namespace Temporal;
+
+/* superclock rates used by current and older sessions, and by the ardour tests */
+static const superclock_t superclock_rates[] = { 282240000, 508032000, 56448000 };
+
+static const int sample_rates[] = { 8000, 11025, 16000, 22050, 24000, 32000, 44100, 48000, 88200, 96000, 176400, 192000, 352800, 384000 };
+
+/* Compare the converter against the muldiv based reference for a dense
+ * range around zero, every power of two (and its neighbours) in both
+ * directions, the int64_t extremes and a set of random values.
+ */
+
+template<typename F>
+static void
+for_each_test_value (F f)
+{
+	for (int64_t v = -100000; v <= 100000; ++v) {
+		f (v);
+	}
+
+	for (int k = 0; k < 63; ++k) {
+		for (int64_t d = -3; d <= 3; ++d) {
+			f ((int64_t (1) << k) + d);
+			f (-(int64_t (1) << k) + d);
+		}
+	}
+
+	f (std::numeric_limits<int64_t>::min());
+	f (std::numeric_limits<int64_t>::min() + 1);
+	f (std::numeric_limits<int64_t>::max());
+
+	std::mt19937_64 rng (0x5c5c);
+
+	for (int n = 0; n < 100000; ++n) {
+		f ((int64_t) rng ());
+	}
+}
+
+void
+SuperclockTest::setUp ()
+{
+	_saved_superclock_ticks_per_second = superclock_ticks_per_second ();
+	_saved_sample_rate = most_recent_engine_sample_rate;
+}
+
+void
+SuperclockTest::tearDown ()
+{
+	set_superclock_ticks_per_second (_saved_superclock_ticks_per_second);
+	set_sample_rate (_saved_sample_rate);
+}
+
+void
+SuperclockTest::exactTest ()
+{
+	for (auto scts : superclock_rates) {
+		for (auto sr : sample_rates) {
+			CPPUNIT_ASSERT (SuperclockSampleConverter (scts, sr).exact ());
+		}
+	}
+
+	/* rates that do not divide the superclock rate use the generic path */
+	CPPUNIT_ASSERT (!SuperclockSampleConverter (282240000, 12345).exact ());
+	CPPUNIT_ASSERT (!SuperclockSampleConverter (282240000, 0).exact ());
+	CPPUNIT_ASSERT (!SuperclockSampleConverter (0, 48000).exact ());
+
+	set_superclock_ticks_per_second (282240000);
+	set_sample_rate (48000);
+	CPPUNIT_ASSERT (superclock_sample_converter ().usable_for (282240000, 48000));
+	CPPUNIT_ASSERT (!superclock_sample_converter ().usable_for (282240000, 44100));
+
+	/* a published converter is never modified, and is re-used for the same rates */
+	SuperclockSampleConverter const* c = &superclock_sample_converter ();
+	set_sample_rate (44100);
+	CPPUNIT_ASSERT (superclock_sample_converter ().usable_for (282240000, 44100));
+	CPPUNIT_ASSERT (c->usable_for (282240000, 48000));
+	set_sample_rate (48000);
+	CPPUNIT_ASSERT (c == &superclock_sample_converter ());
+
+	set_sample_rate (12345);
+	CPPUNIT_ASSERT (!superclock_sample_converter ().usable_for (282240000, 12345));
+	CPPUNIT_ASSERT_EQUAL (PBD::muldiv_floor (1234567890, 12345, 282240000), superclock_to_samples (1234567890, 12345));
+}
+
+void
+SuperclockTest::toSamplesTest ()
+{
+	for (auto scts : superclock_rates) {
+		for (auto sr : sample_rates) {
+			const SuperclockSampleConverter c (scts, sr);
+			for_each_test_value ([&] (int64_t v) {
+				CPPUNIT_ASSERT_EQUAL (PBD::muldiv_floor (v, sr, scts), c.to_samples (v));
+			});
+		}
+	}
+}
+
+void
+SuperclockTest::toSuperclockTest ()
+{
+	for (auto scts : superclock_rates) {
+		for (auto sr : sample_rates) {
+			const SuperclockSampleConverter c (scts, sr);
+			for_each_test_value ([&] (int64_t v) {
+				CPPUNIT_ASSERT_EQUAL (PBD::muldiv_round (v, scts, superclock_t (sr)), c.to_superclock (v));
+			});
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "temporal/superclock.h"
+
+class SuperclockTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (SuperclockTest);
+	CPPUNIT_TEST (exactTest);
+	CPPUNIT_TEST (toSamplesTest);
+	CPPUNIT_TEST (toSuperclockTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void exactTest ();
+	void toSamplesTest ();
+	void toSuperclockTest ();
+
+private:
+	Temporal::superclock_t _saved_superclock_ticks_per_second;
+	int _saved_sample_rate;
+};
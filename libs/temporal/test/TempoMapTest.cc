@@ -53,5 +53,44 @@ TempoMapTest::roundTest()
 void
 TempoMapTest::convertTest()
 {
+	TempoMap::WritableSharedPtr tmap (TempoMap::write_copy());
+	tmap->set_tempo (Tempo (180, 4), BBT_Argument (6, 1, 0));
+	tmap->set_tempo (Tempo (72, 4), BBT_Argument (12, 1, 0));
+	tmap->set_meter (Meter (6, 8), BBT_Argument (3, 1, 0));
+
+	std::vector<Beats> beats;
+	for (int64_t t = 0; t < 80 * ticks_per_beat; t += 397) {
+		beats.push_back (Beats::ticks (t));
+	}
+
+	/* batched conversion must match one-at-a-time conversion */
+
+	std::vector<superclock_t> sc;
+	tmap->superclocks_at (beats, sc);
+	CPPUNIT_ASSERT_EQUAL (beats.size(), sc.size());
+
+	for (size_t n = 0; n < beats.size(); ++n) {
+		CPPUNIT_ASSERT_EQUAL (tmap->superclock_at (beats[n]), sc[n]);
+	}
+
+	std::vector<Beats> back;
+	tmap->quarters_at_superclocks (sc, back);
+	CPPUNIT_ASSERT_EQUAL (sc.size(), back.size());
+
+	for (size_t n = 0; n < sc.size(); ++n) {
+		CPPUNIT_ASSERT (tmap->quarters_at_superclock (sc[n]) == back[n]);
+	}
+
+	/* unsorted input is still converted correctly */
+
+	std::vector<Beats> unsorted (beats.rbegin(), beats.rend());
+	std::vector<superclock_t> usc;
+	tmap->superclocks_at (unsorted, usc);
+
+	for (size_t n = 0; n < unsorted.size(); ++n) {
+		CPPUNIT_ASSERT_EQUAL (tmap->superclock_at (unsorted[n]), usc[n]);
+	}
+
+	tmap->abort_update ();
 }
 
@@ -33,6 +33,17 @@ using namespace ArdourZita;
 float Convproc::_mac_cost = 1.0f;
 float Convproc::_fft_cost = 5.0f;
 
+Convproc::mac_t Convproc::_mac  = &Convproc::default_mac;
+uint32_t        Convproc::_vlen = 4;
+
+uint32_t        Convproc::_max_helpers = UINT32_MAX;
+uint32_t        Convproc::_num_helpers = 0;
+pthread_mutex_t Convproc::_helper_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef ENABLE_VECTOR_MODE
+typedef float FV4 __attribute__ ((vector_size (16)));
+#endif
+
 static float*
 calloc_real (uint32_t k)
 {
@@ -65,6 +76,8 @@ Convproc::Convproc (void)
 	, _maxpart (0)
 	, _nlevels (0)
 	, _latecnt (0)
+	, _nthr (1)
+	, _parallel (false)
 {
 	memset (_inpbuff, 0, MAXINP * sizeof (float*));
 	memset (_outbuff, 0, MAXOUT * sizeof (float*));
@@ -83,6 +96,100 @@ Convproc::set_options (uint32_t options)
 	_options = options;
 }
 
+int
+Convproc::set_threads (uint32_t nthr)
+{
+	if ((_state != ST_IDLE) && (_state != ST_STOP)) {
+		return Converror::BAD_STATE;
+	}
+	if ((nthr < 1) || (nthr > MAXTHR)) {
+		return Converror::BAD_PARAM;
+	}
+	_nthr = nthr;
+	return 0;
+}
+
+void
+Convproc::set_parallel (bool yes)
+{
+	uint32_t k;
+
+	_parallel = yes;
+	for (k = 0; k < _nlevels; k++) {
+		_convlev[k]->_parallel = yes;
+	}
+}
+
+void
+Convproc::set_max_helpers (uint32_t n)
+{
+	pthread_mutex_lock (&_helper_lock);
+	_max_helpers = n;
+	pthread_mutex_unlock (&_helper_lock);
+}
+
+uint32_t
+Convproc::reserve_helpers (uint32_t n)
+{
+	pthread_mutex_lock (&_helper_lock);
+	if (_num_helpers >= _max_helpers) {
+		n = 0;
+	} else if (n > _max_helpers - _num_helpers) {
+		n = _max_helpers - _num_helpers;
+	}
+	_num_helpers += n;
+	pthread_mutex_unlock (&_helper_lock);
+	return n;
+}
+
+void
+Convproc::release_helpers (uint32_t n)
+{
+	pthread_mutex_lock (&_helper_lock);
+	_num_helpers -= n;
+	pthread_mutex_unlock (&_helper_lock);
+}
+
+void
+Convproc::override_mac (mac_t f, uint32_t vlen)
+{
+	if (!f || ((vlen != 4) && (vlen != 8) && (vlen != 16))) {
+		return;
+	}
+	_mac  = f;
+	_vlen = vlen;
+}
+
+void
+Convproc::default_mac (float* d, const float* a, const float* b, uint32_t n)
+{
+	uint32_t k;
+
+#ifdef ENABLE_VECTOR_MODE
+	FV4*       D = (FV4*)d;
+	FV4 const* A = (FV4 const*)a;
+	FV4 const* B = (FV4 const*)b;
+	for (k = 0; k < n; k += 4) {
+		D[0] += A[0] * B[0] - A[1] * B[1];
+		D[1] += A[0] * B[1] + A[1] * B[0];
+		A += 2;
+		B += 2;
+		D += 2;
+	}
+#else
+	int i;
+	for (k = 0; k < n; k += 4) {
+		for (i = 0; i < 4; i++) {
+			d[i]     += a[i] * b[i] - a[i + 4] * b[i + 4];
+			d[i + 4] += a[i] * b[i + 4] + a[i + 4] * b[i];
+		}
+		a += 8;
+		b += 8;
+		d += 8;
+	}
+#endif
+}
+
 int
 Convproc::configure (uint32_t ninp,
                      uint32_t nout,
@@ -153,6 +260,8 @@ Convproc::configure (uint32_t ninp,
 				}
 			}
 			_convlev[pind] = new Convlevel ();
+			_convlev[pind]->_mac  = _mac;
+			_convlev[pind]->_vlen = _vlen;
 			_convlev[pind]->configure (prio, offs, npar, size, _options);
 			offs += size * npar;
 			if (offs < maxsize) {
@@ -262,8 +371,11 @@ Convproc::start_process (int abspri, int policy)
 	_outoffs = 0;
 	reset ();
 
+	for (k = 0; k < _nlevels; k++) {
+		_convlev[k]->_parallel = _parallel;
+	}
 	for (k = (_minpart == _quantum) ? 1 : 0; k < _nlevels; k++) {
-		_convlev[k]->start (abspri, policy);
+		_convlev[k]->start (abspri, policy, _nthr);
 	}
 
 	while (!check_started ((_minpart == _quantum) ? 1 : 0)) {
@@ -381,8 +493,10 @@ Convproc::cleanup (void)
 		_convlev[k] = 0;
 	}
 
-	_state   = ST_IDLE;
-	_options = 0;
+	_state    = ST_IDLE;
+	_options  = 0;
+	_nthr     = 1;
+	_parallel = false;
 	_ninp    = 0;
 	_nout    = 0;
 	_quantum = 0;
@@ -423,10 +537,6 @@ Convproc::print (FILE* F)
 	}
 }
 
-#ifdef ENABLE_VECTOR_MODE
-typedef float FV4 __attribute__ ((vector_size (16)));
-#endif
-
 Convlevel::Convlevel (void)
 	: _stat (ST_IDLE)
 	, _npar (0)
@@ -442,6 +552,13 @@ Convlevel::Convlevel (void)
 	, _time_data (0)
 	, _prep_data (0)
 	, _freq_data (0)
+	, _vlen (4)
+	, _mac (&Convproc::default_mac)
+	, _nhelp (0)
+	, _parallel (false)
+	, _phase (PH_INPUT)
+	, _cur_nthr (1)
+	, _helpers (0)
 {
 }
 
@@ -531,7 +648,7 @@ Convlevel::impdata_write (uint32_t inp,
 				fftwf_execute_dft_r2c (_plan_r2c, _prep_data, _freq_data);
 #ifdef ENABLE_VECTOR_MODE
 				if (_options & OPT_VECTOR_MODE) {
-					fftswap (_freq_data);
+					fftswap (_freq_data, false);
 				}
 #endif
 				for (j = 0; j <= (int)_parsize; j++) {
@@ -598,10 +715,11 @@ Convlevel::reset (uint32_t inpsize,
 	_opind = 0;
 	_trig.init (0, 0);
 	_done.init (0, 0);
+	_help_done.init (0, 0);
 }
 
 void
-Convlevel::start (int abspri, int policy)
+Convlevel::start (int abspri, int policy, uint32_t nthr)
 {
 	int                min, max;
 	pthread_attr_t     attr;
@@ -627,10 +745,48 @@ Convlevel::start (int abspri, int policy)
 	pthread_attr_setscope (&attr, PTHREAD_SCOPE_SYSTEM);
 	pthread_attr_setinheritsched (&attr, PTHREAD_EXPLICIT_SCHED);
 	pthread_attr_setstacksize (&attr, 0x10000); // 64kB
-	pthread_create (&_pthr, &attr, static_main, this);
+	if (!pthread_create (&_pthr, &attr, static_main, this) && (nthr > 1)) {
+		start_helpers (&attr, nthr);
+	}
 	pthread_attr_destroy (&attr);
 }
 
+void
+Convlevel::start_helpers (pthread_attr_t* attr, uint32_t nthr)
+{
+	uint32_t    k, n;
+	Convhelper* H;
+
+	/* shared by all instances, see Convproc::set_max_helpers() */
+	n        = Convproc::reserve_helpers (nthr - 1);
+	_nhelp   = 0;
+	_helpers = new Convhelper*[nthr - 1];
+	for (k = 1; k <= n; k++) {
+		H = new Convhelper (this, k);
+		if (!H->_time_data || !H->_freq_data || pthread_create (&H->_pthr, attr, Convhelper::static_main, H)) {
+			delete H;
+			break;
+		}
+		_helpers[_nhelp++] = H;
+	}
+	Convproc::release_helpers (n - _nhelp);
+}
+
+void
+Convlevel::stop_helpers (void)
+{
+	uint32_t k;
+
+	for (k = 0; k < _nhelp; k++) {
+		_helpers[k]->_term = true;
+		_helpers[k]->_trig.post ();
+	}
+	for (k = 0; k < _nhelp; k++) {
+		_help_done.wait ();
+	}
+	Convproc::release_helpers (_nhelp);
+}
+
 void
 Convlevel::stop (void)
 {
@@ -669,6 +825,13 @@ Convlevel::cleanup (void)
 	}
 	_out_list = 0;
 
+	for (uint32_t k = 0; k < _nhelp; k++) {
+		delete _helpers[k];
+	}
+	delete[] _helpers;
+	_helpers = 0;
+	_nhelp   = 0;
+
 	fftwf_destroy_plan (_plan_r2c);
 	fftwf_destroy_plan (_plan_c2r);
 	fftwf_free (_time_data);
@@ -698,6 +861,7 @@ Convlevel::main (void)
 	while (true) {
 		_trig.wait ();
 		if (_stat == ST_TERM) {
+			stop_helpers ();
 			_stat = ST_IDLE;
 #ifndef PTW32_VERSION
 			_pthr = 0;
@@ -712,74 +876,120 @@ Convlevel::main (void)
 void
 Convlevel::process ()
 {
-	uint32_t       i, i1, j, k, n1, n2, opi1, opi2;
-	Inpnode const* X;
-	Macnode const* M;
-	Outnode const* Y;
-	fftwf_complex* ffta;
-	fftwf_complex* fftb;
-	float*         inpd;
-	float*         outd;
+	uint32_t nthr;
 
-	i1       = _inpoffs;
-	n1       = _parsize;
-	n2       = 0;
-	_inpoffs = i1 + n1;
+	_cur_i1  = _inpoffs;
+	_cur_n1  = _parsize;
+	_cur_n2  = 0;
+	_inpoffs = _cur_i1 + _cur_n1;
 	if (_inpoffs >= _inpsize) {
 		_inpoffs -= _inpsize;
-		n2 = _inpoffs;
-		n1 -= n2;
+		_cur_n2 = _inpoffs;
+		_cur_n1 -= _cur_n2;
 	}
 
-	opi1 = (_opind + 1) % 3;
-	opi2 = (_opind + 2) % 3;
+	_cur_op1 = (_opind + 1) % 3;
+	_cur_op2 = (_opind + 2) % 3;
 
-	for (X = _inp_list; X; X = X->_next) {
+	/* all inputs must be transformed before any output can be computed */
+	nthr = _parallel ? _nhelp + 1 : 1;
+	process_phase (PH_INPUT, nthr);
+	process_phase (PH_OUTPUT, nthr);
+
+	_ptind++;
+	if (_ptind == _npar) {
+		_ptind = 0;
+	}
+}
+
+void
+Convlevel::process_phase (uint32_t phase, uint32_t nthr)
+{
+	uint32_t k;
+
+	_phase    = phase;
+	_cur_nthr = nthr;
+	for (k = 1; k < nthr; k++) {
+		_helpers[k - 1]->_trig.post ();
+	}
+	process_part (0, nthr, _time_data, _freq_data);
+	for (k = 1; k < nthr; k++) {
+		_help_done.wait ();
+	}
+}
+
+void
+Convlevel::process_part (uint32_t k, uint32_t nthr, float* time_data, fftwf_complex* freq_data)
+{
+	if (_phase == PH_INPUT) {
+		process_inputs (k, nthr, time_data);
+	} else {
+		process_outputs (k, nthr, time_data, freq_data);
+	}
+}
+
+void
+Convlevel::process_inputs (uint32_t k, uint32_t nthr, float* time_data)
+{
+	uint32_t       j;
+	Inpnode const* X;
+	float*         inpd;
+
+	for (X = _inp_list, j = 0; X; X = X->_next, j++) {
+		if (j % nthr != k) {
+			continue;
+		}
 		inpd = _inpbuff[X->_inp];
-		if (n1) {
-			memcpy (_time_data, inpd + i1, n1 * sizeof (float));
+		if (_cur_n1) {
+			memcpy (time_data, inpd + _cur_i1, _cur_n1 * sizeof (float));
 		}
-		if (n2) {
-			memcpy (_time_data + n1, inpd, n2 * sizeof (float));
+		if (_cur_n2) {
+			memcpy (time_data + _cur_n1, inpd, _cur_n2 * sizeof (float));
 		}
-		memset (_time_data + _parsize, 0, _parsize * sizeof (float));
-		fftwf_execute_dft_r2c (_plan_r2c, _time_data, X->_ffta[_ptind]);
+		memset (time_data + _parsize, 0, _parsize * sizeof (float));
+		fftwf_execute_dft_r2c (_plan_r2c, time_data, X->_ffta[_ptind]);
 #ifdef ENABLE_VECTOR_MODE
 		if (_options & OPT_VECTOR_MODE) {
-			fftswap (X->_ffta[_ptind]);
+			fftswap (X->_ffta[_ptind], false);
 		}
 #endif
 	}
+}
 
-	for (Y = _out_list; Y; Y = Y->_next) {
-		memset (_freq_data, 0, (_parsize + 1) * sizeof (fftwf_complex));
+void
+Convlevel::process_outputs (uint32_t k, uint32_t nthr, float* time_data, fftwf_complex* freq_data)
+{
+	uint32_t       i, j, m;
+	Inpnode const* X;
+	Macnode const* M;
+	Outnode const* Y;
+	fftwf_complex* ffta;
+	fftwf_complex* fftb;
+	float*         outd;
+
+	for (Y = _out_list, j = 0; Y; Y = Y->_next, j++) {
+		if (j % nthr != k) {
+			continue;
+		}
+		memset (freq_data, 0, (_parsize + 1) * sizeof (fftwf_complex));
 		for (M = Y->_list; M; M = M->_next) {
 			X = M->_inpn;
 			i = _ptind;
-			for (j = 0; j < _npar; j++) {
+			for (m = 0; m < _npar; m++) {
 				ffta = X->_ffta[i];
-				fftb = M->_link ? M->_link->_fftb[j] : M->_fftb[j];
+				fftb = M->_link ? M->_link->_fftb[m] : M->_fftb[m];
 				if (fftb) {
 #ifdef ENABLE_VECTOR_MODE
 					if (_options & OPT_VECTOR_MODE) {
-						FV4* A = (FV4*)ffta;
-						FV4* B = (FV4*)fftb;
-						FV4* D = (FV4*)_freq_data;
-						for (k = 0; k < _parsize; k += 4) {
-							D[0] += A[0] * B[0] - A[1] * B[1];
-							D[1] += A[0] * B[1] + A[1] * B[0];
-							A += 2;
-							B += 2;
-							D += 2;
-						}
-						_freq_data[_parsize][0] += ffta[_parsize][0] * fftb[_parsize][0];
-						_freq_data[_parsize][1] = 0;
+						_mac ((float*)freq_data, (float const*)ffta, (float const*)fftb, _parsize);
+						freq_data[_parsize][0] += ffta[_parsize][0] * fftb[_parsize][0];
+						freq_data[_parsize][1] = 0;
 					} else
 #endif
 					{
-						for (k = 0; k <= _parsize; k++) {
-							_freq_data[k][0] += ffta[k][0] * fftb[k][0] - ffta[k][1] * fftb[k][1];
-							_freq_data[k][1] += ffta[k][0] * fftb[k][1] + ffta[k][1] * fftb[k][0];
+						for (uint32_t n = 0; n <= _parsize; n++) {
+							freq_data[n][0] += ffta[n][0] * fftb[n][0] - ffta[n][1] * fftb[n][1];
+							freq_data[n][1] += ffta[n][0] * fftb[n][1] + ffta[n][1] * fftb[n][0];
 						}
 					}
 				}
@@ -792,21 +1002,16 @@ Convlevel::process ()
 
 #ifdef ENABLE_VECTOR_MODE
 		if (_options & OPT_VECTOR_MODE) {
-			fftswap (_freq_data);
+			fftswap (freq_data, true);
 		}
 #endif
-		fftwf_execute_dft_c2r (_plan_c2r, _freq_data, _time_data);
-		outd = Y->_buff[opi1];
-		for (k = 0; k < _parsize; k++) {
-			outd[k] += _time_data[k];
+		fftwf_execute_dft_c2r (_plan_c2r, freq_data, time_data);
+		outd = Y->_buff[_cur_op1];
+		for (i = 0; i < _parsize; i++) {
+			outd[i] += time_data[i];
 		}
-		outd = Y->_buff[opi2];
-		memcpy (outd, _time_data + _parsize, _parsize * sizeof (float));
-	}
-
-	_ptind++;
-	if (_ptind == _npar) {
-		_ptind = 0;
+		outd = Y->_buff[_cur_op2];
+		memcpy (outd, time_data + _parsize, _parsize * sizeof (float));
 	}
 }
 
@@ -934,11 +1139,40 @@ Convlevel::findmacnode (uint32_t inp, uint32_t out, bool create)
 
 #ifdef ENABLE_VECTOR_MODE
 
+/* Reorder blocks of _vlen complex values into _vlen real parts followed
+ * by _vlen imaginary parts, or back (inverse). The order within a block
+ * does not matter, as long as it is the same for all operands of the MAC.
+ * For blocks of 4 this is done by an involution: r0 r2 r1 r3 i0 i2 i1 i3.
+ */
 void
-Convlevel::fftswap (fftwf_complex* p)
+Convlevel::fftswap (fftwf_complex* p, bool inverse)
 {
 	uint32_t n = _parsize;
+	uint32_t i;
 	float    a, b;
+	float    t[2 * Convproc::MAXVLEN];
+	float*   q;
+
+	if (_vlen != 4) {
+		while (n) {
+			q = (float*)p;
+			memcpy (t, q, 2 * _vlen * sizeof (float));
+			if (inverse) {
+				for (i = 0; i < _vlen; i++) {
+					q[2 * i]     = t[i];
+					q[2 * i + 1] = t[_vlen + i];
+				}
+			} else {
+				for (i = 0; i < _vlen; i++) {
+					q[i]         = t[2 * i];
+					q[_vlen + i] = t[2 * i + 1];
+				}
+			}
+			p += _vlen;
+			n -= _vlen;
+		}
+		return;
+	}
 
 	while (n) {
 		a       = p[2][0];
@@ -954,6 +1188,48 @@ Convlevel::fftswap (fftwf_complex* p)
 
 #endif
 
+Convhelper::Convhelper (Convlevel* level, uint32_t index)
+	: _level (level)
+	, _index (index)
+	, _term (false)
+#ifndef PTW32_VERSION
+	, _pthr (0)
+#endif
+{
+	_time_data = fftwf_alloc_real (2 * level->_parsize);
+	_freq_data = fftwf_alloc_complex (level->_parsize + 1);
+}
+
+Convhelper::~Convhelper (void)
+{
+	fftwf_free (_time_data);
+	fftwf_free (_freq_data);
+}
+
+void*
+Convhelper::static_main (void* arg)
+{
+#if !defined PTW32_VERSION && defined _GNU_SOURCE
+	pthread_setname_np (pthread_self(), "ZConvhelper");
+#endif
+	((Convhelper*)arg)->main ();
+	return 0;
+}
+
+void
+Convhelper::main (void)
+{
+	while (true) {
+		_trig.wait ();
+		if (_term) {
+			_level->_help_done.post ();
+			return;
+		}
+		_level->process_part (_index, _level->_cur_nthr, _time_data, _freq_data);
+		_level->_help_done.post ();
+	}
+}
+
 Inpnode::Inpnode (uint16_t inp)
 	: _next (0)
 	, _ffta (0)
@@ -163,6 +163,8 @@ private:
 
 // ----------------------------------------------------------------------------
 
+class Convhelper;
+
 class LIBZCONVOLVER_API Inpnode
 {
 private:
@@ -229,6 +231,7 @@ class LIBZCONVOLVER_API Convlevel
 {
 private:
 	friend class Convproc;
+	friend class Convhelper;
 
 	enum {
 		OPT_FFTW_MEASURE = 1,
@@ -242,6 +245,11 @@ private:
 		ST_PROC
 	};
 
+	enum {
+		PH_INPUT,
+		PH_OUTPUT
+	};
+
 	Convlevel (void);
 	~Convlevel (void);
 
@@ -267,10 +275,15 @@ private:
 	            float**  inpbuff,
 	            float**  outbuff);
 
-	void start (int absprio, int policy);
+	void start (int absprio, int policy, uint32_t nthr);
 
 	void process ();
 
+	void process_phase (uint32_t phase, uint32_t nthr);
+	void process_part (uint32_t k, uint32_t nthr, float* time_data, fftwf_complex* freq_data);
+	void process_inputs (uint32_t k, uint32_t nthr, float* time_data);
+	void process_outputs (uint32_t k, uint32_t nthr, float* time_data, fftwf_complex* freq_data);
+
 	int readout ();
 	int readtail (uint32_t n_samples);
 
@@ -278,7 +291,7 @@ private:
 
 	void cleanup (void);
 
-	void fftswap (fftwf_complex* p);
+	void fftswap (fftwf_complex* p, bool inverse);
 
 	void print (FILE* F);
 
@@ -288,6 +301,9 @@ private:
 
 	Macnode* findmacnode (uint32_t inp, uint32_t out, bool create);
 
+	void start_helpers (pthread_attr_t* attr, uint32_t nthr);
+	void stop_helpers (void);
+
 	volatile uint32_t _stat;      // current processing state
 	int               _prio;      // relative priority
 	uint32_t          _offs;      // offset from start of impulse response
@@ -314,6 +330,40 @@ private:
 	fftwf_complex*    _freq_data; // workspace
 	float**           _inpbuff;   // array of shared input buffers
 	float**           _outbuff;   // array of shared output buffers
+	uint32_t          _vlen;      // vector size of the MAC function
+	void (*_mac) (float*, const float*, const float*, uint32_t);
+	uint32_t          _nhelp;     // number of running helper threads
+	volatile bool     _parallel;  // use the helper threads
+	volatile uint32_t _phase;     // current phase of a cycle
+	volatile uint32_t _cur_nthr;  // number of threads sharing the current cycle
+	uint32_t          _cur_i1;    // input buffer range of the current cycle
+	uint32_t          _cur_n1;
+	uint32_t          _cur_n2;
+	uint32_t          _cur_op1;   // output buffers of the current cycle
+	uint32_t          _cur_op2;
+	ZCsema            _help_done; // sema used to wait for helpers
+	Convhelper**      _helpers;   // helper threads, sharing the work of a cycle
+};
+
+class LIBZCONVOLVER_API Convhelper
+{
+private:
+	friend class Convlevel;
+
+	Convhelper (Convlevel* level, uint32_t index);
+	~Convhelper (void);
+
+	static void* static_main (void* arg);
+
+	void main (void);
+
+	Convlevel*     _level;
+	uint32_t       _index;     // index of the share of the work
+	volatile bool  _term;      // request to terminate
+	pthread_t      _pthr;      // posix thread executing this helper
+	ZCsema         _trig;      // sema used to trigger a phase
+	float*         _time_data; // workspace
+	fftwf_complex* _freq_data; // workspace
 };
 
 // ----------------------------------------------------------------------------
@@ -350,7 +400,9 @@ public:
 		MAXPART  = 8192,
 		MAXDIVIS = 16,
 		MINQUANT = 16,
-		MAXQUANT = 8192
+		MAXQUANT = 8192,
+		MAXTHR   = 64,
+		MAXVLEN  = 16
 	};
 
 	uint32_t state (void) const
@@ -388,6 +440,40 @@ public:
 
 	void set_options (uint32_t options);
 
+	/* Number of threads processing each partition size, including
+	 * the one that is running the level (default 1). Inputs and outputs
+	 * are shared among the threads. Takes effect at start_process(),
+	 * helper threads are only used while set_parallel (true).
+	 */
+	int set_threads (uint32_t nthr);
+
+	/* Enable or disable the helper threads, realtime safe. */
+	void set_parallel (bool yes);
+
+	/* Limit the total number of helper threads of all instances
+	 * (default: no limit). Levels that are started once the limit is
+	 * reached get fewer helpers, or none. Helper threads are never used
+	 * by the first level if minpart == quantum, since it is processed
+	 * by the caller of process().
+	 */
+	static void set_max_helpers (uint32_t n);
+
+	/* Multiply-accumulate of complex spectra in vector mode, in blocks
+	 * of vlen real parts followed by vlen imaginary parts:
+	 *
+	 *   d.re += a.re * b.re - a.im * b.im
+	 *   d.im += a.re * b.im + a.im * b.re
+	 *
+	 * n is the number of complex values, a multiple of vlen. Can be
+	 * replaced by an optimized version, that applies to instances
+	 * configured afterwards. vlen must be 4, 8 or 16.
+	 */
+	typedef void (*mac_t) (float* d, const float* a, const float* b, uint32_t n);
+
+	static void override_mac (mac_t f, uint32_t vlen);
+
+	static void default_mac (float* d, const float* a, const float* b, uint32_t n);
+
 	int reset (void);
 
 	int start_process (int abspri, int policy);
@@ -405,6 +491,11 @@ public:
 	void print (FILE* F = stdout);
 
 private:
+	friend class Convlevel;
+
+	static uint32_t reserve_helpers (uint32_t n);
+	static void     release_helpers (uint32_t n);
+
 	uint32_t   _state;           // current state
 	float*     _inpbuff[MAXINP]; // input buffers
 	float*     _outbuff[MAXOUT]; // output buffers
@@ -419,11 +510,20 @@ private:
 	uint32_t   _nlevels;         // number of partition sizes
 	uint32_t   _inpsize;         // size of input buffers
 	uint32_t   _latecnt;         // count of cycles ending too late
+	uint32_t   _nthr;            // number of threads per level
+	bool       _parallel;        // use helper threads
 	Convlevel* _convlev[MAXLEV]; // array of processors
 	void*      _dummy[64];
 
 	static float _mac_cost;
 	static float _fft_cost;
+
+	static mac_t    _mac;
+	static uint32_t _vlen;
+
+	static uint32_t        _max_helpers;
+	static uint32_t        _num_helpers;
+	static pthread_mutex_t _helper_lock;
 };
 
 // ----------------------------------------------------------------------------
@@ -28,11 +28,34 @@
 
 using namespace ArdourZita;
 
+VMResampler::interpolate_t VMResampler::_interpolate = &VMResampler::default_interpolate;
+VMResampler::dot_product_t VMResampler::_dot_product = &VMResampler::default_dot_product;
+
+void
+VMResampler::default_interpolate (float *c, const float *cq1, const float *cq2, float aa, float bb, unsigned int hl)
+{
+	for (unsigned int i = 0; i < hl; i++) {
+		c [i] = aa * cq1 [i] + bb * cq1 [i + hl];
+	}
+	for (unsigned int i = 0; i < hl; i++) {
+		c [hl + i] = aa * cq2 [hl - 1 - i] + bb * cq2 [-1 - (int)i];
+	}
+}
+
+float
+VMResampler::default_dot_product (const float *c, const float *p, unsigned int n)
+{
+	float a = 1e-25f;
+	for (unsigned int i = 0; i < n; i++) {
+		a += p [i] * c [i];
+	}
+	return a - 1e-25f;
+}
+
 VMResampler::VMResampler (void)
 	: _table (0)
   , _buff  (0)
-  , _c1 (0)
-  , _c2 (0)
+  , _coef (0)
   , _reset (false)
 {
 	reset ();
@@ -66,8 +89,7 @@ VMResampler::setup (unsigned int hlen, double frel)
 	if (T) {
 		_table = T;
 		_buff  = new float [2 * h - 1 + k];
-		_c1 = new float [2 * h];
-		_c2 = new float [2 * h];
+		_coef = new float [2 * h];
 		_inmax = k;
 		_pstep = s;
 		_qstep = s;
@@ -82,11 +104,9 @@ VMResampler::clear (void)
 {
 	Resampler_table::destroy (_table);
 	delete[] _buff;
-	delete[] _c1;
-	delete[] _c2;
+	delete[] _coef;
 	_buff  = 0;
-	_c1 = 0;
-	_c2 = 0;
+	_coef = 0;
 	_table = 0;
 	_inmax = 0;
 	_pstep = 0;
@@ -167,7 +187,7 @@ VMResampler::process (void)
 {
 	unsigned int   in, nr, n;
 	double         ph, dp;
-	float          a, *p1, *p2;
+	float          *p1, *p2;
 
 	if (!_table) {
 		n = std::min (inp_count, out_count);
@@ -241,21 +261,12 @@ VMResampler::process (void)
 				const unsigned int k = (unsigned int) /*floor (ph / np) +*/ hl;
 				*out_data++ = p1[k];
 			} else {
+				/* p2 == p1 + 2 * hl, when no input is to be read */
 				const unsigned int k = (unsigned int) ph;
 				const float bb = (float)(ph - k);
 				const float aa = 1.0f - bb;
-				float const* cq1 = _table->_ctab + hl * k;
-				float const* cq2 = _table->_ctab + hl * (np - k);
-				for (int i = 0; i < hl; i++) {
-					_c1 [i] = aa * cq1 [i] + bb * cq1 [i + hl];
-					_c2 [i] = aa * cq2 [i] + bb * cq2 [i - hl];
-				}
-
-				a = 1e-25f;
-				for (int i = 0; i < hl; i++) {
-					a += p1[i] * _c1 [i] + p2[-i-1] * _c2 [i];
-				}
-				*out_data++ = a - 1e-25f;
+				_interpolate (_coef, _table->_ctab + hl * k, _table->_ctab + hl * (np - k), aa, bb, hl);
+				*out_data++ = _dot_product (_coef, p1, 2 * hl);
 			}
 			out_count--;
 
@@ -289,3 +300,133 @@ VMResampler::process (void)
 
 	return 0;
 }
+
+bool
+VMResampler::in_sync (const VMResampler &r) const
+{
+	return _table == r._table
+		&& _index == r._index
+		&& _nread == r._nread
+		&& _phase == r._phase
+		&& _pstep == r._pstep
+		&& _qstep == r._qstep
+		&& _wstep == r._wstep
+		&& inp_count == r.inp_count
+		&& out_count == r.out_count;
+}
+
+void
+VMResampler::process (VMResampler * const *r, unsigned int n)
+{
+	unsigned int i = 0;
+	while (i < n) {
+		unsigned int j = i + 1;
+		while (j < n && j - i < MAXSYNC && r[j]->in_sync (*r[i])) {
+			j++;
+		}
+		process_sync (r + i, j - i);
+		i = j;
+	}
+}
+
+void
+VMResampler::process_sync (VMResampler * const *r, unsigned int nch)
+{
+	unsigned int   in, nr, n, ic, oc;
+	double         ph, dp;
+	float          *p1 [MAXSYNC], *p2 [MAXSYNC];
+	float          *inp [MAXSYNC], *out [MAXSYNC];
+
+	VMResampler& R = *r[0];
+
+	if (nch == 1 || !R._table || (R._pstep == R._table->_np && R._qstep == R._table->_np && R._nread == 1 && R.inp_count == R.out_count)) {
+		/* nothing to share, or no filtering involved */
+		for (unsigned int c = 0; c < nch; c++) {
+			r[c]->process ();
+		}
+		return;
+	}
+
+	const int hl = R._table->_hl;
+	const unsigned int np = R._table->_np;
+	in = R._index;
+	nr = R._nread;
+	ph = R._phase;
+	dp = R._pstep;
+	ic = R.inp_count;
+	oc = R.out_count;
+	n = 2 * hl - nr;
+
+	for (unsigned int c = 0; c < nch; c++) {
+		p1[c] = r[c]->_buff + in;
+		p2[c] = p1[c] + n;
+		inp[c] = r[c]->inp_data;
+		out[c] = r[c]->out_data;
+	}
+
+	while (oc) {
+		if (nr) {
+			if (ic == 0) break;
+			for (unsigned int c = 0; c < nch; c++) {
+				*p2[c]++ = *inp[c]++;
+			}
+			nr--;
+			ic--;
+		} else {
+			if (dp == np) {
+				for (unsigned int c = 0; c < nch; c++) {
+					*out[c]++ = p1[c][hl];
+				}
+			} else {
+				/* the coefficients only depend on the phase, compute them once */
+				const unsigned int k = (unsigned int) ph;
+				const float bb = (float)(ph - k);
+				const float aa = 1.0f - bb;
+				_interpolate (R._coef, R._table->_ctab + hl * k, R._table->_ctab + hl * (np - k), aa, bb, hl);
+				for (unsigned int c = 0; c < nch; c++) {
+					*out[c]++ = _dot_product (R._coef, p1[c], 2 * hl);
+				}
+			}
+			oc--;
+
+			const double dd = R._qstep - dp;
+			if (fabs (dd) < 1e-12) {
+				dp = R._qstep;
+			} else {
+				dp += R._wstep * dd;
+			}
+			ph += dp;
+
+			if (ph >= np) {
+				nr = (unsigned int) floor (ph / np);
+				ph -= nr * np;
+				in += nr;
+				for (unsigned int c = 0; c < nch; c++) {
+					p1[c] += nr;
+				}
+				if (in >= R._inmax) {
+					n = (2 * hl - nr);
+					for (unsigned int c = 0; c < nch; c++) {
+						memcpy (r[c]->_buff, p1[c], n * sizeof (float));
+						p1[c] = r[c]->_buff;
+						p2[c] = p1[c] + n;
+					}
+					in = 0;
+				}
+			}
+		}
+	}
+
+	for (unsigned int c = 0; c < nch; c++) {
+		VMResampler& S = *r[c];
+		S.inp_count = ic;
+		S.out_count = oc;
+		S.inp_data = inp[c];
+		S.out_data = out[c];
+		S._index = in;
+		S._nread = nr;
+		S._phase = ph;
+		S._pstep = dp;
+		S._reset = false;
+	}
+}
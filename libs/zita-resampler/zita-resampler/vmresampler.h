@@ -29,6 +29,24 @@ namespace ArdourZita {
 class LIBZRESAMPLER_API VMResampler
 {
 public:
+	/* The filter is a dot product of the 2 * hl input samples in the
+	 * delay line with 2 * hl coefficients. Those are interpolated
+	 * between two adjacent phases of the polyphase table:
+	 *
+	 *   c[i]      = aa * cq1[i] + bb * cq1[i + hl]
+	 *   c[hl + i] = aa * cq2[hl - 1 - i] + bb * cq2[-1 - i]
+	 *
+	 * Both can be replaced by optimized versions, see override_*().
+	 */
+	typedef void  (*interpolate_t) (float *c, const float *cq1, const float *cq2, float aa, float bb, unsigned int hl);
+	typedef float (*dot_product_t) (const float *c, const float *p, unsigned int n);
+
+	static void override_interpolate (interpolate_t f) { _interpolate = f; }
+	static void override_dot_product (dot_product_t f) { _dot_product = f; }
+
+	static void  default_interpolate (float *c, const float *cq1, const float *cq2, float aa, float bb, unsigned int hl);
+	static float default_dot_product (const float *c, const float *p, unsigned int n);
+
 	VMResampler (void);
 	~VMResampler (void);
 
@@ -41,6 +59,14 @@ public:
 	double inpdist (void) const;
 	int    process (void);
 
+	/* Process several resamplers at once (e.g. one per port).
+	 * Resamplers that are in sync, i.e. that were set up and
+	 * processed alike, share the coefficient computation. Runs of
+	 * up to MAXSYNC in-sync resamplers are processed together,
+	 * the others one by one.
+	 */
+	static void process (VMResampler * const *r, unsigned int n);
+
 	void   set_phase (double p);
 	void   set_rrfilt (double t);
 	double set_rratio (double r);
@@ -52,9 +78,14 @@ public:
 	void                *inp_list;
 	void                *out_list;
 
+	enum { MAXSYNC = 16 };
+
 private:
 	enum { NPHASE = 256 };
 
+	bool in_sync (const VMResampler &r) const;
+	static void process_sync (VMResampler * const *r, unsigned int n);
+
 	Resampler_table     *_table;
 	unsigned int         _inmax;
 	unsigned int         _index;
@@ -64,9 +95,11 @@ private:
 	double               _qstep;
 	double               _wstep;
 	float               *_buff;
-	float               *_c1;
-	float               *_c2;
+	float               *_coef;
 	bool                 _reset;
+
+	static interpolate_t _interpolate;
+	static dot_product_t _dot_product;
 };
 
 };